@@ -0,0 +1,2223 @@
+﻿/**
+ * @file    rbtree_bench.cpp
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * 文件名称：rbtree_bench.cpp
+ * 创建日期：2019年09月12日
+ * 文件标识：
+ * 文件摘要：红黑树的性能测试程序（取代 rbtree_test.cpp 中的简单计时）。
+ *
+ * 编译方式：
+ *   g++ -O2 -std=c++11 -pthread -o rbtree_bench rbtree_bench.cpp xrbtree.c xtimerq.c
+ *
+ * 运行方式（参数均可省略，逗号分隔可指定多个值，all 表示全部）：
+ *   rbtree_bench --n 1000000 --impl all --key u32,str64 --dist random,zipf
+ *                --mix 50,90 --reps 3 --format text|csv|json
+ *   rbtree_bench --mode latency --sizes 1000,100000,1000000 --noise 2
+ *
+ * 测试维度：
+ *   impl : xrbtree, xrbtree-kv, xrbtree-multi, xrbtree-prefix, xrbtree-borrow,
+ *          xrbtree-intrusive, xrbtree_set, xrbtree_map（xrbtree_stl.h 容器）, std-set, std-map
+ *   key  : u32(4字节), u64(8字节), str16, str64, str256（std::string）
+ *   dist : seq, reverse, random, zipf, cluster
+ *   mix  : 混合读写测试中读操作所占的百分比
+ *
+ * 测试操作（steady_clock 计时，输出 ns/op）：
+ *   insert, find_hit, find_miss, lower_bound, scan, range_scan, mixed, erase, clear；
+ *   另输出每个键的内存占用：mem_alloc（节点分配字节数）、mem_rss（进程 RSS 增量）。
+ *
+ * 延迟测试（--mode latency）：
+ *   对每次操作单独计时，记入对数分桶的直方图（HDR 风格，相对误差 < 1/64），
+ *   按 --sizes 指定的各个树大小，输出 insert, find, erase（随机）, erase_min,
+ *   erase_max, clear（每轮一个样本）的 p50/p99/p99.9/max 。
+ *   --noise N 启动 N 个后台线程持续读写 --noise-mb 大小的缓冲区，模拟缓存污染。
+ *   每次计时本身的开销（两次 steady_clock::now()）以 timer 操作单独输出。
+ *
+ * 硬件计数器（--perf，仅 Linux）：
+ *   吞吐量测试的每个阶段外围用 perf_event_open 采集 cycles, instructions,
+ *   branch-misses, L1d/LLC/dTLB 读缺失，并按操作次数归一化，
+ *   以 "<op>/<counter>" 的记录输出（value 为每次操作的事件数）。
+ *   计数器不可用（如容器内、perf_event_paranoid 限制）时，只输出计时结果。
+ *
+ * 操作记录重放（--mode replay --trace FILE）：
+ *   读取 xrbtree_record_start() 生成的操作记录文件（编译 xrbtree.c 时需定义
+ *   XRBTREE_ENABLE_RECORD=1），以最快速度在各个 impl 上依次重放全部操作，
+ *   按操作类型输出延迟分布（输出格式同延迟测试，all 为全部操作的汇总）。
+ *   索引键按 --key 解释：u32/u64 要求记录的索引键大小为 4/8 字节，
+ *   bytes 则按字节序比较（默认按索引键大小自动选择）。
+ *
+ * 定时器队列（--mode timer）：
+ *   对比 xtimerq（x_rbtree_t）、heap（带位置索引的二叉堆）、wheel（单层时间轮），
+ *   --n 个定时器，到期时间在 [now + 1, now + --span] 内随机；每次操作随机选取一个定时器，
+ *   已启动的按 --cancel 指定的百分比取消（否则以新的到期时间重新启动），未启动的则启动，
+ *   每 16 次操作推进 1 个时间单位并触发到期的定时器；输出 ops（ns/op）与 fired（触发数量）。
+ *
+ * 当前版本：1.0.0.0
+ * 作    者：
+ * 完成日期：2019年09月12日
+ * 版本摘要：
+ *
+ * 取代版本：
+ * 原作者  ：
+ * 完成日期：
+ * 版本摘要：
+ * </pre>
+ */
+
+#include "xrbtree.h"
+#include "xtimerq.h"
+#include "xrbtree_stl.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif // defined(__linux__)
+
+#include <set>
+#include <map>
+#include <deque>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <atomic>
+
+////////////////////////////////////////////////////////////////////////////////
+
+using xtime_clock = std::chrono::steady_clock;
+using xtime_point = std::chrono::steady_clock::time_point;
+
+#define xtime_nsec(xtm_value) \
+    std::chrono::duration_cast< std::chrono::nanoseconds >(xtm_value).count()
+
+////////////////////////////////////////////////////////////////////////////////
+// 测试配置与结果输出
+
+/**
+ * @struct xbench_conf_t
+ * @brief  性能测试的配置参数。
+ */
+struct xbench_conf_t
+{
+    size_t                     xst_count  = 1000000;
+    size_t                     xst_reps   = 1;
+    size_t                     xst_range  = 100;
+    uint64_t                   xu64_seed  = 20190912;
+    std::string                xstr_format = "text";
+    std::string                xstr_mode   = "throughput";
+    size_t                     xst_noise   = 0;
+    size_t                     xst_noise_mb = 64;
+    bool                       xbt_perf    = false;
+    std::string                xstr_trace;
+    size_t                     xst_span    = 10000;
+    std::vector< int >         xvec_cancel = { 50, 90, 99 };
+    std::vector< size_t >      xvec_sizes;
+    std::vector< std::string > xvec_impl;
+    std::vector< std::string > xvec_key;
+    std::vector< std::string > xvec_dist;
+    std::vector< int >         xvec_mix;
+};
+
+/**
+ * @struct xbench_record_t
+ * @brief  单项测试的结果记录。
+ */
+struct xbench_record_t
+{
+    std::string xstr_impl;
+    std::string xstr_key;
+    std::string xstr_dist;
+    size_t      xst_count;
+    int         xit_mix;
+    std::string xstr_op;
+    size_t      xst_ops;
+    int64_t     xit_total_ns;
+    double      xdbl_value;   ///< ns/op（内存类记录为 bytes/key）
+};
+
+/**
+ * @class xbench_histogram_t
+ * @brief 对数分桶的延迟直方图（HDR 风格）。
+ * @note
+ * 数值按最高有效位分段，每段再线性分为 64 个子桶，
+ * 因此任意数值的记录误差不超过其自身的 1/64 。
+ */
+class xbench_histogram_t
+{
+    enum { XSUB_BITS = 6, XSUB_COUNT = 1 << XSUB_BITS, XSEG_COUNT = 64 - XSUB_BITS + 1 };
+
+    static size_t index_of(uint64_t xu64_value)
+    {
+        if (xu64_value < XSUB_COUNT)
+            return (size_t)xu64_value;
+
+        size_t xst_msb = 63 - (size_t)__builtin_clzll(xu64_value);
+        size_t xst_seg = xst_msb - XSUB_BITS + 1;
+        return xst_seg * XSUB_COUNT + (size_t)((xu64_value >> (xst_seg - 1)) & (XSUB_COUNT - 1));
+    }
+
+    /** 返回桶所覆盖区间的上界（桶内数值均不大于该值） */
+    static uint64_t value_of(size_t xst_index)
+    {
+        size_t xst_seg = xst_index / XSUB_COUNT;
+        size_t xst_sub = xst_index % XSUB_COUNT;
+        if (0 == xst_seg)
+            return (uint64_t)xst_sub;
+        return (((uint64_t)(XSUB_COUNT | xst_sub) + 1) << (xst_seg - 1)) - 1;
+    }
+
+public:
+    xbench_histogram_t(void)
+        : m_xvec_bucket(XSEG_COUNT * XSUB_COUNT, 0)
+        , m_xu64_count(0)
+        , m_xu64_sum(0)
+        , m_xu64_max(0)
+    {
+
+    }
+
+    void record(uint64_t xu64_value)
+    {
+        m_xvec_bucket[index_of(xu64_value)] += 1;
+        m_xu64_count += 1;
+        m_xu64_sum   += xu64_value;
+        if (xu64_value > m_xu64_max)
+            m_xu64_max = xu64_value;
+    }
+
+    void merge(const xbench_histogram_t & xhist)
+    {
+        for (size_t xst_iter = 0; xst_iter < m_xvec_bucket.size(); ++xst_iter)
+            m_xvec_bucket[xst_iter] += xhist.m_xvec_bucket[xst_iter];
+        m_xu64_count += xhist.m_xu64_count;
+        m_xu64_sum   += xhist.m_xu64_sum;
+        m_xu64_max    = std::max(m_xu64_max, xhist.m_xu64_max);
+    }
+
+    /** 返回 xdbl_percent（0 ~ 100）分位的数值 */
+    uint64_t percentile(double xdbl_percent) const
+    {
+        if (0 == m_xu64_count)
+            return 0;
+
+        uint64_t xu64_rank = (uint64_t)ceil(xdbl_percent / 100.0 * (double)m_xu64_count);
+        if (xu64_rank < 1)
+            xu64_rank = 1;
+
+        uint64_t xu64_seen = 0;
+        for (size_t xst_iter = 0; xst_iter < m_xvec_bucket.size(); ++xst_iter)
+        {
+            xu64_seen += m_xvec_bucket[xst_iter];
+            if (xu64_seen >= xu64_rank)
+                return std::min(value_of(xst_iter), m_xu64_max);
+        }
+
+        return m_xu64_max;
+    }
+
+    uint64_t count(void) const { return m_xu64_count; }
+    uint64_t sum  (void) const { return m_xu64_sum;   }
+    uint64_t max  (void) const { return m_xu64_max;   }
+    double   mean (void) const
+    {
+        return (m_xu64_count > 0) ? ((double)m_xu64_sum / (double)m_xu64_count) : 0.0;
+    }
+
+private:
+    std::vector< uint64_t > m_xvec_bucket;
+    uint64_t                m_xu64_count;
+    uint64_t                m_xu64_sum;
+    uint64_t                m_xu64_max;
+};
+
+/**
+ * @class xbench_report_t
+ * @brief 测试结果的输出（text/csv/json）。
+ */
+class xbench_report_t
+{
+public:
+    xbench_report_t(const std::string & xstr_format, bool xbt_latency)
+        : m_xstr_format(xstr_format)
+        , m_xbt_first(true)
+    {
+        if (m_xstr_format == "json")
+            printf("[\n");
+        else if (xbt_latency && (m_xstr_format == "csv"))
+            printf("impl,key,dist,n,op,count,mean,p50,p99,p999,max\n");
+        else if (xbt_latency)
+            printf("%-17s %-7s %-8s %9s %-12s %10s %9s %9s %9s %9s %11s\n",
+                   "impl", "key", "dist", "n", "op", "count",
+                   "mean", "p50", "p99", "p99.9", "max(ns)");
+        else if (m_xstr_format == "csv")
+            printf("impl,key,dist,n,mix,op,ops,total_ns,value\n");
+        else
+            printf("%-17s %-7s %-8s %9s %4s %-12s %10s %12s\n",
+                   "impl", "key", "dist", "n", "mix", "op", "ops", "ns/op|B/key");
+    }
+
+    ~xbench_report_t(void)
+    {
+        if (m_xstr_format == "json")
+            printf("\n]\n");
+    }
+
+    void emit(const xbench_record_t & xrecord)
+    {
+        if (m_xstr_format == "csv")
+        {
+            printf("%s,%s,%s,%zu,%d,%s,%zu,%lld,%.3f\n",
+                   xrecord.xstr_impl.c_str(), xrecord.xstr_key.c_str(),
+                   xrecord.xstr_dist.c_str(), xrecord.xst_count, xrecord.xit_mix,
+                   xrecord.xstr_op.c_str(), xrecord.xst_ops,
+                   (long long)xrecord.xit_total_ns, xrecord.xdbl_value);
+        }
+        else if (m_xstr_format == "json")
+        {
+            printf("%s  {\"impl\":\"%s\",\"key\":\"%s\",\"dist\":\"%s\",\"n\":%zu,"
+                   "\"mix\":%d,\"op\":\"%s\",\"ops\":%zu,\"total_ns\":%lld,\"value\":%.3f}",
+                   m_xbt_first ? "" : ",\n",
+                   xrecord.xstr_impl.c_str(), xrecord.xstr_key.c_str(),
+                   xrecord.xstr_dist.c_str(), xrecord.xst_count, xrecord.xit_mix,
+                   xrecord.xstr_op.c_str(), xrecord.xst_ops,
+                   (long long)xrecord.xit_total_ns, xrecord.xdbl_value);
+        }
+        else
+        {
+            printf("%-17s %-7s %-8s %9zu %4d %-12s %10zu %12.2f\n",
+                   xrecord.xstr_impl.c_str(), xrecord.xstr_key.c_str(),
+                   xrecord.xstr_dist.c_str(), xrecord.xst_count, xrecord.xit_mix,
+                   xrecord.xstr_op.c_str(), xrecord.xst_ops, xrecord.xdbl_value);
+        }
+
+        m_xbt_first = false;
+        fflush(stdout);
+    }
+
+    /** 输出延迟直方图的统计结果（record 中只使用 impl/key/dist/n/op 字段） */
+    void emit_latency(const xbench_record_t & xrecord, const xbench_histogram_t & xhist)
+    {
+        unsigned long long xu64_p50  = xhist.percentile(50.0);
+        unsigned long long xu64_p99  = xhist.percentile(99.0);
+        unsigned long long xu64_p999 = xhist.percentile(99.9);
+        unsigned long long xu64_max  = xhist.max();
+
+        if (m_xstr_format == "csv")
+        {
+            printf("%s,%s,%s,%zu,%s,%llu,%.1f,%llu,%llu,%llu,%llu\n",
+                   xrecord.xstr_impl.c_str(), xrecord.xstr_key.c_str(),
+                   xrecord.xstr_dist.c_str(), xrecord.xst_count, xrecord.xstr_op.c_str(),
+                   (unsigned long long)xhist.count(), xhist.mean(),
+                   xu64_p50, xu64_p99, xu64_p999, xu64_max);
+        }
+        else if (m_xstr_format == "json")
+        {
+            printf("%s  {\"impl\":\"%s\",\"key\":\"%s\",\"dist\":\"%s\",\"n\":%zu,"
+                   "\"op\":\"%s\",\"count\":%llu,\"mean\":%.1f,\"p50\":%llu,"
+                   "\"p99\":%llu,\"p999\":%llu,\"max\":%llu}",
+                   m_xbt_first ? "" : ",\n",
+                   xrecord.xstr_impl.c_str(), xrecord.xstr_key.c_str(),
+                   xrecord.xstr_dist.c_str(), xrecord.xst_count, xrecord.xstr_op.c_str(),
+                   (unsigned long long)xhist.count(), xhist.mean(),
+                   xu64_p50, xu64_p99, xu64_p999, xu64_max);
+        }
+        else
+        {
+            printf("%-17s %-7s %-8s %9zu %-12s %10llu %9.1f %9llu %9llu %9llu %11llu\n",
+                   xrecord.xstr_impl.c_str(), xrecord.xstr_key.c_str(),
+                   xrecord.xstr_dist.c_str(), xrecord.xst_count, xrecord.xstr_op.c_str(),
+                   (unsigned long long)xhist.count(), xhist.mean(),
+                   xu64_p50, xu64_p99, xu64_p999, xu64_max);
+        }
+
+        m_xbt_first = false;
+        fflush(stdout);
+    }
+
+private:
+    std::string m_xstr_format;
+    bool        m_xbt_first;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// 内存统计
+
+/** 防止被测操作的结果被编译器优化掉 */
+static volatile size_t g_xbench_sink = 0;
+
+/** 节点分配的字节数（xrbtree 的 memalloc 回调，以及 std 容器的计数分配器）*/
+static long long g_xalloc_bytes = 0;
+
+/**********************************************************/
+/**
+ * @brief 返回进程当前的 RSS 字节数。
+ */
+static long long xbench_rss_bytes(void)
+{
+    long long xll_pages = 0;
+    long long xll_rss   = 0;
+    FILE * xfile = fopen("/proc/self/statm", "r");
+    if (NULL == xfile)
+        return 0;
+    if (2 != fscanf(xfile, "%lld %lld", &xll_pages, &xll_rss))
+        xll_rss = 0;
+    fclose(xfile);
+    return xll_rss * (long long)sysconf(_SC_PAGESIZE);
+}
+
+static xrbt_void_t * xbench_memalloc(xrbt_vkey_t xrbt_vkey,
+                                     xrbt_size_t xst_nsize,
+                                     xrbt_ctxt_t xrbt_ctxt)
+{
+    g_xalloc_bytes += xst_nsize;
+    return malloc(xst_nsize);
+}
+
+static xrbt_void_t xbench_memfree(x_rbnode_iter xiter_node,
+                                  xrbt_size_t xst_nsize,
+                                  xrbt_ctxt_t xrbt_ctxt)
+{
+    g_xalloc_bytes -= xst_nsize;
+    free(xiter_node);
+}
+
+/**
+ * @class xbench_allocator_t
+ * @brief 对 std 容器节点分配字节数进行计数的分配器。
+ */
+template< class _Ty >
+struct xbench_allocator_t
+{
+    typedef _Ty value_type;
+
+    xbench_allocator_t(void) { }
+    template< class _Uy >
+    xbench_allocator_t(const xbench_allocator_t< _Uy > &) { }
+
+    _Ty * allocate(size_t xst_count)
+    {
+        g_xalloc_bytes += (long long)(xst_count * sizeof(_Ty));
+        return (_Ty *)malloc(xst_count * sizeof(_Ty));
+    }
+
+    void deallocate(_Ty * xptr, size_t xst_count)
+    {
+        g_xalloc_bytes -= (long long)(xst_count * sizeof(_Ty));
+        free(xptr);
+    }
+};
+
+template< class _Ty, class _Uy >
+inline bool operator == (const xbench_allocator_t< _Ty > &, const xbench_allocator_t< _Uy > &)
+{ return true; }
+template< class _Ty, class _Uy >
+inline bool operator != (const xbench_allocator_t< _Ty > &, const xbench_allocator_t< _Uy > &)
+{ return false; }
+
+////////////////////////////////////////////////////////////////////////////////
+// 硬件性能计数器
+
+/**
+ * @class xbench_perf_t
+ * @brief 基于 perf_event_open 的硬件计数器（只统计用户态，当前线程）。
+ * @note
+ * 各计数器独立打开，某个事件不被支持时只跳过该事件；
+ * 全部不可用（或非 Linux 平台）时 available() 返回 false 。
+ */
+class xbench_perf_t
+{
+public:
+    enum { XPERF_COUNT = 7 };
+
+    xbench_perf_t(void)
+    {
+        for (int xit_iter = 0; xit_iter < XPERF_COUNT; ++xit_iter)
+        {
+            m_xit_fd[xit_iter]     = -1;
+            m_xu64_value[xit_iter] = 0;
+        }
+    }
+
+    ~xbench_perf_t(void)
+    {
+        for (int xit_iter = 0; xit_iter < XPERF_COUNT; ++xit_iter)
+        {
+            if (m_xit_fd[xit_iter] >= 0)
+                close(m_xit_fd[xit_iter]);
+        }
+    }
+
+    static const char * name(int xit_index)
+    {
+        static const char * xszt_name[XPERF_COUNT] =
+        {
+            "cycles", "instructions", "branch_miss",
+            "l1d_miss", "llc_miss", "dtlb_miss", "llc_ref"
+        };
+        return xszt_name[xit_index];
+    }
+
+    /** 打开所有计数器，返回成功打开的个数 */
+    int open(void)
+    {
+        int xit_opened = 0;
+
+#if defined(__linux__)
+        const uint64_t xu64_read_miss =
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+        const struct { uint32_t xut_type; uint64_t xu64_config; } xevent[XPERF_COUNT] =
+        {
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES                  },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS                },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES               },
+            { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D  | xu64_read_miss },
+            { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL   | xu64_read_miss },
+            { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | xu64_read_miss },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES            },
+        };
+
+        for (int xit_iter = 0; xit_iter < XPERF_COUNT; ++xit_iter)
+        {
+            struct perf_event_attr xattr;
+            memset(&xattr, 0, sizeof(xattr));
+            xattr.size           = sizeof(xattr);
+            xattr.type           = xevent[xit_iter].xut_type;
+            xattr.config         = xevent[xit_iter].xu64_config;
+            xattr.disabled       = 1;
+            xattr.exclude_kernel = 1;
+            xattr.exclude_hv     = 1;
+
+            m_xit_fd[xit_iter] = (int)syscall(SYS_perf_event_open, &xattr, 0, -1, -1, 0);
+            if (m_xit_fd[xit_iter] >= 0)
+                xit_opened += 1;
+        }
+#endif // defined(__linux__)
+
+        return xit_opened;
+    }
+
+    bool available(void) const
+    {
+        for (int xit_iter = 0; xit_iter < XPERF_COUNT; ++xit_iter)
+        {
+            if (m_xit_fd[xit_iter] >= 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool valid(int xit_index) const { return (m_xit_fd[xit_index] >= 0); }
+
+    void start(void)
+    {
+#if defined(__linux__)
+        for (int xit_iter = 0; xit_iter < XPERF_COUNT; ++xit_iter)
+        {
+            if (m_xit_fd[xit_iter] < 0)
+                continue;
+            ioctl(m_xit_fd[xit_iter], PERF_EVENT_IOC_RESET , 0);
+            ioctl(m_xit_fd[xit_iter], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif // defined(__linux__)
+    }
+
+    void stop(void)
+    {
+#if defined(__linux__)
+        for (int xit_iter = 0; xit_iter < XPERF_COUNT; ++xit_iter)
+        {
+            if (m_xit_fd[xit_iter] < 0)
+                continue;
+            ioctl(m_xit_fd[xit_iter], PERF_EVENT_IOC_DISABLE, 0);
+
+            uint64_t xu64_count = 0;
+            if (sizeof(xu64_count) != read(m_xit_fd[xit_iter], &xu64_count, sizeof(xu64_count)))
+                xu64_count = 0;
+            m_xu64_value[xit_iter] = xu64_count;
+        }
+#endif // defined(__linux__)
+    }
+
+    /** 最近一次 start() ~ stop() 之间的计数值 */
+    uint64_t value(int xit_index) const { return m_xu64_value[xit_index]; }
+
+private:
+    int      m_xit_fd[XPERF_COUNT];
+    uint64_t m_xu64_value[XPERF_COUNT];
+};
+
+/** --perf 打开的计数器（不可用时为 NULL） */
+static xbench_perf_t * g_xbench_perf = NULL;
+
+////////////////////////////////////////////////////////////////////////////////
+// 后台噪声（缓存污染）
+
+/**
+ * @class xbench_noise_t
+ * @brief 启动若干后台线程，按缓存行步长持续读写大块缓冲区，以污染 CPU 缓存。
+ */
+class xbench_noise_t
+{
+public:
+    xbench_noise_t(size_t xst_threads, size_t xst_mbytes)
+        : m_xbt_stop(false)
+    {
+        for (size_t xst_iter = 0; xst_iter < xst_threads; ++xst_iter)
+        {
+            m_xvec_thread.push_back(std::thread(&xbench_noise_t::pollute,
+                                                this,
+                                                xst_mbytes * 1024 * 1024));
+        }
+    }
+
+    ~xbench_noise_t(void)
+    {
+        m_xbt_stop.store(true);
+        for (std::thread & xthread : m_xvec_thread)
+            xthread.join();
+    }
+
+private:
+    void pollute(size_t xst_bytes)
+    {
+        std::vector< unsigned char > xvec_buffer(std::max< size_t >(xst_bytes, 64), 1);
+        size_t xst_sum = 0;
+        while (!m_xbt_stop.load(std::memory_order_relaxed))
+        {
+            for (size_t xst_iter = 0; xst_iter < xvec_buffer.size(); xst_iter += 64)
+            {
+                xst_sum += xvec_buffer[xst_iter];
+                xvec_buffer[xst_iter] = (unsigned char)xst_sum;
+            }
+        }
+        g_xbench_sink = g_xbench_sink + xst_sum;
+    }
+
+private:
+    std::atomic< bool >        m_xbt_stop;
+    std::vector< std::thread > m_xvec_thread;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// 索引键的生成
+
+/**********************************************************/
+/**
+ * @brief 由 键编号 生成索引键（键编号的大小顺序 与 索引键的大小顺序 一致）。
+ */
+template< class _Kty >
+struct xbench_keygen_t;
+
+template< >
+struct xbench_keygen_t< uint32_t >
+{
+    static uint32_t make(uint64_t xu64_id, size_t) { return (uint32_t)xu64_id; }
+};
+
+template< >
+struct xbench_keygen_t< uint64_t >
+{
+    static uint64_t make(uint64_t xu64_id, size_t) { return xu64_id; }
+};
+
+template< >
+struct xbench_keygen_t< std::string >
+{
+    static std::string make(uint64_t xu64_id, size_t xst_len)
+    {
+        char xszt_id[32];
+        snprintf(xszt_id, sizeof(xszt_id), "%016llx", (unsigned long long)xu64_id);
+        std::string xstr_key(xszt_id);
+        xstr_key.resize(std::max(xst_len, xstr_key.size()), '.');
+        return xstr_key;
+    }
+};
+
+/**********************************************************/
+/**
+ * @brief 生成测试所用的键编号序列。
+ * @note
+ * 命中的键编号均为偶数，未命中的键编号均为奇数；
+ * zipf 分布的插入序列包含重复的键编号（按 s = 0.99 的 Zipf 分布抽取）。
+ *
+ * @param [in ] xstr_dist : 分布类型（seq/reverse/random/zipf/cluster）。
+ * @param [in ] xst_count : 插入序列的长度。
+ * @param [in ] xu64_seed : 随机数种子。
+ */
+static std::vector< uint64_t > xbench_make_ids(const std::string & xstr_dist,
+                                               size_t xst_count,
+                                               uint64_t xu64_seed)
+{
+    std::mt19937_64 xrng(xu64_seed);
+    std::vector< uint64_t > xvec_ids(xst_count);
+
+    for (size_t xst_iter = 0; xst_iter < xst_count; ++xst_iter)
+        xvec_ids[xst_iter] = 2 * (uint64_t)xst_iter;
+
+    if (xstr_dist == "reverse")
+    {
+        std::reverse(xvec_ids.begin(), xvec_ids.end());
+    }
+    else if (xstr_dist == "random")
+    {
+        std::shuffle(xvec_ids.begin(), xvec_ids.end(), xrng);
+    }
+    else if (xstr_dist == "zipf")
+    {
+        std::vector< uint64_t > xvec_rank(xvec_ids);
+        std::shuffle(xvec_rank.begin(), xvec_rank.end(), xrng);
+
+        std::vector< double > xvec_cdf(xst_count);
+        double xdbl_sum = 0.0;
+        for (size_t xst_iter = 0; xst_iter < xst_count; ++xst_iter)
+        {
+            xdbl_sum += 1.0 / pow((double)(xst_iter + 1), 0.99);
+            xvec_cdf[xst_iter] = xdbl_sum;
+        }
+
+        std::uniform_real_distribution< double > xdist(0.0, xdbl_sum);
+        for (size_t xst_iter = 0; xst_iter < xst_count; ++xst_iter)
+        {
+            size_t xst_rank = std::lower_bound(xvec_cdf.begin(), xvec_cdf.end(), xdist(xrng))
+                            - xvec_cdf.begin();
+            xvec_ids[xst_iter] = xvec_rank[std::min(xst_rank, xst_count - 1)];
+        }
+    }
+    else if (xstr_dist == "cluster")
+    {
+        // 以 256 个连续键编号为一簇，簇的顺序随机，簇内顺序插入
+        const size_t xst_csize = 256;
+        std::vector< size_t > xvec_cluster((xst_count + xst_csize - 1) / xst_csize);
+        for (size_t xst_iter = 0; xst_iter < xvec_cluster.size(); ++xst_iter)
+            xvec_cluster[xst_iter] = xst_iter;
+        std::shuffle(xvec_cluster.begin(), xvec_cluster.end(), xrng);
+
+        size_t xst_pos = 0;
+        for (size_t xst_cluster : xvec_cluster)
+        {
+            for (size_t xst_iter = xst_cluster * xst_csize;
+                 (xst_iter < (xst_cluster + 1) * xst_csize) && (xst_iter < xst_count);
+                 ++xst_iter)
+            {
+                xvec_ids[xst_pos++] = 2 * (uint64_t)xst_iter;
+            }
+        }
+    }
+
+    return xvec_ids;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 被测容器的适配器（统一接口：insert/erase/find/lower_bound/scan/range/clear）
+
+/**
+ * @class xbench_xrbtree_t
+ * @brief xrbtree 的适配器（xstr_mode : set/kv/multi/prefix/borrow）。
+ */
+template< class _Kty >
+class xbench_xrbtree_t
+{
+public:
+    xbench_xrbtree_t(const std::string & xstr_mode)
+    {
+        xrbt_callback_t xcallback = xrbtree_default_callback< _Kty >();
+        xcallback.xfunc_n_memalloc = &xbench_memalloc;
+        xcallback.xfunc_n_memfree  = &xbench_memfree;
+
+        xrbt_uint32_t xut_flags = 0;
+        xrbt_size_t   xst_vsize = 0;
+        if (xstr_mode == "multi" ) xut_flags |= XRBT_FLAG_MULTI;
+        if (xstr_mode == "borrow") xut_flags |= XRBT_FLAG_BORROW;
+        if (xstr_mode == "kv"    ) xst_vsize  = sizeof(uint64_t);
+
+        m_xtree_ptr = xrbtree_create_ex(sizeof(_Kty), xst_vsize, xut_flags, &xcallback, XRBT_NULL);
+
+        if (xstr_mode == "prefix")
+        {
+            xrbtree_set_key_hints(m_xtree_ptr,
+                                  &xrbtree_vkey_prefix_string< std::string >,
+                                  XRBT_NULL);
+        }
+    }
+
+    ~xbench_xrbtree_t(void)
+    {
+        xrbtree_destroy(m_xtree_ptr);
+    }
+
+    /** 借用模式下，xkey 必须在容器生命周期内保持有效 */
+    bool insert(const _Kty & xkey)
+    {
+        xrbt_bool_t xbt_ok = XRBT_FALSE;
+        uint64_t    xu64_v = 0;
+        xrbtree_try_emplace(m_xtree_ptr, (xrbt_vkey_t)&xkey, &xu64_v, &xbt_ok);
+        return (XRBT_FALSE != xbt_ok);
+    }
+
+    bool erase(const _Kty & xkey)
+    {
+        return (XRBT_FALSE != xrbtree_erase_vkey(m_xtree_ptr, (xrbt_vkey_t)&xkey));
+    }
+
+    bool find(const _Kty & xkey)
+    {
+        return (xrbtree_find(m_xtree_ptr, (xrbt_vkey_t)&xkey) != xrbtree_end(m_xtree_ptr));
+    }
+
+    bool lower_bound(const _Kty & xkey)
+    {
+        return (xrbtree_lower_bound(m_xtree_ptr, (xrbt_vkey_t)&xkey) != xrbtree_end(m_xtree_ptr));
+    }
+
+    size_t range(const _Kty & xkey, size_t xst_limit)
+    {
+        size_t        xst_count = 0;
+        x_rbnode_iter xiter_end = xrbtree_end(m_xtree_ptr);
+        for (x_rbnode_iter xiter = xrbtree_lower_bound(m_xtree_ptr, (xrbt_vkey_t)&xkey);
+             (xiter != xiter_end) && (xst_count < xst_limit);
+             xiter = xrbtree_next(xiter))
+        {
+            xst_count += 1;
+        }
+        return xst_count;
+    }
+
+    size_t scan(void)
+    {
+        size_t        xst_count = 0;
+        x_rbnode_iter xiter_end = xrbtree_end(m_xtree_ptr);
+        for (x_rbnode_iter xiter = xrbtree_begin(m_xtree_ptr);
+             xiter != xiter_end;
+             xiter = xrbtree_next(xiter))
+        {
+            xst_count += (0 != xrbtree_iter_vkey(xiter));
+        }
+        return xst_count;
+    }
+
+    bool begin (void) { return (xrbtree_begin (m_xtree_ptr) != xrbtree_end (m_xtree_ptr)); }
+    bool rbegin(void) { return (xrbtree_rbegin(m_xtree_ptr) != xrbtree_rend(m_xtree_ptr)); }
+
+    bool erase_min(void)
+    {
+        if (xrbtree_empty(m_xtree_ptr))
+            return false;
+        xrbtree_erase(m_xtree_ptr, xrbtree_begin(m_xtree_ptr));
+        return true;
+    }
+
+    bool erase_max(void)
+    {
+        if (xrbtree_empty(m_xtree_ptr))
+            return false;
+        xrbtree_erase(m_xtree_ptr, xrbtree_rbegin(m_xtree_ptr));
+        return true;
+    }
+
+    void   clear(void) { xrbtree_clear(m_xtree_ptr); }
+    size_t size (void) { return xrbtree_size(m_xtree_ptr); }
+
+private:
+    x_rbtree_ptr m_xtree_ptr;
+};
+
+/**
+ * @class xbench_intrusive_t
+ * @brief xrbtree 侵入模式的适配器。
+ * @note
+ * 模拟调用方已持有对象（如连接表中的连接对象）的场景：对象从对象池中取出，
+ * 插入操作只写入索引键并停靠其链接头，红黑树不再申请节点、不再拷贝索引键；
+ * 对象池的内存经 xbench_allocator_t 计数，以便与其他 impl 比较内存占用。
+ */
+template< class _Kty >
+class xbench_intrusive_t
+{
+    struct x_object_t
+    {
+        x_rbtree_link_t xlink;
+        _Kty            xkey;
+    };
+
+public:
+    xbench_intrusive_t(const std::string & xstr_mode)
+    {
+        m_xtree_ptr = xrbtree_create_intrusive_k< _Kty >(
+                            XRBT_LINK_KOFFSET(x_object_t, xlink, xkey));
+    }
+
+    ~xbench_intrusive_t(void)
+    {
+        xrbtree_destroy(m_xtree_ptr);
+    }
+
+    bool insert(const _Kty & xkey)
+    {
+        x_object_t * xobj_ptr = alloc();
+        xobj_ptr->xkey = xkey;
+        if (xrbtree_dock(m_xtree_ptr, XRBT_LINK_ITER(&xobj_ptr->xlink)) !=
+            XRBT_LINK_ITER(&xobj_ptr->xlink))
+        {
+            m_xvec_free.push_back(xobj_ptr);
+            return false;
+        }
+        return true;
+    }
+
+    bool erase(const _Kty & xkey)
+    {
+        x_rbnode_iter xiter = xrbtree_find(m_xtree_ptr, (xrbt_vkey_t)&xkey);
+        if (xiter == xrbtree_end(m_xtree_ptr))
+            return false;
+        xrbtree_undock(m_xtree_ptr, xiter);
+        m_xvec_free.push_back(XRBT_CONTAINER_OF(xiter, x_object_t, xlink));
+        return true;
+    }
+
+    bool find(const _Kty & xkey)
+    {
+        return (xrbtree_find(m_xtree_ptr, (xrbt_vkey_t)&xkey) != xrbtree_end(m_xtree_ptr));
+    }
+
+    bool lower_bound(const _Kty & xkey)
+    {
+        return (xrbtree_lower_bound(m_xtree_ptr, (xrbt_vkey_t)&xkey) != xrbtree_end(m_xtree_ptr));
+    }
+
+    size_t range(const _Kty & xkey, size_t xst_limit)
+    {
+        size_t        xst_count = 0;
+        x_rbnode_iter xiter_end = xrbtree_end(m_xtree_ptr);
+        for (x_rbnode_iter xiter = xrbtree_lower_bound(m_xtree_ptr, (xrbt_vkey_t)&xkey);
+             (xiter != xiter_end) && (xst_count < xst_limit);
+             xiter = xrbtree_next(xiter))
+        {
+            xst_count += 1;
+        }
+        return xst_count;
+    }
+
+    size_t scan(void)
+    {
+        size_t        xst_count = 0;
+        x_rbnode_iter xiter_end = xrbtree_end(m_xtree_ptr);
+        for (x_rbnode_iter xiter = xrbtree_begin(m_xtree_ptr);
+             xiter != xiter_end;
+             xiter = xrbtree_next(xiter))
+        {
+            xst_count += (0 != xrbtree_iter_vkey(xiter));
+        }
+        return xst_count;
+    }
+
+    bool begin (void) { return (xrbtree_begin (m_xtree_ptr) != xrbtree_end (m_xtree_ptr)); }
+    bool rbegin(void) { return (xrbtree_rbegin(m_xtree_ptr) != xrbtree_rend(m_xtree_ptr)); }
+
+    bool erase_min(void)
+    {
+        x_rbnode_iter xiter = xrbtree_pop_min(m_xtree_ptr);
+        if (XRBT_NULL == xiter)
+            return false;
+        m_xvec_free.push_back(XRBT_CONTAINER_OF(xiter, x_object_t, xlink));
+        return true;
+    }
+
+    bool erase_max(void)
+    {
+        x_rbnode_iter xiter = xrbtree_pop_max(m_xtree_ptr);
+        if (XRBT_NULL == xiter)
+            return false;
+        m_xvec_free.push_back(XRBT_CONTAINER_OF(xiter, x_object_t, xlink));
+        return true;
+    }
+
+    void clear(void)
+    {
+        xrbtree_clear(m_xtree_ptr);
+        m_xvec_free.clear();
+        m_xdeq_pool.clear();
+    }
+
+    size_t size(void) { return xrbtree_size(m_xtree_ptr); }
+
+private:
+    x_object_t * alloc(void)
+    {
+        if (!m_xvec_free.empty())
+        {
+            x_object_t * xobj_ptr = m_xvec_free.back();
+            m_xvec_free.pop_back();
+            return xobj_ptr;
+        }
+
+        m_xdeq_pool.push_back(x_object_t());
+        return &m_xdeq_pool.back();
+    }
+
+private:
+    x_rbtree_ptr                                                 m_xtree_ptr;
+    std::deque< x_object_t, xbench_allocator_t< x_object_t > >  m_xdeq_pool;
+    std::vector< x_object_t * >                                  m_xvec_free;
+};
+
+/**
+ * @class xbench_stdset_t
+ * @brief std::set / std::map 的适配器（_Tset/_Tmap 替换为 xrbtree_set/xrbtree_map 时，
+ *        以完全相同的代码测试 xrbtree_stl.h 的容器）。
+ */
+template< class _Kty, bool _IsMap,
+          template< class, class, class > class _Tset = std::set,
+          template< class, class, class, class > class _Tmap = std::map >
+class xbench_stdset_t
+{
+    typedef typename std::conditional< _IsMap,
+        _Tmap< _Kty, uint64_t, std::less< _Kty >,
+              xbench_allocator_t< std::pair< const _Kty, uint64_t > > >,
+        _Tset< _Kty, std::less< _Kty >, xbench_allocator_t< _Kty > >
+    >::type x_container_t;
+
+    template< bool _Map >
+    typename std::enable_if< _Map, bool >::type do_insert(const _Kty & xkey)
+    { return m_xcontainer.emplace(xkey, 0).second; }
+
+    template< bool _Map >
+    typename std::enable_if< !_Map, bool >::type do_insert(const _Kty & xkey)
+    { return m_xcontainer.insert(xkey).second; }
+
+public:
+    xbench_stdset_t(const std::string &) { }
+
+    bool   insert(const _Kty & xkey) { return do_insert< _IsMap >(xkey); }
+    bool   erase (const _Kty & xkey) { return (m_xcontainer.erase(xkey) > 0); }
+    bool   find  (const _Kty & xkey) { return (m_xcontainer.find(xkey) != m_xcontainer.end()); }
+    bool   lower_bound(const _Kty & xkey)
+    { return (m_xcontainer.lower_bound(xkey) != m_xcontainer.end()); }
+
+    size_t range(const _Kty & xkey, size_t xst_limit)
+    {
+        size_t xst_count = 0;
+        for (typename x_container_t::iterator xiter = m_xcontainer.lower_bound(xkey);
+             (xiter != m_xcontainer.end()) && (xst_count < xst_limit);
+             ++xiter)
+        {
+            xst_count += 1;
+        }
+        return xst_count;
+    }
+
+    size_t scan(void)
+    {
+        size_t xst_count = 0;
+        for (typename x_container_t::iterator xiter = m_xcontainer.begin();
+             xiter != m_xcontainer.end();
+             ++xiter)
+        {
+            xst_count += (&*xiter != NULL);
+        }
+        return xst_count;
+    }
+
+    bool begin (void) { return (m_xcontainer.begin () != m_xcontainer.end ()); }
+    bool rbegin(void) { return (m_xcontainer.rbegin() != m_xcontainer.rend()); }
+
+    bool erase_min(void)
+    {
+        if (m_xcontainer.empty())
+            return false;
+        m_xcontainer.erase(m_xcontainer.begin());
+        return true;
+    }
+
+    bool erase_max(void)
+    {
+        if (m_xcontainer.empty())
+            return false;
+        m_xcontainer.erase(std::prev(m_xcontainer.end()));
+        return true;
+    }
+
+    void   clear(void) { m_xcontainer.clear(); }
+    size_t size (void) { return m_xcontainer.size(); }
+
+private:
+    x_container_t m_xcontainer;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// 测试流程
+
+/**
+ * @class xbench_runner_t
+ * @brief 对单个 (impl, key, dist) 组合执行全部测试操作。
+ */
+template< class _Kty, class _Impl >
+class xbench_runner_t
+{
+public:
+    xbench_runner_t(const xbench_conf_t & xconf,
+                    xbench_report_t & xreport,
+                    const std::string & xstr_impl,
+                    const std::string & xstr_mode,
+                    const std::string & xstr_key,
+                    size_t xst_klen,
+                    const std::string & xstr_dist)
+        : m_xconf(xconf)
+        , m_xreport(xreport)
+        , m_xstr_impl(xstr_impl)
+        , m_xstr_mode(xstr_mode)
+        , m_xstr_key(xstr_key)
+        , m_xstr_dist(xstr_dist)
+    {
+        std::vector< uint64_t > xvec_ids =
+            xbench_make_ids(xstr_dist, xconf.xst_count, xconf.xu64_seed);
+
+        m_xvec_insert.reserve(xvec_ids.size());
+        for (uint64_t xu64_id : xvec_ids)
+            m_xvec_insert.push_back(xbench_keygen_t< _Kty >::make(xu64_id, xst_klen));
+
+        // 查找序列：命中键 与 未命中键，均不重复且为随机顺序
+        std::mt19937_64 xrng(xconf.xu64_seed + 1);
+        std::vector< uint64_t > xvec_hit(xvec_ids);
+        std::sort(xvec_hit.begin(), xvec_hit.end());
+        xvec_hit.erase(std::unique(xvec_hit.begin(), xvec_hit.end()), xvec_hit.end());
+        std::shuffle(xvec_hit.begin(), xvec_hit.end(), xrng);
+        for (uint64_t xu64_id : xvec_hit)
+        {
+            m_xvec_hit .push_back(xbench_keygen_t< _Kty >::make(xu64_id, xst_klen));
+            m_xvec_miss.push_back(xbench_keygen_t< _Kty >::make(xu64_id + 1, xst_klen));
+        }
+    }
+
+    void run(void)
+    {
+        if (m_xconf.xstr_mode == "latency")
+        {
+            run_latency();
+            return;
+        }
+
+        for (size_t xst_rep = 0; xst_rep < m_xconf.xst_reps; ++xst_rep)
+        {
+            run_once();
+        }
+    }
+
+protected:
+    template< class _Func >
+    size_t measure(const std::string & xstr_op, int xit_mix, size_t xst_ops, _Func xfunc)
+    {
+        size_t      xst_check = 0;
+        if (NULL != g_xbench_perf)
+            g_xbench_perf->start();
+        xtime_point xtm_begin = xtime_clock::now();
+        xst_check = xfunc();
+        int64_t xit_ns = xtime_nsec(xtime_clock::now() - xtm_begin);
+        if (NULL != g_xbench_perf)
+            g_xbench_perf->stop();
+        g_xbench_sink = g_xbench_sink + xst_check;
+
+        emit(xstr_op, xit_mix, xst_ops, xit_ns,
+             (xst_ops > 0) ? ((double)xit_ns / (double)xst_ops) : 0.0);
+
+        if ((NULL != g_xbench_perf) && (xst_ops > 0))
+        {
+            for (int xit_iter = 0; xit_iter < xbench_perf_t::XPERF_COUNT; ++xit_iter)
+            {
+                if (!g_xbench_perf->valid(xit_iter))
+                    continue;
+                emit(xstr_op + "/" + xbench_perf_t::name(xit_iter), xit_mix, xst_ops, 0,
+                     (double)g_xbench_perf->value(xit_iter) / (double)xst_ops);
+            }
+        }
+
+        return xst_check;
+    }
+
+    void emit(const std::string & xstr_op, int xit_mix, size_t xst_ops,
+              int64_t xit_ns, double xdbl_value)
+    {
+        xbench_record_t xrecord;
+        xrecord.xstr_impl    = m_xstr_impl;
+        xrecord.xstr_key     = m_xstr_key;
+        xrecord.xstr_dist    = m_xstr_dist;
+        xrecord.xst_count    = m_xconf.xst_count;
+        xrecord.xit_mix      = xit_mix;
+        xrecord.xstr_op      = xstr_op;
+        xrecord.xst_ops      = xst_ops;
+        xrecord.xit_total_ns = xit_ns;
+        xrecord.xdbl_value   = xdbl_value;
+        m_xreport.emit(xrecord);
+    }
+
+    /** 单次操作计时，记入直方图 */
+    template< class _Func >
+    void sample(xbench_histogram_t & xhist, _Func xfunc)
+    {
+        xtime_point xtm_begin = xtime_clock::now();
+        size_t xst_check = xfunc();
+        xtime_point xtm_end = xtime_clock::now();
+        xhist.record((uint64_t)xtime_nsec(xtm_end - xtm_begin));
+        g_xbench_sink = g_xbench_sink + xst_check;
+    }
+
+    /** 输出延迟直方图 */
+    void emit_latency(const std::string & xstr_op, const xbench_histogram_t & xhist)
+    {
+        xbench_record_t xrecord;
+        xrecord.xstr_impl    = m_xstr_impl;
+        xrecord.xstr_key     = m_xstr_key;
+        xrecord.xstr_dist    = m_xstr_dist;
+        xrecord.xst_count    = m_xconf.xst_count;
+        xrecord.xit_mix      = -1;
+        xrecord.xstr_op      = xstr_op;
+        xrecord.xst_ops      = (size_t)xhist.count();
+        xrecord.xit_total_ns = (int64_t)xhist.sum();
+        xrecord.xdbl_value   = xhist.mean();
+        m_xreport.emit_latency(xrecord, xhist);
+    }
+
+    /**
+     * 延迟测试：各项操作逐次计时；
+     * erase_min/erase_max 每次都删除当前的最左/最右节点，
+     * clear 每轮只产生一个样本（整棵树的清除耗时）。
+     */
+    void run_latency(void)
+    {
+        xbench_histogram_t xhist_timer;
+        xbench_histogram_t xhist_insert;
+        xbench_histogram_t xhist_find;
+        xbench_histogram_t xhist_erase;
+        xbench_histogram_t xhist_emin;
+        xbench_histogram_t xhist_emax;
+        xbench_histogram_t xhist_clear;
+
+        for (size_t xst_rep = 0; xst_rep < m_xconf.xst_reps; ++xst_rep)
+        {
+            _Impl xcontainer(m_xstr_mode);
+
+            for (size_t xst_iter = 0; xst_iter < m_xvec_hit.size(); ++xst_iter)
+                sample(xhist_timer, [&]() -> size_t { return 0; });
+
+            for (const _Kty & xkey : m_xvec_insert)
+                sample(xhist_insert, [&]() -> size_t { return xcontainer.insert(xkey); });
+
+            for (const _Kty & xkey : m_xvec_hit)
+                sample(xhist_find, [&]() -> size_t { return xcontainer.find(xkey); });
+
+            // 随机删除一半，再补回
+            const size_t xst_half = m_xvec_hit.size() / 2;
+            for (size_t xst_iter = 0; xst_iter < xst_half; ++xst_iter)
+                sample(xhist_erase, [&]() -> size_t { return xcontainer.erase(m_xvec_hit[xst_iter]); });
+            for (size_t xst_iter = 0; xst_iter < xst_half; ++xst_iter)
+                xcontainer.insert(m_xvec_hit[xst_iter]);
+
+            // 从两端删除：前一半删最左节点，后一半删最右节点
+            const size_t xst_size = xcontainer.size();
+            for (size_t xst_iter = 0; xst_iter < xst_size / 2; ++xst_iter)
+                sample(xhist_emin, [&]() -> size_t { return xcontainer.erase_min(); });
+            while (xcontainer.size() > 0)
+                sample(xhist_emax, [&]() -> size_t { return xcontainer.erase_max(); });
+
+            // 重建后整树清除
+            for (const _Kty & xkey : m_xvec_insert)
+                xcontainer.insert(xkey);
+            sample(xhist_clear, [&]() -> size_t { xcontainer.clear(); return 0; });
+        }
+
+        emit_latency("timer"    , xhist_timer );
+        emit_latency("insert"   , xhist_insert);
+        emit_latency("find"     , xhist_find  );
+        emit_latency("erase"    , xhist_erase );
+        emit_latency("erase_min", xhist_emin  );
+        emit_latency("erase_max", xhist_emax  );
+        emit_latency("clear"    , xhist_clear );
+    }
+
+    void run_once(void)
+    {
+        const size_t xst_nhit  = m_xvec_hit.size();
+        long long    xll_alloc = g_xalloc_bytes;
+        long long    xll_rss   = xbench_rss_bytes();
+
+        _Impl xcontainer(m_xstr_mode);
+
+        //======================================
+
+        measure("insert", -1, m_xvec_insert.size(), [&]() -> size_t
+        {
+            size_t xst_count = 0;
+            for (const _Kty & xkey : m_xvec_insert)
+                xst_count += xcontainer.insert(xkey);
+            return xst_count;
+        });
+
+        const size_t xst_size = xcontainer.size();
+        if (xst_size > 0)
+        {
+            emit("mem_alloc", -1, xst_size, 0,
+                 (double)(g_xalloc_bytes - xll_alloc) / (double)xst_size);
+            emit("mem_rss", -1, xst_size, 0,
+                 (double)(xbench_rss_bytes() - xll_rss) / (double)xst_size);
+        }
+
+        std::vector< const _Kty * > xvec_hit;
+        xvec_hit.reserve(xst_nhit);
+        for (const _Kty & xkey : m_xvec_hit)
+            xvec_hit.push_back(&xkey);
+
+        measure("find_hit", -1, xvec_hit.size(), [&]() -> size_t
+        {
+            size_t xst_count = 0;
+            for (const _Kty * xkey : xvec_hit)
+                xst_count += xcontainer.find(*xkey);
+            return xst_count;
+        });
+
+        measure("find_miss", -1, m_xvec_miss.size(), [&]() -> size_t
+        {
+            size_t xst_count = 0;
+            for (const _Kty & xkey : m_xvec_miss)
+                xst_count += xcontainer.find(xkey);
+            return xst_count;
+        });
+
+        measure("lower_bound", -1, m_xvec_miss.size(), [&]() -> size_t
+        {
+            size_t xst_count = 0;
+            for (const _Kty & xkey : m_xvec_miss)
+                xst_count += xcontainer.lower_bound(xkey);
+            return xst_count;
+        });
+
+        measure("scan", -1, xst_size, [&]() -> size_t
+        {
+            return xcontainer.scan();
+        });
+
+        const size_t xst_nrange = std::min< size_t >(m_xvec_miss.size(), 10000);
+        measure("range_scan", -1, xst_nrange, [&]() -> size_t
+        {
+            size_t xst_count = 0;
+            for (size_t xst_iter = 0; xst_iter < xst_nrange; ++xst_iter)
+                xst_count += xcontainer.range(m_xvec_miss[xst_iter], m_xconf.xst_range);
+            return xst_count;
+        });
+
+        //======================================
+        // 混合读写：读操作为命中查找；写操作交替 插入/删除 未命中键（树的大小保持稳定）
+
+        for (int xit_mix : m_xconf.xvec_mix)
+        {
+            std::mt19937 xrng((unsigned)m_xconf.xu64_seed + xit_mix);
+            const size_t xst_nops = m_xvec_miss.size();
+            std::vector< unsigned char > xvec_read(xst_nops);
+            for (size_t xst_iter = 0; xst_iter < xst_nops; ++xst_iter)
+                xvec_read[xst_iter] = ((int)(xrng() % 100) < xit_mix);
+
+            measure("mixed", xit_mix, xst_nops, [&]() -> size_t
+            {
+                size_t xst_count = 0;
+                size_t xst_write = 0;
+                for (size_t xst_iter = 0; xst_iter < xst_nops; ++xst_iter)
+                {
+                    if (xvec_read[xst_iter] && !xvec_hit.empty())
+                    {
+                        xst_count += xcontainer.find(*xvec_hit[xst_iter % xvec_hit.size()]);
+                    }
+                    else if (0 == (xst_write & 1))
+                    {
+                        xst_count += xcontainer.insert(m_xvec_miss[xst_write / 2]);
+                        xst_write += 1;
+                    }
+                    else
+                    {
+                        xst_count += xcontainer.erase(m_xvec_miss[xst_write / 2]);
+                        xst_write += 1;
+                    }
+                }
+
+                // 删除尚未配对删除的键
+                if (0 != (xst_write & 1))
+                    xcontainer.erase(m_xvec_miss[xst_write / 2]);
+                return xst_count;
+            });
+        }
+
+        //======================================
+
+        const size_t xst_nerase = xvec_hit.size() / 2;
+        measure("erase", -1, xst_nerase, [&]() -> size_t
+        {
+            size_t xst_count = 0;
+            for (size_t xst_iter = 0; xst_iter < xst_nerase; ++xst_iter)
+                xst_count += xcontainer.erase(*xvec_hit[xst_iter]);
+            return xst_count;
+        });
+
+        const size_t xst_nclear = xcontainer.size();
+        measure("clear", -1, xst_nclear, [&]() -> size_t
+        {
+            xcontainer.clear();
+            return 0;
+        });
+    }
+
+private:
+    const xbench_conf_t & m_xconf;
+    xbench_report_t     & m_xreport;
+    std::string           m_xstr_impl;
+    std::string           m_xstr_mode;
+    std::string           m_xstr_key;
+    std::string           m_xstr_dist;
+    std::vector< _Kty >   m_xvec_insert;
+    std::vector< _Kty >   m_xvec_hit;
+    std::vector< _Kty >   m_xvec_miss;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// 定时器队列
+
+/** 定时器触发的计数 */
+static size_t g_xtimer_fired = 0;
+
+/**
+ * @class xbench_timer_xtimerq_t
+ * @brief 定时器队列测试：x_timerq_t 。
+ */
+class xbench_timer_xtimerq_t
+{
+    static void on_expire(x_timerq_ptr, x_timer_ptr, xrbt_ctxt_t)
+    {
+        g_xtimer_fired += 1;
+    }
+
+public:
+    explicit xbench_timer_xtimerq_t(size_t xst_count)
+        : m_xtimerq_ptr(xtimerq_create(XRBT_NULL))
+        , m_xvec_timer(xst_count)
+    {
+        for (size_t xst_iter = 0; xst_iter < xst_count; ++xst_iter)
+            m_xvec_timer[xst_iter] = xtimerq_timer_alloc(m_xtimerq_ptr, &on_expire, XRBT_NULL);
+    }
+
+    ~xbench_timer_xtimerq_t(void)
+    {
+        for (x_timer_ptr xtimer_ptr : m_xvec_timer)
+            xtimerq_timer_free(m_xtimerq_ptr, xtimer_ptr);
+        xtimerq_destroy(m_xtimerq_ptr);
+    }
+
+    bool   armed (size_t xst_index) { return (0 != xtimerq_is_armed(m_xtimerq_ptr, m_xvec_timer[xst_index])); }
+    void   arm   (size_t xst_index, uint64_t xu64_expire)
+    { xtimerq_arm(m_xtimerq_ptr, m_xvec_timer[xst_index], xu64_expire); }
+    void   cancel(size_t xst_index) { xtimerq_cancel(m_xtimerq_ptr, m_xvec_timer[xst_index]); }
+    size_t expire(uint64_t xu64_now) { return xtimerq_expire_until(m_xtimerq_ptr, xu64_now); }
+
+private:
+    x_timerq_ptr               m_xtimerq_ptr;
+    std::vector< x_timer_ptr > m_xvec_timer;
+};
+
+/**
+ * @class xbench_timer_heap_t
+ * @brief 定时器队列测试：带位置索引的二叉堆（到期时间相同的，按启动顺序排列）。
+ */
+class xbench_timer_heap_t
+{
+    bool less(size_t xst_lhs, size_t xst_rhs) const
+    {
+        return (m_xvec_expire[xst_lhs] != m_xvec_expire[xst_rhs]) ?
+               (m_xvec_expire[xst_lhs] <  m_xvec_expire[xst_rhs]) :
+               (m_xvec_seq[xst_lhs]    <  m_xvec_seq[xst_rhs]);
+    }
+
+    void place(size_t xst_hpos, size_t xst_index)
+    {
+        m_xvec_heap[xst_hpos] = xst_index;
+        m_xvec_hpos[xst_index] = xst_hpos;
+    }
+
+    void sift_up(size_t xst_hpos)
+    {
+        size_t xst_index = m_xvec_heap[xst_hpos];
+        while (xst_hpos > 0)
+        {
+            size_t xst_parent = (xst_hpos - 1) / 2;
+            if (!less(xst_index, m_xvec_heap[xst_parent]))
+                break;
+            place(xst_hpos, m_xvec_heap[xst_parent]);
+            xst_hpos = xst_parent;
+        }
+        place(xst_hpos, xst_index);
+    }
+
+    void sift_down(size_t xst_hpos)
+    {
+        size_t xst_index = m_xvec_heap[xst_hpos];
+        size_t xst_size  = m_xvec_heap.size();
+        for (;;)
+        {
+            size_t xst_child = 2 * xst_hpos + 1;
+            if (xst_child >= xst_size)
+                break;
+            if ((xst_child + 1 < xst_size) &&
+                less(m_xvec_heap[xst_child + 1], m_xvec_heap[xst_child]))
+                xst_child += 1;
+            if (!less(m_xvec_heap[xst_child], xst_index))
+                break;
+            place(xst_hpos, m_xvec_heap[xst_child]);
+            xst_hpos = xst_child;
+        }
+        place(xst_hpos, xst_index);
+    }
+
+    void remove_at(size_t xst_hpos)
+    {
+        size_t xst_index = m_xvec_heap[xst_hpos];
+        size_t xst_last  = m_xvec_heap.back();
+        m_xvec_heap.pop_back();
+        m_xvec_hpos[xst_index] = XNPOS;
+        if (xst_hpos < m_xvec_heap.size())
+        {
+            place(xst_hpos, xst_last);
+            sift_down(xst_hpos);
+            sift_up(m_xvec_hpos[xst_last]);
+        }
+    }
+
+    static const size_t XNPOS = (size_t)-1;
+
+public:
+    explicit xbench_timer_heap_t(size_t xst_count)
+        : m_xvec_expire(xst_count, 0)
+        , m_xvec_seq(xst_count, 0)
+        , m_xvec_hpos(xst_count, XNPOS)
+        , m_xu64_seq(0)
+    {
+        m_xvec_heap.reserve(xst_count);
+    }
+
+    bool armed(size_t xst_index) { return (XNPOS != m_xvec_hpos[xst_index]); }
+
+    void arm(size_t xst_index, uint64_t xu64_expire)
+    {
+        if (armed(xst_index))
+            remove_at(m_xvec_hpos[xst_index]);
+        m_xvec_expire[xst_index] = xu64_expire;
+        m_xvec_seq[xst_index]    = m_xu64_seq++;
+        m_xvec_heap.push_back(xst_index);
+        m_xvec_hpos[xst_index] = m_xvec_heap.size() - 1;
+        sift_up(m_xvec_heap.size() - 1);
+    }
+
+    void cancel(size_t xst_index)
+    {
+        if (armed(xst_index))
+            remove_at(m_xvec_hpos[xst_index]);
+    }
+
+    size_t expire(uint64_t xu64_now)
+    {
+        size_t xst_count = 0;
+        while (!m_xvec_heap.empty() && (m_xvec_expire[m_xvec_heap[0]] <= xu64_now))
+        {
+            remove_at(0);
+            g_xtimer_fired += 1;
+            xst_count += 1;
+        }
+        return xst_count;
+    }
+
+private:
+    std::vector< uint64_t > m_xvec_expire;
+    std::vector< uint64_t > m_xvec_seq;
+    std::vector< size_t   > m_xvec_hpos;
+    std::vector< size_t   > m_xvec_heap;
+    uint64_t                m_xu64_seq;
+};
+
+const size_t xbench_timer_heap_t::XNPOS;
+
+/**
+ * @class xbench_timer_wheel_t
+ * @brief 定时器队列测试：单层时间轮（4096 个槽，每槽 1 个时间单位，槽内为双向链表）。
+ */
+class xbench_timer_wheel_t
+{
+    enum { XSLOT_COUNT = 4096, XSLOT_MASK = XSLOT_COUNT - 1 };
+    static const size_t XNPOS = (size_t)-1;
+
+    void unlink(size_t xst_index)
+    {
+        size_t xst_prev = m_xvec_prev[xst_index];
+        size_t xst_next = m_xvec_next[xst_index];
+        if (XNPOS != xst_prev)
+            m_xvec_next[xst_prev] = xst_next;
+        else
+            m_xvec_slot[m_xvec_expire[xst_index] & XSLOT_MASK] = xst_next;
+        if (XNPOS != xst_next)
+            m_xvec_prev[xst_next] = xst_prev;
+        m_xvec_armed[xst_index] = 0;
+    }
+
+public:
+    explicit xbench_timer_wheel_t(size_t xst_count)
+        : m_xvec_slot(XSLOT_COUNT, XNPOS)
+        , m_xvec_expire(xst_count, 0)
+        , m_xvec_prev(xst_count, XNPOS)
+        , m_xvec_next(xst_count, XNPOS)
+        , m_xvec_armed(xst_count, 0)
+        , m_xu64_tick(0)
+    {
+
+    }
+
+    bool armed(size_t xst_index) { return (0 != m_xvec_armed[xst_index]); }
+
+    void arm(size_t xst_index, uint64_t xu64_expire)
+    {
+        if (armed(xst_index))
+            unlink(xst_index);
+
+        // 已处理过的时间点，放入下一个待处理的槽
+        if (xu64_expire <= m_xu64_tick)
+            xu64_expire = m_xu64_tick + 1;
+
+        size_t xst_slot = xu64_expire & XSLOT_MASK;
+        m_xvec_expire[xst_index] = xu64_expire;
+        m_xvec_prev[xst_index]   = XNPOS;
+        m_xvec_next[xst_index]   = m_xvec_slot[xst_slot];
+        if (XNPOS != m_xvec_slot[xst_slot])
+            m_xvec_prev[m_xvec_slot[xst_slot]] = xst_index;
+        m_xvec_slot[xst_slot]    = xst_index;
+        m_xvec_armed[xst_index]  = 1;
+    }
+
+    void cancel(size_t xst_index)
+    {
+        if (armed(xst_index))
+            unlink(xst_index);
+    }
+
+    size_t expire(uint64_t xu64_now)
+    {
+        size_t xst_count = 0;
+        while (m_xu64_tick < xu64_now)
+        {
+            m_xu64_tick += 1;
+
+            // 槽内还有 到期时间 在后续轮次的定时器，逐个判断
+            size_t xst_index = m_xvec_slot[m_xu64_tick & XSLOT_MASK];
+            while (XNPOS != xst_index)
+            {
+                size_t xst_next = m_xvec_next[xst_index];
+                if (m_xvec_expire[xst_index] <= m_xu64_tick)
+                {
+                    unlink(xst_index);
+                    g_xtimer_fired += 1;
+                    xst_count += 1;
+                }
+                xst_index = xst_next;
+            }
+        }
+        return xst_count;
+    }
+
+private:
+    std::vector< size_t   > m_xvec_slot;
+    std::vector< uint64_t > m_xvec_expire;
+    std::vector< size_t   > m_xvec_prev;
+    std::vector< size_t   > m_xvec_next;
+    std::vector< uint8_t  > m_xvec_armed;
+    uint64_t                m_xu64_tick;
+};
+
+const size_t xbench_timer_wheel_t::XNPOS;
+
+/**********************************************************/
+/**
+ * @brief 定时器队列测试：高取消率的 启动/取消/重新启动/到期 混合操作。
+ */
+template< class _Timer >
+static void xbench_run_timer(const xbench_conf_t & xconf,
+                             xbench_report_t & xreport,
+                             const std::string & xstr_impl)
+{
+    const size_t xst_count = xconf.xst_count;
+    const size_t xst_nops  = 4 * xst_count;
+    const size_t xst_span  = std::max< size_t >(xconf.xst_span, 1);
+
+    for (int xit_cancel : xconf.xvec_cancel)
+    {
+        for (size_t xst_rep = 0; xst_rep < xconf.xst_reps; ++xst_rep)
+        {
+            // 预先生成随机操作序列，避免随机数生成计入测试时间
+            std::mt19937_64 xrng(xconf.xu64_seed + xit_cancel);
+            std::vector< uint32_t > xvec_index(xst_nops);
+            std::vector< uint32_t > xvec_delay(xst_nops);
+            std::vector< uint8_t  > xvec_cancel(xst_nops);
+            for (size_t xst_iter = 0; xst_iter < xst_nops; ++xst_iter)
+            {
+                xvec_index [xst_iter] = (uint32_t)(xrng() % xst_count);
+                xvec_delay [xst_iter] = (uint32_t)(1 + xrng() % xst_span);
+                xvec_cancel[xst_iter] = ((int)(xrng() % 100) < xit_cancel);
+            }
+
+            _Timer   xtimer(xst_count);
+            uint64_t xu64_now = 0;
+            for (size_t xst_iter = 0; xst_iter < xst_count; ++xst_iter)
+                xtimer.arm(xst_iter, 1 + xrng() % xst_span);
+
+            g_xtimer_fired = 0;
+
+            xtime_point xtm_begin = xtime_clock::now();
+            for (size_t xst_iter = 0; xst_iter < xst_nops; ++xst_iter)
+            {
+                size_t xst_index = xvec_index[xst_iter];
+                if (!xtimer.armed(xst_index))
+                    xtimer.arm(xst_index, xu64_now + xvec_delay[xst_iter]);
+                else if (xvec_cancel[xst_iter])
+                    xtimer.cancel(xst_index);
+                else
+                    xtimer.arm(xst_index, xu64_now + xvec_delay[xst_iter]);
+
+                if (0 == (xst_iter & 15))
+                    xtimer.expire(++xu64_now);
+            }
+            int64_t xit_ns = xtime_nsec(xtime_clock::now() - xtm_begin);
+
+            xbench_record_t xrecord;
+            xrecord.xstr_impl    = xstr_impl;
+            xrecord.xstr_key     = "u64";
+            xrecord.xstr_dist    = "timer";
+            xrecord.xst_count    = xst_count;
+            xrecord.xit_mix      = xit_cancel;
+            xrecord.xstr_op      = "ops";
+            xrecord.xst_ops      = xst_nops;
+            xrecord.xit_total_ns = xit_ns;
+            xrecord.xdbl_value   = (double)xit_ns / (double)xst_nops;
+            xreport.emit(xrecord);
+
+            xrecord.xstr_op      = "fired";
+            xrecord.xst_ops      = g_xtimer_fired;
+            xrecord.xit_total_ns = 0;
+            xrecord.xdbl_value   = (double)g_xtimer_fired;
+            xreport.emit(xrecord);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 操作记录的重放
+
+/**
+ * @struct xbench_trace_t
+ * @brief  从操作记录文件中读取的全部操作（索引键保留原始字节）。
+ */
+struct xbench_trace_t
+{
+    uint32_t                    xut_ksize = 0;
+    uint32_t                    xut_flags = 0;
+    std::vector< uint8_t >      xvec_op;     ///< 操作类型（emXRBtreeRecordOp）
+    std::vector< uint64_t >     xvec_gap;    ///< 与上一条记录的时间间隔（纳秒）
+    std::vector< size_t >       xvec_kpos;   ///< 索引键在 xstr_kbuf 中的偏移（无索引键时为 npos）
+    std::string                 xstr_kbuf;   ///< 索引键的原始字节
+
+    /** 读取操作记录文件，失败时返回 false */
+    bool load(const std::string & xstr_path)
+    {
+        FILE * xfile = fopen(xstr_path.c_str(), "rb");
+        if (NULL == xfile)
+            return false;
+
+        char     xszt_magic[8];
+        uint32_t xut_head[2];
+        bool     xbt_ok = (8 == fread(xszt_magic, 1, 8, xfile)) &&
+                          (0 == memcmp(xszt_magic, XRBT_RECORD_MAGIC, 8)) &&
+                          (2 == fread(xut_head, sizeof(uint32_t), 2, xfile));
+        xut_ksize = xbt_ok ? xut_head[0] : 0;
+        xut_flags = xbt_ok ? xut_head[1] : 0;
+
+        std::vector< char > xvec_key(xut_ksize);
+        int xit_op = EOF;
+        while (xbt_ok && (EOF != (xit_op = fgetc(xfile))))
+        {
+            uint64_t xu64_gap   = 0;
+            int      xit_shift  = 0;
+            int      xit_byte   = 0;
+            do
+            {
+                xit_byte   = fgetc(xfile);
+                xu64_gap  |= (uint64_t)(xit_byte & 0x7F) << xit_shift;
+                xit_shift += 7;
+            } while ((EOF != xit_byte) && (xit_byte & 0x80) && (xit_shift < 64));
+
+            size_t xst_kpos = std::string::npos;
+            if ((XRBT_RECORD_INSERT <= xit_op) && (xit_op <= XRBT_RECORD_LOWER_BOUND))
+            {
+                if (xut_ksize != fread(xvec_key.data(), 1, xut_ksize, xfile))
+                    break;
+                xst_kpos = xstr_kbuf.size();
+                xstr_kbuf.append(xvec_key.data(), xut_ksize);
+            }
+            else if ((xit_op < XRBT_RECORD_INSERT) || (xit_op > XRBT_RECORD_CLEAR))
+            {
+                xbt_ok = false;
+                break;
+            }
+
+            xvec_op  .push_back((uint8_t)xit_op);
+            xvec_gap .push_back(xu64_gap);
+            xvec_kpos.push_back(xst_kpos);
+        }
+
+        fclose(xfile);
+        return xbt_ok;
+    }
+};
+
+/**********************************************************/
+/**
+ * @brief 由操作记录中的索引键原始字节构造索引键。
+ */
+template< class _Kty >
+static _Kty xbench_trace_key(const char * xszt_bytes, size_t xst_ksize)
+{
+    _Kty xkey = _Kty();
+    memcpy(&xkey, xszt_bytes, std::min(sizeof(_Kty), xst_ksize));
+    return xkey;
+}
+
+template< >
+std::string xbench_trace_key< std::string >(const char * xszt_bytes, size_t xst_ksize)
+{
+    return std::string(xszt_bytes, xst_ksize);
+}
+
+/**********************************************************/
+/**
+ * @brief 在指定的容器上重放操作记录，逐次计时。
+ */
+template< class _Kty, class _Impl >
+static void xbench_replay(const xbench_conf_t & xconf,
+                          xbench_report_t & xreport,
+                          const xbench_trace_t & xtrace,
+                          const std::vector< _Kty > & xvec_keys,
+                          const std::string & xstr_impl,
+                          const std::string & xstr_mode,
+                          const std::string & xstr_key)
+{
+    static const char * xszt_op[XRBT_RECORD_CLEAR + 1] =
+    {
+        "all", "insert", "erase", "find", "lower_bound", "begin", "rbegin", "clear"
+    };
+
+    std::vector< xbench_histogram_t > xvec_hist(XRBT_RECORD_CLEAR + 1);
+
+    for (size_t xst_rep = 0; xst_rep < xconf.xst_reps; ++xst_rep)
+    {
+        _Impl  xcontainer(xstr_mode);
+        size_t xst_check = 0;
+        size_t xst_kiter = 0;
+
+        for (size_t xst_iter = 0; xst_iter < xtrace.xvec_op.size(); ++xst_iter)
+        {
+            const uint8_t xut_op = xtrace.xvec_op[xst_iter];
+            const _Kty &  xkey   = xvec_keys[(std::string::npos != xtrace.xvec_kpos[xst_iter]) ?
+                                             xst_kiter++ : 0];
+
+            xtime_point xtm_begin = xtime_clock::now();
+            switch (xut_op)
+            {
+            case XRBT_RECORD_INSERT     : xst_check += xcontainer.insert(xkey);      break;
+            case XRBT_RECORD_ERASE      : xst_check += xcontainer.erase(xkey);       break;
+            case XRBT_RECORD_FIND       : xst_check += xcontainer.find(xkey);        break;
+            case XRBT_RECORD_LOWER_BOUND: xst_check += xcontainer.lower_bound(xkey); break;
+            case XRBT_RECORD_BEGIN      : xst_check += xcontainer.begin();           break;
+            case XRBT_RECORD_RBEGIN     : xst_check += xcontainer.rbegin();          break;
+            case XRBT_RECORD_CLEAR      : xcontainer.clear();                        break;
+            default                     :                                            break;
+            }
+            uint64_t xu64_ns = (uint64_t)xtime_nsec(xtime_clock::now() - xtm_begin);
+
+            xvec_hist[xut_op].record(xu64_ns);
+            xvec_hist[0].record(xu64_ns);
+        }
+
+        g_xbench_sink = g_xbench_sink + xst_check;
+    }
+
+    xbench_record_t xrecord;
+    xrecord.xstr_impl = xstr_impl;
+    xrecord.xstr_key  = xstr_key;
+    xrecord.xstr_dist = "trace";
+    xrecord.xst_count = xtrace.xvec_op.size();
+    xrecord.xit_mix   = -1;
+
+    for (size_t xst_iter = 0; xst_iter < xvec_hist.size(); ++xst_iter)
+    {
+        if (0 == xvec_hist[xst_iter].count())
+            continue;
+        xrecord.xstr_op = xszt_op[xst_iter];
+        xreport.emit_latency(xrecord, xvec_hist[xst_iter]);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 对指定索引键类型，在所有 impl 上重放操作记录。
+ */
+template< class _Kty >
+static void xbench_run_replay(const xbench_conf_t & xconf,
+                              xbench_report_t & xreport,
+                              const xbench_trace_t & xtrace,
+                              const std::string & xstr_key)
+{
+    const bool xbt_string = std::is_same< _Kty, std::string >::value;
+
+    // 重放前先构造全部索引键（借用模式下，索引键须在容器生命周期内保持有效）
+    std::vector< _Kty > xvec_keys;
+    xvec_keys.reserve(xtrace.xvec_kpos.size() + 1);
+    for (size_t xst_kpos : xtrace.xvec_kpos)
+    {
+        if (std::string::npos != xst_kpos)
+            xvec_keys.push_back(xbench_trace_key< _Kty >(&xtrace.xstr_kbuf[xst_kpos],
+                                                         xtrace.xut_ksize));
+    }
+    if (xvec_keys.empty())
+        xvec_keys.push_back(_Kty());
+
+    for (const std::string & xstr_impl : xconf.xvec_impl)
+    {
+        if (xstr_impl == "std-set")
+        {
+            xbench_replay< _Kty, xbench_stdset_t< _Kty, false > >(
+                xconf, xreport, xtrace, xvec_keys, xstr_impl, "", xstr_key);
+        }
+        else if (xstr_impl == "std-map")
+        {
+            xbench_replay< _Kty, xbench_stdset_t< _Kty, true > >(
+                xconf, xreport, xtrace, xvec_keys, xstr_impl, "", xstr_key);
+        }
+        else if (xstr_impl == "xrbtree_set")
+        {
+            xbench_replay< _Kty, xbench_stdset_t< _Kty, false, xrbtree_set, xrbtree_map > >(
+                xconf, xreport, xtrace, xvec_keys, xstr_impl, "", xstr_key);
+        }
+        else if (xstr_impl == "xrbtree_map")
+        {
+            xbench_replay< _Kty, xbench_stdset_t< _Kty, true, xrbtree_set, xrbtree_map > >(
+                xconf, xreport, xtrace, xvec_keys, xstr_impl, "", xstr_key);
+        }
+        else if (xstr_impl == "xrbtree-intrusive")
+        {
+            xbench_replay< _Kty, xbench_intrusive_t< _Kty > >(
+                xconf, xreport, xtrace, xvec_keys, xstr_impl, "intrusive", xstr_key);
+        }
+        else if (0 == xstr_impl.compare(0, 7, "xrbtree"))
+        {
+            std::string xstr_mode =
+                (xstr_impl.size() > 8) ? xstr_impl.substr(8) : std::string("set");
+            if (!xbt_string && ((xstr_mode == "prefix") || (xstr_mode == "borrow")))
+                continue;
+
+            xbench_replay< _Kty, xbench_xrbtree_t< _Kty > >(
+                xconf, xreport, xtrace, xvec_keys, xstr_impl, xstr_mode, xstr_key);
+        }
+        else
+        {
+            fprintf(stderr, "unknown impl: %s\n", xstr_impl.c_str());
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************/
+/**
+ * @brief 对指定索引键类型，运行所有 (impl, dist) 组合。
+ */
+template< class _Kty >
+static void xbench_run_key(const xbench_conf_t & xconf,
+                           xbench_report_t & xreport,
+                           const std::string & xstr_key,
+                           size_t xst_klen)
+{
+    const bool xbt_string = std::is_same< _Kty, std::string >::value;
+
+    // 延迟测试按 --sizes 依次改变树的大小
+    if ((xconf.xstr_mode == "latency") && !xconf.xvec_sizes.empty())
+    {
+        xbench_conf_t xconf_size = xconf;
+        xconf_size.xvec_sizes.clear();
+        for (size_t xst_size : xconf.xvec_sizes)
+        {
+            xconf_size.xst_count = xst_size;
+            xbench_run_key< _Kty >(xconf_size, xreport, xstr_key, xst_klen);
+        }
+        return;
+    }
+
+    for (const std::string & xstr_dist : xconf.xvec_dist)
+    {
+        for (const std::string & xstr_impl : xconf.xvec_impl)
+        {
+            if (xstr_impl == "std-set")
+            {
+                xbench_runner_t< _Kty, xbench_stdset_t< _Kty, false > >(
+                    xconf, xreport, xstr_impl, "", xstr_key, xst_klen, xstr_dist).run();
+            }
+            else if (xstr_impl == "std-map")
+            {
+                xbench_runner_t< _Kty, xbench_stdset_t< _Kty, true > >(
+                    xconf, xreport, xstr_impl, "", xstr_key, xst_klen, xstr_dist).run();
+            }
+            else if (xstr_impl == "xrbtree_set")
+            {
+                xbench_runner_t< _Kty, xbench_stdset_t< _Kty, false, xrbtree_set, xrbtree_map > >(
+                    xconf, xreport, xstr_impl, "", xstr_key, xst_klen, xstr_dist).run();
+            }
+            else if (xstr_impl == "xrbtree_map")
+            {
+                xbench_runner_t< _Kty, xbench_stdset_t< _Kty, true, xrbtree_set, xrbtree_map > >(
+                    xconf, xreport, xstr_impl, "", xstr_key, xst_klen, xstr_dist).run();
+            }
+            else if (xstr_impl == "xrbtree-intrusive")
+            {
+                xbench_runner_t< _Kty, xbench_intrusive_t< _Kty > >(
+                    xconf, xreport, xstr_impl, "intrusive", xstr_key, xst_klen, xstr_dist).run();
+            }
+            else if (0 == xstr_impl.compare(0, 7, "xrbtree"))
+            {
+                std::string xstr_mode =
+                    (xstr_impl.size() > 8) ? xstr_impl.substr(8) : std::string("set");
+
+                // 前缀缓存 与 借用模式 只对字符串索引键有意义
+                if (!xbt_string && ((xstr_mode == "prefix") || (xstr_mode == "borrow")))
+                    continue;
+
+                xbench_runner_t< _Kty, xbench_xrbtree_t< _Kty > >(
+                    xconf, xreport, xstr_impl, xstr_mode, xstr_key, xst_klen, xstr_dist).run();
+            }
+            else
+            {
+                fprintf(stderr, "unknown impl: %s\n", xstr_impl.c_str());
+            }
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 按逗号拆分参数值，"all" 展开为 xvec_all 。
+ */
+static std::vector< std::string > xbench_split(const std::string & xstr_value,
+                                               const std::vector< std::string > & xvec_all)
+{
+    if (xstr_value == "all")
+        return xvec_all;
+
+    std::vector< std::string > xvec_items;
+    size_t xst_pos = 0;
+    while (xst_pos <= xstr_value.size())
+    {
+        size_t xst_end = xstr_value.find(',', xst_pos);
+        if (std::string::npos == xst_end)
+            xst_end = xstr_value.size();
+        if (xst_end > xst_pos)
+            xvec_items.push_back(xstr_value.substr(xst_pos, xst_end - xst_pos));
+        xst_pos = xst_end + 1;
+    }
+
+    return xvec_items;
+}
+
+static void xbench_usage(const char * xszt_name)
+{
+    printf("Usage: %s [--n N] [--reps R] [--impl LIST] [--key LIST] [--dist LIST]\n"
+           "          [--mix LIST] [--range LEN] [--seed S] [--format text|csv|json]\n"
+           "          [--mode throughput|latency] [--sizes LIST] [--noise N] [--noise-mb MB]\n"
+           "          [--perf 0|1] [--mode replay --trace FILE [--key u32|u64|bytes]]\n"
+           "          [--mode timer [--impl xtimerq,heap,wheel] [--cancel LIST] [--span TICKS]]\n"
+           "  impl : xrbtree,xrbtree-kv,xrbtree-multi,xrbtree-prefix,xrbtree-borrow,"
+           "xrbtree-intrusive,xrbtree_set,xrbtree_map,std-set,std-map | all\n"
+           "  key  : u32,u64,str16,str64,str256 | all\n"
+           "  dist : seq,reverse,random,zipf,cluster | all\n"
+           "  mix  : read percentages of the mixed workload, e.g. 50,90,99\n",
+           xszt_name);
+}
+
+int main(int argc, char * argv[])
+{
+    const std::vector< std::string > xvec_all_impl =
+    {
+        "xrbtree", "xrbtree-kv", "xrbtree-multi", "xrbtree-prefix", "xrbtree-borrow",
+        "xrbtree-intrusive", "xrbtree_set", "xrbtree_map", "std-set", "std-map"
+    };
+    const std::vector< std::string > xvec_all_key  =
+        { "u32", "u64", "str16", "str64", "str256" };
+    const std::vector< std::string > xvec_all_dist =
+        { "seq", "reverse", "random", "zipf", "cluster" };
+
+    xbench_conf_t xconf;
+    xconf.xvec_impl = { "xrbtree", "std-set" };
+    xconf.xvec_dist = { "random" };
+    xconf.xvec_mix  = { 50, 90 };
+
+    for (int xit_iter = 1; xit_iter < argc; ++xit_iter)
+    {
+        std::string xstr_arg = argv[xit_iter];
+        if ((xstr_arg == "-h") || (xstr_arg == "--help"))
+        {
+            xbench_usage(argv[0]);
+            return 0;
+        }
+
+        if (xit_iter + 1 >= argc)
+        {
+            xbench_usage(argv[0]);
+            return -1;
+        }
+
+        std::string xstr_value = argv[++xit_iter];
+        if      (xstr_arg == "--n"     ) xconf.xst_count  = (size_t)atoll(xstr_value.c_str());
+        else if (xstr_arg == "--reps"  ) xconf.xst_reps   = (size_t)atoll(xstr_value.c_str());
+        else if (xstr_arg == "--range" ) xconf.xst_range  = (size_t)atoll(xstr_value.c_str());
+        else if (xstr_arg == "--seed"  ) xconf.xu64_seed  = (uint64_t)atoll(xstr_value.c_str());
+        else if (xstr_arg == "--format") xconf.xstr_format = xstr_value;
+        else if (xstr_arg == "--mode"  ) xconf.xstr_mode  = xstr_value;
+        else if (xstr_arg == "--perf"  ) xconf.xbt_perf   = (0 != atoi(xstr_value.c_str()));
+        else if (xstr_arg == "--trace" ) xconf.xstr_trace = xstr_value;
+        else if (xstr_arg == "--span"  ) xconf.xst_span   = (size_t)atoll(xstr_value.c_str());
+        else if (xstr_arg == "--cancel")
+        {
+            xconf.xvec_cancel.clear();
+            for (const std::string & xstr_cancel : xbench_split(xstr_value, { "50", "90", "99" }))
+                xconf.xvec_cancel.push_back(atoi(xstr_cancel.c_str()));
+        }
+        else if (xstr_arg == "--noise" ) xconf.xst_noise  = (size_t)atoll(xstr_value.c_str());
+        else if (xstr_arg == "--noise-mb") xconf.xst_noise_mb = (size_t)atoll(xstr_value.c_str());
+        else if (xstr_arg == "--sizes" )
+        {
+            xconf.xvec_sizes.clear();
+            for (const std::string & xstr_size : xbench_split(xstr_value, { }))
+                xconf.xvec_sizes.push_back((size_t)atoll(xstr_size.c_str()));
+        }
+        else if (xstr_arg == "--impl"  ) xconf.xvec_impl  = xbench_split(xstr_value, xvec_all_impl);
+        else if (xstr_arg == "--key"   ) xconf.xvec_key   = xbench_split(xstr_value, xvec_all_key);
+        else if (xstr_arg == "--dist"  ) xconf.xvec_dist  = xbench_split(xstr_value, xvec_all_dist);
+        else if (xstr_arg == "--mix"   )
+        {
+            xconf.xvec_mix.clear();
+            for (const std::string & xstr_mix : xbench_split(xstr_value, { "0", "50", "90", "99" }))
+                xconf.xvec_mix.push_back(atoi(xstr_mix.c_str()));
+        }
+        else
+        {
+            xbench_usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if (0 == xconf.xst_count)
+    {
+        xbench_usage(argv[0]);
+        return -1;
+    }
+
+    if ((xconf.xstr_mode != "throughput") &&
+        (xconf.xstr_mode != "latency"   ) &&
+        (xconf.xstr_mode != "replay"    ) &&
+        (xconf.xstr_mode != "timer"     ))
+    {
+        xbench_usage(argv[0]);
+        return -1;
+    }
+
+    if (xconf.xvec_key.empty() && (xconf.xstr_mode != "replay"))
+        xconf.xvec_key = { "u32" };
+
+    xbench_trace_t xtrace;
+    if ((xconf.xstr_mode == "replay") && !xtrace.load(xconf.xstr_trace))
+    {
+        fprintf(stderr, "invalid trace file: %s\n", xconf.xstr_trace.c_str());
+        return -1;
+    }
+
+    xbench_perf_t xperf;
+    if (xconf.xbt_perf)
+    {
+        if (xperf.open() > 0)
+            g_xbench_perf = &xperf;
+        else
+            fprintf(stderr, "perf counters unavailable, reporting wall time only\n");
+    }
+
+    xbench_report_t xreport(xconf.xstr_format,
+                            (xconf.xstr_mode == "latency") || (xconf.xstr_mode == "replay"));
+    xbench_noise_t  xnoise(xconf.xst_noise, xconf.xst_noise_mb);
+
+    if (xconf.xstr_mode == "timer")
+    {
+        // 未指定定时器的 impl 时，测试全部
+        std::vector< std::string > xvec_timer;
+        for (const std::string & xstr_impl : xconf.xvec_impl)
+        {
+            if ((xstr_impl == "xtimerq") || (xstr_impl == "heap") || (xstr_impl == "wheel"))
+                xvec_timer.push_back(xstr_impl);
+        }
+        if (xvec_timer.empty())
+            xvec_timer = { "xtimerq", "heap", "wheel" };
+
+        for (const std::string & xstr_impl : xvec_timer)
+        {
+            if      (xstr_impl == "xtimerq") xbench_run_timer< xbench_timer_xtimerq_t >(xconf, xreport, xstr_impl);
+            else if (xstr_impl == "heap"   ) xbench_run_timer< xbench_timer_heap_t    >(xconf, xreport, xstr_impl);
+            else                             xbench_run_timer< xbench_timer_wheel_t   >(xconf, xreport, xstr_impl);
+        }
+        return 0;
+    }
+
+    if (xconf.xstr_mode == "replay")
+    {
+        // 未指定 --key 时，按记录的索引键大小选择
+        std::string xstr_key = xconf.xvec_key.empty() ? std::string("") : xconf.xvec_key[0];
+        if (xstr_key.empty() || (xstr_key == "auto"))
+            xstr_key = (4 == xtrace.xut_ksize) ? "u32" : ((8 == xtrace.xut_ksize) ? "u64" : "bytes");
+
+        if      ((xstr_key == "u32") && (4 == xtrace.xut_ksize))
+            xbench_run_replay< uint32_t    >(xconf, xreport, xtrace, xstr_key);
+        else if ((xstr_key == "u64") && (8 == xtrace.xut_ksize))
+            xbench_run_replay< uint64_t    >(xconf, xreport, xtrace, xstr_key);
+        else if (xstr_key == "bytes")
+            xbench_run_replay< std::string >(xconf, xreport, xtrace, xstr_key);
+        else
+            fprintf(stderr, "key %s does not match the trace key size %u\n",
+                    xstr_key.c_str(), (unsigned)xtrace.xut_ksize);
+        return 0;
+    }
+
+    for (const std::string & xstr_key : xconf.xvec_key)
+    {
+        if      (xstr_key == "u32"   ) xbench_run_key< uint32_t    >(xconf, xreport, xstr_key, 4);
+        else if (xstr_key == "u64"   ) xbench_run_key< uint64_t    >(xconf, xreport, xstr_key, 8);
+        else if (xstr_key == "str16" ) xbench_run_key< std::string >(xconf, xreport, xstr_key, 16);
+        else if (xstr_key == "str64" ) xbench_run_key< std::string >(xconf, xreport, xstr_key, 64);
+        else if (xstr_key == "str256") xbench_run_key< std::string >(xconf, xreport, xstr_key, 256);
+        else fprintf(stderr, "unknown key: %s\n", xstr_key.c_str());
+    }
+
+    return 0;
+}
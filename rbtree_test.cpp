@@ -8,6 +8,10 @@
  * 文件标识：
  * 文件摘要：红黑树的接口测试程序。
  * 
+ * 编译方式：
+ *   g++ -O2 -std=c++11 -pthread -o rbtree_test rbtree_test.cpp xrbtree.c xrbtree_par.c xmmtree.c xtimerq.c -lrt
+ *   （以 -std=c++17 编译时，同时测试 std::pmr 桥接）
+ * 
  * 当前版本：1.0.0.0
  * 作    者：
  * 完成日期：2019年09月12日
@@ -21,12 +25,25 @@
  */
 
 #include "xrbtree.h"
+#include "xmmtree.h"
+#include "xtimerq.h"
+#include "xrbtree_stl.h"
+#include "xrbtree_par.h"
 
 #include <stdio.h>
 #include <memory.h>
+#include <unistd.h>
+#include <sys/wait.h>
 #include <set>
+#include <map>
+#include <vector>
+#include <string>
+#include <random>
 #include <chrono>
 #include <memory>
+#include <iterator>
+#include <atomic>
+#include <stdexcept>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -220,17 +237,2322 @@ void test_settree(int max_insert)
     //======================================
 }
 
-int main(int argc, char * argv[])
+////////////////////////////////////////////////////////////////////////////////
+// 正确性检查（失败时输出所在行，main() 返回非 0 值）
+
+int xcheck_fails = 0;
+
+#define XCHECK(xexpr)                                                          \
+    do                                                                         \
+    {                                                                          \
+        if (!(xexpr))                                                          \
+        {                                                                      \
+            xcheck_fails += 1;                                                 \
+            printf("[CHK] %s(%d) failed: %s\n", __FILE__, __LINE__, #xexpr);   \
+        }                                                                      \
+    } while (0)
+
+/**
+ * @brief 递归检查子树中各节点的父节点链接，返回子树的高度（累计节点数量）。
+ */
+static int xcheck_height(x_rbnode_iter xiter_node, xrbt_size_t & xst_count)
 {
-    int max_insert = 1000000;
-    int first_test = 1;
+    if (xrbtree_iter_is_nil(xiter_node))
+        return 0;
 
-    printf("Usage: %s < max_insert > < first_test_c : 0 or 1 >\n", argv[0]);
+    x_rbtree_link_t * xlink_ptr  = XRBT_ITER_LINK(xiter_node);
+    x_rbnode_iter     xiter_left  = XRBT_LINK_GET(xlink_ptr->xiter_left );
+    x_rbnode_iter     xiter_right = XRBT_LINK_GET(xlink_ptr->xiter_right);
+    xst_count += 1;
 
-    if (argc >= 2) max_insert = std::atoi(argv[1]);
-    if (argc >= 3) first_test = std::atoi(argv[2]);
+    if (!xrbtree_iter_is_nil(xiter_left))
+        XCHECK(XRBT_LINK_GET(XRBT_ITER_LINK(xiter_left)->xiter_parent) == xiter_node);
+    if (!xrbtree_iter_is_nil(xiter_right))
+        XCHECK(XRBT_LINK_GET(XRBT_ITER_LINK(xiter_right)->xiter_parent) == xiter_node);
+
+    int xit_lheight = xcheck_height(xiter_left , xst_count);
+    int xit_rheight = xcheck_height(xiter_right, xst_count);
+
+    return 1 + ((xit_lheight > xit_rheight) ? xit_lheight : xit_rheight);
+}
+
+/**
+ * @brief 检查红黑树的结构：父子链接、节点数量、高度上限（2 * log2(n + 1)）、
+ *        最小/最大节点，以及正向、反向遍历的顺序（int 索引键）。
+ */
+static void xcheck_tree(x_rbtree_ptr xtree_ptr)
+{
+    xrbt_size_t   xst_count  = 0;
+    x_rbnode_iter xiter_root = xrbtree_root(xtree_ptr);
+    int           xit_height = xcheck_height(xiter_root, xst_count);
+    int           xit_limit  = 0;
+
+    XCHECK(xst_count == xrbtree_size(xtree_ptr));
+    while ((1ULL << (xit_limit / 2)) <= xst_count)
+        xit_limit += 2;
+    XCHECK(xit_height <= xit_limit);
+
+    if (0 == xst_count)
+    {
+        XCHECK(xrbtree_iter_is_nil(xiter_root));
+        XCHECK(xrbtree_begin(xtree_ptr) == xrbtree_end(xtree_ptr));
+        return;
+    }
+
+    XCHECK(xrbtree_iter_is_nil(XRBT_LINK_GET(XRBT_ITER_LINK(xiter_root)->xiter_parent)));
+    XCHECK(xrbtree_iter_is_nil(XRBT_LINK_GET(XRBT_ITER_LINK(xrbtree_begin (xtree_ptr))->xiter_left )));
+    XCHECK(xrbtree_iter_is_nil(XRBT_LINK_GET(XRBT_ITER_LINK(xrbtree_rbegin(xtree_ptr))->xiter_right)));
+
+    xrbt_bool_t xbt_multi = (0 != (xrbtree_flags(xtree_ptr) & XRBT_FLAG_MULTI));
+    xrbt_size_t xst_iter  = 0;
+
+    for (x_rbnode_iter xiter = xrbtree_begin(xtree_ptr);
+         xiter != xrbtree_end(xtree_ptr);
+         xiter = xrbtree_next(xiter), ++xst_iter)
+    {
+        x_rbnode_iter xiter_next = xrbtree_next(xiter);
+        if (xiter_next != xrbtree_end(xtree_ptr))
+        {
+            if (xbt_multi)
+                XCHECK(xrbtree_iter_int(xiter) <= xrbtree_iter_int(xiter_next));
+            else
+                XCHECK(xrbtree_iter_int(xiter) <  xrbtree_iter_int(xiter_next));
+        }
+    }
+    XCHECK(xst_iter == xst_count);
+
+    xst_iter = 0;
+    for (x_rbnode_iter xiter = xrbtree_rbegin(xtree_ptr);
+         xiter != xrbtree_rend(xtree_ptr);
+         xiter = xrbtree_rnext(xiter))
+    {
+        xst_iter += 1;
+    }
+    XCHECK(xst_iter == xst_count);
+}
+
+/**
+ * @brief 比较红黑树与参照容器中的索引键序列是否一致。
+ */
+template< typename _Ref >
+static bool xcheck_equal(x_rbtree_ptr xtree_ptr, const _Ref & xref)
+{
+    if (xrbtree_size(xtree_ptr) != xref.size())
+        return false;
+
+    typename _Ref::const_iterator xref_iter = xref.begin();
+    for (x_rbnode_iter xiter = xrbtree_begin(xtree_ptr);
+         xiter != xrbtree_end(xtree_ptr);
+         xiter = xrbtree_next(xiter), ++xref_iter)
+    {
+        if (xrbtree_iter_int(xiter) != *xref_iter)
+            return false;
+    }
+
+    return true;
+}
+
+xrbt_callback_t xcheck_callback =
+{
+    /* .xfunc_n_memalloc = */ &xalloc_memalloc,
+    /* .xfunc_n_memfree  = */ &xalloc_memfree,
+    /* .xfunc_k_copyfrom = */ &xrbtree_xfunc_int_copyfrom,
+    /* .xfunc_k_destruct = */ XRBT_NULL,
+    /* .xfunc_k_lesscomp = */ &xrbtree_xfunc_ltint_compare,
+    /* .xctxt_t_callback = */ XRBT_NULL
+};
+
+/**
+ * @brief 随机混合 插入/删除/区间删除/弹出 操作后，检查结构及内容（唯一键、多键 两种模式）。
+ */
+void test_check_mixed(void)
+{
+    std::mt19937 xrand(45);
+
+    x_rbtree_ptr  xtree_ptr = xrbtree_create(sizeof(int), &xcheck_callback);
+    x_rbtree_ptr  xmtree_ptr = xrbtree_create_ex(
+                        sizeof(int), 0, XRBT_FLAG_MULTI, &xcheck_callback, XRBT_NULL);
+    std::set< int >      xref;
+    std::multiset< int > xmref;
+
+    for (int i = 0; i < 40000; ++i)
+    {
+        int xkey = (int)(xrand() % 4000) - 2000;
+
+        switch (xrand() % 8)
+        {
+        case 0: case 1: case 2:
+            XCHECK((0 != xrbtree_insert_int(xtree_ptr, xkey)) == xref.insert(xkey).second);
+            xrbtree_insert(xmtree_ptr, &xkey, XRBT_NULL);
+            xmref.insert(xkey);
+            break;
+
+        case 3: case 4:
+            XCHECK((0 != xrbtree_erase_int(xtree_ptr, xkey)) == (xref.erase(xkey) > 0));
+            XCHECK(xrbtree_erase_equal(xmtree_ptr, &xkey) == xmref.erase(xkey));
+            break;
+
+        case 5:
+            {
+                int xlast = xkey + (int)(xrand() % 64);
+                xrbt_size_t xst_count = xrbtree_erase_range(
+                                            xtree_ptr,
+                                            xrbtree_lower_bound_int(xtree_ptr, xkey),
+                                            xrbtree_lower_bound_int(xtree_ptr, xlast));
+                XCHECK(xst_count == (xrbt_size_t)std::distance(
+                                        xref.lower_bound(xkey), xref.lower_bound(xlast)));
+                xref.erase(xref.lower_bound(xkey), xref.lower_bound(xlast));
+
+                // 自首个节点开始的区间（切分删除的路径）
+                xrbtree_erase_range(xmtree_ptr,
+                                    xrbtree_begin(xmtree_ptr),
+                                    xrbtree_lower_bound(xmtree_ptr, &xkey));
+                xmref.erase(xmref.begin(), xmref.lower_bound(xkey));
+            }
+            break;
+
+        case 6:
+            if (!xref.empty())
+            {
+                x_rbnode_iter xiter = xrbtree_pop_min(xtree_ptr);
+                XCHECK(xrbtree_iter_int(xiter) == *xref.begin());
+                XCHECK(xrbtree_iter_is_undocked(xiter));
+                xrbtree_node_release(xtree_ptr, xiter);
+                xref.erase(xref.begin());
+            }
+            break;
+
+        default:
+            if (!xref.empty())
+            {
+                x_rbnode_iter xiter = xrbtree_pop_max(xtree_ptr);
+                XCHECK(xrbtree_iter_int(xiter) == *xref.rbegin());
+                xrbtree_node_release(xtree_ptr, xiter);
+                xref.erase(--xref.end());
+            }
+            break;
+        }
+
+        if (0 == (i % 1000))
+        {
+            xcheck_tree(xtree_ptr);
+            xcheck_tree(xmtree_ptr);
+            XCHECK(xcheck_equal(xtree_ptr, xref));
+            XCHECK(xcheck_equal(xmtree_ptr, xmref));
+        }
+    }
+
+    xcheck_tree(xtree_ptr);
+    xcheck_tree(xmtree_ptr);
+    XCHECK(xcheck_equal(xtree_ptr, xref));
+    XCHECK(xcheck_equal(xmtree_ptr, xmref));
+
+    xrbtree_destroy(xtree_ptr);
+    xrbtree_destroy(xmtree_ptr);
+}
+
+static int xcheck_vcopy     = 0;
+static int xcheck_vdestruct = 0;
+
+static xrbt_void_t xcheck_vcopyfrom(xrbt_vkey_t xrbt_dval,
+                                    xrbt_vkey_t xrbt_sval,
+                                    xrbt_size_t xrbt_size,
+                                    xrbt_bool_t xbt_move,
+                                    xrbt_ctxt_t xrbt_ctxt)
+{
+    xcheck_vcopy += 1;
+    if (XRBT_NULL != xrbt_sval)
+        memcpy(xrbt_dval, xrbt_sval, xrbt_size);
+    else
+        memset(xrbt_dval, 0, xrbt_size);
+}
+
+static xrbt_void_t xcheck_vdestructor(xrbt_vkey_t xrbt_vval,
+                                      xrbt_size_t xrbt_size,
+                                      xrbt_ctxt_t xrbt_ctxt)
+{
+    xcheck_vdestruct += 1;
+}
+
+/**
+ * @brief 映射表模式：值数据存放在索引键之后的对齐位置；
+ *        try_emplace 不改动已有节点，insert_or_assign 先析构再拷贝以覆盖值数据。
+ */
+void test_check_map_mode(void)
+{
+    xrbt_vcallback_t xvcallback = { &xcheck_vcopyfrom, &xcheck_vdestructor };
+    xrbt_bool_t      xbt_ok     = XRBT_FALSE;
+    x_rbnode_iter    xiter      = XRBT_NULL;
+    double           xdbl_val   = 0.0;
+    int              xkey       = 0;
+
+    xcheck_vcopy     = 0;
+    xcheck_vdestruct = 0;
+
+    x_rbtree_ptr xtree_ptr = xrbtree_create_ex(
+                        sizeof(int), sizeof(double), 0, &xcheck_callback, &xvcallback);
+
+    for (xkey = 0; xkey < 1000; ++xkey)
+    {
+        xdbl_val = xkey * 0.5;
+        xiter = xrbtree_try_emplace(xtree_ptr, &xkey, &xdbl_val, &xbt_ok);
+        XCHECK(xbt_ok && (xrbtree_iter_int(xiter) == xkey));
+
+        // int 索引键占 4 字节，值数据位于其后按 8 字节对齐的位置，不与索引键重叠
+        xrbt_byte_t * xbt_vkey = (xrbt_byte_t *)xrbtree_iter_vkey(xiter);
+        xrbt_byte_t * xbt_vval = (xrbt_byte_t *)xrbtree_iter_value(xiter);
+        XCHECK(xbt_vval - xbt_vkey == 8);
+        XCHECK(0 == ((size_t)xbt_vval % 8));
+    }
+    XCHECK((1000 == xcheck_vcopy) && (0 == xcheck_vdestruct));
+
+    // try_emplace：索引键已存在时，不回调任何值数据操作，值数据保持不变
+    xkey     = 10;
+    xdbl_val = -1.0;
+    xiter = xrbtree_try_emplace(xtree_ptr, &xkey, &xdbl_val, &xbt_ok);
+    XCHECK(!xbt_ok && (*(double *)xrbtree_iter_value(xiter) == 5.0));
+    XCHECK((1000 == xcheck_vcopy) && (0 == xcheck_vdestruct));
+
+    // insert_or_assign：索引键已存在时，先析构再拷贝，索引键保持不变
+    xiter = xrbtree_insert_or_assign(xtree_ptr, &xkey, &xdbl_val, &xbt_ok);
+    XCHECK(!xbt_ok && (*(double *)xrbtree_iter_value(xiter) == -1.0));
+    XCHECK(xrbtree_iter_int(xiter) == 10);
+    XCHECK((1001 == xcheck_vcopy) && (1 == xcheck_vdestruct));
+    XCHECK(xrbtree_size(xtree_ptr) == 1000);
+
+    // insert_or_assign 插入新节点；try_emplace 的值数据为 XRBT_NULL 时按默认值构造
+    xkey = 2000;
+    xiter = xrbtree_insert_or_assign(xtree_ptr, &xkey, &xdbl_val, &xbt_ok);
+    XCHECK(xbt_ok && (*(double *)xrbtree_iter_value(xiter) == -1.0));
+    xkey = 2001;
+    xiter = xrbtree_try_emplace(xtree_ptr, &xkey, XRBT_NULL, &xbt_ok);
+    XCHECK(xbt_ok && (*(double *)xrbtree_iter_value(xiter) == 0.0));
+    XCHECK(xrbtree_size(xtree_ptr) == 1002);
+    xcheck_tree(xtree_ptr);
+
+    // 销毁时析构全部值数据
+    xrbtree_destroy(xtree_ptr);
+    XCHECK(xcheck_vdestruct == 1 + 1002);
+}
+
+static int xcheck_upsert_init  = 0;
+static int xcheck_upsert_merge = 0;
+
+static xrbt_void_t xcheck_upsert_on_init(x_rbnode_iter xiter_node,
+                                         xrbt_vkey_t xrbt_vkey,
+                                         xrbt_ctxt_t xrbt_ctxt)
+{
+    xcheck_upsert_init += 1;
+    *(int *)xrbtree_iter_value(xiter_node) = 1;
+}
+
+static xrbt_void_t xcheck_upsert_on_merge(x_rbnode_iter xiter_node,
+                                          xrbt_vkey_t xrbt_vkey,
+                                          xrbt_ctxt_t xrbt_ctxt)
+{
+    xcheck_upsert_merge += 1;
+    *(int *)xrbtree_iter_value(xiter_node) += *(int *)xrbt_ctxt;
+}
+
+/**
+ * @brief upsert：索引键不存在时插入新节点并回调 初始化 操作，
+ *        已存在时在原节点上回调 合并 操作（节点不变，其他节点不受影响）。
+ */
+void test_check_upsert(void)
+{
+    std::mt19937 xrand(27);
+    std::map< int, int > xref;
+
+    int xit_step = 1;
+    x_rbtree_ptr xtree_ptr = xrbtree_create_ex(
+                        sizeof(int), sizeof(int), 0, &xcheck_callback, XRBT_NULL);
+
+    xcheck_upsert_init  = 0;
+    xcheck_upsert_merge = 0;
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        int xkey = (int)(xrand() % 3000);
+        x_rbnode_iter xiter_old = xrbtree_find(xtree_ptr, &xkey);
+
+        x_rbnode_iter xiter = xrbtree_upsert(xtree_ptr, &xkey,
+                                             &xcheck_upsert_on_init,
+                                             &xcheck_upsert_on_merge,
+                                             &xit_step);
+        XCHECK(xrbtree_iter_int(xiter) == xkey);
+        if (xiter_old != xrbtree_end(xtree_ptr))
+            XCHECK(xiter == xiter_old);
+
+        xref[xkey] += 1;
+        XCHECK(*(int *)xrbtree_iter_value(xiter) == xref[xkey]);
+    }
+
+    XCHECK(xcheck_upsert_init == (int)xref.size());
+    XCHECK(xcheck_upsert_init + xcheck_upsert_merge == 20000);
+    XCHECK(xrbtree_size(xtree_ptr) == xref.size());
+    xcheck_tree(xtree_ptr);
+
+    // 回调为 XRBT_NULL 时，只完成 插入/定位（新节点的值数据按默认值构造）
+    int xkey = 5000;
+    x_rbnode_iter xiter = xrbtree_upsert(xtree_ptr, &xkey, XRBT_NULL, XRBT_NULL, XRBT_NULL);
+    XCHECK((xrbtree_iter_int(xiter) == 5000) && (0 == *(int *)xrbtree_iter_value(xiter)));
+    XCHECK(xiter == xrbtree_upsert(xtree_ptr, &xkey, XRBT_NULL, XRBT_NULL, XRBT_NULL));
+    XCHECK(xrbtree_size(xtree_ptr) == xref.size() + 1);
+
+    xrbtree_destroy(xtree_ptr);
+}
+
+/**
+ * @brief 多键模式下的重复索引键：相等的节点按插入顺序排列，
+ *        equal_range/count/erase_equal 与 std::multimap 一致。
+ */
+void test_check_multi_equal(void)
+{
+    std::mt19937 xrand(28);
+    std::multimap< int, int > xref;
+
+    x_rbtree_ptr xtree_ptr = xrbtree_create_ex(
+                        sizeof(int), sizeof(int), XRBT_FLAG_MULTI, &xcheck_callback, XRBT_NULL);
+
+    // 值数据记录插入的序号
+    for (int xseq = 0; xseq < 10000; ++xseq)
+    {
+        int xkey = (int)(xrand() % 200);
+        xrbt_bool_t xbt_ok = XRBT_FALSE;
+        xrbtree_try_emplace(xtree_ptr, &xkey, &xseq, &xbt_ok);
+        XCHECK(xbt_ok);
+        xref.insert(std::make_pair(xkey, xseq));
+    }
+
+    for (int xkey = -1; xkey <= 200; ++xkey)
+    {
+        x_rbnode_iter xiter_lower = XRBT_NULL;
+        x_rbnode_iter xiter_upper = XRBT_NULL;
+        xrbtree_equal_range(xtree_ptr, &xkey, &xiter_lower, &xiter_upper);
+        XCHECK(xiter_lower == xrbtree_lower_bound(xtree_ptr, &xkey));
+        XCHECK(xiter_upper == xrbtree_upper_bound(xtree_ptr, &xkey));
+        XCHECK(xrbtree_count(xtree_ptr, &xkey) == xref.count(xkey));
+
+        // 相等的节点位于区间之内，且按插入顺序（序号递增）排列
+        std::pair< std::multimap< int, int >::iterator,
+                   std::multimap< int, int >::iterator > xref_range = xref.equal_range(xkey);
+        x_rbnode_iter xiter = xiter_lower;
+        for (; xref_range.first != xref_range.second; ++xref_range.first)
+        {
+            XCHECK(xiter != xiter_upper);
+            if (xiter == xiter_upper)
+                break;
+            XCHECK(xrbtree_iter_int(xiter) == xkey);
+            XCHECK(*(int *)xrbtree_iter_value(xiter) == xref_range.first->second);
+            xiter = xrbtree_next(xiter);
+        }
+        XCHECK(xiter == xiter_upper);
+    }
+
+    // 删除部分索引键的全部重复节点，其余节点及其顺序不变
+    for (int xkey = 0; xkey < 200; xkey += 3)
+    {
+        XCHECK(xrbtree_erase_equal(xtree_ptr, &xkey) == xref.erase(xkey));
+        XCHECK(0 == xrbtree_count(xtree_ptr, &xkey));
+        XCHECK(xrbtree_find(xtree_ptr, &xkey) == xrbtree_end(xtree_ptr));
+    }
+    xcheck_tree(xtree_ptr);
+
+    XCHECK(xrbtree_size(xtree_ptr) == xref.size());
+    std::multimap< int, int >::iterator xref_iter = xref.begin();
+    for (x_rbnode_iter xiter = xrbtree_begin(xtree_ptr);
+         (xiter != xrbtree_end(xtree_ptr)) && (xref_iter != xref.end());
+         xiter = xrbtree_next(xiter), ++xref_iter)
+    {
+        XCHECK(xrbtree_iter_int(xiter) == xref_iter->first);
+        XCHECK(*(int *)xrbtree_iter_value(xiter) == xref_iter->second);
+    }
+
+    xrbtree_destroy(xtree_ptr);
+}
+
+static xrbt_int32_t xcheck_probe_compare(xrbt_vkey_t xrbt_probe,
+                                         xrbt_vkey_t xrbt_vkey,
+                                         xrbt_size_t xrbt_size,
+                                         xrbt_ctxt_t xrbt_ctxt)
+{
+    double xdbl_probe = *(double *)xrbt_probe;
+    int    xit_key    = *(int *)xrbt_vkey;
+    return (xdbl_probe < xit_key) ? -1 : ((xdbl_probe > xit_key) ? 1 : 0);
+}
+
+/**
+ * @brief 异构查找（以 double 探测 int 索引键）与同构查找的结果一致（唯一键、多键 两种模式）；
+ *        位于两个索引键之间的探测值，find_with 返回 end，上下界均为其后的首个节点。
+ */
+void test_check_probe(void)
+{
+    std::mt19937 xrand(29);
+
+    x_rbtree_ptr xtree_ptr  = xrbtree_create(sizeof(int), &xcheck_callback);
+    x_rbtree_ptr xmtree_ptr = xrbtree_create_ex(
+                        sizeof(int), 0, XRBT_FLAG_MULTI, &xcheck_callback, XRBT_NULL);
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        int xkey = (int)(xrand() % 1000) * 2;
+        xrbtree_insert(xtree_ptr , &xkey, XRBT_NULL);
+        xrbtree_insert(xmtree_ptr, &xkey, XRBT_NULL);
+    }
+
+    x_rbtree_ptr xtrees[2] = { xtree_ptr, xmtree_ptr };
+    for (int t = 0; t < 2; ++t)
+    {
+        x_rbtree_ptr xthis_ptr = xtrees[t];
+        for (int xkey = -3; xkey <= 2003; ++xkey)
+        {
+            double xdbl_probe = xkey;
+            XCHECK(xrbtree_find_with(xthis_ptr, &xdbl_probe, &xcheck_probe_compare, XRBT_NULL) ==
+                   xrbtree_find(xthis_ptr, &xkey));
+            XCHECK(xrbtree_lower_bound_with(xthis_ptr, &xdbl_probe, &xcheck_probe_compare, XRBT_NULL) ==
+                   xrbtree_lower_bound(xthis_ptr, &xkey));
+            XCHECK(xrbtree_upper_bound_with(xthis_ptr, &xdbl_probe, &xcheck_probe_compare, XRBT_NULL) ==
+                   xrbtree_upper_bound(xthis_ptr, &xkey));
+
+            // 不对应任何索引键的探测值
+            int xnext = xkey + 1;
+            xdbl_probe = xkey + 0.5;
+            XCHECK(xrbtree_find_with(xthis_ptr, &xdbl_probe, &xcheck_probe_compare, XRBT_NULL) ==
+                   xrbtree_end(xthis_ptr));
+            XCHECK(xrbtree_lower_bound_with(xthis_ptr, &xdbl_probe, &xcheck_probe_compare, XRBT_NULL) ==
+                   xrbtree_lower_bound(xthis_ptr, &xnext));
+            XCHECK(xrbtree_upper_bound_with(xthis_ptr, &xdbl_probe, &xcheck_probe_compare, XRBT_NULL) ==
+                   xrbtree_lower_bound(xthis_ptr, &xnext));
+        }
+    }
+
+    // 多键模式下，find_with 返回相等节点中的首个（与 lower_bound 一致）
+    for (int xkey = 0; xkey < 2000; xkey += 2)
+    {
+        double xdbl_probe = xkey;
+        x_rbnode_iter xiter = xrbtree_find_with(xmtree_ptr, &xdbl_probe, &xcheck_probe_compare, XRBT_NULL);
+        if (xiter != xrbtree_end(xmtree_ptr))
+            XCHECK(xiter == xrbtree_lower_bound(xmtree_ptr, &xkey));
+    }
+
+    xrbtree_destroy(xtree_ptr);
+    xrbtree_destroy(xmtree_ptr);
+}
+
+/**
+ * @brief 记录 构造/拷贝 次数的非平凡索引键（用于检查就地构造）。
+ */
+struct xcheck_ekey_t
+{
+    static int xit_live;
+    static int xit_copies;
+
+    std::string xstr;
+
+    xcheck_ekey_t(size_t xst_count, char xch) : xstr(xst_count, xch) { ++xit_live; }
+    xcheck_ekey_t(const xcheck_ekey_t & xother) : xstr(xother.xstr) { ++xit_live; ++xit_copies; }
+    xcheck_ekey_t(xcheck_ekey_t && xother) : xstr(std::move(xother.xstr)) { ++xit_live; ++xit_copies; }
+    ~xcheck_ekey_t(void) { --xit_live; }
+
+    bool operator < (const xcheck_ekey_t & xother) const { return (xstr < xother.xstr); }
+};
+
+int xcheck_ekey_t::xit_live   = 0;
+int xcheck_ekey_t::xit_copies = 0;
+
+static bool xcheck_alloc_fail = false;
+
+static xrbt_void_t * xcheck_failing_memalloc(xrbt_vkey_t xrbt_vkey,
+                                             xrbt_size_t xst_nsize,
+                                             xrbt_ctxt_t xrbt_ctxt)
+{
+    return xcheck_alloc_fail ? XRBT_NULL : xalloc_memalloc(xrbt_vkey, xst_nsize, xrbt_ctxt);
+}
+
+/**
+ * @brief xrbtree_emplace_k()：在节点中就地构造非平凡的索引键（不产生 拷贝/移动），
+ *        冲突时析构已构造的索引键；申请失败 及 不适用的模式 返回 end 。
+ */
+void test_check_emplace(void)
+{
+    xrbt_callback_t xcallback = xrbtree_default_callback< xcheck_ekey_t >();
+    xcallback.xfunc_n_memalloc = &xcheck_failing_memalloc;
+    xcallback.xfunc_n_memfree  = &xalloc_memfree;
+
+    xcheck_ekey_t::xit_live   = 0;
+    xcheck_ekey_t::xit_copies = 0;
+
+    x_rbtree_ptr xtree_ptr = xrbtree_create(sizeof(xcheck_ekey_t), &xcallback);
+    std::pair< x_rbnode_iter, xrbt_bool_t > xret;
+
+    // 申请节点失败：不构造索引键，红黑树不变
+    xcheck_alloc_fail = true;
+    xret = xrbtree_emplace_k< xcheck_ekey_t >(xtree_ptr, (size_t)3, 'a');
+    xcheck_alloc_fail = false;
+    XCHECK((xret.first == xrbtree_end(xtree_ptr)) && !xret.second);
+    XCHECK((0 == xcheck_ekey_t::xit_live) && xrbtree_empty(xtree_ptr));
+
+    for (int i = 1; i <= 40; ++i)
+    {
+        xret = xrbtree_emplace_k< xcheck_ekey_t >(xtree_ptr, (size_t)i, (char)('a' + (i % 7)));
+        XCHECK(xret.second);
+        XCHECK(xrbtree_ikey_k< xcheck_ekey_t >(xret.first).xstr == std::string((size_t)i, (char)('a' + (i % 7))));
+    }
+    XCHECK((40 == xcheck_ekey_t::xit_live) && (0 == xcheck_ekey_t::xit_copies));
+
+    // 冲突：返回已有节点，新构造的索引键被析构
+    x_rbnode_iter xiter_old = xrbtree_find_k(xtree_ptr, xcheck_ekey_t(5, 'f'));
+    xret = xrbtree_emplace_k< xcheck_ekey_t >(xtree_ptr, (size_t)5, 'f');
+    XCHECK(!xret.second && (xret.first == xiter_old));
+    XCHECK((40 == xcheck_ekey_t::xit_live) && (0 == xcheck_ekey_t::xit_copies));
+    XCHECK(40 == xrbtree_size(xtree_ptr));
+
+    xrbtree_destroy(xtree_ptr);
+    XCHECK(0 == xcheck_ekey_t::xit_live);
+
+    // 映射表模式：值数据不会被构造，直接返回 end
+    xrbt_vcallback_t xvcallback = xrbtree_default_vcallback< int >();
+    xtree_ptr = xrbtree_create_ex(sizeof(xcheck_ekey_t), sizeof(int), 0, &xcallback, &xvcallback);
+    xret = xrbtree_emplace_k< xcheck_ekey_t >(xtree_ptr, (size_t)3, 'a');
+    XCHECK((xret.first == xrbtree_end(xtree_ptr)) && !xret.second);
+    XCHECK((0 == xcheck_ekey_t::xit_live) && xrbtree_empty(xtree_ptr));
+    xrbtree_destroy(xtree_ptr);
+}
+
+/**
+ * @brief 借用索引键模式：索引键所在的缓存整体移动后，以 xrbtree_rebase_keys() 重定位，
+ *        原缓存被改写、释放后，红黑树依然有效；区域之外借用的索引键不受影响。
+ */
+void test_check_borrow_rebase(void)
+{
+    xrbt_callback_t xcallback = xcheck_callback;
+    xcallback.xfunc_k_copyfrom = XRBT_NULL;
+
+    std::mt19937 xrand(31);
+    std::set< int > xref;
+    std::vector< int > xkeys(4000);
+    int xother[3] = { -100, 50001, 50003 };
+
+    x_rbtree_ptr xtree_ptr = xrbtree_create_ex(
+                        sizeof(int), 0, XRBT_FLAG_BORROW, &xcallback, XRBT_NULL);
+
+    xrbt_size_t xst_borrowed = 0;
+    for (size_t i = 0; i < xkeys.size(); ++i)
+    {
+        xrbt_bool_t xbt_ok = XRBT_FALSE;
+        xkeys[i] = (int)(xrand() % 50000);
+        x_rbnode_iter xiter = xrbtree_insert(xtree_ptr, &xkeys[i], &xbt_ok);
+        XCHECK(xbt_ok == (xrbt_bool_t)xref.insert(xkeys[i]).second);
+        if (xbt_ok)
+        {
+            XCHECK(xrbtree_iter_vkey(xiter) == &xkeys[i]);
+            xst_borrowed += 1;
+        }
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        xrbtree_insert(xtree_ptr, &xother[i], XRBT_NULL);
+        xref.insert(xother[i]);
+    }
+
+    // 索引键缓存整体移动：重定位后改写并释放原缓存
+    std::vector< int > xmoved(xkeys);
+    XCHECK(xst_borrowed == xrbtree_rebase_keys(xtree_ptr,
+                                               &xkeys[0], &xkeys[0] + xkeys.size(),
+                                               &xmoved[0]));
+    memset(&xkeys[0], 0xEE, xkeys.size() * sizeof(int));
+    std::vector< int >().swap(xkeys);
+
+    xcheck_tree(xtree_ptr);
+    XCHECK(xcheck_equal(xtree_ptr, xref));
+    for (x_rbnode_iter xiter = xrbtree_begin(xtree_ptr);
+         xiter != xrbtree_end(xtree_ptr);
+         xiter = xrbtree_next(xiter))
+    {
+        int * xkey_ptr = (int *)xrbtree_iter_vkey(xiter);
+        XCHECK(((xkey_ptr >= &xmoved[0]) && (xkey_ptr < &xmoved[0] + xmoved.size())) ||
+               ((xkey_ptr >= &xother[0]) && (xkey_ptr < &xother[0] + 3)));
+    }
+    for (size_t i = 0; i < xmoved.size(); ++i)
+        XCHECK(xrbtree_find(xtree_ptr, &xmoved[i]) != xrbtree_end(xtree_ptr));
+    XCHECK(xrbtree_iter_vkey(xrbtree_find(xtree_ptr, &xother[1])) == &xother[1]);
+
+    // 不在区域内的指针不被重定位
+    XCHECK(0 == xrbtree_rebase_keys(xtree_ptr, &xother[1], &xother[1], &xother[2]));
+
+    xrbtree_destroy(xtree_ptr);
+}
+
+static int xcheck_bytes_compares = 0;
+
+static xrbt_bool_t xcheck_bytes_compare(xrbt_vkey_t xrbt_lkey,
+                                        xrbt_vkey_t xrbt_rkey,
+                                        xrbt_size_t xrbt_size,
+                                        xrbt_ctxt_t xrbt_ctxt)
+{
+    xcheck_bytes_compares += 1;
+    return (memcmp(xrbt_lkey, xrbt_rkey, xrbt_size) < 0);
+}
+
+/**
+ * @brief 拷贝模式下的前缀值缓存：前缀（前 8 字节）相同、只在其后不同的索引键，
+ *        依然由完整的比较操作区分；std::string 索引键中 不足 8 字节/含 '\0' 的情况。
+ */
+void test_check_prefix_cache(void)
+{
+    const size_t XKEY_SIZE = 16;
+
+    xrbt_callback_t xcallback = xcheck_callback;
+    xcallback.xfunc_k_copyfrom = XRBT_NULL;
+    xcallback.xfunc_k_compare  = &xcheck_bytes_compare;
+
+    std::mt19937 xrand(32);
+    std::set< std::string > xref;
+
+    x_rbtree_ptr xtree_ptr = xrbtree_create(XKEY_SIZE, &xcallback);
+    XCHECK(xrbtree_set_key_hints(xtree_ptr, &xrbtree_vkey_prefix_bytes, XRBT_NULL));
+
+    // 大部分索引键的前 10 字节相同（前缀值全部相等），少量索引键在前 8 字节内即不同
+    for (int i = 0; i < 6000; ++i)
+    {
+        char xkey[16];
+        memcpy(xkey, (0 == (i % 5)) ? "shared-Pfx" : "shared-pfx", 10);
+        if (0 == (i % 11))
+            xkey[i % 8] = (char)(xrand() % 256);
+        for (size_t j = 10; j < XKEY_SIZE; ++j)
+            xkey[j] = (char)(xrand() % 4);
+
+        xrbt_bool_t xbt_ok = XRBT_FALSE;
+        xrbtree_insert(xtree_ptr, xkey, &xbt_ok);
+        XCHECK(xbt_ok == (xrbt_bool_t)xref.insert(std::string(xkey, XKEY_SIZE)).second);
+    }
+
+    XCHECK(xrbtree_size(xtree_ptr) == xref.size());
+    std::set< std::string >::iterator xref_iter = xref.begin();
+    for (x_rbnode_iter xiter = xrbtree_begin(xtree_ptr);
+         (xiter != xrbtree_end(xtree_ptr)) && (xref_iter != xref.end());
+         xiter = xrbtree_next(xiter), ++xref_iter)
+    {
+        XCHECK(0 == memcmp(xrbtree_iter_vkey(xiter), xref_iter->data(), XKEY_SIZE));
+    }
+
+    // 前缀值相等时，查找须回调完整的比较操作，且结果正确
+    for (xref_iter = xref.begin(); xref_iter != xref.end(); ++xref_iter)
+    {
+        std::string xkey = *xref_iter;
+        xcheck_bytes_compares = 0;
+        x_rbnode_iter xiter = xrbtree_find(xtree_ptr, (xrbt_vkey_t)xkey.data());
+        XCHECK((xiter != xrbtree_end(xtree_ptr)) &&
+               (0 == memcmp(xrbtree_iter_vkey(xiter), xkey.data(), XKEY_SIZE)));
+        if (0 == xkey.compare(0, 10, "shared-pfx"))
+            XCHECK(xcheck_bytes_compares > 0);
+
+        xkey[XKEY_SIZE - 1] = (char)0x7F;
+        XCHECK(xref.count(xkey) == xrbtree_count(xtree_ptr, (xrbt_vkey_t)xkey.data()));
+    }
+
+    for (int i = 0; i < 200; ++i)
+    {
+        std::string xkey = *xref.begin();
+        XCHECK(xrbtree_erase_vkey(xtree_ptr, (xrbt_vkey_t)xkey.data()));
+        xref.erase(xref.begin());
+    }
+    XCHECK(xrbtree_size(xtree_ptr) == xref.size());
+    XCHECK(0 == memcmp(xrbtree_iter_vkey(xrbtree_begin(xtree_ptr)), xref.begin()->data(), XKEY_SIZE));
+    xrbtree_destroy(xtree_ptr);
+
+    // std::string：不足 8 字节时补 0，与 含 '\0' 的索引键前缀值相同
+    xrbt_callback_t xscallback = xrbtree_default_callback< std::string >();
+    x_rbtree_ptr xstree_ptr = xrbtree_create(sizeof(std::string), &xscallback);
+    XCHECK(xrbtree_set_key_hints(xstree_ptr, &xrbtree_vkey_prefix_string< std::string >, XRBT_NULL));
+
+    const std::string xstrs[] =
+    {
+        std::string("ab"), std::string("ab\0", 3), std::string("ab\0\0\0\0\0\0z", 9),
+        std::string("ab\0\0\0\0\0\0", 8), std::string("abcdefgh"), std::string("abcdefgh-2"),
+        std::string("abcdefgh-1"), std::string(""), std::string("a")
+    };
+    std::set< std::string > xsref(xstrs, xstrs + sizeof(xstrs) / sizeof(xstrs[0]));
+    for (size_t i = 0; i < sizeof(xstrs) / sizeof(xstrs[0]); ++i)
+        xrbtree_insert_k(xstree_ptr, xstrs[i]);
+
+    XCHECK(xrbtree_size(xstree_ptr) == xsref.size());
+    xref_iter = xsref.begin();
+    for (x_rbnode_iter xiter = xrbtree_begin(xstree_ptr);
+         (xiter != xrbtree_end(xstree_ptr)) && (xref_iter != xsref.end());
+         xiter = xrbtree_next(xiter), ++xref_iter)
+    {
+        XCHECK(xrbtree_ikey_k< std::string >(xiter) == *xref_iter);
+        XCHECK(xrbtree_find_k(xstree_ptr, *xref_iter) == xiter);
+    }
+
+    xrbtree_destroy(xstree_ptr);
+}
+
+/**
+ * @brief 侵入模式的测试对象：同时位于两棵红黑树中（按 xit_key 唯一，按 xit_prio 多键）。
+ */
+struct xcheck_item_t
+{
+    int             xit_key;
+    x_rbtree_link_t xlink_key;
+    x_rbtree_link_t xlink_prio;
+    int             xit_prio;
+};
+
+/**
+ * @brief 侵入模式：停靠/分离 调用方的对象，红黑树不申请、不释放任何内存，
+ *        清除/销毁 时只将链接头置为分离状态，对象可再次停靠。
+ */
+void test_check_intrusive(void)
+{
+    std::mt19937 xrand(41);
+    std::set< int >      xref;
+    std::multiset< int > xpref;
+    std::vector< xcheck_item_t > xitems(3000);
+    long long xalloc_base = xalloc_count;
+
+    x_rbtree_ptr xtree_ptr = xrbtree_create_intrusive(
+        sizeof(int), XRBT_LINK_KOFFSET(xcheck_item_t, xlink_key, xit_key), 0, &xcheck_callback);
+    x_rbtree_ptr xptree_ptr = xrbtree_create_intrusive(
+        sizeof(int), XRBT_LINK_KOFFSET(xcheck_item_t, xlink_prio, xit_prio),
+        XRBT_FLAG_MULTI, &xcheck_callback);
+
+    memset(&xitems[0], 0, xitems.size() * sizeof(xcheck_item_t));
+    for (size_t i = 0; i < xitems.size(); ++i)
+    {
+        xcheck_item_t & xitem = xitems[i];
+        xitem.xit_key  = (int)(xrand() % 5000);
+        xitem.xit_prio = (int)(xrand() % 16);
+
+        // 索引键冲突时返回已有对象的链接头，新对象的链接头保持分离状态
+        x_rbnode_iter xiter = xrbtree_dock(xtree_ptr, XRBT_LINK_ITER(&xitem.xlink_key));
+        XCHECK((xiter == XRBT_LINK_ITER(&xitem.xlink_key)) == xref.insert(xitem.xit_key).second);
+        if (xiter != XRBT_LINK_ITER(&xitem.xlink_key))
+        {
+            XCHECK(xrbtree_iter_is_undocked(XRBT_LINK_ITER(&xitem.xlink_key)));
+            XCHECK(XRBT_CONTAINER_OF(xiter, xcheck_item_t, xlink_key)->xit_key == xitem.xit_key);
+        }
+
+        XCHECK(xrbtree_dock(xptree_ptr, XRBT_LINK_ITER(&xitem.xlink_prio)) ==
+               XRBT_LINK_ITER(&xitem.xlink_prio));
+        xpref.insert(xitem.xit_prio);
+    }
+    XCHECK(xalloc_count == xalloc_base);
+    xcheck_tree(xtree_ptr);
+    xcheck_tree(xptree_ptr);
+    XCHECK(xcheck_equal(xtree_ptr, xref));
+    XCHECK(xcheck_equal(xptree_ptr, xpref));
+
+    // 由节点取得调用方对象，两棵树中的链接头属于同一对象
+    int xkey = *xref.begin();
+    x_rbnode_iter xiter = xrbtree_find(xtree_ptr, &xkey);
+    xcheck_item_t * xitem_ptr = XRBT_CONTAINER_OF(xiter, xcheck_item_t, xlink_key);
+    XCHECK((xitem_ptr >= &xitems[0]) && (xitem_ptr < &xitems[0] + xitems.size()));
+    XCHECK(xitem_ptr->xit_key == xkey);
+    XCHECK(!xrbtree_iter_is_undocked(XRBT_LINK_ITER(&xitem_ptr->xlink_prio)));
+
+    // 分离一部分对象（删除操作等同于分离），对象的内容不变，可再次停靠
+    for (size_t i = 0; i < xitems.size(); i += 3)
+    {
+        xcheck_item_t & xitem = xitems[i];
+        if (xrbtree_iter_is_undocked(XRBT_LINK_ITER(&xitem.xlink_key)))
+            continue;
+        xrbtree_erase(xtree_ptr, XRBT_LINK_ITER(&xitem.xlink_key));
+        XCHECK(xrbtree_iter_is_undocked(XRBT_LINK_ITER(&xitem.xlink_key)));
+        xref.erase(xitem.xit_key);
+    }
+    for (size_t i = 0; i < xitems.size(); i += 6)
+    {
+        xcheck_item_t & xitem = xitems[i];
+        if (!xrbtree_iter_is_undocked(XRBT_LINK_ITER(&xitem.xlink_key)))
+            continue;
+        if (xrbtree_dock(xtree_ptr, XRBT_LINK_ITER(&xitem.xlink_key)) == XRBT_LINK_ITER(&xitem.xlink_key))
+            xref.insert(xitem.xit_key);
+    }
+    xrbtree_undock(xptree_ptr, XRBT_LINK_ITER(&xitems[1].xlink_prio));
+    xpref.erase(xpref.find(xitems[1].xit_prio));
+    xcheck_tree(xtree_ptr);
+    XCHECK(xcheck_equal(xtree_ptr, xref));
+    XCHECK(xcheck_equal(xptree_ptr, xpref));
+
+    // 清除、销毁 只将链接头置为分离状态，不释放调用方对象
+    xrbtree_clear(xptree_ptr);
+    xrbtree_destroy(xtree_ptr);
+    XCHECK(xalloc_count == xalloc_base);
+    for (size_t i = 0; i < xitems.size(); ++i)
+    {
+        XCHECK(xrbtree_iter_is_undocked(XRBT_LINK_ITER(&xitems[i].xlink_key )));
+        XCHECK(xrbtree_iter_is_undocked(XRBT_LINK_ITER(&xitems[i].xlink_prio)));
+    }
+
+    for (size_t i = 0; i < xitems.size(); ++i)
+        xrbtree_dock(xptree_ptr, XRBT_LINK_ITER(&xitems[i].xlink_prio));
+    XCHECK(xrbtree_size(xptree_ptr) == xitems.size());
+    xcheck_tree(xptree_ptr);
+    xrbtree_destroy(xptree_ptr);
+}
+
+/**
+ * @brief 内存中的序列化数据流。
+ */
+struct xcheck_stream_t
+{
+    std::vector< unsigned char > xbytes;
+    size_t                       xst_rpos;
+};
+
+static xrbt_bool_t xcheck_stream_write(xrbt_ctxt_t xrbt_ctxt,
+                                       const xrbt_void_t * xmt_data,
+                                       xrbt_size_t xst_size)
+{
+    xcheck_stream_t * xstream = (xcheck_stream_t *)xrbt_ctxt;
+    const unsigned char * xbt_data = (const unsigned char *)xmt_data;
+    xstream->xbytes.insert(xstream->xbytes.end(), xbt_data, xbt_data + xst_size);
+    return XRBT_TRUE;
+}
+
+static xrbt_size_t xcheck_stream_read(xrbt_ctxt_t xrbt_ctxt,
+                                      xrbt_void_t * xmt_buf,
+                                      xrbt_size_t xst_size)
+{
+    xcheck_stream_t * xstream = (xcheck_stream_t *)xrbt_ctxt;
+    size_t xst_left = xstream->xbytes.size() - xstream->xst_rpos;
+    if (xst_size > xst_left)
+        xst_size = (xrbt_size_t)xst_left;
+    if (xst_size > 0)
+        memcpy(xmt_buf, &xstream->xbytes[xstream->xst_rpos], xst_size);
+    xstream->xst_rpos += xst_size;
+    return xst_size;
+}
+
+static bool xcheck_load(x_rbtree_ptr xtree_ptr, const std::vector< unsigned char > & xbytes)
+{
+    xcheck_stream_t xstream;
+    xstream.xbytes   = xbytes;
+    xstream.xst_rpos = 0;
+    return (0 != xrbtree_load(xtree_ptr, &xcheck_stream_read, &xstream));
+}
+
+/**
+ * @brief 两种编码方式的 保存/加载 往返，以及截断、位翻转的输入。
+ */
+void test_check_save_load(void)
+{
+    std::mt19937 xrand(451);
+    std::set< int > xref;
+
+    x_rbtree_ptr xtree_ptr = xrbtree_create_ex(
+                        sizeof(int), sizeof(int), 0, &xcheck_callback, XRBT_NULL);
+    for (int i = 0; i < 5000; ++i)
+    {
+        int xkey = (int)(xrand() % 2000000000U) - 1000000000;
+        int xval = ~xkey;
+        if (xref.insert(xkey).second)
+            xrbtree_try_emplace(xtree_ptr, &xkey, &xval, XRBT_NULL);
+    }
+
+    const xrbt_uint32_t xencode[] = { XRBT_SAVE_RAW, XRBT_SAVE_DELTA };
+    for (size_t e = 0; e < sizeof(xencode) / sizeof(xencode[0]); ++e)
+    {
+        xcheck_stream_t xstream;
+        xstream.xst_rpos = 0;
+        XCHECK(xrbtree_save(xtree_ptr, &xcheck_stream_write, &xstream, xencode[e]));
+
+        x_rbtree_ptr xload_ptr = xrbtree_create_ex(
+                        sizeof(int), sizeof(int), 0, &xcheck_callback, XRBT_NULL);
+
+        XCHECK(xcheck_load(xload_ptr, xstream.xbytes));
+        xcheck_tree(xload_ptr);
+        XCHECK(xcheck_equal(xload_ptr, xref));
+        for (x_rbnode_iter xiter = xrbtree_begin(xload_ptr);
+             xiter != xrbtree_end(xload_ptr);
+             xiter = xrbtree_next(xiter))
+        {
+            XCHECK(*(int *)xrbtree_iter_value(xiter) == ~xrbtree_iter_int(xiter));
+        }
+
+        // 截断的输入：加载失败，且红黑树被清空
+        const size_t xcut[] = { 0, 7, 32, 40, xstream.xbytes.size() / 2, xstream.xbytes.size() - 1 };
+        for (size_t c = 0; c < sizeof(xcut) / sizeof(xcut[0]); ++c)
+        {
+            std::vector< unsigned char > xbytes(xstream.xbytes.begin(),
+                                                xstream.xbytes.begin() + xcut[c]);
+            XCHECK(!xcheck_load(xload_ptr, xbytes));
+            XCHECK(xrbtree_empty(xload_ptr));
+        }
+
+        // 位翻转的输入（头部、节点数据、校验值）：校验失败
+        for (size_t xst_pos = 0; xst_pos < xstream.xbytes.size(); xst_pos += 997)
+        {
+            std::vector< unsigned char > xbytes = xstream.xbytes;
+            xbytes[xst_pos] ^= (unsigned char)(1 << (xst_pos % 8));
+            XCHECK(!xcheck_load(xload_ptr, xbytes));
+            XCHECK(xrbtree_empty(xload_ptr));
+        }
+        {
+            std::vector< unsigned char > xbytes = xstream.xbytes;
+            xbytes.back() ^= 0x80;
+            XCHECK(!xcheck_load(xload_ptr, xbytes));
+        }
+
+        xrbtree_destroy(xload_ptr);
+    }
+
+    xrbtree_destroy(xtree_ptr);
+}
+
+/**
+ * @brief 升序、降序的批量区间扫描（含游标的分批续扫）。
+ */
+void test_check_scan(void)
+{
+    std::mt19937 xrand(452);
+    std::set< int > xref;
+
+    x_rbtree_ptr xtree_ptr = xrbtree_create(sizeof(int), &xcheck_callback);
+    for (int i = 0; i < 3000; ++i)
+    {
+        int xkey = (int)(xrand() % 10000);
+        xref.insert(xkey);
+        xrbtree_insert_int(xtree_ptr, xkey);
+    }
+
+    xrbt_vkey_t xvkey_buf[7];
+
+    for (int t = 0; t < 200; ++t)
+    {
+        int  xlower = (int)(xrand() % 11000) - 500;
+        int  xupper = xlower + (int)(xrand() % 3000);
+        bool xbt_nolower = (0 == (t % 10));
+        bool xbt_noupper = (1 == (t % 10));
+
+        std::set< int >::iterator xref_first =
+            xbt_nolower ? xref.begin() : xref.lower_bound(xlower);
+        std::set< int >::iterator xref_last =
+            xbt_noupper ? xref.end() : xref.lower_bound(xupper);
+        std::vector< int > xasc;
+        if (xbt_nolower || xbt_noupper || (xlower < xupper))
+            xasc.assign(xref_first, xref_last);
+
+        for (int d = 0; d < 2; ++d)
+        {
+            std::vector< int > xout;
+            xrbt_cursor_t      xcursor;
+            xrbt_size_t        xst_count = 0;
+
+            xrbtree_cursor_init(&xcursor, d ? XRBT_SCAN_DESC : XRBT_SCAN_ASC);
+            while (0 != (xst_count = xrbtree_scan(xtree_ptr,
+                                                  xbt_nolower ? XRBT_NULL : &xlower,
+                                                  xbt_noupper ? XRBT_NULL : &xupper,
+                                                  xvkey_buf,
+                                                  XRBT_NULL,
+                                                  1 + (t % 7),
+                                                  &xcursor)))
+            {
+                for (xrbt_size_t i = 0; i < xst_count; ++i)
+                    xout.push_back(*(int *)xvkey_buf[i]);
+            }
+
+            if (d)
+                XCHECK(std::vector< int >(xasc.rbegin(), xasc.rend()) == xout);
+            else
+                XCHECK(xasc == xout);
+        }
+    }
+
+    xrbtree_destroy(xtree_ptr);
+}
+
+/**
+ * @brief 切分的各个分段 互不相交、非空、有序，且合起来覆盖全部节点。
+ */
+void test_check_partition(void)
+{
+    const xrbt_size_t xsizes[] = { 0, 1, 2, 3, 5, 17, 100, 1000, 4097 };
+    x_rbnode_iter     xbounds[65];
+
+    for (size_t s = 0; s < sizeof(xsizes) / sizeof(xsizes[0]); ++s)
+    {
+        x_rbtree_ptr xtree_ptr = xrbtree_create(sizeof(int), &xcheck_callback);
+        for (int i = 0; i < (int)xsizes[s]; ++i)
+            xrbtree_insert_int(xtree_ptr, i * 3);
+
+        for (xrbt_size_t xst_max = 1; xst_max <= 64; ++xst_max)
+        {
+            xrbt_size_t xst_parts = xrbtree_partition(xtree_ptr, xbounds, xst_max);
+            XCHECK(xst_parts <= xst_max);
+
+            if (0 == xsizes[s])
+            {
+                XCHECK(0 == xst_parts);
+                continue;
+            }
+
+            XCHECK(xst_parts >= 1);
+            XCHECK(xbounds[0] == xrbtree_begin(xtree_ptr));
+            XCHECK(xbounds[xst_parts] == xrbtree_end(xtree_ptr));
+
+            xrbt_size_t xst_total = 0;
+            int         xit_prev  = -1;
+            for (xrbt_size_t p = 0; p < xst_parts; ++p)
+            {
+                XCHECK(xbounds[p] != xbounds[p + 1]);
+                for (x_rbnode_iter xiter = xbounds[p];
+                     xiter != xbounds[p + 1];
+                     xiter = xrbtree_next(xiter))
+                {
+                    XCHECK(xrbtree_iter_int(xiter) > xit_prev);
+                    xit_prev   = xrbtree_iter_int(xiter);
+                    xst_total += 1;
+                }
+            }
+            XCHECK(xst_total == xsizes[s]);
+        }
+
+        xrbtree_destroy(xtree_ptr);
+    }
+}
+
+/** 并行遍历的回调：累计访问的节点数量及索引键之和 */
+static xrbt_void_t xcheck_par_visit(x_rbnode_iter xiter_node, xrbt_ctxt_t xrbt_ctxt)
+{
+    std::atomic< long long > * xsums = static_cast< std::atomic< long long > * >(xrbt_ctxt);
+    xsums[0] += 1;
+    xsums[1] += xrbtree_iter_int(xiter_node);
+}
+
+/** 并行归约的部分结果：按访问顺序收集的索引键 */
+static xrbt_void_t xcheck_par_init(xrbt_void_t * xacc_ptr, xrbt_ctxt_t xrbt_ctxt)
+{
+    *static_cast< std::vector< int > ** >(xacc_ptr) = new std::vector< int >();
+}
+
+static xrbt_void_t xcheck_par_collect(xrbt_void_t * xacc_ptr,
+                                      x_rbnode_iter xiter_node,
+                                      xrbt_ctxt_t xrbt_ctxt)
+{
+    (*static_cast< std::vector< int > ** >(xacc_ptr))->push_back(xrbtree_iter_int(xiter_node));
+}
+
+/** 有序合并：xacc_from 中的索引键总是排在已合并的索引键之后（xrbt_ctxt 记录合并次数） */
+static xrbt_void_t xcheck_par_merge(xrbt_void_t * xacc_ptr,
+                                    xrbt_void_t * xacc_from,
+                                    xrbt_ctxt_t xrbt_ctxt)
+{
+    std::vector< int > * xvec_ptr  = *static_cast< std::vector< int > ** >(xacc_ptr);
+    std::vector< int > * xvec_from = *static_cast< std::vector< int > ** >(xacc_from);
+
+    if (!xvec_ptr->empty() && !xvec_from->empty())
+        XCHECK(xvec_ptr->back() < xvec_from->front());
+    xvec_ptr->insert(xvec_ptr->end(), xvec_from->begin(), xvec_from->end());
+    *static_cast< int * >(xrbt_ctxt) += 1;
+}
+
+static xrbt_void_t xcheck_par_release(xrbt_void_t * xacc_ptr, xrbt_ctxt_t xrbt_ctxt)
+{
+    delete *static_cast< std::vector< int > ** >(xacc_ptr);
+}
+
+/**
+ * @brief 并行遍历、并行归约：每个线程不足 4096 个节点时在调用线程中顺序完成；
+ *        XRBT_PAR_ORDERED 模式下，各分段的部分结果按索引键的顺序合并。
+ */
+void test_check_parallel(void)
+{
+    const int xsizes[] = { 0, 100, 4096 * 2 - 1, 4096 * 2, 4096 * 16 };
+
+    for (size_t s = 0; s < sizeof(xsizes) / sizeof(xsizes[0]); ++s)
+    {
+        x_rbtree_ptr xtree_ptr = xrbtree_create(sizeof(int), &xcheck_callback);
+        long long    xll_sum   = 0;
+        for (int i = 0; i < xsizes[s]; ++i)
+        {
+            xrbtree_insert_int(xtree_ptr, i * 3);
+            xll_sum += i * 3;
+        }
+
+        // 并行遍历：4 个线程，节点不足 4 * 4096 时按 每线程 4096 个节点 减少线程数量
+        std::atomic< long long > xsums[2];
+        xsums[0] = 0;
+        xsums[1] = 0;
+        xrbt_uint32_t xut_nused = 0;
+        XCHECK(xrbtree_parallel_for_each(xtree_ptr, &xcheck_par_visit, xsums, 4, &xut_nused) ==
+               (xrbt_size_t)xsizes[s]);
+        XCHECK((xsums[0] == xsizes[s]) && (xsums[1] == xll_sum));
+        if (xsizes[s] < 4096 * 2)
+            XCHECK(1 == xut_nused);
+        else
+            XCHECK((xut_nused >= 1) && ((int)xut_nused <= xsizes[s] / 4096) && (xut_nused <= 4));
+
+        // 有序归约：拼接的结果即为升序的全部索引键
+        int xit_merges = 0;
+        xrbt_reducer_t xreducer =
+        {
+            sizeof(std::vector< int > *),
+            &xcheck_par_init,
+            &xcheck_par_collect,
+            &xcheck_par_merge,
+            &xcheck_par_release,
+            &xit_merges
+        };
+
+        std::vector< int > * xresult = XRBT_NULL;
+        XCHECK(xrbtree_parallel_reduce(xtree_ptr, &xreducer, &xresult, 4,
+                                       XRBT_PAR_ORDERED, &xut_nused));
+        XCHECK((int)xresult->size() == xsizes[s]);
+        for (int i = 0; i < (int)xresult->size(); ++i)
+            XCHECK(i * 3 == (*xresult)[i]);
+        XCHECK((xit_merges > 1) == (xut_nused > 1));
+        if (4096 * 16 == xsizes[s])
+            XCHECK(xut_nused > 1);
+        xcheck_par_release(&xresult, XRBT_NULL);
+
+        // 1 个线程：总是顺序完成
+        xit_merges = 0;
+        XCHECK(xrbtree_parallel_reduce(xtree_ptr, &xreducer, &xresult, 1,
+                                       XRBT_PAR_ORDERED, &xut_nused));
+        XCHECK((1 == xut_nused) && ((int)xresult->size() == xsizes[s]));
+        xcheck_par_release(&xresult, XRBT_NULL);
+
+        xrbtree_destroy(xtree_ptr);
+    }
+}
+
+/**
+ * @brief 分步清除期间继续插入：新节点不受影响，全部节点最终都被释放。
+ */
+void test_check_clear_step(void)
+{
+    long long    xalloc_base = xalloc_count;
+    x_rbtree_ptr xtree_ptr   = xrbtree_create(sizeof(int), &xcheck_callback);
+    std::set< int > xref;
+
+    for (int i = 0; i < 20000; ++i)
+        xrbtree_insert_int(xtree_ptr, i);
+
+    xrbt_size_t xst_left = xrbtree_clear_step(xtree_ptr, 1);
+    XCHECK(xrbtree_empty(xtree_ptr));
+    XCHECK(xst_left > 0);
+
+    int xkey = 10000;
+    for (xrbt_size_t xst_rounds = 0; xst_left > 0; ++xst_rounds)
+    {
+        // 与待释放的节点 索引键相同，也可以正常插入
+        for (int i = 0; i < 3; ++i, xkey += 7)
+        {
+            XCHECK(xrbtree_insert_int(xtree_ptr, xkey % 20000));
+            xref.insert(xkey % 20000);
+        }
+
+        xrbt_size_t xst_next = xrbtree_clear_step(xtree_ptr, 16);
+        XCHECK(xst_next < xst_left);
+        xst_left = xst_next;
+
+        if (0 == (xst_rounds % 64))
+        {
+            xcheck_tree(xtree_ptr);
+            XCHECK(xcheck_equal(xtree_ptr, xref));
+        }
+    }
+
+    XCHECK(0 == xrbtree_clear_step(xtree_ptr, 0));
+    xcheck_tree(xtree_ptr);
+    XCHECK(xcheck_equal(xtree_ptr, xref));
+    XCHECK(xalloc_count == xalloc_base + (long long)xref.size());
+
+    xrbtree_destroy(xtree_ptr);
+    XCHECK(xalloc_count == xalloc_base);
+}
+
+/** 后台回收测试的计数（节点内存、析构回调 会在后台回收线程中调用） */
+std::atomic< long long > xasync_nodes(0);
+std::atomic< long long > xasync_destructs(0);
+
+xrbt_void_t * xasync_memalloc(xrbt_vkey_t xrbt_vkey,
+                              xrbt_size_t xst_nsize,
+                              xrbt_ctxt_t xrbt_ctxt)
+{
+    xasync_nodes += 1;
+    return malloc(xst_nsize);
+}
+
+xrbt_void_t xasync_memfree(x_rbnode_iter xrbt_node,
+                           xrbt_size_t xst_nsize,
+                           xrbt_ctxt_t xrbt_ctxt)
+{
+    xasync_nodes -= 1;
+    free(xrbt_node);
+}
+
+xrbt_void_t xasync_destruct(xrbt_vkey_t xrbt_vkey,
+                            xrbt_size_t xrbt_size,
+                            xrbt_ctxt_t xrbt_ctxt)
+{
+    xasync_destructs += 1;
+}
+
+/**
+ * @brief 后台回收：序号按提交顺序递增；xrbtree_clear_async() 返回后红黑树即可继续使用；
+ *        xrbtree_reclaim_wait() 返回前，对应（或全部）节点的析构、释放回调均已完成。
+ */
+void test_check_clear_async(void)
+{
+    xrbt_callback_t xcallback = xcheck_callback;
+    xcallback.xfunc_n_memalloc = &xasync_memalloc;
+    xcallback.xfunc_n_memfree  = &xasync_memfree;
+    xcallback.xfunc_k_destruct = &xasync_destruct;
+
+    long long    xll_nodes = xasync_nodes;
+    long long    xll_base  = xasync_destructs;
+    x_rbtree_ptr xtree_ptr = xrbtree_create(sizeof(int), &xcallback);
+    x_rbtree_ptr xtemp_ptr = xrbtree_create(sizeof(int), &xcallback);
+    std::set< int > xref;
+
+    for (int i = 0; i < 20000; ++i)
+        xrbtree_insert_int(xtree_ptr, i);
+    for (int i = 0; i < 5000; ++i)
+        xrbtree_insert_int(xtemp_ptr, i);
+
+    // 清除后立即可用：与待回收的节点 索引键相同，也可以正常插入
+    xrbt_uint64_t xu64_ticket1 = xrbtree_clear_async(xtree_ptr);
+    XCHECK(xrbtree_empty(xtree_ptr) && (xrbtree_begin(xtree_ptr) == xrbtree_end(xtree_ptr)));
+    for (int i = 0; i < 3000; i += 3)
+    {
+        XCHECK(xrbtree_insert_int(xtree_ptr, i));
+        xref.insert(i);
+    }
+    xcheck_tree(xtree_ptr);
+    XCHECK(xcheck_equal(xtree_ptr, xref));
+
+    // 序号按提交顺序递增
+    xrbt_uint64_t xu64_ticket2 = xrbtree_destroy_async(xtemp_ptr);
+    xrbt_uint64_t xu64_ticket3 = xrbtree_clear_async(xtree_ptr);
+    XCHECK((0 != xu64_ticket1) && (xu64_ticket1 < xu64_ticket2) && (xu64_ticket2 < xu64_ticket3));
+    XCHECK(xrbtree_empty(xtree_ptr));
+
+    // 等待指定序号：该序号（及之前）的回收已完成
+    xrbtree_reclaim_wait(xu64_ticket2);
+    XCHECK(xasync_destructs - xll_base >= 25000);
+
+    // 等待全部：此前提交的节点 均已析构、释放
+    xrbtree_reclaim_wait(0);
+    XCHECK(xasync_destructs - xll_base == 25000 + (long long)xref.size());
+    XCHECK(xasync_nodes == xll_nodes);
+
+    // 没有需要释放的节点时 同步完成，返回 0
+    XCHECK(0 == xrbtree_clear_async(xtree_ptr));
+
+    // 分步清除中尚未释放的节点，一并交由后台回收
+    for (int i = 0; i < 10000; ++i)
+        xrbtree_insert_int(xtree_ptr, i);
+    XCHECK(xrbtree_clear_step(xtree_ptr, 100) > 0);
+    xrbtree_insert_int(xtree_ptr, 1);
+    xrbtree_reclaim_wait(xrbtree_destroy_async(xtree_ptr));
+    XCHECK(xasync_destructs - xll_base == 35001 + (long long)xref.size());
+    XCHECK(xasync_nodes == xll_nodes);
+}
+
+/**
+ * @brief 合并、节点句柄的 分离/停靠：节点直接转移，不申请内存。
+ */
+void test_check_merge_handle(void)
+{
+    x_rbtree_ptr xdst_ptr = xrbtree_create(sizeof(int), &xcheck_callback);
+    x_rbtree_ptr xsrc_ptr = xrbtree_create(sizeof(int), &xcheck_callback);
+    std::set< int > xdst_ref;
+    std::set< int > xsrc_ref;
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        if (xrbtree_insert_int(xdst_ptr, i * 2))
+            xdst_ref.insert(i * 2);
+        if (xrbtree_insert_int(xsrc_ptr, i * 3))
+            xsrc_ref.insert(i * 3);
+    }
+
+    // 合并：冲突的节点（6 的倍数）留在源红黑树中
+    long long   xalloc_base = xalloc_count;
+    xrbt_size_t xst_moved   = xrbtree_merge(xdst_ptr, xsrc_ptr);
+    XCHECK(xalloc_count == xalloc_base);
+
+    std::set< int > xleft;
+    for (std::set< int >::iterator xiter = xsrc_ref.begin(); xiter != xsrc_ref.end(); ++xiter)
+    {
+        if (!xdst_ref.insert(*xiter).second)
+            xleft.insert(*xiter);
+    }
+    XCHECK(xst_moved == xsrc_ref.size() - xleft.size());
+    xcheck_tree(xdst_ptr);
+    xcheck_tree(xsrc_ptr);
+    XCHECK(xcheck_equal(xdst_ptr, xdst_ref));
+    XCHECK(xcheck_equal(xsrc_ptr, xleft));
+
+    // 分离后停靠到另一棵红黑树
+    int            xkey    = 3;
+    xrbt_bool_t    xbt_ok  = XRBT_FALSE;
+    xrbt_nhandle_t xhandle = xrbtree_extract_vkey(xdst_ptr, &xkey);
+    XCHECK((XRBT_NULL != xhandle.xiter_node) && xrbtree_iter_is_undocked(xhandle.xiter_node));
+    xdst_ref.erase(xkey);
+
+    x_rbnode_iter xiter = xrbtree_insert_handle(xsrc_ptr, &xhandle, &xbt_ok);
+    XCHECK(xbt_ok && (xrbtree_iter_int(xiter) == xkey) && (XRBT_NULL == xhandle.xiter_node));
+    xleft.insert(xkey);
+
+    // 索引键冲突：句柄保持不变，由调用方释放
+    xkey    = 0;
+    xhandle = xrbtree_extract_vkey(xdst_ptr, &xkey);
+    xiter   = xrbtree_insert_handle(xsrc_ptr, &xhandle, &xbt_ok);
+    XCHECK(!xbt_ok && (XRBT_NULL != xhandle.xiter_node) && (xrbtree_iter_int(xiter) == xkey));
+    xrbtree_handle_release(&xhandle);
+    XCHECK((XRBT_NULL == xhandle.xiter_node) && (XRBT_NULL == xhandle.xtree_ptr));
+    xdst_ref.erase(xkey);
+
+    // 不兼容的红黑树（值数据大小不同）：句柄保持不变
+    x_rbtree_ptr xkv_ptr = xrbtree_create_ex(
+                        sizeof(int), sizeof(int), 0, &xcheck_callback, XRBT_NULL);
+    xkey    = 4;
+    xhandle = xrbtree_extract_vkey(xdst_ptr, &xkey);
+    XCHECK(!xrbtree_compatible(xkv_ptr, xdst_ptr));
+    XCHECK(xrbtree_insert_handle(xkv_ptr, &xhandle, &xbt_ok) == xrbtree_end(xkv_ptr));
+    XCHECK(!xbt_ok && (XRBT_NULL != xhandle.xiter_node));
+    XCHECK(0 == xrbtree_merge(xkv_ptr, xdst_ptr));
+    xrbtree_insert_handle(xdst_ptr, &xhandle, &xbt_ok);
+    XCHECK(xbt_ok);
+
+    xcheck_tree(xdst_ptr);
+    xcheck_tree(xsrc_ptr);
+    XCHECK(xcheck_equal(xdst_ptr, xdst_ref));
+    XCHECK(xcheck_equal(xsrc_ptr, xleft));
+
+    xrbtree_destroy(xkv_ptr);
+    xrbtree_destroy(xdst_ptr);
+    xrbtree_destroy(xsrc_ptr);
+}
+
+/** 倒计数为 0 时抛出异常（-1 表示不抛出），用于 xrbtree_set/xrbtree_map 的异常测试 */
+int       xstl_alloc_fail  = -1;
+int       xstl_cmp_fail    = -1;
+long long xstl_alloc_count = 0;
+
+/**
+ * @brief 无状态的计数分配器（同类型容器之间可直接转移节点）。
+ */
+template< class _Ty >
+struct xcheck_stl_alloc_t
+{
+    typedef _Ty value_type;
+
+    xcheck_stl_alloc_t(void) { }
+    template< class _Uy > xcheck_stl_alloc_t(const xcheck_stl_alloc_t< _Uy > &) { }
+
+    _Ty * allocate(std::size_t xst_count)
+    {
+        if ((xstl_alloc_fail >= 0) && (0 == xstl_alloc_fail--))
+            throw std::bad_alloc();
+        xstl_alloc_count += 1;
+        return static_cast< _Ty * >(::operator new(xst_count * sizeof(_Ty)));
+    }
+
+    void deallocate(_Ty * xptr, std::size_t)
+    {
+        xstl_alloc_count -= 1;
+        ::operator delete(xptr);
+    }
+};
+
+template< class _Ty, class _Uy >
+inline bool operator == (const xcheck_stl_alloc_t< _Ty > &, const xcheck_stl_alloc_t< _Uy > &)
+{ return true; }
+template< class _Ty, class _Uy >
+inline bool operator != (const xcheck_stl_alloc_t< _Ty > &, const xcheck_stl_alloc_t< _Uy > &)
+{ return false; }
+
+/**
+ * @brief 可按倒计数抛出异常的比较器（无状态）。
+ */
+struct xcheck_stl_less_t
+{
+    bool operator () (int xit_lkey, int xit_rkey) const
+    {
+        if ((xstl_cmp_fail >= 0) && (0 == xstl_cmp_fail--))
+            throw std::runtime_error("xcheck_stl_less_t");
+        return (xit_lkey < xit_rkey);
+    }
+};
+
+/**
+ * @brief 带有状态的比较器（节点不可在容器之间直接转移）。
+ */
+struct xcheck_stl_sless_t : public xcheck_stl_less_t
+{
+    int xit_state;
+};
+
+typedef xrbtree_set< int, xcheck_stl_less_t , xcheck_stl_alloc_t< int > > xcheck_set_t;
+typedef xrbtree_set< int, xcheck_stl_sless_t, xcheck_stl_alloc_t< int > > xcheck_sset_t;
+typedef xrbtree_map< int, std::string, xcheck_stl_less_t,
+                     xcheck_stl_alloc_t< std::pair< const int, std::string > > > xcheck_map_t;
+
+/**
+ * @brief 在 xset 中插入 xkey，比较器逐次在第 0、1、2 ... 次比较时抛出异常：
+ *        异常由容器重新抛出，且容器内容与 xref 保持一致，直至插入成功。
+ */
+template< class _Set >
+static void xcheck_stl_cmp_throw(_Set & xset, std::set< int > & xref, int xkey)
+{
+    int xit_thrown = 0;
+    for (int xit_fail = 0; ; ++xit_fail)
+    {
+        bool xbt_thrown = false;
+        xstl_cmp_fail = xit_fail;
+        try
+        {
+            xset.insert(xkey);
+        }
+        catch (const std::runtime_error &)
+        {
+            xbt_thrown = true;
+        }
+        xstl_cmp_fail = -1;
+
+        xcheck_tree(xset.native_handle());
+        if (!xbt_thrown)
+            break;
+        XCHECK(xcheck_equal(xset.native_handle(), xref));
+        xit_thrown += 1;
+    }
+
+    xref.insert(xkey);
+    XCHECK(xit_thrown > 0);
+    XCHECK(xcheck_equal(xset.native_handle(), xref));
+}
+
+/**
+ * @brief 合并期间，比较器逐次在第 0、1、2 ... 次比较时抛出异常：
+ *        两个容器均保持有序，元素既不丢失也不重复，直至合并成功。
+ */
+template< class _Set >
+static void xcheck_stl_merge_throw(void)
+{
+    std::set< int > xunion;
+    for (int xit_fail = 0; ; ++xit_fail)
+    {
+        _Set xdst;
+        _Set xsrc;
+        for (int i = 0; i < 24; ++i)
+        {
+            xdst.insert(i * 2);
+            xsrc.insert(i * 3);
+            xunion.insert(i * 2);
+            xunion.insert(i * 3);
+        }
+
+        bool xbt_thrown = false;
+        xstl_cmp_fail = xit_fail;
+        try
+        {
+            xdst.merge(xsrc);
+        }
+        catch (const std::runtime_error &)
+        {
+            xbt_thrown = true;
+        }
+        xstl_cmp_fail = -1;
+
+        xcheck_tree(xdst.native_handle());
+        xcheck_tree(xsrc.native_handle());
+        XCHECK(48 == xdst.size() + xsrc.size());
+
+        std::set< int > xmerged(xdst.begin(), xdst.end());
+        xmerged.insert(xsrc.begin(), xsrc.end());
+        XCHECK(xmerged == xunion);
+
+        if (!xbt_thrown)
+        {
+            XCHECK(xcheck_equal(xdst.native_handle(), xunion));
+            break;
+        }
+    }
+}
+
+/**
+ * @brief xrbtree_set/xrbtree_map：迭代器的有效性、节点句柄、合并、比较运算符，
+ *        以及 分配器、比较器 抛出的异常（不穿过 xrbtree.c，容器内容保持不变）。
+ */
+void test_check_stl(void)
+{
+    long long xalloc_base = xstl_alloc_count;
+
+    {
+        std::mt19937    xrand(43);
+        xcheck_set_t    xset;
+        std::set< int > xref;
+
+        // 其他元素的 插入/删除 不影响已有的迭代器
+        std::vector< xcheck_set_t::iterator > xiters;
+        for (int i = 0; i < 64; ++i)
+        {
+            xiters.push_back(xset.insert(i * 1000).first);
+            xref.insert(i * 1000);
+        }
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            int xkey = (int)(xrand() % 64000);
+            if (0 == (xkey % 1000))
+                continue;
+            if (xrand() & 1)
+                XCHECK(xset.insert(xkey).second == xref.insert(xkey).second);
+            else
+                XCHECK(xset.erase(xkey) == xref.erase(xkey));
+        }
+
+        for (int i = 0; i < 64; ++i)
+            XCHECK((i * 1000 == *xiters[i]) && (xset.find(i * 1000) == xiters[i]));
+        xcheck_tree(xset.native_handle());
+        XCHECK(xcheck_equal(xset.native_handle(), xref));
+        XCHECK(std::equal(xset.rbegin(), xset.rend(), xref.rbegin()));
+        XCHECK(xset.erase(xiters[10]) == xset.upper_bound(10000));
+        xref.erase(10000);
+
+        // 节点句柄：分离后修改元素，再插入另一个容器（节点直接转移，不申请内存）
+        xcheck_set_t xother;
+        xother.insert(5);
+
+        long long xcount = xstl_alloc_count;
+        xcheck_set_t::node_type xnode = xset.extract(20000);
+        XCHECK(!xnode.empty() && (20000 == xnode.value()));
+        XCHECK(xset.extract(20000).empty());
+        xref.erase(20000);
+
+        xnode.value() = 5;
+        xcheck_set_t::insert_return_type xreturn = xother.insert(std::move(xnode));
+        XCHECK(!xreturn.inserted && (5 == *xreturn.position) && !xreturn.node.empty());
+        xreturn.node.value() = 7;
+        xreturn = xother.insert(std::move(xreturn.node));
+        XCHECK(xreturn.inserted && (7 == *xreturn.position) && xreturn.node.empty());
+        XCHECK((2 == xother.size()) && (xstl_alloc_count == xcount));
+        XCHECK(xcheck_equal(xset.native_handle(), xref));
+
+        // 合并：冲突的元素留在源容器中；比较器、分配器 无状态时直接转移节点
+        xcheck_set_t    xsrc;
+        xcheck_sset_t   xsdst;
+        xcheck_sset_t   xssrc;
+        std::set< int > xleft;
+        for (int i = 0; i < 3000; ++i)
+        {
+            xsrc.insert(i * 7);
+            xssrc.insert(i * 7);
+            if (xref.count(i * 7))
+                xleft.insert(i * 7);
+        }
+        xsdst.insert(xref.begin(), xref.end());
+
+        xcount = xstl_alloc_count;
+        xset.merge(xsrc);
+        XCHECK(xstl_alloc_count == xcount);
+        xsdst.merge(xssrc);
+
+        for (int i = 0; i < 3000; ++i)
+            xref.insert(i * 7);
+        xcheck_tree(xset.native_handle());
+        xcheck_tree(xsrc.native_handle());
+        XCHECK(xcheck_equal(xset.native_handle(), xref));
+        XCHECK(xcheck_equal(xsrc.native_handle(), xleft));
+        XCHECK(xcheck_equal(xsdst.native_handle(), xref));
+        XCHECK(xcheck_equal(xssrc.native_handle(), xleft));
+
+        // 比较运算符：与 std::set 的结果一致
+        const int xvalues[][3] = { { 1, 2, 3 }, { 1, 2, 4 }, { 1, 2, 2 }, { 1, 2, 3 }, { 0, 9, 9 } };
+        for (int i = 0; i < 5; ++i)
+        {
+            for (int j = 0; j < 5; ++j)
+            {
+                xcheck_set_t    xlhs(xvalues[i], xvalues[i] + 3);
+                xcheck_set_t    xrhs(xvalues[j], xvalues[j] + 3);
+                std::set< int > xlref(xvalues[i], xvalues[i] + 3);
+                std::set< int > xrref(xvalues[j], xvalues[j] + 3);
+
+                XCHECK((xlhs == xrhs) == (xlref == xrref));
+                XCHECK((xlhs != xrhs) == (xlref != xrref));
+                XCHECK((xlhs <  xrhs) == (xlref <  xrref));
+                XCHECK((xlhs <= xrhs) == (xlref <= xrref));
+                XCHECK((xlhs >  xrhs) == (xlref >  xrref));
+                XCHECK((xlhs >= xrhs) == (xlref >= xrref));
+            }
+        }
+
+        // 比较器在 xrbtree.c 的函数栈中抛出异常：插入被撤销，容器保持有序
+        xcheck_stl_cmp_throw(xset, xref, 70001);
+        xcheck_stl_cmp_throw(xsdst, xref = std::set< int >(xsdst.begin(), xsdst.end()), 70001);
+
+        xcheck_stl_merge_throw< xcheck_set_t  >();
+        xcheck_stl_merge_throw< xcheck_sset_t >();
+
+        // 分配器抛出异常：由 x_memalloc 转为 XRBT_NULL，容器抛出原异常
+        xcheck_set_t xfresh;
+        xfresh.insert(1);
+        xstl_alloc_fail = 0;
+        bool xbt_thrown = false;
+        try
+        {
+            xfresh.insert(2);
+        }
+        catch (const std::bad_alloc &)
+        {
+            xbt_thrown = true;
+        }
+        XCHECK(xbt_thrown && (1 == xfresh.size()) && (0 == xfresh.count(2)));
+        xstl_alloc_fail = -1;
+    }
+
+    {
+        xcheck_map_t xmap;
+        std::map< int, std::string > xmref;
+
+        xmap[3] = "c";
+        XCHECK(xmap.try_emplace(1, 2, 'a').second);
+        XCHECK(!xmap.try_emplace(1, "x").second && ("aa" == xmap.at(1)));
+        XCHECK(!xmap.insert_or_assign(3, "C").second);
+        XCHECK(xmap.insert(std::make_pair(5, std::string("e"))).second);
+        xmref[1] = "aa";
+        xmref[3] = "C";
+        xmref[5] = "e";
+        XCHECK(std::equal(xmap.begin(), xmap.end(), xmref.begin()));
+
+        bool xbt_thrown = false;
+        try
+        {
+            xmap.at(99);
+        }
+        catch (const std::out_of_range &)
+        {
+            xbt_thrown = true;
+        }
+        XCHECK(xbt_thrown);
+
+        // 节点句柄：修改索引键后重新插入
+        xcheck_map_t::node_type xnode = xmap.extract(3);
+        XCHECK(!xnode.empty() && (3 == xnode.key()) && ("C" == xnode.mapped()));
+        xnode.key() = 2;
+        XCHECK(xmap.insert(std::move(xnode)).inserted);
+        XCHECK((0 == xmap.count(3)) && ("C" == xmap.at(2)));
+
+        // 比较运算符
+        xcheck_map_t xcopy(xmap);
+        XCHECK((xcopy == xmap) && !(xcopy < xmap) && (xcopy >= xmap));
+        xcopy[0] = "z";
+        XCHECK((xcopy != xmap) && (xcopy < xmap) && (xmap > xcopy));
+        xcopy.erase(0);
+        xcopy[2] = "D";
+        XCHECK((xcopy > xmap) && (xmap <= xcopy));
+
+        // try_emplace()/operator[] 申请节点失败：抛出原异常，不插入
+        xcheck_map_t xfresh;
+        xfresh[1] = "a";
+        xstl_alloc_fail = 0;
+        xbt_thrown = false;
+        try
+        {
+            xfresh[2] = "b";
+        }
+        catch (const std::bad_alloc &)
+        {
+            xbt_thrown = true;
+        }
+        xstl_alloc_fail = -1;
+        XCHECK(xbt_thrown && (1 == xfresh.size()) && (0 == xfresh.count(2)));
+
+        xstl_cmp_fail = 0;
+        xbt_thrown = false;
+        try
+        {
+            xfresh.try_emplace(2, "b");
+        }
+        catch (const std::runtime_error &)
+        {
+            xbt_thrown = true;
+        }
+        xstl_cmp_fail = -1;
+        XCHECK(xbt_thrown && (1 == xfresh.size()));
+    }
+
+    XCHECK(xstl_alloc_count == xalloc_base);
+}
+
+/**
+ * @brief 整体回收的节点内存池（上下文标识）：memfree 不应被回调。
+ */
+xrbt_void_t * xarena_memalloc(xrbt_vkey_t xrbt_vkey,
+                              xrbt_size_t xst_nsize,
+                              xrbt_ctxt_t xrbt_ctxt)
+{
+    std::vector< void * > * xarena = static_cast< std::vector< void * > * >(xrbt_ctxt);
+    xarena->push_back(malloc(xst_nsize));
+    return xarena->back();
+}
+
+xrbt_void_t xarena_memfree(x_rbnode_iter xrbt_node,
+                           xrbt_size_t xst_nsize,
+                           xrbt_ctxt_t xrbt_ctxt)
+{
+    XCHECK(false);
+}
+
+/**
+ * @brief XRBT_FLAG_NOFREE 模式：不回调 memfree，删除的节点留给后续的插入复用，
+ *        清除、销毁后由内存池整体释放。
+ */
+void test_check_nofree(void)
+{
+    std::vector< void * > xarena;
+    std::set< int >       xref;
+
+    xrbt_callback_t xcallback = xcheck_callback;
+    xcallback.xfunc_n_memalloc = &xarena_memalloc;
+    xcallback.xfunc_n_memfree  = &xarena_memfree;
+    xcallback.xctxt_t_callback = &xarena;
+
+    x_rbtree_ptr xtree_ptr = xrbtree_create_ex(
+                        sizeof(int), 0, XRBT_FLAG_NOFREE, &xcallback, XRBT_NULL);
+    XCHECK(0 != (xrbtree_flags(xtree_ptr) & XRBT_FLAG_NOFREE));
+
+    for (int i = 0; i < 4000; ++i)
+    {
+        xrbtree_insert_int(xtree_ptr, i);
+        xref.insert(i);
+    }
+    XCHECK(4000 == xarena.size());
+
+    // 删除的节点进入备用链表，再插入时不申请内存
+    for (int i = 0; i < 4000; i += 2)
+    {
+        XCHECK(xrbtree_erase_int(xtree_ptr, i));
+        xref.erase(i);
+    }
+    for (int i = 0; i < 2000; ++i)
+    {
+        XCHECK(xrbtree_insert_int(xtree_ptr, 10000 + i));
+        xref.insert(10000 + i);
+    }
+    XCHECK(4000 == xarena.size());
+    xcheck_tree(xtree_ptr);
+    XCHECK(xcheck_equal(xtree_ptr, xref));
+
+    // 无须析构：清除操作不逐个释放节点
+    xrbtree_clear(xtree_ptr);
+    XCHECK(xrbtree_empty(xtree_ptr) && (0 == xrbtree_clear_step(xtree_ptr, 0)));
+    xrbtree_insert_int(xtree_ptr, 1);
+    XCHECK(xrbtree_size(xtree_ptr) == 1);
+
+    xrbtree_destroy(xtree_ptr);
+    XCHECK(4001 == xarena.size());
+    for (std::size_t i = 0; i < xarena.size(); ++i)
+        free(xarena[i]);
+}
+
+#ifdef XRBTREE_HAS_PMR
+
+/**
+ * @brief 记录 申请/释放 次数的内存资源（转发给上游资源）。
+ */
+class xcheck_pmr_count_t : public std::pmr::memory_resource
+{
+public:
+    explicit xcheck_pmr_count_t(std::pmr::memory_resource * xupstream)
+        : m_xupstream(xupstream)
+        , m_xst_allocs(0)
+        , m_xst_frees(0)
+    {
+    }
+
+    std::pmr::memory_resource * m_xupstream;
+    std::size_t                 m_xst_allocs;
+    std::size_t                 m_xst_frees;
+
+protected:
+    void * do_allocate(std::size_t xst_bytes, std::size_t xst_align) override
+    {
+        m_xst_allocs += 1;
+        return m_xupstream->allocate(xst_bytes, xst_align);
+    }
+
+    void do_deallocate(void * xptr, std::size_t xst_bytes, std::size_t xst_align) override
+    {
+        m_xst_frees += 1;
+        m_xupstream->deallocate(xptr, xst_bytes, xst_align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource & xother) const noexcept override
+    {
+        return (this == &xother);
+    }
+};
+
+/** 经 xrbtree_pmr_user_ctxt() 取得调用方上下文的比较回调（上下文非 0 时逆序） */
+xrbt_bool_t xcheck_pmr_compare(xrbt_vkey_t xrbt_lkey,
+                               xrbt_vkey_t xrbt_rkey,
+                               xrbt_size_t xrbt_size,
+                               xrbt_ctxt_t xrbt_ctxt)
+{
+    int xit_lkey = *static_cast< int * >(xrbt_lkey);
+    int xit_rkey = *static_cast< int * >(xrbt_rkey);
+    if (0 != *static_cast< int * >(xrbtree_pmr_user_ctxt(xrbt_ctxt)))
+        return (xit_rkey < xit_lkey);
+    return (xit_lkey < xit_rkey);
+}
+
+/**
+ * @brief std::pmr 桥接：节点内存经内存资源 申请/释放；monotonic_buffer_resource
+ *        自动设置 XRBT_FLAG_NOFREE，其他资源可显式指定；调用方的上下文标识可继续使用。
+ */
+void test_check_pmr(void)
+{
+    xcheck_pmr_count_t xcount(std::pmr::new_delete_resource());
+    std::set< int >    xref;
+
+    // 逐个释放的资源
+    {
+        xrbtree_pmr_ctxt_t xpmr_ctxt = { &xcount, XRBT_NULL };
+        x_rbtree_ptr xtree_ptr = xrbtree_create_pmr_k< int >(&xpmr_ctxt);
+        XCHECK(0 == (xrbtree_flags(xtree_ptr) & XRBT_FLAG_NOFREE));
+
+        for (int i = 0; i < 1000; ++i)
+            xrbtree_insert_int(xtree_ptr, i);
+        for (int i = 0; i < 1000; i += 3)
+            xrbtree_erase_int(xtree_ptr, i);
+        XCHECK(xcount.m_xst_allocs == 1000);
+        XCHECK(xcount.m_xst_allocs - xcount.m_xst_frees == xrbtree_size(xtree_ptr));
+
+        xrbtree_destroy(xtree_ptr);
+        XCHECK(xcount.m_xst_allocs == xcount.m_xst_frees);
+    }
+
+    // monotonic_buffer_resource：自动设置 XRBT_FLAG_NOFREE，内存随资源整体释放
+    {
+        xcount.m_xst_allocs = xcount.m_xst_frees = 0;
+        std::pmr::monotonic_buffer_resource xmono(&xcount);
+        xrbtree_pmr_ctxt_t xpmr_ctxt = { &xmono, XRBT_NULL };
+        XCHECK(xrbtree_pmr_is_monotonic(&xmono) && !xrbtree_pmr_is_monotonic(&xcount));
+
+        x_rbtree_ptr xtree_ptr = xrbtree_create_pmr_k< int, int >(&xpmr_ctxt);
+        XCHECK(0 != (xrbtree_flags(xtree_ptr) & XRBT_FLAG_NOFREE));
+        for (int i = 0; i < 1000; ++i)
+            xrbtree_insert_int(xtree_ptr, i);
+        xcheck_tree(xtree_ptr);
+        xrbtree_clear(xtree_ptr);
+        xrbtree_destroy(xtree_ptr);
+        XCHECK((xcount.m_xst_allocs > 0) && (0 == xcount.m_xst_frees));
+
+        xmono.release();
+        XCHECK(xcount.m_xst_allocs == xcount.m_xst_frees);
+    }
+
+    // 显式指定 XRBT_FLAG_NOFREE（内存池 销毁时整体释放），并经 xctxt_user 使用调用方的上下文
+    {
+        xcount.m_xst_allocs = xcount.m_xst_frees = 0;
+        std::pmr::unsynchronized_pool_resource xpool;
+        xcheck_pmr_count_t xpcount(&xpool);
+
+        int xit_reverse = 1;
+        xrbtree_pmr_ctxt_t xpmr_ctxt = { &xpcount, &xit_reverse };
+        xrbt_callback_t xcallback = xrbtree_pmr_callback< int >(&xpmr_ctxt);
+        xcallback.xfunc_k_compare = &xcheck_pmr_compare;
+        x_rbtree_ptr xtree_ptr = xrbtree_create_ex(
+                        sizeof(int), 0, XRBT_FLAG_NOFREE, &xcallback, XRBT_NULL);
+
+        for (int i = 0; i < 500; ++i)
+            xrbtree_insert_int(xtree_ptr, i);
+        for (int i = 0; i < 500; i += 2)
+            xrbtree_erase_int(xtree_ptr, i);
+        for (int i = 0; i < 250; ++i)
+            xrbtree_insert_int(xtree_ptr, 1000 + i);
+        XCHECK((500 == xpcount.m_xst_allocs) && (0 == xpcount.m_xst_frees));
+
+        int xit_prev = 0x7FFFFFFF;
+        for (x_rbnode_iter xiter = xrbtree_begin(xtree_ptr);
+             xiter != xrbtree_end(xtree_ptr);
+             xiter = xrbtree_next(xiter))
+        {
+            XCHECK(xrbtree_iter_int(xiter) < xit_prev);
+            xit_prev = xrbtree_iter_int(xiter);
+        }
+
+        xrbtree_destroy(xtree_ptr);
+        XCHECK(0 == xpcount.m_xst_frees);
+    }
+
+    // xrbtree_set 使用 polymorphic_allocator
+    {
+        std::pmr::monotonic_buffer_resource xmono;
+        std::pmr::polymorphic_allocator< int > xalloc(&xmono);
+        xrbtree_set< int, std::less< int >, std::pmr::polymorphic_allocator< int > > xset(xalloc);
+        for (int i = 0; i < 100; ++i)
+        {
+            xset.insert(i * 5 % 101);
+            xref.insert(i * 5 % 101);
+        }
+        XCHECK(0 != (xrbtree_flags(xset.native_handle()) & XRBT_FLAG_NOFREE));
+        xcheck_tree(xset.native_handle());
+        XCHECK(xcheck_equal(xset.native_handle(), xref));
+    }
+}
+
+#endif // XRBTREE_HAS_PMR
+
+/**
+ * @brief 持久化索引的节点区域用尽后，插入操作失败，红黑树及文件保持有效。
+ */
+void test_check_mmtree_full(void)
+{
+    struct xkey64_t
+    {
+        int  xit_key;
+        char xct_pad[60];
+    };
+
+    xrbt_callback_t xcallback =
+    {
+        /* .xfunc_n_memalloc = */ XRBT_NULL,
+        /* .xfunc_n_memfree  = */ XRBT_NULL,
+        /* .xfunc_k_copyfrom = */ XRBT_NULL,
+        /* .xfunc_k_destruct = */ XRBT_NULL,
+        /* .xfunc_k_lesscomp = */ &xrbtree_xfunc_ltint_compare,
+        /* .xctxt_t_callback = */ XRBT_NULL
+    };
+
+    const char  * xszt_path = "rbtree_test_full.xmm";
+    xkey64_t      xkey;
+    xrbt_bool_t   xbt_ok    = XRBT_FALSE;
+    x_rbnode_iter xiter     = XRBT_NULL;
+    int           xit_count = 0;
+
+    unlink(xszt_path);
+    memset(&xkey, 0, sizeof(xkey));
+
+    x_mmtree_ptr xmmtree_ptr = xmmtree_open(
+        xszt_path, sizeof(xkey64_t), 0, 0, 2 * 1024 * 1024, &xcallback, XRBT_NULL);
+    XCHECK(XRBT_NULL != xmmtree_ptr);
+    if (XRBT_NULL == xmmtree_ptr)
+        return;
+
+    x_rbtree_ptr xtree_ptr = xmmtree_modify(xmmtree_ptr);
+    for (xit_count = 0; ; ++xit_count)
+    {
+        xkey.xit_key = xit_count;
+        xiter = xrbtree_insert(xtree_ptr, &xkey, &xbt_ok);
+        if (!xbt_ok)
+            break;
+    }
+
+    XCHECK(xiter == xrbtree_end(xtree_ptr));
+    XCHECK((xit_count > 1000) && (xrbtree_size(xtree_ptr) == (xrbt_size_t)xit_count));
+    xcheck_tree(xtree_ptr);
+
+    // 已有的索引键依然返回对应节点；删除节点后，其缓存可被再次插入使用
+    xkey.xit_key = 7;
+    xiter = xrbtree_insert(xtree_ptr, &xkey, &xbt_ok);
+    XCHECK(!xbt_ok && (xrbtree_iter_int(xiter) == 7));
+    XCHECK(xrbtree_erase_vkey(xtree_ptr, &xkey));
+    xkey.xit_key = xit_count;
+    XCHECK(xrbtree_insert(xtree_ptr, &xkey, &xbt_ok) != xrbtree_end(xtree_ptr) && xbt_ok);
+    xkey.xit_key = xit_count + 1;
+    XCHECK(xrbtree_insert(xtree_ptr, &xkey, &xbt_ok) == xrbtree_end(xtree_ptr) && !xbt_ok);
+    XCHECK(xmmtree_checkpoint(xmmtree_ptr));
+    xmmtree_close(xmmtree_ptr);
+
+    // 重新打开时，文件处于 完整 状态，无须重建
+    xmmtree_ptr = xmmtree_open(
+        xszt_path, sizeof(xkey64_t), 0, 0, 0, &xcallback, XRBT_NULL);
+    XCHECK(XRBT_NULL != xmmtree_ptr);
+    if (XRBT_NULL != xmmtree_ptr)
+    {
+        xtree_ptr = xmmtree_tree(xmmtree_ptr);
+        XCHECK(!xmmtree_recovered(xmmtree_ptr));
+        XCHECK(xrbtree_size(xtree_ptr) == (xrbt_size_t)xit_count);
+        xcheck_tree(xtree_ptr);
+        xmmtree_close(xmmtree_ptr);
+    }
+
+    unlink(xszt_path);
+}
+
+/** 共享内存模式的测试所使用的 比较回调（独立启动的子进程中也使用） */
+static xrbt_callback_t xshm_callback =
+{
+    /* .xfunc_n_memalloc = */ XRBT_NULL,
+    /* .xfunc_n_memfree  = */ XRBT_NULL,
+    /* .xfunc_k_copyfrom = */ XRBT_NULL,
+    /* .xfunc_k_destruct = */ XRBT_NULL,
+    /* .xfunc_k_lesscomp = */ &xrbtree_xfunc_ltint_compare,
+    /* .xctxt_t_callback = */ XRBT_NULL
+};
+
+/**
+ * @brief 由 test_check_mmtree_shm() 以 exec 启动的子进程（地址空间布局与父进程无关）：
+ *        挂接共享内存段，检查父进程写入的节点，再插入父进程空出的索引键 0 。
+ */
+int test_check_mmtree_shm_child(const char * xszt_name, int xit_count)
+{
+    xrbt_bool_t xbt_ok = XRBT_FALSE;
+    int         xit_key = 0;
+
+    x_mmtree_ptr xmmtree_ptr = xmmtree_open_shm(
+        xszt_name, sizeof(int), 0, 0, 0, &xshm_callback, XRBT_NULL);
+    if (XRBT_NULL == xmmtree_ptr)
+        return 2;
+
+    x_rbtree_ptr xtree_ptr = xmmtree_write_lock(xmmtree_ptr);
+    xcheck_tree(xtree_ptr);
+    for (xit_key = 1; xit_key < xit_count; ++xit_key)
+    {
+        x_rbnode_iter xiter = xrbtree_find(xtree_ptr, &xit_key);
+        if ((xiter == xrbtree_end(xtree_ptr)) || (xrbtree_iter_int(xiter) != xit_key))
+            xcheck_fails += 1;
+    }
+
+    xit_key = 0;
+    XCHECK(xrbtree_size(xtree_ptr) == (xrbt_size_t)(xit_count - 1));
+    XCHECK(xrbtree_insert(xtree_ptr, &xit_key, &xbt_ok) != xrbtree_end(xtree_ptr) && xbt_ok);
+    xit_key = xit_count;
+    XCHECK(xrbtree_insert(xtree_ptr, &xit_key, &xbt_ok) == xrbtree_end(xtree_ptr) && !xbt_ok);
+    xmmtree_write_unlock(xmmtree_ptr);
+    xmmtree_close(xmmtree_ptr);
+
+    return (0 == xcheck_fails) ? 0 : 1;
+}
+
+/**
+ * @brief 共享内存模式：节点区域用尽后插入失败；映射到不同基址的挂接（同一进程再次挂接、
+ *        exec 启动的独立进程）均可使用同一棵红黑树，且各自使用本进程的回调函数。
+ */
+void test_check_mmtree_shm(void)
+{
+    char          xszt_name[64];
+    char          xszt_count[16];
+    xrbt_bool_t   xbt_ok    = XRBT_FALSE;
+    int           xit_key   = 0;
+    int           xit_count = 0;
+    int           xit_stat  = 0;
+    pid_t         xpid_child = 0;
+
+    snprintf(xszt_name, sizeof(xszt_name), "/rbtree_test_shm_%d", (int)getpid());
+    xmmtree_unlink_shm(xszt_name);
+
+    x_mmtree_ptr xmmtree_ptr = xmmtree_open_shm(
+        xszt_name, sizeof(int), 0, 0, 1024 * 1024, &xshm_callback, XRBT_NULL);
+    XCHECK(XRBT_NULL != xmmtree_ptr);
+    if (XRBT_NULL == xmmtree_ptr)
+        return;
+
+    // 共享内存段不扩展，用尽后插入失败，树结构保持有效
+    x_rbtree_ptr xtree_ptr = xmmtree_write_lock(xmmtree_ptr);
+    for (xit_count = 0; ; ++xit_count)
+    {
+        if (xrbtree_insert(xtree_ptr, &xit_count, &xbt_ok) == xrbtree_end(xtree_ptr))
+            break;
+    }
+    XCHECK(!xbt_ok && (xit_count > 1000));
+    XCHECK(xrbtree_size(xtree_ptr) == (xrbt_size_t)xit_count);
+    xcheck_tree(xtree_ptr);
+    xit_key = 0;
+    XCHECK(xrbtree_erase_vkey(xtree_ptr, &xit_key));
+    xmmtree_write_unlock(xmmtree_ptr);
+
+    // 同一进程再次挂接，原先的基址已被占用，映射到其他地址
+    x_mmtree_ptr xmmtree_other = xmmtree_open_shm(
+        xszt_name, sizeof(int), 0, 0, 0, &xshm_callback, XRBT_NULL);
+    XCHECK(XRBT_NULL != xmmtree_other);
+    if (XRBT_NULL != xmmtree_other)
+    {
+        XCHECK(xmmtree_relocated(xmmtree_other));
+        xtree_ptr = xmmtree_read_lock(xmmtree_other);
+        xit_key = 5;
+        XCHECK(xrbtree_size(xtree_ptr) == (xrbt_size_t)(xit_count - 1));
+        XCHECK(xrbtree_iter_int(xrbtree_find(xtree_ptr, &xit_key)) == 5);
+        xcheck_tree(xtree_ptr);
+        xmmtree_read_unlock(xmmtree_other);
+        xmmtree_close(xmmtree_other);
+    }
+
+    // 独立启动的进程（重新 exec，代码与数据的地址均与本进程无关）挂接并修改
+    snprintf(xszt_count, sizeof(xszt_count), "%d", xit_count);
+    xpid_child = fork();
+    if (0 == xpid_child)
+    {
+        execl("/proc/self/exe", "rbtree_test", "--shm-child", xszt_name, xszt_count, (char *)XRBT_NULL);
+        _exit(3);
+    }
+    XCHECK(xpid_child > 0);
+    XCHECK((xpid_child > 0) && (xpid_child == waitpid(xpid_child, &xit_stat, 0)));
+    XCHECK(WIFEXITED(xit_stat) && (0 == WEXITSTATUS(xit_stat)));
+
+    xtree_ptr = xmmtree_read_lock(xmmtree_ptr);
+    xit_key = 0;
+    XCHECK(xrbtree_size(xtree_ptr) == (xrbt_size_t)xit_count);
+    XCHECK(xrbtree_iter_int(xrbtree_find(xtree_ptr, &xit_key)) == 0);
+    xcheck_tree(xtree_ptr);
+    xmmtree_read_unlock(xmmtree_ptr);
+
+    xmmtree_close(xmmtree_ptr);
+    xmmtree_unlink_shm(xszt_name);
+}
+
+/**
+ * @brief 定时器的测试对象（嵌入定时器），回调中按 xit_action 操作其他定时器。
+ */
+struct xcheck_timer_t
+{
+    x_timer_t        xtimer;
+    int              xit_id;
+    int              xit_action;   ///< 0：无，1：取消 xtarget，2：以 xu64_rearm 重新启动自身
+    x_timer_ptr      xtarget;
+    xrbt_uint64_t    xu64_rearm;
+    std::vector< int > * xfired;
+};
+
+static xrbt_void_t xcheck_timer_expire(x_timerq_ptr xtimerq_ptr,
+                                       x_timer_ptr xtimer_ptr,
+                                       xrbt_ctxt_t xtimer_ctxt)
+{
+    xcheck_timer_t * xobj = (xcheck_timer_t *)xtimer_ctxt;
+    xobj->xfired->push_back(xobj->xit_id);
+    XCHECK(!xtimerq_is_armed(xtimerq_ptr, xtimer_ptr));
+
+    if (1 == xobj->xit_action)
+    {
+        XCHECK(xtimerq_is_armed(xtimerq_ptr, xobj->xtarget));
+        XCHECK(xtimerq_cancel(xtimerq_ptr, xobj->xtarget));
+        XCHECK(!xtimerq_is_armed(xtimerq_ptr, xobj->xtarget));
+    }
+    else if (2 == xobj->xit_action)
+    {
+        xobj->xit_action = 0;
+        xtimerq_arm(xtimerq_ptr, xtimer_ptr, xobj->xu64_rearm);
+    }
+}
+
+/**
+ * @brief xtimerq_expire_until()：相同到期时间按启动先后触发；
+ *        回调中取消已到期、待回调的定时器；回调中重新启动定时器（留待下一次调用触发）。
+ */
+void test_check_timerq(void)
+{
+    std::vector< int > xfired;
+    xcheck_timer_t     xobjs[8];
+    xrbt_uint64_t      xu64_next = 0;
+
+    x_timerq_ptr xtimerq_ptr = xtimerq_create(XRBT_NULL);
+    for (int i = 0; i < 8; ++i)
+    {
+        xobjs[i].xit_id     = i;
+        xobjs[i].xit_action = 0;
+        xobjs[i].xtarget    = XRBT_NULL;
+        xobjs[i].xu64_rearm = 0;
+        xobjs[i].xfired     = &xfired;
+        xtimerq_timer_init(&xobjs[i].xtimer, &xcheck_timer_expire, &xobjs[i]);
+    }
+
+    // 相同到期时间：按启动的先后顺序；重新启动的定时器排到相同时间的最后
+    const int xorder[] = { 5, 2, 7, 0, 3 };
+    for (int i = 0; i < 5; ++i)
+        xtimerq_arm(xtimerq_ptr, &xobjs[xorder[i]].xtimer, 100);
+    xtimerq_arm(xtimerq_ptr, &xobjs[2].xtimer, 100);
+    xtimerq_arm(xtimerq_ptr, &xobjs[6].xtimer, 99);
+    XCHECK(xtimerq_next_expire(xtimerq_ptr, &xu64_next) && (99 == xu64_next));
+    XCHECK(6 == xtimerq_expire_until(xtimerq_ptr, 100));
+    const int xexpect[] = { 6, 5, 7, 0, 3, 2 };
+    XCHECK(xfired == std::vector< int >(xexpect, xexpect + 6));
+    XCHECK(0 == xtimerq_size(xtimerq_ptr));
+
+    // 回调中取消 同一批已到期、尚未回调 的定时器：该定时器不再触发
+    xfired.clear();
+    xobjs[0].xit_action = 1;
+    xobjs[0].xtarget    = &xobjs[1].xtimer;
+    for (int i = 0; i < 3; ++i)
+        xtimerq_arm(xtimerq_ptr, &xobjs[i].xtimer, 200);
+    XCHECK(2 == xtimerq_expire_until(xtimerq_ptr, 200));
+    XCHECK((2 == xfired.size()) && (0 == xfired[0]) && (2 == xfired[1]));
+    XCHECK(!xtimerq_is_armed(xtimerq_ptr, &xobjs[1].xtimer));
+    XCHECK(!xtimerq_cancel(xtimerq_ptr, &xobjs[1].xtimer));
+    xobjs[0].xit_action = 0;
+
+    // 回调中重新启动自身：即使 到期时间 <= 当前时间，也留待下一次调用触发
+    xfired.clear();
+    xobjs[3].xit_action = 2;
+    xobjs[3].xu64_rearm = 250;
+    xobjs[4].xit_action = 2;
+    xobjs[4].xu64_rearm = 400;
+    xtimerq_arm(xtimerq_ptr, &xobjs[3].xtimer, 300);
+    xtimerq_arm(xtimerq_ptr, &xobjs[4].xtimer, 300);
+    XCHECK(2 == xtimerq_expire_until(xtimerq_ptr, 300));
+    XCHECK(xtimerq_is_armed(xtimerq_ptr, &xobjs[3].xtimer) && (250 == xtimerq_expire_time(&xobjs[3].xtimer)));
+    XCHECK(xtimerq_next_expire(xtimerq_ptr, &xu64_next) && (250 == xu64_next));
+    XCHECK(1 == xtimerq_expire_until(xtimerq_ptr, 300));
+    XCHECK(0 == xtimerq_expire_until(xtimerq_ptr, 399));
+    XCHECK(1 == xtimerq_expire_until(xtimerq_ptr, 400));
+    const int xrearm[] = { 3, 4, 3, 4 };
+    XCHECK(xfired == std::vector< int >(xrearm, xrearm + 4));
+    XCHECK(0 == xtimerq_size(xtimerq_ptr));
+
+    xtimerq_destroy(xtimerq_ptr);
+}
+
+/**
+ * @brief 执行全部的正确性检查。
+ */
+void test_check(void)
+{
+    long long xalloc_base = xalloc_count;
+
+    test_check_mixed();
+    test_check_map_mode();
+    test_check_upsert();
+    test_check_multi_equal();
+    test_check_probe();
+    test_check_emplace();
+    test_check_borrow_rebase();
+    test_check_prefix_cache();
+    test_check_intrusive();
+    test_check_save_load();
+    test_check_scan();
+    test_check_partition();
+    test_check_parallel();
+    test_check_clear_step();
+    test_check_clear_async();
+    test_check_merge_handle();
+    test_check_stl();
+    test_check_nofree();
+#ifdef XRBTREE_HAS_PMR
+    test_check_pmr();
+#endif // XRBTREE_HAS_PMR
+    test_check_mmtree_full();
+    test_check_mmtree_shm();
+    test_check_timerq();
+
+    XCHECK(xalloc_count == xalloc_base);
+    printf("[CHK] check failures : %d\n", xcheck_fails);
+}
+
+int main(int argc, char * argv[])
+{
+    int max_insert = 1000000;
+    int first_test = 1;
+
+    if ((4 == argc) && (0 == strcmp(argv[1], "--shm-child")))
+        return test_check_mmtree_shm_child(argv[2], std::atoi(argv[3]));
+
+    printf("Usage: %s < max_insert > < first_test_c : 0 or 1 >\n", argv[0]);
+
+    if (argc >= 2) max_insert = std::atoi(argv[1]);
+    if (argc >= 3) first_test = std::atoi(argv[2]);
+
+    printf("Test insert : %d\n", max_insert);
+    printf("//======================================\n");
+
+    test_check();
 
-    printf("Test insert : %d\n", max_insert);
     printf("//======================================\n");
 
     if (0 != first_test)
@@ -246,6 +2568,6 @@ int main(int argc, char * argv[])
 
     printf("//======================================\n");
 
-    return 0;
+    return (0 == xcheck_fails) ? 0 : 1;
 }
 
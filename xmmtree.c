@@ -0,0 +1,1192 @@
+﻿/**
+ * @file    xmmtree.c
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * 文件名称：xmmtree.c
+ * 创建日期：2019年09月09日
+ * 文件标识：
+ * 文件摘要：基于红黑树（x_rbtree_t）的文件映射（mmap）持久化索引。
+ *
+ * 当前版本：1.0.0.0
+ * 作    者：
+ * 完成日期：2019年09月09日
+ * 版本摘要：
+ *
+ * 历史版本：
+ * 原作者  ：
+ * 完成日期：
+ * 版本摘要：
+ * </pre>
+ */
+
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif // !defined(_WIN32) && !defined(_GNU_SOURCE)
+
+#include "xmmtree.h"
+
+#include <stdlib.h>
+#include <memory.h>
+
+#ifndef _WIN32
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif // _WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ENABLE_XASSERT
+#if ((defined _DEBUG) || (defined DEBUG))
+#define ENABLE_XASSERT 1
+#else // !((defined _DEBUG) || (defined DEBUG))
+#define ENABLE_XASSERT 0
+#endif // ((defined _DEBUG) || (defined DEBUG))
+#endif // ENABLE_XASSERT
+
+#ifndef XASSERT
+#if ENABLE_XASSERT
+#include <assert.h>
+#define XASSERT(xptr)    assert(xptr)
+#else // !ENABLE_XASSERT
+#define XASSERT(xptr)
+#endif // ENABLE_XASSERT
+#endif // XASSERT
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define XMM_STATE_CLEAN     0   ///< 完整状态（与最近一次检查点一致）
+#define XMM_STATE_DIRTY     1   ///< 修改中状态
+
+#define XMM_TREE_OFFS       1024                ///< x_rbtree_t 对象在文件中的偏移量
+#define XMM_NODE_OFFS       XMM_ALIGN_UP(XMM_TREE_OFFS + xrbtree_sizeof(), XMM_ALIGN) ///< 节点区域的起始偏移量
+#define XMM_ALIGN           8                   ///< 节点的对齐字节数
+#define XMM_GROW_MIN        (1024 * 1024)       ///< 文件的最小（扩展）大小
+#define XMM_ALIGN_UP(xsize, xalign) (((xsize) + ((xalign) - 1)) & ~((xrbt_uint64_t)(xalign) - 1))
+
+/** 文件的默认最大容量（即预留的地址空间大小） */
+#define XMM_CAPACITY_DEF    ((sizeof(void *) > 4) ? (64ULL << 30) : (512ULL << 20))
+
+/** 可同时持有读锁的数量（参看 x_mmtree_lock_t） */
+#define XMM_READERS         96
+
+/** 等待读写锁时，检查持有者是否已退出的间隔（毫秒） */
+#define XMM_LOCK_POLL_MS    10
+
+#ifndef _WIN32
+
+/**
+ * @struct x_mmtree_lock_t
+ * @brief  文件头部中的读写锁（共享内存模式下为进程间共享）。
+ * @note
+ * 以 健壮互斥量（PTHREAD_MUTEX_ROBUST）保护以下各字段，持有者异常退出后可恢复：
+ * 1. 读锁 只在登记/注销时短暂持有互斥量，登记的是进程号，
+ *    等待方超时后检查登记的进程是否已退出，并清除已退出进程的登记；
+ * 2. 写锁 在整个修改期间持有互斥量，持有写锁的进程异常退出后，
+ *    下一个取得互斥量的一方收到 EOWNERDEAD，重建红黑树（参看 xmmtree_rebuild()）后继续使用。
+ */
+typedef struct x_mmtree_lock_t
+{
+    pthread_mutex_t xmutex;        ///< 健壮互斥量
+    pthread_cond_t  xcond;         ///< 等待 读锁释放/写锁释放 的条件变量
+    pid_t           xpid_writer;   ///< 持有（或正在等待）写锁的进程（为 0 时表示无）
+    xrbt_uint32_t   xut_writing;   ///< 写锁的持有者是否已开始修改
+    xrbt_uint32_t   xut_readers;   ///< 持有读锁的数量
+    pid_t           xpid_readers[XMM_READERS]; ///< 持有读锁的进程（为 0 时表示空位）
+} x_mmtree_lock_t;
+
+#endif // _WIN32
+
+/**
+ * @struct x_mmtree_head_t
+ * @brief  持久化索引文件的头部（位于文件起始处，字节序为本机字节序）。
+ */
+typedef struct x_mmtree_head_t
+{
+    xrbt_byte_t   xbt_magic[8];    ///< 头部标识（XMMTREE_MAGIC）
+    xrbt_uint32_t xut_state;       ///< 文件状态（XMM_STATE_CLEAN/XMM_STATE_DIRTY）
+    xrbt_uint32_t xut_tsize;       ///< x_rbtree_t 对象的大小（xrbtree_sizeof()，随编译选项变化）
+    xrbt_uint32_t xut_ksize;       ///< 索引键的缓存大小
+    xrbt_uint32_t xut_vsize;       ///< 值数据的缓存大小
+    xrbt_uint32_t xut_flags;       ///< 模式标识
+    xrbt_uint32_t xut_nsize;       ///< 节点的分配大小（首次分配时记录）
+    xrbt_uint64_t xu64_base;       ///< 最近一次映射的基址
+    xrbt_uint64_t xu64_capacity;   ///< 文件的最大容量
+    xrbt_uint64_t xu64_fsize;      ///< 文件的当前大小
+    xrbt_uint64_t xu64_used;       ///< 节点区域已分配到的位置（偏移量）
+    xrbt_uint64_t xu64_free;       ///< 空闲节点链表的首个节点（偏移量，为 0 时表示空）
+    xrbt_uint64_t xu64_checkpoint; ///< 已完成的检查点次数
+    xrbt_uint32_t xut_shared;      ///< 是否为共享内存模式（参看 xmmtree_open_shm()）
+#ifndef _WIN32
+    x_mmtree_lock_t xlock;         ///< 读写锁（共享内存模式下为进程间共享）
+#endif // _WIN32
+} x_mmtree_head_t;
+
+/**
+ * @struct x_mmtree_t
+ * @brief  持久化索引的结构体描述信息（运行时对象，不存储在文件中）。
+ */
+typedef struct x_mmtree_t
+{
+    int               xit_fd;       ///< 文件描述符
+    xrbt_byte_t     * xbt_base;     ///< 映射基址（即文件头部）
+    xrbt_uint64_t     xu64_capacity;///< 预留的地址空间大小
+    xrbt_uint64_t     xu64_psize;   ///< 内存页大小
+    xrbt_ctxt_t       xrbt_ctxt;    ///< 调用方的回调上下文标识
+    xrbt_callback_t   xtree_callback; ///< 红黑树所使用的回调函数（重建红黑树时使用）
+    xrbt_vcallback_t  xvcallback;   ///< 节点值数据的回调函数（重建红黑树时使用）
+    xrbt_bool_t       xbt_relocated;///< 打开时是否映射到了与上次不同的基址
+    xrbt_bool_t       xbt_recovered;///< 打开时是否从 修改中 状态重建了红黑树
+    xrbt_bool_t       xbt_shared;   ///< 是否为共享内存模式
+} x_mmtree_t;
+
+#define XMM_HEAD(xmmtree_ptr)  ((x_mmtree_head_t *)(xmmtree_ptr)->xbt_base)
+#define XMM_TREE(xmmtree_ptr)  ((x_rbtree_ptr)((xmmtree_ptr)->xbt_base + XMM_TREE_OFFS))
+
+/** 创建红黑树时使用的模式标识（共享内存模式下，附加 XRBT_FLAG_SHARED） */
+#define XMM_TREE_FLAGS(xmmtree_ptr, xut_flags) \
+    ((xut_flags) | ((xmmtree_ptr)->xbt_shared ? (xrbt_uint32_t)XRBT_FLAG_SHARED : 0))
+
+/** 文件头部须位于 x_rbtree_t 对象之前 */
+typedef char x_mmtree_head_check_t[(sizeof(x_mmtree_head_t) <= XMM_TREE_OFFS) ? 1 : -1];
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WIN32
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif // !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif // MAP_NORESERVE
+
+/**
+ * 共享内存模式下，串行化本进程内 回调函数的绑定/解除绑定 操作（参看 xrbtree_bind_callback()）：
+ * 红黑树以 XRBT_FLAG_SHARED 模式创建，各进程的回调函数（上下文标识为本进程的 x_mmtree_t 对象）
+ * 记录在本进程的绑定表中，不存储在共享内存段里。
+ */
+static pthread_mutex_t xmmtree_bind_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** 预留地址空间时，要求映射到指定的地址（不支持时，只作为提示地址） */
+#ifdef MAP_FIXED_NOREPLACE
+#define XMM_MAP_HINT  MAP_FIXED_NOREPLACE
+#else // !MAP_FIXED_NOREPLACE
+#define XMM_MAP_HINT  0
+#endif // MAP_FIXED_NOREPLACE
+
+/**********************************************************/
+/**
+ * @brief 同步写入文件头部所在的内存页。
+ */
+static xrbt_bool_t xmmtree_sync_head(x_mmtree_ptr xmmtree_ptr)
+{
+    return (0 == msync(xmmtree_ptr->xbt_base, (size_t)xmmtree_ptr->xu64_psize, MS_SYNC));
+}
+
+/**********************************************************/
+/**
+ * @brief 扩展文件大小（并映射扩展的区域），使节点区域至少可容纳到 xu64_need 位置。
+ */
+static xrbt_bool_t xmmtree_grow(x_mmtree_ptr xmmtree_ptr, xrbt_uint64_t xu64_need)
+{
+    x_mmtree_head_t * xhead_ptr  = XMM_HEAD(xmmtree_ptr);
+    xrbt_uint64_t     xu64_fsize = xhead_ptr->xu64_fsize * 2;
+    void            * xmt_addr   = MAP_FAILED;
+
+    if (xu64_fsize < xu64_need)
+        xu64_fsize = xu64_need;
+    xu64_fsize = XMM_ALIGN_UP(xu64_fsize, xmmtree_ptr->xu64_psize);
+    if (xu64_fsize > xmmtree_ptr->xu64_capacity)
+        xu64_fsize = xmmtree_ptr->xu64_capacity;
+    if (xu64_fsize < xu64_need)
+        return XRBT_FALSE;
+
+    if (0 != ftruncate(xmmtree_ptr->xit_fd, (off_t)xu64_fsize))
+        return XRBT_FALSE;
+
+    xmt_addr = mmap(xmmtree_ptr->xbt_base + xhead_ptr->xu64_fsize,
+                    (size_t)(xu64_fsize - xhead_ptr->xu64_fsize),
+                    PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_FIXED,
+                    xmmtree_ptr->xit_fd,
+                    (off_t)xhead_ptr->xu64_fsize);
+    if (MAP_FAILED == xmt_addr)
+        return XRBT_FALSE;
+
+    xhead_ptr->xu64_fsize = xu64_fsize;
+    return XRBT_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 从节点区域申请节点缓存（优先复用空闲链表中的节点）。
+ * @note
+ * 节点区域已满时，返回 XRBT_NULL ；
+ * 空闲节点的链接头为全 0，下一空闲节点的偏移量存储在链接头之后（参看 xmmtree_rebuild()）。
+ */
+static xrbt_void_t * xmmtree_arena_alloc(xrbt_byte_t * xbt_base, xrbt_size_t xst_nsize)
+{
+    x_mmtree_head_t * xhead_ptr = (x_mmtree_head_t *)xbt_base;
+    xrbt_uint64_t     xu64_offs = 0;
+    xrbt_uint64_t     xu64_size = XMM_ALIGN_UP(xst_nsize, XMM_ALIGN);
+
+    XASSERT((0 == xhead_ptr->xut_nsize) || (xst_nsize == xhead_ptr->xut_nsize));
+    xhead_ptr->xut_nsize = (xrbt_uint32_t)xst_nsize;
+
+    if (0 != xhead_ptr->xu64_free)
+    {
+        xu64_offs = xhead_ptr->xu64_free;
+        memcpy(&xhead_ptr->xu64_free,
+               xbt_base + xu64_offs + sizeof(x_rbtree_link_t),
+               sizeof(xrbt_uint64_t));
+        return (xbt_base + xu64_offs);
+    }
+
+    if (xhead_ptr->xu64_used + xu64_size > xhead_ptr->xu64_fsize)
+    {
+        return XRBT_NULL;
+    }
+
+    xu64_offs = xhead_ptr->xu64_used;
+    xhead_ptr->xu64_used += xu64_size;
+    return (xbt_base + xu64_offs);
+}
+
+/**********************************************************/
+/**
+ * @brief 将节点缓存归还到空闲链表（以相对基址的偏移量串联）。
+ * @note  清零链接头（xiter_parent 为 XRBT_NULL），使遍历节点区域时可区分空闲节点。
+ */
+static xrbt_void_t xmmtree_arena_free(xrbt_byte_t * xbt_base, x_rbnode_iter xiter_node)
+{
+    x_mmtree_head_t * xhead_ptr = (x_mmtree_head_t *)xbt_base;
+
+    memset(xiter_node, 0, sizeof(x_rbtree_link_t));
+    memcpy((xrbt_byte_t *)xiter_node + sizeof(x_rbtree_link_t),
+           &xhead_ptr->xu64_free,
+           sizeof(xrbt_uint64_t));
+    xhead_ptr->xu64_free = (xrbt_uint64_t)((xrbt_byte_t *)xiter_node - xbt_base);
+}
+
+/**********************************************************/
+/**
+ * @brief 从文件的节点区域申请节点缓存的回调函数（节点区域不足时，扩展文件）。
+ * @note  文件已达到容量时，返回 XRBT_NULL（红黑树的插入操作失败，树结构保持不变）。
+ */
+static xrbt_void_t * xmmtree_node_memalloc(xrbt_vkey_t xrbt_vkey,
+                                           xrbt_size_t xst_nsize,
+                                           xrbt_ctxt_t xrbt_ctxt)
+{
+    x_mmtree_ptr      xmmtree_ptr = (x_mmtree_ptr)xrbt_ctxt;
+    x_mmtree_head_t * xhead_ptr   = XMM_HEAD(xmmtree_ptr);
+    xrbt_void_t     * xmt_node    = XRBT_NULL;
+
+    XASSERT(XMM_STATE_DIRTY == xhead_ptr->xut_state);
+
+    xmt_node = xmmtree_arena_alloc(xmmtree_ptr->xbt_base, xst_nsize);
+    if ((XRBT_NULL == xmt_node) &&
+        xmmtree_grow(xmmtree_ptr,
+                     xhead_ptr->xu64_used + XMM_ALIGN_UP(xst_nsize, XMM_ALIGN)))
+    {
+        xmt_node = xmmtree_arena_alloc(xmmtree_ptr->xbt_base, xst_nsize);
+    }
+
+    return xmt_node;
+}
+
+/**********************************************************/
+/**
+ * @brief 将节点缓存归还到文件中的空闲链表的回调函数。
+ */
+static xrbt_void_t xmmtree_node_memfree(x_rbnode_iter xiter_node,
+                                        xrbt_size_t xnode_size,
+                                        xrbt_ctxt_t xrbt_ctxt)
+{
+    x_mmtree_ptr xmmtree_ptr = (x_mmtree_ptr)xrbt_ctxt;
+
+    XASSERT(XMM_STATE_DIRTY == XMM_HEAD(xmmtree_ptr)->xut_state);
+    xmmtree_arena_free(xmmtree_ptr->xbt_base, xiter_node);
+}
+
+/**********************************************************/
+/**
+ * @brief 共享内存模式下，申请节点缓存的回调函数。
+ * @note  共享内存段在创建时即为最大容量，不再扩展；已满时返回 XRBT_NULL（插入操作失败）。
+ */
+static xrbt_void_t * xmmtree_shm_memalloc(xrbt_vkey_t xrbt_vkey,
+                                          xrbt_size_t xst_nsize,
+                                          xrbt_ctxt_t xrbt_ctxt)
+{
+    return xmmtree_arena_alloc(((x_mmtree_ptr)xrbt_ctxt)->xbt_base, xst_nsize);
+}
+
+/**********************************************************/
+/**
+ * @brief 共享内存模式下，释放节点缓存的回调函数。
+ */
+static xrbt_void_t xmmtree_shm_memfree(x_rbnode_iter xiter_node,
+                                       xrbt_size_t xnode_size,
+                                       xrbt_ctxt_t xrbt_ctxt)
+{
+    xmmtree_arena_free(((x_mmtree_ptr)xrbt_ctxt)->xbt_base, xiter_node);
+}
+
+/**********************************************************/
+/**
+ * @brief 生成红黑树所使用的回调函数（节点内存由持久化索引管理）。
+ * @note
+ * 上下文标识为本进程的持久化索引对象（共享内存模式下，只在本进程的绑定表中使用）。
+ */
+static xrbt_void_t xmmtree_callback(x_mmtree_ptr xmmtree_ptr,
+                                    xrbt_callback_t * xcallback,
+                                    xrbt_callback_t * xtree_callback)
+{
+    memset(xtree_callback, 0, sizeof(xrbt_callback_t));
+    if (XRBT_NULL != xcallback)
+    {
+        xtree_callback->xfunc_k_copyfrom = xcallback->xfunc_k_copyfrom;
+        xtree_callback->xfunc_k_destruct = xcallback->xfunc_k_destruct;
+        xtree_callback->xfunc_k_compare  = xcallback->xfunc_k_compare ;
+    }
+
+    if (xmmtree_ptr->xbt_shared)
+    {
+        xtree_callback->xfunc_n_memalloc = &xmmtree_shm_memalloc;
+        xtree_callback->xfunc_n_memfree  = &xmmtree_shm_memfree ;
+    }
+    else
+    {
+        xtree_callback->xfunc_n_memalloc = &xmmtree_node_memalloc;
+        xtree_callback->xfunc_n_memfree  = &xmmtree_node_memfree ;
+    }
+    xtree_callback->xctxt_t_callback = (xrbt_ctxt_t)xmmtree_ptr;
+}
+
+/**********************************************************/
+/**
+ * @brief 预留地址空间（尽量位于 xmt_hint 地址），并将文件映射到预留区域的起始处。
+ */
+static xrbt_byte_t * xmmtree_map(x_mmtree_ptr xmmtree_ptr,
+                                 void * xmt_hint,
+                                 xrbt_uint64_t xu64_fsize)
+{
+    void * xmt_base = MAP_FAILED;
+    void * xmt_file = MAP_FAILED;
+
+    if (XRBT_NULL != xmt_hint)
+    {
+        xmt_base = mmap(xmt_hint, (size_t)xmmtree_ptr->xu64_capacity, PROT_NONE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | XMM_MAP_HINT, -1, 0);
+    }
+
+    if (MAP_FAILED == xmt_base)
+    {
+        xmt_base = mmap(XRBT_NULL, (size_t)xmmtree_ptr->xu64_capacity, PROT_NONE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (MAP_FAILED == xmt_base)
+            return XRBT_NULL;
+    }
+
+    xmt_file = mmap(xmt_base, (size_t)xu64_fsize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_FIXED, xmmtree_ptr->xit_fd, 0);
+    if (MAP_FAILED == xmt_file)
+    {
+        munmap(xmt_base, (size_t)xmmtree_ptr->xu64_capacity);
+        return XRBT_NULL;
+    }
+
+    return (xrbt_byte_t *)xmt_base;
+}
+
+/**********************************************************/
+/**
+ * @brief 遍历节点区域，重建红黑树及空闲链表（调用前须处于 修改中 状态）。
+ * @note
+ * 停靠在红黑树中的节点，其 xiter_parent 总不为 0（根节点指向 nil 节点）；
+ * 空闲节点、备用节点以及 分离中 的节点，其 xiter_parent 为 0 。
+ * 因此，无论进程在何处崩溃，节点区域中 xiter_parent 不为 0 的节点
+ * 即为崩溃时红黑树中的节点（只依据该字段是否为空，不使用其中的链接指针），
+ * 将其重新停靠到新建的红黑树中，其余的节点归还到新建的空闲链表。
+ * 逆序遍历，重建过程中若再次崩溃，已处理的节点依然可被下一次重建识别。
+ *
+ * @return xrbt_size_t
+ *         - 返回重建后红黑树中的节点数量。
+ */
+static xrbt_size_t xmmtree_rebuild(x_mmtree_ptr xmmtree_ptr)
+{
+    x_mmtree_head_t * xhead_ptr  = XMM_HEAD(xmmtree_ptr);
+    x_rbtree_ptr      xtree_ptr  = XMM_TREE(xmmtree_ptr);
+    xrbt_uint64_t     xu64_step  = XMM_ALIGN_UP(xhead_ptr->xut_nsize, XMM_ALIGN);
+    xrbt_uint64_t     xu64_offs  = xhead_ptr->xu64_used;
+    x_rbtree_link_t * xlink_ptr  = XRBT_NULL;
+    x_rbnode_iter     xiter_node = XRBT_NULL;
+
+    xrbtree_emplace_create_ex(xtree_ptr,
+                              xhead_ptr->xut_ksize,
+                              xhead_ptr->xut_vsize,
+                              XMM_TREE_FLAGS(xmmtree_ptr, xhead_ptr->xut_flags),
+                              &xmmtree_ptr->xtree_callback,
+                              &xmmtree_ptr->xvcallback);
+    xhead_ptr->xu64_free = 0;
+
+    if (0 == xu64_step)
+    {
+        return 0;
+    }
+
+    xu64_offs = XMM_NODE_OFFS + ((xu64_offs - XMM_NODE_OFFS) / xu64_step) * xu64_step;
+    while (xu64_offs > XMM_NODE_OFFS)
+    {
+        xu64_offs -= xu64_step;
+        xlink_ptr  = (x_rbtree_link_t *)(xmmtree_ptr->xbt_base + xu64_offs);
+        xiter_node = XRBT_LINK_ITER(xlink_ptr);
+
+        if (0 == xlink_ptr->xiter_parent)
+        {
+            xmmtree_arena_free(xmmtree_ptr->xbt_base, xiter_node);
+            continue;
+        }
+
+        xlink_ptr->xiter_parent = 0;
+        xlink_ptr->xiter_left   = 0;
+        xlink_ptr->xiter_right  = 0;
+
+        // 唯一键模式下，崩溃时可能残留键值重复的节点，只保留其中之一
+        if (xiter_node != xrbtree_dock(xtree_ptr, xiter_node))
+        {
+            xrbtree_node_release(xtree_ptr, xiter_node);
+        }
+    }
+
+    return xrbtree_size(xtree_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 初始化文件头部中的读写锁（共享内存模式下为进程间共享）。
+ */
+static xrbt_bool_t xmmtree_lock_init(x_mmtree_ptr xmmtree_ptr)
+{
+    x_mmtree_lock_t   * xlock_ptr = &XMM_HEAD(xmmtree_ptr)->xlock;
+    pthread_mutexattr_t xmutex_attr;
+    pthread_condattr_t  xcond_attr;
+    xrbt_bool_t         xbt_ok = XRBT_FALSE;
+    int                 xit_pshared =
+        xmmtree_ptr->xbt_shared ? PTHREAD_PROCESS_SHARED : PTHREAD_PROCESS_PRIVATE;
+
+    memset(xlock_ptr, 0, sizeof(x_mmtree_lock_t));
+
+    if (0 != pthread_mutexattr_init(&xmutex_attr))
+        return XRBT_FALSE;
+    if ((0 == pthread_mutexattr_setpshared(&xmutex_attr, xit_pshared)) &&
+        (0 == pthread_mutexattr_setrobust(&xmutex_attr, PTHREAD_MUTEX_ROBUST)))
+    {
+        xbt_ok = (0 == pthread_mutex_init(&xlock_ptr->xmutex, &xmutex_attr));
+    }
+    pthread_mutexattr_destroy(&xmutex_attr);
+    if (!xbt_ok || (0 != pthread_condattr_init(&xcond_attr)))
+        return XRBT_FALSE;
+
+    xbt_ok = (0 == pthread_condattr_setpshared(&xcond_attr, xit_pshared)) &&
+             (0 == pthread_condattr_setclock(&xcond_attr, CLOCK_MONOTONIC)) &&
+             (0 == pthread_cond_init(&xlock_ptr->xcond, &xcond_attr));
+    pthread_condattr_destroy(&xcond_attr);
+
+    return xbt_ok;
+}
+
+/**********************************************************/
+/**
+ * @brief 判断进程是否已退出。
+ */
+static xrbt_bool_t xmmtree_pid_gone(pid_t xpid)
+{
+    return ((0 != kill(xpid, 0)) && (ESRCH == errno));
+}
+
+/**********************************************************/
+/**
+ * @brief 清除已退出的进程所登记的 读锁/写锁（调用前须持有互斥量）。
+ * @note  写锁的登记方只在等待读锁释放时不持有互斥量，此时退出不会留下未完成的修改。
+ */
+static xrbt_void_t xmmtree_lock_reap(x_mmtree_lock_t * xlock_ptr)
+{
+    xrbt_uint32_t xut_iter = 0;
+
+    for (xut_iter = 0; (xut_iter < XMM_READERS) && (xlock_ptr->xut_readers > 0); ++xut_iter)
+    {
+        if ((0 != xlock_ptr->xpid_readers[xut_iter]) &&
+            xmmtree_pid_gone(xlock_ptr->xpid_readers[xut_iter]))
+        {
+            xlock_ptr->xpid_readers[xut_iter] = 0;
+            xlock_ptr->xut_readers -= 1;
+        }
+    }
+
+    if ((0 != xlock_ptr->xpid_writer) && xmmtree_pid_gone(xlock_ptr->xpid_writer))
+    {
+        xlock_ptr->xpid_writer = 0;
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 互斥量的前一持有者异常退出（EOWNERDEAD）后，恢复读写锁及红黑树的一致状态。
+ */
+static xrbt_void_t xmmtree_lock_repair(x_mmtree_ptr xmmtree_ptr)
+{
+    x_mmtree_lock_t * xlock_ptr = &XMM_HEAD(xmmtree_ptr)->xlock;
+
+    // 写锁的持有者在修改期间退出，树结构可能不完整
+    if (xlock_ptr->xut_writing)
+    {
+        xmmtree_modify(xmmtree_ptr);
+        xmmtree_rebuild(xmmtree_ptr);
+        xlock_ptr->xut_writing = 0;
+        xlock_ptr->xpid_writer = 0;
+    }
+
+    xmmtree_lock_reap(xlock_ptr);
+    pthread_mutex_consistent(&xlock_ptr->xmutex);
+}
+
+/**********************************************************/
+/**
+ * @brief 取得读写锁的互斥量。
+ */
+static xrbt_void_t xmmtree_lock_enter(x_mmtree_ptr xmmtree_ptr)
+{
+    if (EOWNERDEAD == pthread_mutex_lock(&XMM_HEAD(xmmtree_ptr)->xlock.xmutex))
+    {
+        xmmtree_lock_repair(xmmtree_ptr);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 等待读写锁的状态变化（调用前须持有互斥量），超时后清除已退出进程的登记。
+ */
+static xrbt_void_t xmmtree_lock_wait(x_mmtree_ptr xmmtree_ptr)
+{
+    x_mmtree_lock_t * xlock_ptr = &XMM_HEAD(xmmtree_ptr)->xlock;
+    struct timespec   xtime_out;
+    int               xit_err = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &xtime_out);
+    xtime_out.tv_nsec += XMM_LOCK_POLL_MS * 1000000L;
+    if (xtime_out.tv_nsec >= 1000000000L)
+    {
+        xtime_out.tv_sec  += 1;
+        xtime_out.tv_nsec -= 1000000000L;
+    }
+
+    xit_err = pthread_cond_timedwait(&xlock_ptr->xcond, &xlock_ptr->xmutex, &xtime_out);
+    if (EOWNERDEAD == xit_err)
+        xmmtree_lock_repair(xmmtree_ptr);
+    else if (ETIMEDOUT == xit_err)
+        xmmtree_lock_reap(xlock_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 创建新的持久化索引文件（文件为空时）。
+ */
+static xrbt_bool_t xmmtree_create_file(x_mmtree_ptr xmmtree_ptr,
+                                       xrbt_size_t xst_ksize,
+                                       xrbt_size_t xst_vsize,
+                                       xrbt_uint32_t xut_flags,
+                                       xrbt_callback_t * xcallback,
+                                       xrbt_vcallback_t * xvcallback)
+{
+    x_mmtree_head_t * xhead_ptr  = XRBT_NULL;
+    xrbt_uint64_t     xu64_used  = XMM_NODE_OFFS;
+    xrbt_uint64_t     xu64_fsize = XMM_ALIGN_UP(XMM_GROW_MIN, xmmtree_ptr->xu64_psize);
+
+    // 共享内存段一次性设置为最大容量（内存页在首次访问时才分配）
+    if (xmmtree_ptr->xbt_shared || (xu64_fsize > xmmtree_ptr->xu64_capacity))
+        xu64_fsize = xmmtree_ptr->xu64_capacity;
+    if ((xu64_used > xu64_fsize) || (0 != ftruncate(xmmtree_ptr->xit_fd, (off_t)xu64_fsize)))
+        return XRBT_FALSE;
+
+    xmmtree_ptr->xbt_base = xmmtree_map(xmmtree_ptr, XRBT_NULL, xu64_fsize);
+    if (XRBT_NULL == xmmtree_ptr->xbt_base)
+        return XRBT_FALSE;
+
+    xhead_ptr = XMM_HEAD(xmmtree_ptr);
+    memcpy(xhead_ptr->xbt_magic, XMMTREE_MAGIC, sizeof(xhead_ptr->xbt_magic));
+    xhead_ptr->xut_state       = XMM_STATE_DIRTY;
+    xhead_ptr->xut_tsize       = xrbtree_sizeof();
+    xhead_ptr->xut_ksize       = (xrbt_uint32_t)xst_ksize;
+    xhead_ptr->xut_vsize       = (xrbt_uint32_t)xst_vsize;
+    xhead_ptr->xut_flags       = xut_flags;
+    xhead_ptr->xut_nsize       = 0;
+    xhead_ptr->xu64_base       = (xrbt_uint64_t)(size_t)xmmtree_ptr->xbt_base;
+    xhead_ptr->xu64_capacity   = xmmtree_ptr->xu64_capacity;
+    xhead_ptr->xu64_fsize      = xu64_fsize;
+    xhead_ptr->xu64_used       = xu64_used;
+    xhead_ptr->xu64_free       = 0;
+    xhead_ptr->xu64_checkpoint = 0;
+    xhead_ptr->xut_shared      = xmmtree_ptr->xbt_shared;
+    if (!xmmtree_lock_init(xmmtree_ptr))
+        return XRBT_FALSE;
+
+    xmmtree_callback(xmmtree_ptr, xcallback, &xmmtree_ptr->xtree_callback);
+    if (XRBT_NULL == xrbtree_emplace_create_ex(XMM_TREE(xmmtree_ptr),
+                                               xst_ksize,
+                                               xst_vsize,
+                                               XMM_TREE_FLAGS(xmmtree_ptr, xut_flags),
+                                               &xmmtree_ptr->xtree_callback,
+                                               &xmmtree_ptr->xvcallback))
+    {
+        return XRBT_FALSE;
+    }
+
+    return xmmtree_checkpoint(xmmtree_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 映射已有的持久化索引文件，并重新挂接其中的红黑树对象。
+ */
+static xrbt_bool_t xmmtree_attach_file(x_mmtree_ptr xmmtree_ptr,
+                                       xrbt_uint64_t xu64_fsize,
+                                       xrbt_size_t xst_ksize,
+                                       xrbt_size_t xst_vsize,
+                                       xrbt_uint32_t xut_flags,
+                                       xrbt_callback_t * xcallback,
+                                       xrbt_vcallback_t * xvcallback)
+{
+    x_mmtree_head_t   xhead;
+    x_mmtree_head_t * xhead_ptr = XRBT_NULL;
+    xrbt_byte_t     * xbt_base  = XRBT_NULL;
+
+    if (sizeof(x_mmtree_head_t) != pread(xmmtree_ptr->xit_fd, &xhead, sizeof(x_mmtree_head_t), 0))
+        return XRBT_FALSE;
+
+    if ((0 != memcmp(xhead.xbt_magic, XMMTREE_MAGIC, sizeof(xhead.xbt_magic))) ||
+        ((xrbt_uint32_t)xmmtree_ptr->xbt_shared != xhead.xut_shared) ||
+        ((XMM_STATE_CLEAN != xhead.xut_state) && (XMM_STATE_DIRTY != xhead.xut_state)) ||
+        (xrbtree_sizeof() != xhead.xut_tsize) ||
+        ((xrbt_uint32_t)xst_ksize != xhead.xut_ksize) ||
+        ((xrbt_uint32_t)xst_vsize != xhead.xut_vsize) ||
+        (xut_flags != xhead.xut_flags) ||
+        (xu64_fsize != xhead.xu64_fsize) ||
+        (xu64_fsize > xhead.xu64_capacity) ||
+        (xhead.xu64_used > xu64_fsize) ||
+        (xhead.xu64_used < XMM_NODE_OFFS) ||
+        ((size_t)xhead.xu64_capacity != xhead.xu64_capacity))
+    {
+        return XRBT_FALSE;
+    }
+
+    xmmtree_ptr->xu64_capacity = xhead.xu64_capacity;
+    xmmtree_ptr->xbt_base = xmmtree_map(xmmtree_ptr, (void *)(size_t)xhead.xu64_base, xu64_fsize);
+    if (XRBT_NULL == xmmtree_ptr->xbt_base)
+        return XRBT_FALSE;
+
+    xhead_ptr = XMM_HEAD(xmmtree_ptr);
+    xbt_base  = xmmtree_ptr->xbt_base;
+    xmmtree_ptr->xbt_relocated = (xhead_ptr->xu64_base != (xrbt_uint64_t)(size_t)xbt_base);
+    xmmtree_callback(xmmtree_ptr, xcallback, &xmmtree_ptr->xtree_callback);
+
+    // 共享内存段正被其他进程使用，不改写其中的任何数据，只为本进程绑定回调函数（可位于任意基址）
+    if (xmmtree_ptr->xbt_shared)
+    {
+        return (XRBT_NULL != xrbtree_emplace_reattach(XMM_TREE(xmmtree_ptr),
+                                                      &xmmtree_ptr->xtree_callback,
+                                                      &xmmtree_ptr->xvcallback,
+                                                      XRBT_NULL, XRBT_NULL));
+    }
+
+    // 之前持有读写锁的进程可能已异常退出，重新初始化
+    if (!xmmtree_lock_init(xmmtree_ptr))
+        return XRBT_FALSE;
+
+    // 修改中 崩溃的文件，其树结构可能不完整，遍历节点区域重建（不使用原先的链接指针）
+    if (XMM_STATE_DIRTY == xhead_ptr->xut_state)
+    {
+        xmmtree_ptr->xbt_recovered = XRBT_TRUE;
+        xhead_ptr->xu64_base = (xrbt_uint64_t)(size_t)xbt_base;
+        xmmtree_rebuild(xmmtree_ptr);
+        return xmmtree_checkpoint(xmmtree_ptr);
+    }
+
+    // 节点之间以自相对偏移量链接，映射到任意基址时都无须重定位，只重新设置回调函数
+    // （记录的基址只作为下次映射的提示地址，不影响文件的一致性）
+    xhead_ptr->xu64_base = (xrbt_uint64_t)(size_t)xbt_base;
+    xrbtree_emplace_reattach(XMM_TREE(xmmtree_ptr),
+                             &xmmtree_ptr->xtree_callback, &xmmtree_ptr->xvcallback,
+                             XRBT_NULL, XRBT_NULL);
+
+    return XRBT_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 以已打开的 文件/共享内存段 描述符，创建或挂接持久化索引（失败时关闭描述符）。
+ * @note
+ * 文件模式下，整个打开期间持有文件的独占锁（flock），同一文件只可被一个进程打开；
+ * 共享内存模式下，只在 创建/挂接 期间持有独占锁，挂接的进程须等待创建的进程完成初始化。
+ */
+static x_mmtree_ptr xmmtree_open_fd(int xit_fd,
+                                    xrbt_bool_t xbt_shared,
+                                    xrbt_bool_t xbt_create,
+                                    xrbt_size_t xst_ksize,
+                                    xrbt_size_t xst_vsize,
+                                    xrbt_uint32_t xut_flags,
+                                    xrbt_uint64_t xu64_capacity,
+                                    xrbt_callback_t * xcallback,
+                                    xrbt_vcallback_t * xvcallback)
+{
+    x_mmtree_ptr  xmmtree_ptr = XRBT_NULL;
+    xrbt_bool_t   xbt_ok      = XRBT_FALSE;
+    xrbt_int32_t  xit_retry   = 0;
+    struct stat   xfile_stat;
+
+    xmmtree_ptr = (x_mmtree_ptr)malloc(sizeof(x_mmtree_t));
+    if (XRBT_NULL == xmmtree_ptr)
+    {
+        close(xit_fd);
+        return XRBT_NULL;
+    }
+
+    memset(xmmtree_ptr, 0, sizeof(x_mmtree_t));
+    xmmtree_ptr->xit_fd        = xit_fd;
+    xmmtree_ptr->xbt_shared    = xbt_shared;
+    xmmtree_ptr->xu64_psize    = (xrbt_uint64_t)sysconf(_SC_PAGESIZE);
+    xmmtree_ptr->xu64_capacity = XMM_ALIGN_UP(
+        (0 != xu64_capacity) ? xu64_capacity : XMM_CAPACITY_DEF, xmmtree_ptr->xu64_psize);
+    xmmtree_ptr->xrbt_ctxt     = (XRBT_NULL != xcallback) ? xcallback->xctxt_t_callback : XRBT_NULL;
+    xut_flags &= XRBT_FLAG_MULTI;
+
+    if (XRBT_NULL != xvcallback)
+        xmmtree_ptr->xvcallback = *xvcallback;
+
+    if (0 != flock(xit_fd, xbt_shared ? LOCK_EX : (LOCK_EX | LOCK_NB)))
+    {
+        close(xit_fd);
+        free(xmmtree_ptr);
+        return XRBT_NULL;
+    }
+
+    // 共享内存模式下，创建/挂接 时为本进程绑定回调函数，与本进程的其他 绑定/解除绑定 操作互斥
+    if (xbt_shared)
+    {
+        pthread_mutex_lock(&xmmtree_bind_mutex);
+    }
+
+    for (xit_retry = 0; xit_retry < 1000; ++xit_retry)
+    {
+        if (0 != fstat(xit_fd, &xfile_stat))
+            break;
+
+        if ((0 != xfile_stat.st_size) || !xbt_shared || xbt_create)
+        {
+            if (0 == xfile_stat.st_size)
+            {
+                xbt_ok = xmmtree_create_file(
+                            xmmtree_ptr, xst_ksize, xst_vsize, xut_flags, xcallback, xvcallback);
+            }
+            else
+            {
+                xbt_ok = xmmtree_attach_file(
+                            xmmtree_ptr, (xrbt_uint64_t)xfile_stat.st_size,
+                            xst_ksize, xst_vsize, xut_flags, xcallback, xvcallback);
+            }
+            break;
+        }
+
+        // 共享内存段已建立，但创建的进程尚未取得独占锁（未初始化）
+        flock(xit_fd, LOCK_UN);
+        usleep(1000);
+        flock(xit_fd, LOCK_EX);
+    }
+
+    if (xbt_shared)
+    {
+        if (!xbt_ok && (XRBT_NULL != xmmtree_ptr->xbt_base))
+            xrbtree_unbind_callback(XMM_TREE(xmmtree_ptr));
+        pthread_mutex_unlock(&xmmtree_bind_mutex);
+        flock(xit_fd, LOCK_UN);
+    }
+
+    if (!xbt_ok)
+    {
+        if (XRBT_NULL != xmmtree_ptr->xbt_base)
+            munmap(xmmtree_ptr->xbt_base, (size_t)xmmtree_ptr->xu64_capacity);
+        close(xit_fd);
+        free(xmmtree_ptr);
+        return XRBT_NULL;
+    }
+
+    return xmmtree_ptr;
+}
+
+#endif // _WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************/
+/**
+ * @brief 打开（不存在或为空文件时，创建）持久化索引文件。
+ */
+x_mmtree_ptr xmmtree_open(const char * xszt_path,
+                          xrbt_size_t xst_ksize,
+                          xrbt_size_t xst_vsize,
+                          xrbt_uint32_t xut_flags,
+                          xrbt_uint64_t xu64_capacity,
+                          xrbt_callback_t * xcallback,
+                          xrbt_vcallback_t * xvcallback)
+{
+    XASSERT(XRBT_NULL != xszt_path);
+    XASSERT(0 == (xut_flags & ~(xrbt_uint32_t)XRBT_FLAG_MULTI));
+
+#ifndef _WIN32
+    int xit_fd = open(xszt_path, O_RDWR | O_CREAT, 0644);
+    if (xit_fd < 0)
+    {
+        return XRBT_NULL;
+    }
+
+    return xmmtree_open_fd(xit_fd, XRBT_FALSE, XRBT_FALSE,
+                           xst_ksize, xst_vsize, xut_flags, xu64_capacity,
+                           xcallback, xvcallback);
+#else // _WIN32
+    return XRBT_NULL;
+#endif // _WIN32
+}
+
+/**********************************************************/
+/**
+ * @brief 打开（不存在时，创建）共享内存模式的持久化索引。
+ */
+x_mmtree_ptr xmmtree_open_shm(const char * xszt_name,
+                              xrbt_size_t xst_ksize,
+                              xrbt_size_t xst_vsize,
+                              xrbt_uint32_t xut_flags,
+                              xrbt_uint64_t xu64_capacity,
+                              xrbt_callback_t * xcallback,
+                              xrbt_vcallback_t * xvcallback)
+{
+    XASSERT(XRBT_NULL != xszt_name);
+    XASSERT(0 == (xut_flags & ~(xrbt_uint32_t)XRBT_FLAG_MULTI));
+
+#ifndef _WIN32
+    x_mmtree_ptr xmmtree_ptr = XRBT_NULL;
+    xrbt_bool_t  xbt_create  = XRBT_TRUE;
+    int          xit_fd      = shm_open(xszt_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+    if (xit_fd < 0)
+    {
+        xbt_create = XRBT_FALSE;
+        xit_fd = shm_open(xszt_name, O_RDWR, 0600);
+        if (xit_fd < 0)
+            return XRBT_NULL;
+    }
+
+    xmmtree_ptr = xmmtree_open_fd(xit_fd, XRBT_TRUE, xbt_create,
+                                  xst_ksize, xst_vsize, xut_flags, xu64_capacity,
+                                  xcallback, xvcallback);
+    if ((XRBT_NULL == xmmtree_ptr) && xbt_create)
+    {
+        shm_unlink(xszt_name);
+    }
+
+    return xmmtree_ptr;
+#else // _WIN32
+    return XRBT_NULL;
+#endif // _WIN32
+}
+
+/**********************************************************/
+/**
+ * @brief 删除共享内存段的名称（已挂接的进程不受影响，全部关闭后释放共享内存）。
+ */
+xrbt_bool_t xmmtree_unlink_shm(const char * xszt_name)
+{
+    XASSERT(XRBT_NULL != xszt_name);
+
+#ifndef _WIN32
+    return (0 == shm_unlink(xszt_name));
+#else // _WIN32
+    return XRBT_FALSE;
+#endif // _WIN32
+}
+
+/**********************************************************/
+/**
+ * @brief 关闭 x_mmtree_t 对象（先执行检查点操作）。
+ */
+xrbt_void_t xmmtree_close(x_mmtree_ptr xmmtree_ptr)
+{
+    XASSERT(XRBT_NULL != xmmtree_ptr);
+
+#ifndef _WIN32
+    xmmtree_checkpoint(xmmtree_ptr);
+
+    if (xmmtree_ptr->xbt_shared)
+    {
+        pthread_mutex_lock(&xmmtree_bind_mutex);
+        xrbtree_unbind_callback(XMM_TREE(xmmtree_ptr));
+        pthread_mutex_unlock(&xmmtree_bind_mutex);
+    }
+
+    munmap(xmmtree_ptr->xbt_base, (size_t)xmmtree_ptr->xu64_capacity);
+    close(xmmtree_ptr->xit_fd);
+    free(xmmtree_ptr);
+#endif // _WIN32
+}
+
+/**********************************************************/
+/**
+ * @brief 返回持久化索引中的红黑树对象，只用于 查找/遍历 等只读操作。
+ */
+x_rbtree_ptr xmmtree_tree(x_mmtree_ptr xmmtree_ptr)
+{
+    XASSERT(XRBT_NULL != xmmtree_ptr);
+    return XMM_TREE(xmmtree_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 将文件标记为 修改中 状态，并返回持久化索引中的红黑树对象，用于修改操作。
+ */
+x_rbtree_ptr xmmtree_modify(x_mmtree_ptr xmmtree_ptr)
+{
+    XASSERT(XRBT_NULL != xmmtree_ptr);
+
+#ifndef _WIN32
+    // 修改中 状态须先于任何被修改的页面落盘（共享内存模式下不涉及磁盘）
+    if (!xmmtree_ptr->xbt_shared && (XMM_STATE_DIRTY != XMM_HEAD(xmmtree_ptr)->xut_state))
+    {
+        XMM_HEAD(xmmtree_ptr)->xut_state = XMM_STATE_DIRTY;
+        xmmtree_sync_head(xmmtree_ptr);
+    }
+#endif // _WIN32
+
+    return XMM_TREE(xmmtree_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 加读锁，返回持久化索引中的红黑树对象（用于 查找/遍历 等只读操作）。
+ */
+x_rbtree_ptr xmmtree_read_lock(x_mmtree_ptr xmmtree_ptr)
+{
+    XASSERT(XRBT_NULL != xmmtree_ptr);
+
+#ifndef _WIN32
+    x_mmtree_lock_t * xlock_ptr = &XMM_HEAD(xmmtree_ptr)->xlock;
+    xrbt_uint32_t     xut_iter  = XMM_READERS;
+
+    xmmtree_lock_enter(xmmtree_ptr);
+    for (;;)
+    {
+        // 写锁优先：有写入方（含等待中的）时，不再登记新的读锁
+        if ((0 == xlock_ptr->xpid_writer) && (xlock_ptr->xut_readers < XMM_READERS))
+        {
+            for (xut_iter = 0; 0 != xlock_ptr->xpid_readers[xut_iter]; ++xut_iter)
+            {
+            }
+            break;
+        }
+
+        xmmtree_lock_wait(xmmtree_ptr);
+    }
+
+    xlock_ptr->xpid_readers[xut_iter] = getpid();
+    xlock_ptr->xut_readers += 1;
+    pthread_mutex_unlock(&xlock_ptr->xmutex);
+#endif // _WIN32
+
+    return XMM_TREE(xmmtree_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 解除 xmmtree_read_lock() 所加的读锁。
+ */
+xrbt_void_t xmmtree_read_unlock(x_mmtree_ptr xmmtree_ptr)
+{
+    XASSERT(XRBT_NULL != xmmtree_ptr);
+
+#ifndef _WIN32
+    x_mmtree_lock_t * xlock_ptr = &XMM_HEAD(xmmtree_ptr)->xlock;
+    pid_t             xpid_self = getpid();
+    xrbt_uint32_t     xut_iter  = 0;
+
+    xmmtree_lock_enter(xmmtree_ptr);
+
+    // 同一进程登记的各个读锁可互换，注销其中任一个即可
+    for (xut_iter = 0; xut_iter < XMM_READERS; ++xut_iter)
+    {
+        if (xpid_self == xlock_ptr->xpid_readers[xut_iter])
+        {
+            xlock_ptr->xpid_readers[xut_iter] = 0;
+            xlock_ptr->xut_readers -= 1;
+            break;
+        }
+    }
+
+    XASSERT(xut_iter < XMM_READERS);
+    if ((0 == xlock_ptr->xut_readers) || (0 == xlock_ptr->xpid_writer))
+        pthread_cond_broadcast(&xlock_ptr->xcond);
+    pthread_mutex_unlock(&xlock_ptr->xmutex);
+#endif // _WIN32
+}
+
+/**********************************************************/
+/**
+ * @brief 加写锁，返回持久化索引中的红黑树对象（用于修改操作，参看 xmmtree_modify()）。
+ */
+x_rbtree_ptr xmmtree_write_lock(x_mmtree_ptr xmmtree_ptr)
+{
+    XASSERT(XRBT_NULL != xmmtree_ptr);
+
+#ifndef _WIN32
+    x_mmtree_lock_t * xlock_ptr = &XMM_HEAD(xmmtree_ptr)->xlock;
+
+    xmmtree_lock_enter(xmmtree_ptr);
+    while (0 != xlock_ptr->xpid_writer)
+    {
+        xmmtree_lock_wait(xmmtree_ptr);
+    }
+
+    xlock_ptr->xpid_writer = getpid();
+    while (0 != xlock_ptr->xut_readers)
+    {
+        xmmtree_lock_wait(xmmtree_ptr);
+    }
+
+    // 修改期间一直持有互斥量，异常退出时由下一个持有者收到 EOWNERDEAD 并重建红黑树
+    xlock_ptr->xut_writing = 1;
+#endif // _WIN32
+
+    return xmmtree_modify(xmmtree_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 解除 xmmtree_write_lock() 所加的写锁。
+ */
+xrbt_void_t xmmtree_write_unlock(x_mmtree_ptr xmmtree_ptr)
+{
+    XASSERT(XRBT_NULL != xmmtree_ptr);
+
+#ifndef _WIN32
+    x_mmtree_lock_t * xlock_ptr = &XMM_HEAD(xmmtree_ptr)->xlock;
+
+    xlock_ptr->xut_writing = 0;
+    xlock_ptr->xpid_writer = 0;
+    pthread_cond_broadcast(&xlock_ptr->xcond);
+    pthread_mutex_unlock(&xlock_ptr->xmutex);
+#endif // _WIN32
+}
+
+/**********************************************************/
+/**
+ * @brief 执行检查点操作：将所有修改同步到磁盘，并将文件标记为 完整 状态。
+ */
+xrbt_bool_t xmmtree_checkpoint(x_mmtree_ptr xmmtree_ptr)
+{
+    XASSERT(XRBT_NULL != xmmtree_ptr);
+
+#ifndef _WIN32
+    x_mmtree_head_t * xhead_ptr = XMM_HEAD(xmmtree_ptr);
+
+    if (xmmtree_ptr->xbt_shared || (XMM_STATE_CLEAN == xhead_ptr->xut_state))
+    {
+        return XRBT_TRUE;
+    }
+
+    // 先同步所有节点（及扩展文件大小的元数据），再同步 完整 状态
+    if ((0 != msync(xmmtree_ptr->xbt_base, (size_t)xhead_ptr->xu64_fsize, MS_SYNC)) ||
+        (0 != fsync(xmmtree_ptr->xit_fd)))
+    {
+        return XRBT_FALSE;
+    }
+
+    xhead_ptr->xut_state        = XMM_STATE_CLEAN;
+    xhead_ptr->xu64_checkpoint += 1;
+    if (!xmmtree_sync_head(xmmtree_ptr))
+    {
+        xhead_ptr->xut_state = XMM_STATE_DIRTY;
+        return XRBT_FALSE;
+    }
+
+    return XRBT_TRUE;
+#else // _WIN32
+    return XRBT_FALSE;
+#endif // _WIN32
+}
+
+/**********************************************************/
+/**
+ * @brief 遍历节点区域，重建红黑树及空闲链表，并执行检查点操作。
+ */
+xrbt_size_t xmmtree_recover(x_mmtree_ptr xmmtree_ptr)
+{
+    XASSERT(XRBT_NULL != xmmtree_ptr);
+
+#ifndef _WIN32
+    xrbt_size_t xst_count = 0;
+
+    xmmtree_modify(xmmtree_ptr);
+    xst_count = xmmtree_rebuild(xmmtree_ptr);
+    xmmtree_checkpoint(xmmtree_ptr);
+
+    return xst_count;
+#else // _WIN32
+    return 0;
+#endif // _WIN32
+}
+
+/**********************************************************/
+/**
+ * @brief 返回打开 x_mmtree_t 对象时，调用方的回调上下文标识。
+ */
+xrbt_ctxt_t xmmtree_ctxt(x_mmtree_ptr xmmtree_ptr)
+{
+    XASSERT(XRBT_NULL != xmmtree_ptr);
+    return xmmtree_ptr->xrbt_ctxt;
+}
+
+/**********************************************************/
+/**
+ * @brief 返回持久化索引文件的当前大小（字节数）。
+ */
+xrbt_uint64_t xmmtree_file_size(x_mmtree_ptr xmmtree_ptr)
+{
+    XASSERT(XRBT_NULL != xmmtree_ptr);
+    return XMM_HEAD(xmmtree_ptr)->xu64_fsize;
+}
+
+/**********************************************************/
+/**
+ * @brief 返回最近一次打开时，是否因映射基址变化而重定位了所有节点。
+ */
+xrbt_bool_t xmmtree_relocated(x_mmtree_ptr xmmtree_ptr)
+{
+    XASSERT(XRBT_NULL != xmmtree_ptr);
+    return xmmtree_ptr->xbt_relocated;
+}
+
+/**********************************************************/
+/**
+ * @brief 返回最近一次打开时，是否因文件处于 修改中 状态而重建了红黑树。
+ */
+xrbt_bool_t xmmtree_recovered(x_mmtree_ptr xmmtree_ptr)
+{
+    XASSERT(XRBT_NULL != xmmtree_ptr);
+    return xmmtree_ptr->xbt_recovered;
+}
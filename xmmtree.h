@@ -0,0 +1,266 @@
+﻿/**
+ * @file    xmmtree.h
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * 文件名称：xmmtree.h
+ * 创建日期：2019年09月09日
+ * 文件标识：
+ * 文件摘要：基于红黑树（x_rbtree_t）的文件映射（mmap）持久化索引。
+ *
+ * 当前版本：1.0.0.0
+ * 作    者：
+ * 完成日期：2019年09月09日
+ * 版本摘要：
+ *
+ * 历史版本：
+ * 原作者  ：
+ * 完成日期：
+ * 版本摘要：
+ * </pre>
+ */
+
+#ifndef __XMMTREE_H__
+#define __XMMTREE_H__
+
+#include "xrbtree.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+////////////////////////////////////////////////////////////////////////////////
+// 持久化索引的相关数据定义以及操作接口
+
+//====================================================================
+
+//
+// 持久化索引的相关数据定义
+//
+
+/**
+ * 持久化索引 将 x_rbtree_t 对象及其全部节点存放在同一个文件中，经 mmap 映射后直接使用：
+ * 1. 文件头部记录 映射基址、容量、节点分配的位置 等信息，随后是 x_rbtree_t 对象
+ *    （含 xiter_root、xiter_lnode、xiter_rnode 等），再之后是节点区域；
+ * 2. 打开时预留 容量 大小的地址空间，并尽量映射到文件记录的基址；节点之间以自相对偏移量链接
+ *    （参看 xrbt_lofs_t），映射到任意地址时都无须任何加载操作（O(1)），
+ *    页面在查询访问时才按需载入；
+ * 3. 节点从文件的节点区域分配，释放的节点以 相对基址的偏移量 串联为空闲链表（存储在文件中）；
+ *    节点区域不足时，按倍增方式扩展文件（不超过容量）；文件达到容量、且空闲链表为空时，
+ *    插入操作失败（返回 xrbtree_end()，xbt_ok 为 XRBT_FALSE），红黑树保持不变，
+ *    删除节点后可继续插入；
+ * 4. 检查点（xmmtree_checkpoint()）将修改同步到磁盘后，把文件标记为 完整 状态；
+ *    修改前（xmmtree_modify()）先同步地将文件标记为 修改中 状态。
+ *    检查点之后若没有修改，进程崩溃后文件即为该检查点的状态；
+ *    修改中崩溃的文件，其树结构可能不完整，重新打开时遍历节点区域重建红黑树
+ *    （xmmtree_recover()，O(n log n)），得到崩溃时已停靠在红黑树中的全部节点，
+ *    崩溃时正在进行的单个 插入/删除 操作可能生效，也可能未生效。
+ *    以上只针对 进程崩溃（修改过的页面仍在操作系统的页缓存中，最终会完整写回文件）；
+ *    修改中 状态下发生 掉电 或 操作系统崩溃 时，页面可能只写回了一部分（撕裂的节点），
+ *    节点未设校验（键值可被原地修改），重建时无法识别这类节点，其结果不受保证，
+ *    对此有要求时，应在检查点之后另行备份文件。
+ * 索引键、值数据 须为平凡类型（可按字节拷贝，且不含指针）；红黑树的 回调上下文标识
+ * 被持久化索引对象占用，回调函数中可通过 xmmtree_ctxt() 取得调用方的上下文标识。
+ * 只在 POSIX 系统上实现，其他平台上 xmmtree_open() 总是返回 XRBT_NULL 。
+ *
+ * 共享内存模式（xmmtree_open_shm()）下，多个进程挂接同一个 POSIX 共享内存段，
+ * 共用其中的红黑树（只占用一份物理内存）：
+ * 1. 各进程可将共享内存段映射到不同的基址（节点以自相对偏移量链接），
+ *    独立启动的进程（包括 PIE 程序、不同的可执行程序）均可挂接
+ *    （fork 产生的子进程继承了映射，应直接使用所继承的对象，而不再次挂接）；
+ * 2. 红黑树以 XRBT_FLAG_SHARED 模式创建，共享内存段中不存储任何回调函数的地址，
+ *    每个进程 创建/挂接 时为本进程绑定自己的回调函数（参看 xrbtree_bind_callback()），
+ *    关闭时解除绑定；各进程的比较回调须给出相同的次序。回调函数收到的上下文标识为本进程的
+ *    x_mmtree_t 对象，与文件模式相同，可通过 xmmtree_ctxt() 取得本进程调用方的上下文标识；
+ *    每个进程可同时挂接的共享内存段数量不超过 XRBT_BIND_MAX ，超出时挂接失败；
+ * 3. 共享内存段在创建时即为最大容量（内存页在首次访问时才分配），不再扩展，
+ *    节点区域用尽后的插入操作失败（与文件模式相同）；
+ * 4. 以进程间共享的读写锁同步：查找、遍历 在 xmmtree_read_lock()/xmmtree_read_unlock()
+ *    之间进行，可多个进程并发；修改在 xmmtree_write_lock()/xmmtree_write_unlock() 之间进行；
+ *    读写锁基于健壮互斥量（PTHREAD_MUTEX_ROBUST）：持有读锁的进程异常退出后，其登记被清除；
+ *    持有写锁的进程异常退出后，下一个加锁的进程重建红黑树（参看 xmmtree_recover()）后继续使用；
+ * 5. 不涉及磁盘，xmmtree_checkpoint() 不执行任何操作。
+ */
+
+/** 声明持久化索引结构体 */
+struct x_mmtree_t;
+
+/** 声明持久化索引对象指针 */
+typedef struct x_mmtree_t * x_mmtree_ptr;
+
+/** 持久化索引文件的头部标识 */
+#define XMMTREE_MAGIC   "XMMTREE3"
+
+//====================================================================
+
+//
+// 持久化索引的相关操作接口
+//
+
+/**********************************************************/
+/**
+ * @brief 打开（不存在或为空文件时，创建）持久化索引文件。
+ * @note  应使用 @see xmmtree_close() 关闭所打开的对象。
+ *
+ * @param [in ] xszt_path     : 文件路径（同一文件只可被一个进程打开）。
+ * @param [in ] xst_ksize     : 索引键数据类型所需的缓存大小（须与文件中的一致）。
+ * @param [in ] xst_vsize     : 值数据类型所需的缓存大小（为 0 时，不使用映射表模式；须与文件中的一致）。
+ * @param [in ] xut_flags     : 模式标识（只可为 0 或 XRBT_FLAG_MULTI；须与文件中的一致）。
+ * @param [in ] xu64_capacity : 创建文件时，文件的最大容量（字节数，为 0 时使用默认值）；
+ *                              打开已有文件时忽略，使用文件中记录的容量；
+ *                              节点区域用尽时，插入操作失败（参看 文件头部的说明 3）。
+ * @param [in ] xcallback     : 节点操作的相关回调函数（只使用 拷贝/析构/比较 回调
+ *                              与 调用方的上下文标识，可为 XRBT_NULL）。
+ * @param [in ] xvcallback    : 节点值数据的相关回调函数（可为 XRBT_NULL）。
+ *
+ * @return x_mmtree_ptr
+ *         - 成功，返回 x_mmtree_t 对象；
+ *         - 失败，返回 XRBT_NULL （文件处于 修改中 状态时，重建红黑树，参看 xmmtree_recovered()）。
+ */
+x_mmtree_ptr xmmtree_open(const char * xszt_path,
+                          xrbt_size_t xst_ksize,
+                          xrbt_size_t xst_vsize,
+                          xrbt_uint32_t xut_flags,
+                          xrbt_uint64_t xu64_capacity,
+                          xrbt_callback_t * xcallback,
+                          xrbt_vcallback_t * xvcallback);
+
+/**********************************************************/
+/**
+ * @brief 打开（不存在时，创建）共享内存模式的持久化索引（参看 文件头部的说明）。
+ * @note  应使用 @see xmmtree_close() 关闭所打开的对象。
+ *
+ * @param [in ] xszt_name     : 共享内存段的名称（shm_open() 的名称，如 "/my_index"）。
+ * @param [in ] xst_ksize     : 索引键数据类型所需的缓存大小（须与创建时的一致）。
+ * @param [in ] xst_vsize     : 值数据类型所需的缓存大小（须与创建时的一致）。
+ * @param [in ] xut_flags     : 模式标识（只可为 0 或 XRBT_FLAG_MULTI；须与创建时的一致）。
+ * @param [in ] xu64_capacity : 创建时，共享内存段的大小（为 0 时使用默认值）；挂接时忽略；
+ *                              节点区域用尽时，插入操作失败。
+ * @param [in ] xcallback     : 节点操作的相关回调函数（只使用 拷贝/析构/比较 回调，
+ *                              语义须与创建时的一致，可为 XRBT_NULL）。
+ * @param [in ] xvcallback    : 节点值数据的相关回调函数（语义须与创建时的一致，可为 XRBT_NULL）。
+ *
+ * @return x_mmtree_ptr
+ *         - 成功，返回 x_mmtree_t 对象；
+ *         - 失败，返回 XRBT_NULL 。
+ */
+x_mmtree_ptr xmmtree_open_shm(const char * xszt_name,
+                              xrbt_size_t xst_ksize,
+                              xrbt_size_t xst_vsize,
+                              xrbt_uint32_t xut_flags,
+                              xrbt_uint64_t xu64_capacity,
+                              xrbt_callback_t * xcallback,
+                              xrbt_vcallback_t * xvcallback);
+
+/**********************************************************/
+/**
+ * @brief 删除共享内存段的名称（已挂接的进程不受影响，全部关闭后释放共享内存）。
+ */
+xrbt_bool_t xmmtree_unlink_shm(const char * xszt_name);
+
+/**********************************************************/
+/**
+ * @brief 关闭 x_mmtree_t 对象（先执行检查点操作）。
+ */
+xrbt_void_t xmmtree_close(x_mmtree_ptr xmmtree_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回持久化索引中的红黑树对象，只用于 查找/遍历 等只读操作。
+ */
+x_rbtree_ptr xmmtree_tree(x_mmtree_ptr xmmtree_ptr);
+
+/**********************************************************/
+/**
+ * @brief 将文件标记为 修改中 状态，并返回持久化索引中的红黑树对象，用于修改操作。
+ * @note
+ * 每次修改红黑树（插入、删除、清除 等）之前都须通过该接口取得红黑树对象；
+ * 自上一次检查点以来首次调用时，同步写入文件头部（一次 msync），其后为 O(1) 。
+ */
+x_rbtree_ptr xmmtree_modify(x_mmtree_ptr xmmtree_ptr);
+
+/**********************************************************/
+/**
+ * @brief 加读锁，返回持久化索引中的红黑树对象（用于 查找/遍历 等只读操作）。
+ * @note  文件模式下，可用于同一进程中多个线程之间的同步。
+ */
+x_rbtree_ptr xmmtree_read_lock(x_mmtree_ptr xmmtree_ptr);
+
+/**********************************************************/
+/**
+ * @brief 解除 xmmtree_read_lock() 所加的读锁。
+ */
+xrbt_void_t xmmtree_read_unlock(x_mmtree_ptr xmmtree_ptr);
+
+/**********************************************************/
+/**
+ * @brief 加写锁，返回持久化索引中的红黑树对象（用于修改操作，同时完成 xmmtree_modify() 的操作）。
+ */
+x_rbtree_ptr xmmtree_write_lock(x_mmtree_ptr xmmtree_ptr);
+
+/**********************************************************/
+/**
+ * @brief 解除 xmmtree_write_lock() 所加的写锁。
+ */
+xrbt_void_t xmmtree_write_unlock(x_mmtree_ptr xmmtree_ptr);
+
+/**********************************************************/
+/**
+ * @brief 执行检查点操作：将所有修改同步到磁盘，并将文件标记为 完整 状态。
+ *
+ * @return xrbt_bool_t
+ *         - 成功，返回 XRBT_TRUE；
+ *         - 失败，返回 XRBT_FALSE（文件保持 修改中 状态）。
+ */
+xrbt_bool_t xmmtree_checkpoint(x_mmtree_ptr xmmtree_ptr);
+
+/**********************************************************/
+/**
+ * @brief 遍历节点区域，重建红黑树及空闲链表，并执行检查点操作（O(n log n)）。
+ * @note
+ * 文件处于 修改中 状态时，xmmtree_open() 会自动执行该操作；
+ * 也可用于怀疑树结构已损坏的场合（如 写锁持有者异常退出后）。
+ * 只能修复 进程崩溃 造成的不完整树结构，不能修复 掉电 造成的撕裂节点（参看文件开头的说明）。
+ * 共享内存模式下，须在 xmmtree_write_lock()/xmmtree_write_unlock() 之间调用。
+ *
+ * @return xrbt_size_t
+ *         - 返回重建后红黑树中的节点数量。
+ */
+xrbt_size_t xmmtree_recover(x_mmtree_ptr xmmtree_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回打开 x_mmtree_t 对象时，调用方的回调上下文标识（参看 xmmtree_open()）。
+ */
+xrbt_ctxt_t xmmtree_ctxt(x_mmtree_ptr xmmtree_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回持久化索引文件的当前大小（字节数）。
+ */
+xrbt_uint64_t xmmtree_file_size(x_mmtree_ptr xmmtree_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回最近一次打开时，是否映射到了与上次不同的基址（节点无须重定位，只作为诊断信息）。
+ */
+xrbt_bool_t xmmtree_relocated(x_mmtree_ptr xmmtree_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回最近一次打开时，是否因文件处于 修改中 状态而重建了红黑树（参看 xmmtree_recover()）。
+ */
+xrbt_bool_t xmmtree_recovered(x_mmtree_ptr xmmtree_ptr);
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}; // extern "C"
+#endif // __cplusplus
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XMMTREE_H__
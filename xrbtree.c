@@ -23,6 +23,8 @@
 #include "xrbtree.h"
 
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdio.h>
 #include <memory.h>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -55,6 +57,48 @@
 
 typedef xrbt_byte_t xrbt_vkey_ptr;
 
+/**
+ * 编译时定义 XRBTREE_ENABLE_STATS 为 1，开启操作统计功能（参看 xrbtree_get_stats()）；
+ * 未开启时，所有统计操作均为空操作，不产生任何额外开销。
+ */
+#ifndef XRBTREE_ENABLE_STATS
+#define XRBTREE_ENABLE_STATS 0
+#endif // XRBTREE_ENABLE_STATS
+
+/**
+ * 若编译环境提供 <sys/sdt.h>（systemtap-sdt-dev），则自动开启 USDT 静态探测点，
+ * 以便 bpftrace/perf/systemtap 在运行时挂接（未挂接时，每个探测点只是一条 nop 指令）；
+ * 可定义 XRBTREE_DISABLE_USDT 强制关闭。探测点列表参看 bpftrace/README.md 。
+ */
+#ifndef XRBTREE_ENABLE_USDT
+#if !defined(XRBTREE_DISABLE_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define XRBTREE_ENABLE_USDT 1
+#endif // __has_include(<sys/sdt.h>)
+#endif // !defined(XRBTREE_DISABLE_USDT) && defined(__has_include)
+#endif // XRBTREE_ENABLE_USDT
+
+#ifndef XRBTREE_ENABLE_USDT
+#define XRBTREE_ENABLE_USDT 0
+#endif // XRBTREE_ENABLE_USDT
+
+#if XRBTREE_ENABLE_USDT
+#include <sys/sdt.h>
+#endif // XRBTREE_ENABLE_USDT
+
+/**
+ * 编译时定义 XRBTREE_ENABLE_RECORD 为 1，开启操作记录功能（参看 xrbtree_record_start()）；
+ * 未开启记录文件时，每个记录点只是一次指针判断。记录的时间戳取自 clock_gettime(CLOCK_MONOTONIC)，
+ * 编译环境未提供该接口时（如严格的 -std=c99），退化为 clock() 。
+ */
+#ifndef XRBTREE_ENABLE_RECORD
+#define XRBTREE_ENABLE_RECORD 0
+#endif // XRBTREE_ENABLE_RECORD
+
+#if XRBTREE_ENABLE_RECORD
+#include <time.h>
+#endif // XRBTREE_ENABLE_RECORD
+
 /**
  * @struct x_rbtree_node_t
  * @brief  红黑树所使用的节点结构体描述信息。
@@ -62,10 +106,11 @@ typedef xrbt_byte_t xrbt_vkey_ptr;
 typedef struct x_rbtree_node_t
 {
     xrbt_uint32_t xut_color :  1;  ///< 颜色值
-    xrbt_uint32_t xut_ksize : 31;  ///< 索引键缓存大小（对于 NIL 节点，该值始终为 0）
-    x_rbnode_iter xiter_parent;    ///< 父节点
-    x_rbnode_iter xiter_left;      ///< 左子树
-    x_rbnode_iter xiter_right;     ///< 右子树
+    xrbt_uint32_t xut_kmode :  3;  ///< 索引键的存储方式（参看 XNODE_KMODE_* 宏定义）
+    xrbt_uint32_t xut_ksize : 28;  ///< 索引键缓存大小（对于 NIL 节点，该值始终为 0）
+    xrbt_lofs_t   xiter_parent;    ///< 父节点（自相对偏移量，参看 XNODE_PARENT()）
+    xrbt_lofs_t   xiter_left;      ///< 左子树（自相对偏移量，参看 XNODE_LEFT()）
+    xrbt_lofs_t   xiter_right;     ///< 右子树（自相对偏移量，参看 XNODE_RIGHT()）
 
 #ifdef _MSC_VER
 #pragma warning(disable:4200)
@@ -77,6 +122,10 @@ typedef struct x_rbtree_node_t
 
 } x_rbtree_node_t;
 
+/** 侵入模式的链接头（x_rbtree_link_t）须与节点头部的内存布局一致 */
+typedef char x_rbtree_link_check_t[
+    (sizeof(x_rbtree_link_t) == sizeof(x_rbtree_node_t)) ? 1 : -1];
+
 /**
  * @struct x_rbtree_nil_t
  * @brief  红黑树所使用的 nil 节点结构体描述信息（其继承自 x_rbtree_node_t ）。
@@ -84,13 +133,35 @@ typedef struct x_rbtree_node_t
 typedef struct x_rbtree_nil_t
 {
     xrbt_uint32_t xut_color :  1; ///< 颜色值
-    xrbt_uint32_t xut_ksize : 31; ///< 索引键缓存大小（对于 NIL 节点，该值始终为 0）
-    x_rbnode_iter xiter_parent;   ///< 父节点
-    x_rbnode_iter xiter_left;     ///< 左子树
-    x_rbnode_iter xiter_right;    ///< 右子树
-    x_rbtree_ptr  xower_ptr;      ///< 指向所属红黑树
+    xrbt_uint32_t xut_kmode :  3; ///< 索引键的存储方式（参看 XNODE_KMODE_* 宏定义）
+    xrbt_uint32_t xut_ksize : 28; ///< 索引键缓存大小（对于 NIL 节点，该值始终为 0）
+    xrbt_lofs_t   xiter_parent;   ///< 父节点
+    xrbt_lofs_t   xiter_left;     ///< 左子树
+    xrbt_lofs_t   xiter_right;    ///< 右子树
+    xrbt_lofs_t   xower_ptr;      ///< 所属红黑树（自相对偏移量）
 } x_rbtree_nil_t;
 
+/**
+ * @struct x_rbtree_bkey_t
+ * @brief  借用索引键模式下，节点中存储的索引键描述信息。
+ */
+typedef struct x_rbtree_bkey_t
+{
+    xrbt_vkey_t   xrbt_kptr;      ///< 借用的（由调用方持有的）索引键
+    xrbt_uint32_t xut_khash;      ///< 索引键的哈希值（未设置哈希回调时为 0）
+} x_rbtree_bkey_t;
+
+/**
+ * @struct x_rbtree_probe_t
+ * @brief  定位操作中所使用的索引键描述信息（每次操作只计算一次 前缀值/哈希值）。
+ */
+typedef struct x_rbtree_probe_t
+{
+    xrbt_vkey_t   xrbt_vkey;      ///< 索引键值
+    xrbt_uint64_t xu64_prefix;    ///< 索引键的前缀值（XNODE_KMODE_PREFIX 模式下有效）
+    xrbt_uint32_t xut_khash;      ///< 索引键的哈希值（设置了哈希回调时有效）
+} x_rbtree_probe_t;
+
 /**
  * @struct x_rbtree_t
  * @brief  红黑树的结构体描述信息。
@@ -98,12 +169,37 @@ typedef struct x_rbtree_nil_t
 typedef struct x_rbtree_t
 {
     xrbt_size_t      xst_ksize;    ///< 节点索引键的缓存大小
+    xrbt_size_t      xst_vsize;    ///< 节点值数据的缓存大小（映射表模式，否则为 0）
+    xrbt_size_t      xst_nsize;    ///< 节点对象的缓存大小
+    xrbt_uint32_t    xut_flags;    ///< 模式标识（参看 emXRBtreeFlags 枚举值）
+    xrbt_uint32_t    xut_kmode;    ///< 节点索引键的存储方式（参看 XNODE_KMODE_* 宏定义）
+    xrbt_uint32_t    xut_lkoffs;   ///< 侵入模式下，写入链接头 xut_ksize 字段的（偏置后的）索引键偏移量
     xrbt_callback_t  xcallback;    ///< 节点操作的相关回调函数
+    xfunc_vkey_prefix_t xfunc_k_prefix; ///< 计算索引键前缀值的回调函数（可为 XRBT_NULL）
+    xfunc_vkey_hash_t   xfunc_k_hash  ; ///< 计算索引键哈希值的回调函数（可为 XRBT_NULL）
+    xrbt_vcallback_t xvcallback;   ///< 节点值数据的相关回调函数（映射表模式）
     xrbt_size_t      xst_count;    ///< 当前节点数量
     x_rbtree_nil_t   xnode_nil;    ///< nil 节点
-    x_rbnode_iter    xiter_root;   ///< 根节点
-    x_rbnode_iter    xiter_lnode;  ///< 最左侧节点
-    x_rbnode_iter    xiter_rnode;  ///< 最右侧节点
+    xrbt_lofs_t      xiter_root;   ///< 根节点（以下链接字段均为自相对偏移量，参看 XLINK_GET()）
+    xrbt_lofs_t      xiter_lnode;  ///< 最左侧节点
+    xrbt_lofs_t      xiter_rnode;  ///< 最右侧节点
+    xrbt_lofs_t      xiter_spare;  ///< 缓存的备用节点（未构造索引键的节点缓存，可为 XRBT_NULL；
+                                   ///< XRBT_FLAG_NOFREE 模式下为以 xiter_parent 串联的链表）
+    xrbt_lofs_t      xiter_reclaim; ///< 分步清除中，待释放节点的根（没有时为 XRBT_NULL；参看 xrbtree_clear_step()）
+    xrbt_lofs_t      xiter_rnil;    ///< 待释放节点所引用的 nil 节点（只用于比较，不访问其内容）
+    xrbt_size_t      xst_reclaim;   ///< 待释放的节点数量
+#if XRBTREE_ENABLE_STATS
+    xrbt_uint32_t    xut_stat_op;  ///< 当前执行的操作类型（参看 emXRBtreeStatsOp 枚举值）
+    xrbt_stats_t     xstats;       ///< 操作统计信息
+#endif // XRBTREE_ENABLE_STATS
+#if XRBTREE_ENABLE_USDT
+    xrbt_uint32_t    xut_trace_depth;  ///< 最近一次定位操作的深度（供探测点使用）
+    xrbt_uint32_t    xut_trace_rotate; ///< 旋转操作的累计次数（供探测点使用）
+#endif // XRBTREE_ENABLE_USDT
+#if XRBTREE_ENABLE_RECORD
+    FILE           * xfile_record;     ///< 操作记录文件（未开启记录时为 XRBT_NULL）
+    xrbt_uint64_t    xu64_record_tm;   ///< 上一条记录的时间戳（纳秒）
+#endif // XRBTREE_ENABLE_RECORD
 } x_rbtree_t;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -111,46 +207,200 @@ typedef struct x_rbtree_t
 #define X_RED    0
 #define X_BLACK  1
 
+#define XNODE_KMODE_PREFIX  0x1  ///< 节点索引键缓存的首部存储 8 字节的索引键前缀值
+#define XNODE_KMODE_BORROW  0x2  ///< 节点只存储借用的索引键指针（x_rbtree_bkey_t）
+#define XNODE_KMODE_LINK    0x4  ///< 节点为调用方对象中的链接头，索引键位于相对链接头的固定偏移处
+
+#define XNODE_KSIZE_MAX     0x0FFFFFFF
+
+/**
+ * 侵入模式下，链接头的 xut_ksize 字段存储 索引键偏移量 + XNODE_LINK_KBIAS，
+ * 使得偏移量可为负值，且该字段总是非 0（不会被误判为 NIL 节点）。
+ */
+#define XNODE_LINK_KBIAS    0x08000000
+#define XNODE_LINK_KOFFS(xiter_node)                                       \
+            ((xrbt_int32_t)(xiter_node)->xut_ksize - XNODE_LINK_KBIAS)     \
+
 #define XNODE_SPIN_CLR(xiter_node)  ((xiter_node)->xut_color = !(xiter_node)->xut_color)
-#define XNODE_VKEY(xiter_node)      ((xrbt_vkey_t)((xiter_node)->xvkey_ptr))
+#define XNODE_PREFIX(xiter_node)    (*(xrbt_uint64_t *)((xiter_node)->xvkey_ptr))
+#define XNODE_KBUF(xiter_node)                                             \
+            ((xiter_node)->xvkey_ptr +                                     \
+             (((xiter_node)->xut_kmode & XNODE_KMODE_PREFIX) ?             \
+                                        sizeof(xrbt_uint64_t) : 0))        \
+
+#define XNODE_BKEY(xiter_node)      ((x_rbtree_bkey_t *)XNODE_KBUF(xiter_node))
+#define XNODE_VKEY(xiter_node)                                             \
+            ((0 == (xiter_node)->xut_kmode) ?                              \
+                (xrbt_vkey_t)((xiter_node)->xvkey_ptr) :                   \
+                xrbtree_node_vkey(xiter_node))                             \
+
+#define XNODE_KREGION(xut_kmode, xst_ksize)                                \
+            ((((xut_kmode) & XNODE_KMODE_PREFIX) ? sizeof(xrbt_uint64_t) : 0) + \
+             (((xut_kmode) & XNODE_KMODE_BORROW) ?                         \
+                            sizeof(x_rbtree_bkey_t) : (xst_ksize)))        \
+
+#define XNODE_VALIGN                8
+#define XNODE_VOFFS(xst_ksize)      (((xst_ksize) + (XNODE_VALIGN - 1)) & ~(XNODE_VALIGN - 1))
+#define XNODE_VVAL(xiter_node)                                             \
+            ((xrbt_vval_t)((xiter_node)->xvkey_ptr +                       \
+                XNODE_VOFFS(XNODE_KREGION((xiter_node)->xut_kmode,         \
+                                          (xiter_node)->xut_ksize))))      \
+
 #define XNODE_IS_NIL(xiter_node)    (0 == (xiter_node)->xut_ksize)
 #define XNODE_NOT_NIL(xiter_node)   (0 != (xiter_node)->xut_ksize)
 
-#define XNODE_IS_DOCKED(xiter_node)                       \
-            ((XRBT_NULL != (xiter_node)->xiter_parent) && \
-             (XRBT_NULL != (xiter_node)->xiter_left  ) && \
-             (XRBT_NULL != (xiter_node)->xiter_right ))   \
-
-#define XNODE_IS_UNDOCKED(xiter_node)                     \
-            ((XRBT_NULL == (xiter_node)->xiter_parent) && \
-             (XRBT_NULL == (xiter_node)->xiter_left  ) && \
-             (XRBT_NULL == (xiter_node)->xiter_right ))   \
-
-#define XNODE_UNDOCK(xiter_node)                          \
-            do                                            \
-            {                                             \
-                (xiter_node)->xiter_parent = XRBT_NULL;   \
-                (xiter_node)->xiter_left   = XRBT_NULL;   \
-                (xiter_node)->xiter_right  = XRBT_NULL;   \
-            } while (0)                                   \
-
-#define XTREE_BEGIN(xtree_ptr)      ((xtree_ptr)->xiter_lnode)
-#define XTREE_RBEGIN(xtree_ptr)     ((xtree_ptr)->xiter_rnode)
+/**
+ * 链接字段（xrbt_lofs_t）的读写：存储 目标地址 与 字段自身地址 之差，0 表示 XRBT_NULL
+ * （节点头部的链接字段不位于节点起始处，指向自身所在节点的偏移量也不为 0）。
+ */
+#define XLINK_GET(xlofs)            XRBT_LINK_GET(xlofs)
+#define XLINK_SET(xlofs, xiter_node) ((xlofs) = xrbtree_lofs(&(xlofs), (xiter_node)))
+
+#define XNODE_PARENT(xiter_node)    XLINK_GET((xiter_node)->xiter_parent)
+#define XNODE_LEFT(xiter_node)      XLINK_GET((xiter_node)->xiter_left  )
+#define XNODE_RIGHT(xiter_node)     XLINK_GET((xiter_node)->xiter_right )
+#define XNODE_SET_PARENT(xiter_node, xiter_link) XLINK_SET((xiter_node)->xiter_parent, xiter_link)
+#define XNODE_SET_LEFT(xiter_node, xiter_link)   XLINK_SET((xiter_node)->xiter_left  , xiter_link)
+#define XNODE_SET_RIGHT(xiter_node, xiter_link)  XLINK_SET((xiter_node)->xiter_right , xiter_link)
+
+#define XNODE_IS_DOCKED(xiter_node)               \
+            ((0 != (xiter_node)->xiter_parent) && \
+             (0 != (xiter_node)->xiter_left  ) && \
+             (0 != (xiter_node)->xiter_right ))   \
+
+#define XNODE_IS_UNDOCKED(xiter_node)             \
+            ((0 == (xiter_node)->xiter_parent) && \
+             (0 == (xiter_node)->xiter_left  ) && \
+             (0 == (xiter_node)->xiter_right ))   \
+
+#define XNODE_UNDOCK(xiter_node)                  \
+            do                                    \
+            {                                     \
+                (xiter_node)->xiter_parent = 0;   \
+                (xiter_node)->xiter_left   = 0;   \
+                (xiter_node)->xiter_right  = 0;   \
+            } while (0)                           \
+
+#if defined(__GNUC__) || defined(__clang__)
+#define XNODE_PREFETCH(xmem_ptr)    __builtin_prefetch((const void *)(xmem_ptr))
+#else // !__GNUC__
+#define XNODE_PREFETCH(xmem_ptr)    ((void)0)
+#endif // __GNUC__
+
+#define XTREE_IS_MULTI(xtree_ptr)   (0 != ((xtree_ptr)->xut_flags & XRBT_FLAG_MULTI))
+#define XTREE_IS_BORROW(xtree_ptr)  (0 != ((xtree_ptr)->xut_kmode & XNODE_KMODE_BORROW))
+#define XTREE_IS_LINK(xtree_ptr)    (0 != ((xtree_ptr)->xut_kmode & XNODE_KMODE_LINK))
+#define XTREE_IS_NOFREE(xtree_ptr)  (0 != ((xtree_ptr)->xut_flags & XRBT_FLAG_NOFREE))
+#define XTREE_IS_SHARED(xtree_ptr)  (0 != ((xtree_ptr)->xut_flags & XRBT_FLAG_SHARED))
+#define XTREE_ROOT(xtree_ptr)       XLINK_GET((xtree_ptr)->xiter_root )
+#define XTREE_BEGIN(xtree_ptr)      XLINK_GET((xtree_ptr)->xiter_lnode)
+#define XTREE_RBEGIN(xtree_ptr)     XLINK_GET((xtree_ptr)->xiter_rnode)
 #define XTREE_GET_NIL(xtree_ptr)    ((x_rbnode_iter)(&(xtree_ptr)->xnode_nil))
-#define XTREE_SET_NIL(xtree_ptr, xiter_node) \
-            ((xiter_node) = (x_rbnode_iter)(&(xtree_ptr)->xnode_nil))
+#define XTREE_SET_NIL(xtree_ptr, xlofs) \
+            XLINK_SET(xlofs, XTREE_GET_NIL(xtree_ptr))
+
+/** 红黑树所使用的回调函数（共享模式下，为本进程绑定的回调函数，参看 xrbtree_bind_callback()） */
+#define XTREE_CB(xtree_ptr)                                                    \
+            (XTREE_IS_SHARED(xtree_ptr) ?                                      \
+                xrbtree_bound_callback(xtree_ptr) : &(xtree_ptr)->xcallback)   \
+
+#define XTREE_VCB(xtree_ptr)                                                   \
+            (XTREE_IS_SHARED(xtree_ptr) ?                                      \
+                xrbtree_bound_vcallback(xtree_ptr) : &(xtree_ptr)->xvcallback) \
 
 #define X_RESET_NIL(xtree_ptr)                                                 \
             do                                                                 \
             {                                                                  \
                 (xtree_ptr)->xnode_nil.xut_color = X_BLACK;                    \
+                (xtree_ptr)->xnode_nil.xut_kmode = 0;                          \
                 (xtree_ptr)->xnode_nil.xut_ksize = 0;                          \
                 XTREE_SET_NIL(xtree_ptr, (xtree_ptr)->xnode_nil.xiter_parent); \
                 XTREE_SET_NIL(xtree_ptr, (xtree_ptr)->xnode_nil.xiter_left  ); \
                 XTREE_SET_NIL(xtree_ptr, (xtree_ptr)->xnode_nil.xiter_right ); \
-                (xtree_ptr)->xnode_nil.xower_ptr = (xtree_ptr);                \
+                XLINK_SET((xtree_ptr)->xnode_nil.xower_ptr,                    \
+                          (x_rbnode_iter)(xtree_ptr));                         \
+            } while (0)                                                        \
+
+#if XRBTREE_ENABLE_STATS
+
+#define XSTAT_ADD(xtree_ptr, xfield, xvalue)  ((xtree_ptr)->xstats.xfield += (xvalue))
+#define XSTAT_INC(xtree_ptr, xfield)          XSTAT_ADD(xtree_ptr, xfield, 1)
+#define XSTAT_OP(xtree_ptr, xop)                                               \
+            ((xtree_ptr)->xut_stat_op = (xop),                                 \
+             (xtree_ptr)->xstats.xops[(xop)].xu64_calls += 1)                  \
+
+#define XSTAT_OP_ADD(xtree_ptr, xfield, xvalue)                                \
+            ((xtree_ptr)->xstats.xops[(xtree_ptr)->xut_stat_op].xfield += (xvalue))
+#define XSTAT_DEPTH_SUM(xtree_ptr, xdepth)                                     \
+            do                                                                 \
+            {                                                                  \
+                (xtree_ptr)->xstats.xu64_searches  += 1;                       \
+                (xtree_ptr)->xstats.xu64_depth_sum += (xdepth);                \
+                if ((xdepth) > (xtree_ptr)->xstats.xut_depth_max)              \
+                    (xtree_ptr)->xstats.xut_depth_max = (xdepth);              \
+            } while (0)                                                        \
+
+#else // !XRBTREE_ENABLE_STATS
+
+#define XSTAT_ADD(xtree_ptr, xfield, xvalue)     ((void)0)
+#define XSTAT_INC(xtree_ptr, xfield)             ((void)0)
+#define XSTAT_OP(xtree_ptr, xop)                 ((void)0)
+#define XSTAT_OP_ADD(xtree_ptr, xfield, xvalue)  ((void)0)
+#define XSTAT_DEPTH_SUM(xtree_ptr, xdepth)       ((void)0)
+
+#endif // XRBTREE_ENABLE_STATS
+
+#if XRBTREE_ENABLE_USDT
+
+#define XTRACE_DECL(xdecl)                       xdecl
+#define XTRACE_EXEC(xstmt)                       xstmt
+#define XTRACE1(xname, a1)                       DTRACE_PROBE1(xrbtree, xname, a1)
+#define XTRACE2(xname, a1, a2)                   DTRACE_PROBE2(xrbtree, xname, a1, a2)
+#define XTRACE3(xname, a1, a2, a3)               DTRACE_PROBE3(xrbtree, xname, a1, a2, a3)
+#define XTRACE4(xname, a1, a2, a3, a4)           DTRACE_PROBE4(xrbtree, xname, a1, a2, a3, a4)
+
+#else // !XRBTREE_ENABLE_USDT
+
+#define XTRACE_DECL(xdecl)
+#define XTRACE_EXEC(xstmt)                       ((void)0)
+#define XTRACE1(xname, a1)                       ((void)0)
+#define XTRACE2(xname, a1, a2)                   ((void)0)
+#define XTRACE3(xname, a1, a2, a3)               ((void)0)
+#define XTRACE4(xname, a1, a2, a3, a4)           ((void)0)
+
+#endif // XRBTREE_ENABLE_USDT
+
+/**
+ * 定位操作的深度（访问的节点数量）只在 开启统计 或 开启探测点 时计算。
+ */
+#if (XRBTREE_ENABLE_STATS || XRBTREE_ENABLE_USDT)
+#define XSTAT_DEPTH_DECL(xdepth)                 xrbt_uint32_t xdepth = 0
+#define XSTAT_DEPTH_STEP(xdepth)                 (++(xdepth))
+#define XSTAT_DEPTH(xtree_ptr, xdepth)                                         \
+            do                                                                 \
+            {                                                                  \
+                XSTAT_DEPTH_SUM(xtree_ptr, xdepth);                            \
+                XTRACE_EXEC((xtree_ptr)->xut_trace_depth = (xdepth));          \
+            } while (0)                                                        \
+
+#else // !(XRBTREE_ENABLE_STATS || XRBTREE_ENABLE_USDT)
+#define XSTAT_DEPTH_DECL(xdepth)
+#define XSTAT_DEPTH_STEP(xdepth)                 ((void)0)
+#define XSTAT_DEPTH(xtree_ptr, xdepth)           ((void)0)
+#endif // (XRBTREE_ENABLE_STATS || XRBTREE_ENABLE_USDT)
+
+#if XRBTREE_ENABLE_RECORD
+#define XRECORD(xtree_ptr, xop, xvkey)                                         \
+            do                                                                 \
+            {                                                                  \
+                if (XRBT_NULL != (xtree_ptr)->xfile_record)                    \
+                    xrbtree_record_write((xtree_ptr), (xop), (xvkey));         \
             } while (0)                                                        \
 
+#else // !XRBTREE_ENABLE_RECORD
+#define XRECORD(xtree_ptr, xop, xvkey)           ((void)0)
+#endif // XRBTREE_ENABLE_RECORD
+
 ////////////////////////////////////////////////////////////////////////////////
 
 /**********************************************************/
@@ -172,6 +422,122 @@ static inline xrbt_void_t xrbt_heap_free(xrbt_void_t * xmt_heap)
         free(xmt_heap);
 }
 
+/**********************************************************/
+/**
+ * @brief 返回链接字段（位于 xlofs_ptr）指向 xiter_node 时，所存储的自相对偏移量。
+ */
+static inline xrbt_lofs_t xrbtree_lofs(const xrbt_lofs_t * xlofs_ptr,
+                                       x_rbnode_iter xiter_node)
+{
+    return (XRBT_NULL == xiter_node) ? 0 :
+           (xrbt_lofs_t)((xrbt_byte_t *)xiter_node - (const xrbt_byte_t *)xlofs_ptr);
+}
+
+/**
+ * @struct x_rbtree_bind_t
+ * @brief  共享模式（XRBT_FLAG_SHARED）下，本进程为红黑树绑定的回调函数。
+ */
+typedef struct x_rbtree_bind_t
+{
+    x_rbtree_ptr     xtree_ptr;    ///< 红黑树对象在本进程中的地址（空位时为 XRBT_NULL）
+    xrbt_callback_t  xcallback;    ///< 节点操作的相关回调函数
+    xrbt_vcallback_t xvcallback;   ///< 节点值数据的相关回调函数
+} x_rbtree_bind_t;
+
+/** 本进程的绑定表（参看 xrbtree_bind_callback()） */
+static x_rbtree_bind_t xrbtree_bind_table[XRBT_BIND_MAX];
+
+/**********************************************************/
+/**
+ * @brief 查找本进程为红黑树绑定的回调函数（未绑定时返回 XRBT_NULL）。
+ */
+static x_rbtree_bind_t * xrbtree_bind_find(x_rbtree_ptr xthis_ptr)
+{
+    xrbt_uint32_t xut_iter = 0;
+
+    for (; xut_iter < XRBT_BIND_MAX; ++xut_iter)
+    {
+        if (xthis_ptr == xrbtree_bind_table[xut_iter].xtree_ptr)
+            return &xrbtree_bind_table[xut_iter];
+    }
+
+    return XRBT_NULL;
+}
+
+/**********************************************************/
+/**
+ * @brief 共享模式下，返回本进程绑定的节点操作回调函数（参看 XTREE_CB()）。
+ * @note  未绑定属于调用错误，此时退回使用红黑树对象中（创建进程）的回调函数。
+ */
+static xrbt_callback_t * xrbtree_bound_callback(x_rbtree_ptr xthis_ptr)
+{
+    x_rbtree_bind_t * xbind_ptr = xrbtree_bind_find(xthis_ptr);
+
+    XASSERT(XRBT_NULL != xbind_ptr);
+    return (XRBT_NULL != xbind_ptr) ? &xbind_ptr->xcallback : &xthis_ptr->xcallback;
+}
+
+/**********************************************************/
+/**
+ * @brief 共享模式下，返回本进程绑定的值数据回调函数（参看 XTREE_VCB()）。
+ */
+static xrbt_vcallback_t * xrbtree_bound_vcallback(x_rbtree_ptr xthis_ptr)
+{
+    x_rbtree_bind_t * xbind_ptr = xrbtree_bind_find(xthis_ptr);
+
+    XASSERT(XRBT_NULL != xbind_ptr);
+    return (XRBT_NULL != xbind_ptr) ? &xbind_ptr->xvcallback : &xthis_ptr->xvcallback;
+}
+
+#if XRBTREE_ENABLE_RECORD
+
+/**********************************************************/
+/**
+ * @brief 返回单调时钟的时间戳（纳秒）。
+ */
+static xrbt_uint64_t xrbtree_record_clock(void)
+{
+#if defined(CLOCK_MONOTONIC)
+    struct timespec xtm_spec;
+    clock_gettime(CLOCK_MONOTONIC, &xtm_spec);
+    return ((xrbt_uint64_t)xtm_spec.tv_sec * 1000000000ULL) + (xrbt_uint64_t)xtm_spec.tv_nsec;
+#else // !defined(CLOCK_MONOTONIC)
+    return (xrbt_uint64_t)clock() * (1000000000ULL / CLOCKS_PER_SEC);
+#endif // defined(CLOCK_MONOTONIC)
+}
+
+/**********************************************************/
+/**
+ * @brief 向操作记录文件写入一条记录（参看 xrbtree_record_start() 的文件格式说明）。
+ */
+static xrbt_void_t xrbtree_record_write(x_rbtree_ptr xthis_ptr,
+                                        xrbt_uint32_t xut_op,
+                                        xrbt_vkey_t xrbt_vkey)
+{
+    xrbt_byte_t   xbt_head[1 + 10];
+    xrbt_size_t   xst_head = 0;
+    xrbt_uint64_t xu64_now = xrbtree_record_clock();
+    xrbt_uint64_t xu64_gap = xu64_now - xthis_ptr->xu64_record_tm;
+
+    xthis_ptr->xu64_record_tm = xu64_now;
+
+    xbt_head[xst_head++] = (xrbt_byte_t)xut_op;
+    do
+    {
+        xbt_head[xst_head] = (xrbt_byte_t)(xu64_gap & 0x7F);
+        xu64_gap >>= 7;
+        if (0 != xu64_gap)
+            xbt_head[xst_head] |= 0x80;
+        xst_head += 1;
+    } while (0 != xu64_gap);
+
+    fwrite(xbt_head, 1, xst_head, xthis_ptr->xfile_record);
+    if (XRBT_NULL != xrbt_vkey)
+        fwrite(xrbt_vkey, 1, xthis_ptr->xst_ksize, xthis_ptr->xfile_record);
+}
+
+#endif // XRBTREE_ENABLE_RECORD
+
 //====================================================================
 
 // 
@@ -282,276 +648,677 @@ static xrbt_bool_t xrbt_comm_vkey_compare(
     return XRBT_FALSE;
 }
 
+/**********************************************************/
+/**
+ * @brief 默认的 拷贝节点对象的值数据的回调函数（映射表模式）。
+ * @note  xrbt_sval 为 XRBT_NULL 时，目标值数据按全 0 填充。
+ *
+ * @param [out] xrbt_dval : 目标的值数据缓存。
+ * @param [in ] xrbt_sval : 源数据的值数据缓存。
+ * @param [in ] xrbt_size : 值数据缓存大小。
+ * @param [in ] xbt_move  : 是否采用右值 move 操作进行数据拷贝。
+ * @param [in ] xrbt_ctxt : 回调的上下文标识。
+ */
+static xrbt_void_t xrbt_comm_vval_copyfrom(
+                            xrbt_vval_t xrbt_dval,
+                            xrbt_vval_t xrbt_sval,
+                            xrbt_size_t xrbt_size,
+                            xrbt_bool_t xbt_move ,
+                            xrbt_ctxt_t xrbt_ctxt)
+{
+    if (XRBT_NULL != xrbt_sval)
+        memcpy(xrbt_dval, xrbt_sval, xrbt_size);
+    else
+        memset(xrbt_dval, 0, xrbt_size);
+}
+
 //====================================================================
 
 // 
-// 红黑树的内部操作接口
+// 通用的索引键前缀值计算接口
 // 
 
 /**********************************************************/
 /**
- * @brief 返回最左侧的节点。
+ * @brief 按字节序计算索引键前缀值（取前 8 字节，以大端序组成整数，不足 8 字节时补 0）。
+ * @note  适用于按无符号字节逐个比较的索引键（如默认的比较操作、memcmp 排序的字符串键）。
  */
-static x_rbnode_iter xrbtree_far_left(x_rbtree_ptr xthis_ptr,
-                                      x_rbnode_iter xiter_node)
+xrbt_uint64_t xrbtree_vkey_prefix_bytes(xrbt_vkey_t xrbt_vkey,
+                                        xrbt_size_t xrbt_size,
+                                        xrbt_ctxt_t xrbt_ctxt)
 {
-    while (XNODE_NOT_NIL(xiter_node->xiter_left))
+    xrbt_uint64_t  xu64_prefix = 0;
+    xrbt_size_t    xst_iter    = 0;
+    xrbt_byte_t  * xbt_mptr    = (xrbt_byte_t *)xrbt_vkey;
+
+    for (; xst_iter < sizeof(xrbt_uint64_t); ++xst_iter)
     {
-        xiter_node = xiter_node->xiter_left;
+        xu64_prefix <<= 8;
+        if (xst_iter < xrbt_size)
+            xu64_prefix |= xbt_mptr[xst_iter];
     }
 
-    return xiter_node;
+    return xu64_prefix;
 }
 
+//====================================================================
+
+// 
+// 红黑树的内部操作接口
+// 
+
 /**********************************************************/
 /**
- * @brief 返回最右侧的节点。
+ * @brief 返回节点的索引键值（非默认的索引键存储方式）。
  */
-static x_rbnode_iter xrbtree_far_right(x_rbtree_ptr xthis_ptr,
-                                       x_rbnode_iter xiter_node)
+static xrbt_vkey_t xrbtree_node_vkey(x_rbnode_iter xiter_node)
 {
-    while (XNODE_NOT_NIL(xiter_node->xiter_right))
-    {
-        xiter_node = xiter_node->xiter_right;
-    }
-
-    return xiter_node;
+    if (xiter_node->xut_kmode & XNODE_KMODE_LINK)
+        return (xrbt_vkey_t)((xrbt_byte_t *)xiter_node + XNODE_LINK_KOFFS(xiter_node));
+    if (xiter_node->xut_kmode & XNODE_KMODE_BORROW)
+        return XNODE_BKEY(xiter_node)->xrbt_kptr;
+    return (xrbt_vkey_t)XNODE_KBUF(xiter_node);
 }
 
 /**********************************************************/
 /**
- * @brief 释放节点资源。
+ * @brief 初始化定位操作所使用的索引键描述信息（计算 前缀值/哈希值）。
  */
-static xrbt_void_t xrbtree_dealloc(x_rbtree_ptr xthis_ptr,
-                                   x_rbnode_iter xiter_node)
+static inline xrbt_void_t xrbtree_probe_init(x_rbtree_ptr xthis_ptr,
+                                             x_rbtree_probe_t * xprobe,
+                                             xrbt_vkey_t xrbt_vkey)
 {
-    XASSERT(XNODE_NOT_NIL(xiter_node));
+    xprobe->xrbt_vkey   = xrbt_vkey;
+    xprobe->xu64_prefix = 0;
+    xprobe->xut_khash   = 0;
 
-    xthis_ptr->xcallback.xfunc_k_destruct(
-        XNODE_VKEY(xiter_node),
-        xthis_ptr->xst_ksize,
-        xthis_ptr->xcallback.xctxt_t_callback);
+    if (0 == xthis_ptr->xut_kmode)
+        return;
 
-    xthis_ptr->xcallback.xfunc_n_memfree(
-        xiter_node,
-        sizeof(x_rbtree_node_t) + xthis_ptr->xst_ksize,
-        xthis_ptr->xcallback.xctxt_t_callback);
+    if (XRBT_NULL != xthis_ptr->xfunc_k_prefix)
+    {
+        xprobe->xu64_prefix = xthis_ptr->xfunc_k_prefix(
+                                    xrbt_vkey,
+                                    xthis_ptr->xst_ksize,
+                                    XTREE_CB(xthis_ptr)->xctxt_t_callback);
+    }
+
+    if (XRBT_NULL != xthis_ptr->xfunc_k_hash)
+    {
+        xprobe->xut_khash = xthis_ptr->xfunc_k_hash(
+                                    xrbt_vkey,
+                                    xthis_ptr->xst_ksize,
+                                    XTREE_CB(xthis_ptr)->xctxt_t_callback);
+    }
 }
 
 /**********************************************************/
 /**
- * @brief 使用递归方式释放分支上的所有节点资源。
+ * @brief 判断 xprobe 是否小于 xiter_node 的索引键值（前缀值不同时，无须回调比较操作）。
  */
-static xrbt_void_t xrbtree_clear_branch(x_rbtree_ptr xthis_ptr,
-                                        x_rbnode_iter xiter_branch_root)
+static inline xrbt_bool_t xrbtree_less_pn(x_rbtree_ptr xthis_ptr,
+                                          x_rbtree_probe_t * xprobe,
+                                          x_rbnode_iter xiter_node)
 {
-#if 1
-    x_rbnode_iter xiter_node = xiter_branch_root;
-
-    while (XNODE_NOT_NIL(xiter_node))
+    if ((xiter_node->xut_kmode & XNODE_KMODE_PREFIX) &&
+        (xprobe->xu64_prefix != XNODE_PREFIX(xiter_node)))
     {
-        if (XNODE_NOT_NIL(xiter_node->xiter_right))
-        {
-            xrbtree_clear_branch(xthis_ptr, xiter_node->xiter_right);
-        }
-
-        xiter_branch_root = xiter_node->xiter_left;
-        xrbtree_dealloc(xthis_ptr, xiter_node);
-        xiter_node = xiter_branch_root;
+        return (xprobe->xu64_prefix < XNODE_PREFIX(xiter_node));
     }
-#else
-    if (XNODE_IS_NIL(xiter_branch_root))
-        return;
 
-    if (XNODE_NOT_NIL(xiter_branch_root->xiter_left))
-        xrbtree_clear_branch(xthis_ptr, xiter_branch_root->xiter_left);
+    XSTAT_INC(xthis_ptr, xu64_compares);
+    return XTREE_CB(xthis_ptr)->xfunc_k_compare(
+                                xprobe->xrbt_vkey,
+                                XNODE_VKEY(xiter_node),
+                                xthis_ptr->xst_ksize,
+                                XTREE_CB(xthis_ptr)->xctxt_t_callback);
+}
 
-    if (XNODE_NOT_NIL(xiter_branch_root->xiter_right))
-        xrbtree_clear_branch(xthis_ptr, xiter_branch_root->xiter_right);
+/**********************************************************/
+/**
+ * @brief 判断 xiter_node 的索引键值是否小于 xprobe（前缀值不同时，无须回调比较操作）。
+ */
+static inline xrbt_bool_t xrbtree_less_np(x_rbtree_ptr xthis_ptr,
+                                          x_rbnode_iter xiter_node,
+                                          x_rbtree_probe_t * xprobe)
+{
+    if ((xiter_node->xut_kmode & XNODE_KMODE_PREFIX) &&
+        (xprobe->xu64_prefix != XNODE_PREFIX(xiter_node)))
+    {
+        return (XNODE_PREFIX(xiter_node) < xprobe->xu64_prefix);
+    }
 
-    xrbtree_dealloc(xthis_ptr, xiter_branch_root);
-#endif
+    XSTAT_INC(xthis_ptr, xu64_compares);
+    return XTREE_CB(xthis_ptr)->xfunc_k_compare(
+                                XNODE_VKEY(xiter_node),
+                                xprobe->xrbt_vkey,
+                                xthis_ptr->xst_ksize,
+                                XTREE_CB(xthis_ptr)->xctxt_t_callback);
 }
 
 /**********************************************************/
 /**
- * @brief 查找后继节点（即查找 “索引键值大于该节点” 的 “最小节点” ）。
+ * @brief 判断 xprobe 与 xiter_node 的索引键值是否一定不相等（借用索引键模式下，比较哈希值）。
  */
-static x_rbnode_iter xrbtree_successor(x_rbtree_ptr xthis_ptr,
-                                       x_rbnode_iter xiter_node)
+static inline xrbt_bool_t xrbtree_differ_pn(x_rbtree_ptr xthis_ptr,
+                                            x_rbtree_probe_t * xprobe,
+                                            x_rbnode_iter xiter_node)
 {
-    x_rbnode_iter xiter_parent = xiter_node->xiter_parent;
+    return ((XRBT_NULL != xthis_ptr->xfunc_k_hash) &&
+            (xiter_node->xut_kmode & XNODE_KMODE_BORROW) &&
+            (xprobe->xut_khash != XNODE_BKEY(xiter_node)->xut_khash));
+}
 
-    if (XNODE_NOT_NIL(xiter_node->xiter_right))
+/**********************************************************/
+/**
+ * @brief 设置新节点的索引键（借用索引键模式下只记录索引键指针，否则回调拷贝索引键）。
+ */
+static inline xrbt_void_t xrbtree_node_setkey(x_rbtree_ptr xthis_ptr,
+                                              x_rbnode_iter xiter_node,
+                                              x_rbtree_probe_t * xprobe,
+                                              xrbt_bool_t xbt_move)
+{
+    if (xiter_node->xut_kmode & XNODE_KMODE_PREFIX)
     {
-        return xrbtree_far_left(xthis_ptr, xiter_node->xiter_right);
+        XNODE_PREFIX(xiter_node) = xprobe->xu64_prefix;
     }
 
-    while (XNODE_NOT_NIL(xiter_parent) &&
-           (xiter_parent->xiter_right == xiter_node))
+    if (xiter_node->xut_kmode & XNODE_KMODE_BORROW)
     {
-        xiter_node   = xiter_parent;
-        xiter_parent = xiter_parent->xiter_parent;
+        XNODE_BKEY(xiter_node)->xrbt_kptr = xprobe->xrbt_vkey;
+        XNODE_BKEY(xiter_node)->xut_khash = xprobe->xut_khash;
+    }
+    else
+    {
+        XTREE_CB(xthis_ptr)->xfunc_k_copyfrom(
+                                (xrbt_vkey_t)XNODE_KBUF(xiter_node),
+                                xprobe->xrbt_vkey,
+                                xthis_ptr->xst_ksize,
+                                xbt_move,
+                                XTREE_CB(xthis_ptr)->xctxt_t_callback);
     }
-
-    return xiter_parent;
 }
 
 /**********************************************************/
 /**
- * @brief 查找前驱节点（即查找 “索引键值小于该节点” 的 “最大节点” ）。
+ * @brief 依据 索引键存储方式 与 值数据大小，计算（更新）节点对象的内存大小。
  */
-static x_rbnode_iter xrbtree_precursor(x_rbtree_ptr xthis_ptr,
-                                       x_rbnode_iter xiter_node)
+static xrbt_void_t xrbtree_node_size(x_rbtree_ptr xthis_ptr)
 {
-    x_rbnode_iter xiter_parent = xiter_node->xiter_parent;
+    xrbt_size_t xst_kregion = XNODE_KREGION(xthis_ptr->xut_kmode, xthis_ptr->xst_ksize);
 
-    if (XNODE_NOT_NIL(xiter_node->xiter_left))
+    // 侵入模式下，节点即链接头，不存储索引键
+    if (XTREE_IS_LINK(xthis_ptr))
     {
-        return xrbtree_far_right(xthis_ptr, xiter_node->xiter_left);
+        xthis_ptr->xst_nsize = (xrbt_size_t)sizeof(x_rbtree_node_t);
+        return;
     }
 
-    while (XNODE_NOT_NIL(xiter_parent) &&
-           (xiter_parent->xiter_left == xiter_node))
+    xthis_ptr->xst_nsize =
+        (xrbt_size_t)sizeof(x_rbtree_node_t) +
+        ((xthis_ptr->xst_vsize > 0) ?
+            (XNODE_VOFFS(xst_kregion) + xthis_ptr->xst_vsize) : xst_kregion);
+}
+
+/**********************************************************/
+/**
+ * @brief 返回最左侧的节点。
+ */
+static x_rbnode_iter xrbtree_far_left(x_rbtree_ptr xthis_ptr,
+                                      x_rbnode_iter xiter_node)
+{
+    while (XNODE_NOT_NIL(XNODE_LEFT(xiter_node)))
     {
-        xiter_node   = xiter_parent;
-        xiter_parent = xiter_parent->xiter_parent;
+        xiter_node = XNODE_LEFT(xiter_node);
     }
 
-    return xiter_parent;
+    return xiter_node;
 }
 
 /**********************************************************/
 /**
- * @brief 对节点进行左旋转操作。
+ * @brief 返回最右侧的节点。
  */
-static xrbt_void_t xrbtree_left_rotate(x_rbtree_ptr xthis_ptr,
+static x_rbnode_iter xrbtree_far_right(x_rbtree_ptr xthis_ptr,
                                        x_rbnode_iter xiter_node)
 {
-    x_rbnode_iter xiter_swap = xiter_node->xiter_right;
-
-    xiter_node->xiter_right = xiter_swap->xiter_left;
-    if (XNODE_NOT_NIL(xiter_swap->xiter_left))
-    {
-        xiter_swap->xiter_left->xiter_parent = xiter_node;
-    }
-
-    xiter_swap->xiter_parent = xiter_node->xiter_parent;
-    if (XNODE_IS_NIL(xiter_node->xiter_parent))
-    {
-        xthis_ptr->xiter_root = xiter_swap;
-    }
-    else if (xiter_node == xiter_node->xiter_parent->xiter_left)
-    {
-        xiter_node->xiter_parent->xiter_left = xiter_swap;
-    }
-    else
+    while (XNODE_NOT_NIL(XNODE_RIGHT(xiter_node)))
     {
-        xiter_node->xiter_parent->xiter_right = xiter_swap;
+        xiter_node = XNODE_RIGHT(xiter_node);
     }
 
-    xiter_swap->xiter_left   = xiter_node;
-    xiter_node->xiter_parent = xiter_swap;
+    return xiter_node;
 }
 
 /**********************************************************/
 /**
- * @brief 对节点进行右旋转操作。
+ * @brief 释放节点资源。
  */
-static xrbt_void_t xrbtree_right_rotate(x_rbtree_ptr xthis_ptr,
-                                        x_rbnode_iter xiter_node)
+static xrbt_void_t xrbtree_dealloc(x_rbtree_ptr xthis_ptr,
+                                   x_rbnode_iter xiter_node)
 {
-    x_rbnode_iter xiter_swap = xiter_node->xiter_left;
+    XASSERT(XNODE_NOT_NIL(xiter_node));
 
-    xiter_node->xiter_left = xiter_swap->xiter_right;
-    if (XNODE_NOT_NIL(xiter_swap->xiter_right))
+    // 侵入模式下，调用方对象由调用方管理，只置为分离状态
+    if (xiter_node->xut_kmode & XNODE_KMODE_LINK)
     {
-        xiter_swap->xiter_right->xiter_parent = xiter_node;
+        XNODE_UNDOCK(xiter_node);
+        return;
     }
 
-    xiter_swap->xiter_parent = xiter_node->xiter_parent;
-    if (XNODE_IS_NIL(xiter_node->xiter_parent))
+    if (xthis_ptr->xst_vsize > 0)
     {
-        xthis_ptr->xiter_root = xiter_swap;
+        XTREE_VCB(xthis_ptr)->xfunc_v_destruct(
+            XNODE_VVAL(xiter_node),
+            xthis_ptr->xst_vsize,
+            XTREE_CB(xthis_ptr)->xctxt_t_callback);
     }
-    else if (xiter_node == xiter_node->xiter_parent->xiter_right)
+
+    if (!(xiter_node->xut_kmode & XNODE_KMODE_BORROW))
     {
-        xiter_node->xiter_parent->xiter_right = xiter_swap;
+        XTREE_CB(xthis_ptr)->xfunc_k_destruct(
+            XNODE_VKEY(xiter_node),
+            xthis_ptr->xst_ksize,
+            XTREE_CB(xthis_ptr)->xctxt_t_callback);
     }
-    else
+
+    // 不逐个释放节点内存的模式下，节点缓存留给后续的申请操作复用
+    if (XTREE_IS_NOFREE(xthis_ptr))
     {
-        xiter_node->xiter_parent->xiter_left = xiter_swap;
+        XNODE_UNDOCK(xiter_node);
+        XNODE_SET_PARENT(xiter_node, XLINK_GET(xthis_ptr->xiter_spare));
+        XLINK_SET(xthis_ptr->xiter_spare, xiter_node);
+        return;
     }
 
-    xiter_swap->xiter_right  = xiter_node;
-    xiter_node->xiter_parent = xiter_swap;
+    XSTAT_OP_ADD(xthis_ptr, xu64_frees, 1);
+    XSTAT_OP_ADD(xthis_ptr, xu64_free_bytes, xthis_ptr->xst_nsize);
+    XTRACE3(free_entry, xthis_ptr, xiter_node, xthis_ptr->xst_nsize);
+    XTREE_CB(xthis_ptr)->xfunc_n_memfree(
+        xiter_node,
+        xthis_ptr->xst_nsize,
+        XTREE_CB(xthis_ptr)->xctxt_t_callback);
+    XTRACE1(free_return, xthis_ptr);
 }
 
 /**********************************************************/
 /**
- * @brief 将节点停靠到红黑树时，对红黑树进行修正。
+ * @brief 申请节点对象缓存（优先使用缓存的备用节点）。
+ * @note
+ * 返回的节点处于分离状态，其 索引键/值数据 未构造；
+ * xfunc_n_memalloc 申请失败时，返回 XRBT_NULL（红黑树保持不变）。
  */
-static xrbt_void_t xrbtree_dock_fixup(x_rbtree_ptr xthis_ptr,
-                                      x_rbnode_iter xiter_where)
+static x_rbnode_iter xrbtree_node_get(x_rbtree_ptr xthis_ptr,
+                                      xrbt_vkey_t xrbt_vkey)
 {
-    x_rbnode_iter xiter_uncle = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter xiter_node = XLINK_GET(xthis_ptr->xiter_spare);
 
-    // xiter_where ---> X_RED
-    while (X_RED == xiter_where->xiter_parent->xut_color)
+    if (XRBT_NULL != xiter_node)
+    {
+        // 备用节点处于分离状态，非 XRBT_FLAG_NOFREE 模式下其 xiter_parent 总为 XRBT_NULL
+        XLINK_SET(xthis_ptr->xiter_spare, XNODE_PARENT(xiter_node));
+    }
+    else
     {
-        if (xiter_where->xiter_parent == xiter_where->xiter_parent->xiter_parent->xiter_left)
+        XTRACE2(alloc_entry, xthis_ptr, xthis_ptr->xst_nsize);
+        xiter_node = (x_rbnode_iter)XTREE_CB(xthis_ptr)->xfunc_n_memalloc(
+                                        xrbt_vkey,
+                                        xthis_ptr->xst_nsize,
+                                        XTREE_CB(xthis_ptr)->xctxt_t_callback);
+        XTRACE3(alloc_return, xthis_ptr, xiter_node, xthis_ptr->xst_nsize);
+        if (XRBT_NULL == xiter_node)
         {
-            xiter_uncle = xiter_where->xiter_parent->xiter_parent->xiter_right;
-            if (X_RED == xiter_uncle->xut_color)
-            {
-                xiter_where->xiter_parent->xut_color = X_BLACK;
-                xiter_uncle->xut_color = X_BLACK;
-                xiter_where->xiter_parent->xiter_parent->xut_color = X_RED;
+            return XRBT_NULL;
+        }
 
-                // xiter_where --> X_RED
-                xiter_where = xiter_where->xiter_parent->xiter_parent;
-            }
-            else
-            {
-                if (xiter_where == xiter_where->xiter_parent->xiter_right)
+        XSTAT_OP_ADD(xthis_ptr, xu64_allocs, 1);
+        XSTAT_OP_ADD(xthis_ptr, xu64_alloc_bytes, xthis_ptr->xst_nsize);
+    }
+
+    xiter_node->xut_color = X_RED;
+    xiter_node->xut_kmode = xthis_ptr->xut_kmode;
+    xiter_node->xut_ksize = xthis_ptr->xst_ksize;
+    XNODE_UNDOCK(xiter_node);
+
+    return xiter_node;
+}
+
+/**********************************************************/
+/**
+ * @brief 释放缓存的备用节点。
+ */
+static xrbt_void_t xrbtree_node_drop_spare(x_rbtree_ptr xthis_ptr)
+{
+    // 不逐个释放节点内存的模式下，备用节点随内存资源整体回收
+    if (XTREE_IS_NOFREE(xthis_ptr))
+    {
+        XLINK_SET(xthis_ptr->xiter_spare, XRBT_NULL);
+        return;
+    }
+
+    if (XRBT_NULL != XLINK_GET(xthis_ptr->xiter_spare))
+    {
+        XSTAT_OP_ADD(xthis_ptr, xu64_frees, 1);
+        XSTAT_OP_ADD(xthis_ptr, xu64_free_bytes, xthis_ptr->xst_nsize);
+        XTREE_CB(xthis_ptr)->xfunc_n_memfree(
+            XLINK_GET(xthis_ptr->xiter_spare),
+            xthis_ptr->xst_nsize,
+            XTREE_CB(xthis_ptr)->xctxt_t_callback);
+        XLINK_SET(xthis_ptr->xiter_spare, XRBT_NULL);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 使用递归方式释放分支上的所有节点资源。
+ * 
+ * @return xrbt_size_t
+ *         - 返回释放的节点数量。
+ */
+static xrbt_size_t xrbtree_clear_branch(x_rbtree_ptr xthis_ptr,
+                                        x_rbnode_iter xiter_branch_root)
+{
+    xrbt_size_t xst_count = 0;
+
+#if 1
+    x_rbnode_iter xiter_node = xiter_branch_root;
+
+    while (XNODE_NOT_NIL(xiter_node))
+    {
+        if (XNODE_NOT_NIL(XNODE_RIGHT(xiter_node)))
+        {
+            xst_count += xrbtree_clear_branch(xthis_ptr, XNODE_RIGHT(xiter_node));
+        }
+
+        xiter_branch_root = XNODE_LEFT(xiter_node);
+        xrbtree_dealloc(xthis_ptr, xiter_node);
+        xiter_node = xiter_branch_root;
+        xst_count += 1;
+    }
+#else
+    if (XNODE_IS_NIL(xiter_branch_root))
+        return 0;
+
+    if (XNODE_NOT_NIL(XNODE_LEFT(xiter_branch_root)))
+        xst_count += xrbtree_clear_branch(xthis_ptr, XNODE_LEFT(xiter_branch_root));
+
+    if (XNODE_NOT_NIL(XNODE_RIGHT(xiter_branch_root)))
+        xst_count += xrbtree_clear_branch(xthis_ptr, XNODE_RIGHT(xiter_branch_root));
+
+    xrbtree_dealloc(xthis_ptr, xiter_branch_root);
+    xst_count += 1;
+#endif
+
+    return xst_count;
+}
+
+/**********************************************************/
+/**
+ * @brief 判断清除操作是否需要逐个释放节点
+ *        （XRBT_FLAG_NOFREE 模式下，索引键/值数据 无须析构时，可直接丢弃整棵树）。
+ */
+static xrbt_bool_t xrbtree_need_release(x_rbtree_ptr xthis_ptr)
+{
+    return (!XTREE_IS_NOFREE(xthis_ptr) ||
+            (!XTREE_IS_BORROW(xthis_ptr) &&
+             (XTREE_CB(xthis_ptr)->xfunc_k_destruct != &xrbt_comm_vkey_destruct)) ||
+            ((xthis_ptr->xst_vsize > 0) &&
+             (XTREE_VCB(xthis_ptr)->xfunc_v_destruct != &xrbt_comm_vkey_destruct)));
+}
+
+/**********************************************************/
+/**
+ * @brief 对待释放的节点执行至多 xst_budget 步释放操作（参看 xrbtree_clear_step()）。
+ * @note
+ * 当前节点有左子树时右旋（左子节点上升），否则释放当前节点并转到其右子树，
+ * 每个节点至多被右旋一次，所以总步数不超过 2n ；待释放节点的 xiter_parent 不再维护，
+ * 且只以地址比较 nil 节点（xiter_rnil），不访问其内容。
+ * 
+ * @return xrbt_size_t
+ *         - 返回剩余的待释放节点数量。
+ */
+static xrbt_size_t xrbtree_reclaim_steps(x_rbtree_ptr xthis_ptr, xrbt_size_t xst_budget)
+{
+    x_rbnode_iter xiter_node = XLINK_GET(xthis_ptr->xiter_reclaim);
+    x_rbnode_iter xiter_rnil = XLINK_GET(xthis_ptr->xiter_rnil);
+    x_rbnode_iter xiter_swap = XRBT_NULL;
+    xrbt_size_t   xst_steps  = 0;
+
+    if (XRBT_NULL == xiter_node)
+    {
+        return 0;
+    }
+
+    while ((xiter_node != xiter_rnil) && (xst_steps < xst_budget))
+    {
+        xiter_swap = XNODE_LEFT(xiter_node);
+        if (xiter_swap != xiter_rnil)
+        {
+            XNODE_SET_LEFT(xiter_node, XNODE_RIGHT(xiter_swap));
+            XNODE_SET_RIGHT(xiter_swap, xiter_node);
+            xiter_node = xiter_swap;
+        }
+        else
+        {
+            xiter_swap = XNODE_RIGHT(xiter_node);
+            xrbtree_dealloc(xthis_ptr, xiter_node);
+            xthis_ptr->xst_reclaim -= 1;
+            xiter_node = xiter_swap;
+        }
+
+        xst_steps += 1;
+    }
+
+    if (xiter_node == xiter_rnil)
+    {
+        XASSERT(0 == xthis_ptr->xst_reclaim);
+        xiter_node = XRBT_NULL;
+        XLINK_SET(xthis_ptr->xiter_rnil, XRBT_NULL);
+    }
+
+    XLINK_SET(xthis_ptr->xiter_reclaim, xiter_node);
+    return xthis_ptr->xst_reclaim;
+}
+
+/**********************************************************/
+/**
+ * @brief 查找后继节点（即查找 “索引键值大于该节点” 的 “最小节点” ）。
+ */
+static x_rbnode_iter xrbtree_successor(x_rbtree_ptr xthis_ptr,
+                                       x_rbnode_iter xiter_node)
+{
+    x_rbnode_iter xiter_parent = XNODE_PARENT(xiter_node);
+
+    if (XNODE_NOT_NIL(XNODE_RIGHT(xiter_node)))
+    {
+        return xrbtree_far_left(xthis_ptr, XNODE_RIGHT(xiter_node));
+    }
+
+    while (XNODE_NOT_NIL(xiter_parent) &&
+           (XNODE_RIGHT(xiter_parent) == xiter_node))
+    {
+        xiter_node   = xiter_parent;
+        xiter_parent = XNODE_PARENT(xiter_parent);
+    }
+
+    return xiter_parent;
+}
+
+/**********************************************************/
+/**
+ * @brief 查找前驱节点（即查找 “索引键值小于该节点” 的 “最大节点” ）。
+ */
+static x_rbnode_iter xrbtree_precursor(x_rbtree_ptr xthis_ptr,
+                                       x_rbnode_iter xiter_node)
+{
+    x_rbnode_iter xiter_parent = XNODE_PARENT(xiter_node);
+
+    if (XNODE_NOT_NIL(XNODE_LEFT(xiter_node)))
+    {
+        return xrbtree_far_right(xthis_ptr, XNODE_LEFT(xiter_node));
+    }
+
+    while (XNODE_NOT_NIL(xiter_parent) &&
+           (XNODE_LEFT(xiter_parent) == xiter_node))
+    {
+        xiter_node   = xiter_parent;
+        xiter_parent = XNODE_PARENT(xiter_parent);
+    }
+
+    return xiter_parent;
+}
+
+/**********************************************************/
+/**
+ * @brief 对节点进行左旋转操作。
+ */
+static xrbt_void_t xrbtree_left_rotate(x_rbtree_ptr xthis_ptr,
+                                       x_rbnode_iter xiter_node)
+{
+    x_rbnode_iter xiter_swap = XNODE_RIGHT(xiter_node);
+
+    XSTAT_INC(xthis_ptr, xu64_rotate_left);
+    XTRACE_EXEC(xthis_ptr->xut_trace_rotate += 1);
+
+    XNODE_SET_RIGHT(xiter_node, XNODE_LEFT(xiter_swap));
+    if (XNODE_NOT_NIL(XNODE_LEFT(xiter_swap)))
+    {
+        XNODE_SET_PARENT(XNODE_LEFT(xiter_swap), xiter_node);
+    }
+
+    XNODE_SET_PARENT(xiter_swap, XNODE_PARENT(xiter_node));
+    if (XNODE_IS_NIL(XNODE_PARENT(xiter_node)))
+    {
+        XLINK_SET(xthis_ptr->xiter_root, xiter_swap);
+    }
+    else if (xiter_node == XNODE_LEFT(XNODE_PARENT(xiter_node)))
+    {
+        XNODE_SET_LEFT(XNODE_PARENT(xiter_node), xiter_swap);
+    }
+    else
+    {
+        XNODE_SET_RIGHT(XNODE_PARENT(xiter_node), xiter_swap);
+    }
+
+    XNODE_SET_LEFT(xiter_swap, xiter_node);
+    XNODE_SET_PARENT(xiter_node, xiter_swap);
+}
+
+/**********************************************************/
+/**
+ * @brief 对节点进行右旋转操作。
+ */
+static xrbt_void_t xrbtree_right_rotate(x_rbtree_ptr xthis_ptr,
+                                        x_rbnode_iter xiter_node)
+{
+    x_rbnode_iter xiter_swap = XNODE_LEFT(xiter_node);
+
+    XSTAT_INC(xthis_ptr, xu64_rotate_right);
+    XTRACE_EXEC(xthis_ptr->xut_trace_rotate += 1);
+
+    XNODE_SET_LEFT(xiter_node, XNODE_RIGHT(xiter_swap));
+    if (XNODE_NOT_NIL(XNODE_RIGHT(xiter_swap)))
+    {
+        XNODE_SET_PARENT(XNODE_RIGHT(xiter_swap), xiter_node);
+    }
+
+    XNODE_SET_PARENT(xiter_swap, XNODE_PARENT(xiter_node));
+    if (XNODE_IS_NIL(XNODE_PARENT(xiter_node)))
+    {
+        XLINK_SET(xthis_ptr->xiter_root, xiter_swap);
+    }
+    else if (xiter_node == XNODE_RIGHT(XNODE_PARENT(xiter_node)))
+    {
+        XNODE_SET_RIGHT(XNODE_PARENT(xiter_node), xiter_swap);
+    }
+    else
+    {
+        XNODE_SET_LEFT(XNODE_PARENT(xiter_node), xiter_swap);
+    }
+
+    XNODE_SET_RIGHT(xiter_swap, xiter_node);
+    XNODE_SET_PARENT(xiter_node, xiter_swap);
+}
+
+/**********************************************************/
+/**
+ * @brief 将节点停靠到红黑树时，对红黑树进行修正。
+ */
+static xrbt_void_t xrbtree_dock_fixup(x_rbtree_ptr xthis_ptr,
+                                      x_rbnode_iter xiter_where)
+{
+    x_rbnode_iter xiter_uncle = XTREE_GET_NIL(xthis_ptr);
+    XTRACE_DECL(xrbt_uint32_t xut_loops = 0);
+    XTRACE_DECL(xrbt_uint32_t xut_rbase = xthis_ptr->xut_trace_rotate);
+
+    XTRACE2(dock_fixup_entry, xthis_ptr, xiter_where);
+
+    // xiter_where ---> X_RED
+    while (X_RED == XNODE_PARENT(xiter_where)->xut_color)
+    {
+        XSTAT_INC(xthis_ptr, xu64_fixup_loops);
+        XTRACE_EXEC(xut_loops += 1);
+
+        if (XNODE_PARENT(xiter_where) == XNODE_LEFT(XNODE_PARENT(XNODE_PARENT(xiter_where))))
+        {
+            xiter_uncle = XNODE_RIGHT(XNODE_PARENT(XNODE_PARENT(xiter_where)));
+            if (X_RED == xiter_uncle->xut_color)
+            {
+                XNODE_PARENT(xiter_where)->xut_color = X_BLACK;
+                xiter_uncle->xut_color = X_BLACK;
+                XNODE_PARENT(XNODE_PARENT(xiter_where))->xut_color = X_RED;
+                XSTAT_ADD(xthis_ptr, xu64_recolors, 3);
+
+                // xiter_where --> X_RED
+                xiter_where = XNODE_PARENT(XNODE_PARENT(xiter_where));
+            }
+            else
+            {
+                if (xiter_where == XNODE_RIGHT(XNODE_PARENT(xiter_where)))
                 {
-                    xiter_where = xiter_where->xiter_parent;
+                    xiter_where = XNODE_PARENT(xiter_where);
                     xrbtree_left_rotate(xthis_ptr, xiter_where);
                 }
 
-                xiter_where->xiter_parent->xut_color = X_BLACK;
-                xiter_where->xiter_parent->xiter_parent->xut_color = X_RED;
-                xrbtree_right_rotate(xthis_ptr, xiter_where->xiter_parent->xiter_parent);
+                XNODE_PARENT(xiter_where)->xut_color = X_BLACK;
+                XNODE_PARENT(XNODE_PARENT(xiter_where))->xut_color = X_RED;
+                XSTAT_ADD(xthis_ptr, xu64_recolors, 2);
+                xrbtree_right_rotate(xthis_ptr, XNODE_PARENT(XNODE_PARENT(xiter_where)));
             }
         }
         else
         {
-            xiter_uncle = xiter_where->xiter_parent->xiter_parent->xiter_left;
+            xiter_uncle = XNODE_LEFT(XNODE_PARENT(XNODE_PARENT(xiter_where)));
             if (X_RED == xiter_uncle->xut_color)
             {
-                xiter_where->xiter_parent->xut_color = X_BLACK;
+                XNODE_PARENT(xiter_where)->xut_color = X_BLACK;
                 xiter_uncle->xut_color = X_BLACK;
-                xiter_where->xiter_parent->xiter_parent->xut_color = X_RED;
+                XNODE_PARENT(XNODE_PARENT(xiter_where))->xut_color = X_RED;
+                XSTAT_ADD(xthis_ptr, xu64_recolors, 3);
 
                 // xiter_where --> X_RED
-                xiter_where = xiter_where->xiter_parent->xiter_parent;
+                xiter_where = XNODE_PARENT(XNODE_PARENT(xiter_where));
             }
             else
             {
-                if (xiter_where == xiter_where->xiter_parent->xiter_left)
+                if (xiter_where == XNODE_LEFT(XNODE_PARENT(xiter_where)))
                 {
-                    xiter_where = xiter_where->xiter_parent;
+                    xiter_where = XNODE_PARENT(xiter_where);
                     xrbtree_right_rotate(xthis_ptr, xiter_where);
                 }
 
-                xiter_where->xiter_parent->xut_color = X_BLACK;
-                xiter_where->xiter_parent->xiter_parent->xut_color = X_RED;
-                xrbtree_left_rotate(xthis_ptr, xiter_where->xiter_parent->xiter_parent);
+                XNODE_PARENT(xiter_where)->xut_color = X_BLACK;
+                XNODE_PARENT(XNODE_PARENT(xiter_where))->xut_color = X_RED;
+                XSTAT_ADD(xthis_ptr, xu64_recolors, 2);
+                xrbtree_left_rotate(xthis_ptr, XNODE_PARENT(XNODE_PARENT(xiter_where)));
             }
         }
     }
 
-    xthis_ptr->xiter_root->xut_color = X_BLACK;
+    XTREE_ROOT(xthis_ptr)->xut_color = X_BLACK;
+
+    XTRACE3(dock_fixup_return, xthis_ptr, xut_loops,
+            xthis_ptr->xut_trace_rotate - xut_rbase);
 }
 
 /**********************************************************/
@@ -564,83 +1331,98 @@ static xrbt_void_t xrbtree_undock_fixup(
                                 x_rbnode_iter xiter_parent)
 {
     x_rbnode_iter xiter_sibling = XTREE_GET_NIL(xthis_ptr);
+    XTRACE_DECL(xrbt_uint32_t xut_loops = 0);
+    XTRACE_DECL(xrbt_uint32_t xut_rbase = xthis_ptr->xut_trace_rotate);
 
-    for (; (xiter_where != xthis_ptr->xiter_root) &&
+    XTRACE2(undock_fixup_entry, xthis_ptr, xiter_where);
+
+    for (; (xiter_where != XTREE_ROOT(xthis_ptr)) &&
            (X_BLACK == xiter_where->xut_color);
-         xiter_parent = xiter_where->xiter_parent)
+         xiter_parent = XNODE_PARENT(xiter_where))
     {
-        if (xiter_where == xiter_parent->xiter_left)
+        XSTAT_INC(xthis_ptr, xu64_fixup_loops);
+        XTRACE_EXEC(xut_loops += 1);
+
+        if (xiter_where == XNODE_LEFT(xiter_parent))
         {
-            xiter_sibling = xiter_parent->xiter_right;
+            xiter_sibling = XNODE_RIGHT(xiter_parent);
             if (X_RED == xiter_sibling->xut_color)
             {
                 xiter_sibling->xut_color = X_BLACK;
                 xiter_parent->xut_color = X_RED;
+                XSTAT_ADD(xthis_ptr, xu64_recolors, 2);
                 xrbtree_left_rotate(xthis_ptr, xiter_parent);
-                xiter_sibling = xiter_parent->xiter_right;
+                xiter_sibling = XNODE_RIGHT(xiter_parent);
             }
 
             if (XNODE_IS_NIL(xiter_sibling))
             {
                 xiter_where = xiter_parent;
             }
-            else if ((X_BLACK == xiter_sibling->xiter_left->xut_color) &&
-                     (X_BLACK == xiter_sibling->xiter_right->xut_color))
+            else if ((X_BLACK == XNODE_LEFT(xiter_sibling)->xut_color) &&
+                     (X_BLACK == XNODE_RIGHT(xiter_sibling)->xut_color))
             {
                 xiter_sibling->xut_color = X_RED;
+                XSTAT_INC(xthis_ptr, xu64_recolors);
                 xiter_where = xiter_parent;
             }
             else
             {
-                if (X_BLACK == xiter_sibling->xiter_right->xut_color)
+                if (X_BLACK == XNODE_RIGHT(xiter_sibling)->xut_color)
                 {
-                    xiter_sibling->xiter_left->xut_color = X_BLACK;
+                    XNODE_LEFT(xiter_sibling)->xut_color = X_BLACK;
                     xiter_sibling->xut_color = X_RED;
+                    XSTAT_ADD(xthis_ptr, xu64_recolors, 2);
                     xrbtree_right_rotate(xthis_ptr, xiter_sibling);
-                    xiter_sibling = xiter_parent->xiter_right;
+                    xiter_sibling = XNODE_RIGHT(xiter_parent);
                 }
 
                 xiter_sibling->xut_color = xiter_parent->xut_color;
                 xiter_parent->xut_color = X_BLACK;
-                xiter_sibling->xiter_right->xut_color = X_BLACK;
+                XNODE_RIGHT(xiter_sibling)->xut_color = X_BLACK;
+                XSTAT_ADD(xthis_ptr, xu64_recolors, 3);
                 xrbtree_left_rotate(xthis_ptr, xiter_parent);
                 break;	// tree now recolored/rebalanced
             }
         }
         else
         {
-            xiter_sibling = xiter_parent->xiter_left;
+            xiter_sibling = XNODE_LEFT(xiter_parent);
             if (X_RED == xiter_sibling->xut_color)
             {
                 xiter_sibling->xut_color = X_BLACK;
                 xiter_parent->xut_color = X_RED;
+                XSTAT_ADD(xthis_ptr, xu64_recolors, 2);
                 xrbtree_right_rotate(xthis_ptr, xiter_parent);
-                xiter_sibling = xiter_parent->xiter_left;
+                xiter_sibling = XNODE_LEFT(xiter_parent);
             }
 
             if (XNODE_IS_NIL(xiter_sibling))
             {
                 xiter_where = xiter_parent;
             }
-            else if ((X_BLACK == xiter_sibling->xiter_right->xut_color) &&
-                     (X_BLACK == xiter_sibling->xiter_left->xut_color))
+            else if ((X_BLACK == XNODE_RIGHT(xiter_sibling)->xut_color) &&
+                     (X_BLACK == XNODE_LEFT(xiter_sibling)->xut_color))
             {
                 xiter_sibling->xut_color = X_RED;
+                XSTAT_INC(xthis_ptr, xu64_recolors);
                 xiter_where = xiter_parent;
             }
             else
             {
-                if (X_BLACK == xiter_sibling->xiter_left->xut_color)
+                if (X_BLACK == XNODE_LEFT(xiter_sibling)->xut_color)
                 {
-                    xiter_sibling->xiter_right->xut_color = X_BLACK;
+                    XNODE_RIGHT(xiter_sibling)->xut_color = X_BLACK;
                     xiter_sibling->xut_color = X_RED;
+                    XSTAT_ADD(xthis_ptr, xu64_recolors, 2);
                     xrbtree_left_rotate(xthis_ptr, xiter_sibling);
-                    xiter_sibling = xiter_parent->xiter_left;
+                    xiter_sibling = XNODE_LEFT(xiter_parent);
                 }
 
                 xiter_sibling->xut_color = xiter_parent->xut_color;
                 xiter_parent->xut_color = X_BLACK;
-                xiter_sibling->xiter_left->xut_color = X_BLACK;
+                XNODE_LEFT(xiter_sibling)->xut_color = X_BLACK;
+                XSTAT_ADD(xthis_ptr, xu64_recolors, 3);
                 xrbtree_right_rotate(xthis_ptr, xiter_parent);
                 break;	// tree now recolored/rebalanced
             }
@@ -648,61 +1430,66 @@ static xrbt_void_t xrbtree_undock_fixup(
     }
 
     xiter_where->xut_color = X_BLACK;
+
+    XTRACE3(undock_fixup_return, xthis_ptr, xut_loops,
+            xthis_ptr->xut_trace_rotate - xut_rbase);
 }
 
 /**********************************************************/
 /**
  * @brief 进行 插入/删除 节点操作后，更新红黑树的其他附带信息（节点数量、最左/右节点位置 等）。
+ * @note 插入操作时，xprobe 为新节点的索引键描述信息；删除操作时，xprobe 可为 XRBT_NULL 。
  */
 static xrbt_void_t xrbtree_update(x_rbtree_ptr xthis_ptr,
                                   x_rbnode_iter xiter_where,
+                                  xrbt_int32_t xit_select,
                                   xrbt_bool_t xbt_erase)
 {
     if (xbt_erase)
     {
-        // 删除操作后的更新过程
+        // 删除操作前的更新过程（须在调整树结构之前进行）：
+        // 最左侧节点没有左子树，其后继节点 要么是其右子节点（红色叶子），要么是其父节点，
+        // 最右侧节点同理，因此无须再从根节点向下查找
 
         XASSERT(xthis_ptr->xst_count > 0);
         xthis_ptr->xst_count -= 1;
 
-        if (xthis_ptr->xiter_lnode == xiter_where)
+        if (XTREE_BEGIN(xthis_ptr) == xiter_where)
         {
-            xthis_ptr->xiter_lnode =
-                xrbtree_far_left(xthis_ptr, xthis_ptr->xiter_root);
+            XSTAT_INC(xthis_ptr, xu64_rewalk_left);
+            XLINK_SET(xthis_ptr->xiter_lnode, xrbtree_successor(xthis_ptr, xiter_where));
         }
 
-        if (xthis_ptr->xiter_rnode == xiter_where)
+        if (XTREE_RBEGIN(xthis_ptr) == xiter_where)
         {
-            xthis_ptr->xiter_rnode =
-                xrbtree_far_right(xthis_ptr, xthis_ptr->xiter_root);
+            XSTAT_INC(xthis_ptr, xu64_rewalk_right);
+            XLINK_SET(xthis_ptr->xiter_rnode, xrbtree_precursor(xthis_ptr, xiter_where));
         }
     }
     else
     {
-        // 插入操作后的更新过程
+        // 插入操作后的更新过程（须在修正操作之前进行，此时新节点仍是叶子节点）：
+        // 新节点为最左侧节点，当且仅当其停靠在原最左侧节点的左侧（或者树原本为空），
+        // 最右侧节点同理（多键模式下，相等的新节点停靠在右侧，因此也会成为最右侧节点）
+
+        x_rbnode_iter xiter_dpos = XNODE_PARENT(xiter_where);
 
         xthis_ptr->xst_count += 1;
 
-        if (XNODE_IS_NIL(xthis_ptr->xiter_lnode) ||
-            xthis_ptr->xcallback.xfunc_k_compare(
-                                  XNODE_VKEY(xiter_where),
-                                  XNODE_VKEY(xthis_ptr->xiter_lnode),
-                                  xthis_ptr->xst_ksize,
-                                  xthis_ptr->xcallback.xctxt_t_callback)
-           )
+        if (XNODE_IS_NIL(xiter_dpos))
         {
-            xthis_ptr->xiter_lnode = xiter_where;
+            XLINK_SET(xthis_ptr->xiter_lnode, xiter_where);
+            XLINK_SET(xthis_ptr->xiter_rnode, xiter_where);
         }
-
-        if (XNODE_IS_NIL(xthis_ptr->xiter_rnode) ||
-            xthis_ptr->xcallback.xfunc_k_compare(
-                                  XNODE_VKEY(xthis_ptr->xiter_rnode),
-                                  XNODE_VKEY(xiter_where),
-                                  xthis_ptr->xst_ksize,
-                                  xthis_ptr->xcallback.xctxt_t_callback)
-           )
+        else if (xit_select < 0)
+        {
+            if (XTREE_BEGIN(xthis_ptr) == xiter_dpos)
+                XLINK_SET(xthis_ptr->xiter_lnode, xiter_where);
+        }
+        else
         {
-            xthis_ptr->xiter_rnode = xiter_where;
+            if (XTREE_RBEGIN(xthis_ptr) == xiter_dpos)
+                XLINK_SET(xthis_ptr->xiter_rnode, xiter_where);
         }
     }
 }
@@ -715,33 +1502,40 @@ static xrbt_void_t xrbtree_update(x_rbtree_ptr xthis_ptr,
  *  - 为 -1，索引键值 <  返回节点，可向返回节点的左侧停靠；
  *  - 为  0，索引键值 == 返回节点，不可进行后续的停靠操作；
  *  - 为  1，索引键值 >  返回节点，可向返回节点的右侧停靠。
+ * 多键模式下，相等的索引键值向右侧停靠，xit_select 不会返回 0 。
  * 
  * @param [in ] xthis_ptr : 红黑树对象。
- * @param [in ] xrbt_vkey : 索引键值。
+ * @param [in ] xprobe    : 索引键描述信息。
  * @param [out] xit_select: 返回的停靠方式。
  * 
  * @param x_rbnode_iter
  *        - 可停靠的节点位置。
  */
 static x_rbnode_iter xrbtree_dock_pos(x_rbtree_ptr xthis_ptr,
-                                      xrbt_vkey_t xrbt_vkey,
+                                      x_rbtree_probe_t * xprobe,
                                       xrbt_int32_t * xit_select)
 {
     x_rbnode_iter xiter_where = XTREE_GET_NIL(xthis_ptr);
-    x_rbnode_iter xiter_ntrav = xthis_ptr->xiter_root;
+    x_rbnode_iter xiter_ntrav = XTREE_ROOT(xthis_ptr);
     xrbt_bool_t   xbt_to_left = XRBT_TRUE;
+    XSTAT_DEPTH_DECL(xst_depth);
 
     while (XNODE_NOT_NIL(xiter_ntrav))
     {
+        XSTAT_DEPTH_STEP(xst_depth);
         xiter_where = xiter_ntrav;
 
-        xbt_to_left = xthis_ptr->xcallback.xfunc_k_compare(
-                                     xrbt_vkey,
-                                     XNODE_VKEY(xiter_ntrav),
-                                     xthis_ptr->xst_ksize,
-                                     xthis_ptr->xcallback.xctxt_t_callback);
+        xbt_to_left = xrbtree_less_pn(xthis_ptr, xprobe, xiter_ntrav);
 
-        xiter_ntrav = xbt_to_left ? xiter_ntrav->xiter_left : xiter_ntrav->xiter_right;
+        xiter_ntrav = xbt_to_left ? XNODE_LEFT(xiter_ntrav) : XNODE_RIGHT(xiter_ntrav);
+    }
+
+    XSTAT_DEPTH(xthis_ptr, xst_depth);
+
+    if (XTREE_IS_MULTI(xthis_ptr))
+    {
+        *xit_select = xbt_to_left ? -1 : 1;
+        return xiter_where;
     }
 
     xiter_ntrav = xiter_where;
@@ -759,11 +1553,8 @@ static x_rbnode_iter xrbtree_dock_pos(x_rbtree_ptr xthis_ptr,
         *xit_select = 1;
     }
 
-    if (xthis_ptr->xcallback.xfunc_k_compare(
-                              XNODE_VKEY(xiter_ntrav),
-                              xrbt_vkey,
-                              xthis_ptr->xst_ksize,
-                              xthis_ptr->xcallback.xctxt_t_callback))
+    if (xrbtree_differ_pn(xthis_ptr, xprobe, xiter_ntrav) ||
+        xrbtree_less_np(xthis_ptr, xiter_ntrav, xprobe))
     {
         return xiter_where;
     }
@@ -774,619 +1565,3301 @@ static x_rbnode_iter xrbtree_dock_pos(x_rbtree_ptr xthis_ptr,
 
 /**********************************************************/
 /**
- * @brief 向 x_rbtree_t 对象插入新节点。
- * 
- * @param [in ] xthis_ptr : 红黑树对象。
- * @param [in ] xrbt_vkey : 新节点的索引键值。
- * @param [in ] xbt_move  : 回调设置索引键值时，是否使用 move 操作方式。
- * @param [out] xbt_ok    : 返回操作成功的标识。
- * 
- * @return x_rbnode_iter
- *         - 返回对应节点。
+ * @brief 查找 等于 指定索引键值 的节点区间 [返回值, *xiter_upper) 。
+ * @note
+ * 自根向下遇到首个相等节点时，分别在其左、右子树中继续查找下界与上界，
+ * 即 只需一次定位操作 就可得到 lower_bound 与 upper_bound 的结果。
  */
-static x_rbnode_iter xrbtree_insert_nkey(x_rbtree_ptr xthis_ptr,
-                                         xrbt_vkey_t xrbt_vkey,
-                                         xrbt_bool_t xbt_move,
-                                         xrbt_bool_t * xbt_ok)
+static x_rbnode_iter xrbtree_equal_pos(x_rbtree_ptr xthis_ptr,
+                                       x_rbtree_probe_t * xprobe,
+                                       x_rbnode_iter * xiter_upper)
 {
-    //======================================
+    x_rbnode_iter xiter_lower = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter xiter_ntrav = XTREE_ROOT(xthis_ptr);
+    x_rbnode_iter xiter_utrav = XTREE_GET_NIL(xthis_ptr);
+    XSTAT_DEPTH_DECL(xst_depth);
 
-    x_rbnode_iter xiter_node = XTREE_GET_NIL(xthis_ptr);
-    xrbt_int32_t  xit_select = -1;
-    x_rbnode_iter xiter_dpos = xrbtree_dock_pos(xthis_ptr,
-                                                xrbt_vkey,
-                                                &xit_select);
-    if (0 == xit_select)
+    *xiter_upper = XTREE_GET_NIL(xthis_ptr);
+
+    while (XNODE_NOT_NIL(xiter_ntrav))
     {
-        if (XRBT_NULL != xbt_ok)
-            *xbt_ok = XRBT_FALSE;
-        return xiter_dpos;
-    }
+        XSTAT_DEPTH_STEP(xst_depth);
+        if (xrbtree_less_np(xthis_ptr, xiter_ntrav, xprobe))
+        {
+            xiter_ntrav = XNODE_RIGHT(xiter_ntrav);
+        }
+        else if (xrbtree_less_pn(xthis_ptr, xprobe, xiter_ntrav))
+        {
+            xiter_lower  = xiter_ntrav;
+            *xiter_upper = xiter_ntrav;
+            xiter_ntrav  = XNODE_LEFT(xiter_ntrav);
+        }
+        else
+        {
+            xiter_lower = xiter_ntrav;
+            xiter_utrav = XNODE_RIGHT(xiter_ntrav);
+            xiter_ntrav = XNODE_LEFT(xiter_ntrav);
 
-    //======================================
+            // 在左子树中查找下界
+            while (XNODE_NOT_NIL(xiter_ntrav))
+            {
+                XSTAT_DEPTH_STEP(xst_depth);
+                if (xrbtree_less_np(xthis_ptr, xiter_ntrav, xprobe))
+                {
+                    xiter_ntrav = XNODE_RIGHT(xiter_ntrav);
+                }
+                else
+                {
+                    xiter_lower = xiter_ntrav;
+                    xiter_ntrav = XNODE_LEFT(xiter_ntrav);
+                }
+            }
 
-    xiter_node = (x_rbnode_iter)xthis_ptr->xcallback.xfunc_n_memalloc(
-                                    xrbt_vkey,
-                                    sizeof(x_rbtree_node_t) + xthis_ptr->xst_ksize,
-                                    xthis_ptr->xcallback.xctxt_t_callback);
-    XASSERT(XRBT_NULL != xiter_node);
+            // 在右子树中查找上界
+            while (XNODE_NOT_NIL(xiter_utrav))
+            {
+                XSTAT_DEPTH_STEP(xst_depth);
+                if (xrbtree_less_pn(xthis_ptr, xprobe, xiter_utrav))
+                {
+                    *xiter_upper = xiter_utrav;
+                    xiter_utrav  = XNODE_LEFT(xiter_utrav);
+                }
+                else
+                {
+                    xiter_utrav = XNODE_RIGHT(xiter_utrav);
+                }
+            }
 
-    xthis_ptr->xcallback.xfunc_k_copyfrom(
-                                    XNODE_VKEY(xiter_node),
-                                    xrbt_vkey,
-                                    xthis_ptr->xst_ksize,
-                                    xbt_move,
-                                    xthis_ptr->xcallback.xctxt_t_callback);
+            break;
+        }
+    }
 
-    //======================================
+    XSTAT_DEPTH(xthis_ptr, xst_depth);
+    return xiter_lower;
+}
+
+/**********************************************************/
+/**
+ * @brief 返回的是首个不小于 xprobe 的 节点位置。
+ */
+static x_rbnode_iter xrbtree_lower_pos(x_rbtree_ptr xthis_ptr,
+                                       x_rbtree_probe_t * xprobe)
+{
+    x_rbnode_iter xiter_node = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter xiter_trav = XTREE_ROOT(xthis_ptr);
+    XSTAT_DEPTH_DECL(xst_depth);
 
-    xiter_node->xiter_parent = xiter_dpos;
-    if (XNODE_IS_NIL(xiter_dpos))
+    while (XNODE_NOT_NIL(xiter_trav))
     {
-        xthis_ptr->xiter_root = xiter_node;
-    }
-    else if (xit_select < 0)
+        XSTAT_DEPTH_STEP(xst_depth);
+        if (xrbtree_less_np(xthis_ptr, xiter_trav, xprobe))
+        {
+            xiter_trav = XNODE_RIGHT(xiter_trav);
+        }
+        else
+        {
+            xiter_node = xiter_trav;
+            xiter_trav = XNODE_LEFT(xiter_trav);
+        }
+    }
+
+    XSTAT_DEPTH(xthis_ptr, xst_depth);
+    return xiter_node;
+}
+
+/**********************************************************/
+/**
+ * @brief 返回的是首个大于 xprobe 的 节点位置。
+ */
+static x_rbnode_iter xrbtree_upper_pos(x_rbtree_ptr xthis_ptr,
+                                       x_rbtree_probe_t * xprobe)
+{
+    x_rbnode_iter xiter_node = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter xiter_trav = XTREE_ROOT(xthis_ptr);
+    XSTAT_DEPTH_DECL(xst_depth);
+
+    while (XNODE_NOT_NIL(xiter_trav))
+    {
+        XSTAT_DEPTH_STEP(xst_depth);
+        if (xrbtree_less_pn(xthis_ptr, xprobe, xiter_trav))
+        {
+            xiter_node = xiter_trav;
+            xiter_trav = XNODE_LEFT(xiter_trav);
+        }
+        else
+        {
+            xiter_trav = XNODE_RIGHT(xiter_trav);
+        }
+    }
+
+    XSTAT_DEPTH(xthis_ptr, xst_depth);
+    return xiter_node;
+}
+
+/**********************************************************/
+/**
+ * @brief 将分离状态的节点停靠到 xrbtree_dock_pos() 返回的位置上，并进行修正操作。
+ */
+static xrbt_void_t xrbtree_dock_at(x_rbtree_ptr xthis_ptr,
+                                   x_rbnode_iter xiter_node,
+                                   x_rbnode_iter xiter_where,
+                                   xrbt_int32_t xit_select)
+{
+    XASSERT(0 != xit_select);
+
+    XNODE_SET_PARENT(xiter_node, xiter_where);
+    if (XNODE_IS_NIL(xiter_where))
+    {
+        XLINK_SET(xthis_ptr->xiter_root, xiter_node);
+    }
+    else if (xit_select < 0)
+    {
+        XNODE_SET_LEFT(xiter_where, xiter_node);
+    }
+    else
+    {
+        XNODE_SET_RIGHT(xiter_where, xiter_node);
+    }
+
+    xiter_node->xut_color = X_RED;
+    XTREE_SET_NIL(xthis_ptr, xiter_node->xiter_left );
+    XTREE_SET_NIL(xthis_ptr, xiter_node->xiter_right);
+
+    xrbtree_update(xthis_ptr, xiter_node, xit_select, XRBT_FALSE);
+    xrbtree_dock_fixup(xthis_ptr, xiter_node);
+}
+
+/**********************************************************/
+/**
+ * @brief 返回子树的黑高度（沿最左侧分支计数的黑色节点数量，不含 nil 节点）。
+ */
+static xrbt_uint32_t xrbtree_black_height(x_rbnode_iter xiter_node)
+{
+    xrbt_uint32_t xut_height = 0;
+
+    for (; XNODE_NOT_NIL(xiter_node); xiter_node = XNODE_LEFT(xiter_node))
+    {
+        if (X_BLACK == xiter_node->xut_color)
+            xut_height += 1;
+    }
+
+    return xut_height;
+}
+
+/**********************************************************/
+/**
+ * @brief 以 xiter_pivot 为连接节点，将左、右两棵子树合并为一棵子树
+ *        （左子树的节点 <= 连接节点 <= 右子树的节点）。
+ * @note
+ * 沿较高子树的内侧分支下行，至黑高度与较矮子树相同的黑色节点，以红色的连接节点替换之
+ * （被替换的节点与较矮子树作为连接节点的左右子树），再按停靠操作进行修正；
+ * 耗时与两棵子树的黑高度之差成正比。修正期间 xthis_ptr->xiter_root 被用作临时的根节点。
+ * 
+ * @param [in ] xthis_ptr   : 红黑树对象。
+ * @param [in ] xiter_lroot : 左子树的根节点（可为 nil 节点）。
+ * @param [in ] xut_lbh     : 左子树的黑高度。
+ * @param [in ] xiter_pivot : 连接节点。
+ * @param [in ] xiter_rroot : 右子树的根节点（可为 nil 节点）。
+ * @param [in ] xut_rbh     : 右子树的黑高度。
+ * @param [out] xut_bh      : 返回合并后子树的黑高度。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回合并后子树的根节点。
+ */
+static x_rbnode_iter xrbtree_join(x_rbtree_ptr xthis_ptr,
+                                  x_rbnode_iter xiter_lroot,
+                                  xrbt_uint32_t xut_lbh,
+                                  x_rbnode_iter xiter_pivot,
+                                  x_rbnode_iter xiter_rroot,
+                                  xrbt_uint32_t xut_rbh,
+                                  xrbt_uint32_t * xut_bh)
+{
+    x_rbnode_iter xiter_nil    = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter xiter_parent = xiter_nil;
+    x_rbnode_iter xiter_node   = xiter_nil;
+    x_rbnode_iter xiter_refer  = xiter_nil;
+    xrbt_uint32_t xut_height   = 0;
+
+    // 两棵子树的根节点置为黑色（红色的根节点变为黑色时，黑高度加 1）
+    if (X_RED == xiter_lroot->xut_color)
+    {
+        xiter_lroot->xut_color = X_BLACK;
+        xut_lbh += 1;
+    }
+
+    if (X_RED == xiter_rroot->xut_color)
+    {
+        xiter_rroot->xut_color = X_BLACK;
+        xut_rbh += 1;
+    }
+
+    xiter_pivot->xut_color = X_RED;
+
+    if (xut_lbh == xut_rbh)
+    {
+        XNODE_SET_PARENT(xiter_pivot, xiter_nil);
+        XNODE_SET_LEFT(xiter_pivot, xiter_lroot);
+        XNODE_SET_RIGHT(xiter_pivot, xiter_rroot);
+        if (XNODE_NOT_NIL(xiter_lroot))
+            XNODE_SET_PARENT(xiter_lroot, xiter_pivot);
+        if (XNODE_NOT_NIL(xiter_rroot))
+            XNODE_SET_PARENT(xiter_rroot, xiter_pivot);
+
+        *xut_bh = xut_lbh;
+        return xiter_pivot;
+    }
+
+    if (xut_lbh < xut_rbh)
+    {
+        // 沿右子树的最左侧分支下行
+        xiter_node = xiter_rroot;
+        xut_height = xut_rbh;
+        while ((X_RED == xiter_node->xut_color) || (xut_height > xut_lbh))
+        {
+            if (X_BLACK == xiter_node->xut_color)
+                xut_height -= 1;
+            xiter_parent = xiter_node;
+            xiter_node   = XNODE_LEFT(xiter_node);
+        }
+
+        XNODE_SET_LEFT(xiter_parent, xiter_pivot);
+        XNODE_SET_LEFT(xiter_pivot, xiter_lroot);
+        XNODE_SET_RIGHT(xiter_pivot, xiter_node);
+
+        XNODE_SET_PARENT(xiter_rroot, xiter_nil);
+        XLINK_SET(xthis_ptr->xiter_root, xiter_rroot);
+        xiter_refer = xiter_lroot;
+        xut_height  = xut_lbh;
+    }
+    else
+    {
+        // 沿左子树的最右侧分支下行
+        xiter_node = xiter_lroot;
+        xut_height = xut_lbh;
+        while ((X_RED == xiter_node->xut_color) || (xut_height > xut_rbh))
+        {
+            if (X_BLACK == xiter_node->xut_color)
+                xut_height -= 1;
+            xiter_parent = xiter_node;
+            xiter_node   = XNODE_RIGHT(xiter_node);
+        }
+
+        XNODE_SET_RIGHT(xiter_parent, xiter_pivot);
+        XNODE_SET_LEFT(xiter_pivot, xiter_node);
+        XNODE_SET_RIGHT(xiter_pivot, xiter_rroot);
+
+        XNODE_SET_PARENT(xiter_lroot, xiter_nil);
+        XLINK_SET(xthis_ptr->xiter_root, xiter_lroot);
+        xiter_refer = xiter_rroot;
+        xut_height  = xut_rbh;
+    }
+
+    XNODE_SET_PARENT(xiter_pivot, xiter_parent);
+    if (XNODE_NOT_NIL(XNODE_LEFT(xiter_pivot)))
+        XNODE_SET_PARENT(XNODE_LEFT(xiter_pivot), xiter_pivot);
+    if (XNODE_NOT_NIL(XNODE_RIGHT(xiter_pivot)))
+        XNODE_SET_PARENT(XNODE_RIGHT(xiter_pivot), xiter_pivot);
+
+    xrbtree_dock_fixup(xthis_ptr, xiter_pivot);
+
+    // 修正操作不改变较矮子树的内部结构，由其根节点上行计数，即得合并后的黑高度
+    if (XNODE_IS_NIL(xiter_refer))
+    {
+        xut_height = xrbtree_black_height(XTREE_ROOT(xthis_ptr));
+    }
+    else
+    {
+        for (xiter_node = XNODE_PARENT(xiter_refer);
+             XNODE_NOT_NIL(xiter_node);
+             xiter_node = XNODE_PARENT(xiter_node))
+        {
+            if (X_BLACK == xiter_node->xut_color)
+                xut_height += 1;
+        }
+    }
+
+    *xut_bh = xut_height;
+    return XTREE_ROOT(xthis_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 将 [XTREE_BEGIN(), xiter_last) 区间内的节点整体从红黑树中分离（xiter_last 不可为 nil 节点）。
+ * @note
+ * 由 xiter_last 沿父节点上行至根节点：位于路径右侧的节点（连同其右子树）依次以 xrbtree_join()
+ * 合并为新的红黑树；位于路径左侧的节点（连同其左子树）即被分离的节点。
+ * 逐级合并的黑高度之差累加后不超过树高，因此调整树结构的耗时为 O(log n) 。
+ * 节点数量、最左侧节点 由调用方更新。
+ * 
+ * @param [in ] xthis_ptr   : 红黑树对象。
+ * @param [in ] xiter_last  : 区间的结束位置。
+ * @param [in ] xbt_release : 是否释放被分离的节点（否则不访问被分离的节点，其链接保持原样）。
+ * 
+ * @return xrbt_size_t
+ *         - 释放被分离的节点时，返回释放的节点数量；否则返回 0 。
+ */
+static xrbt_size_t xrbtree_split_front(x_rbtree_ptr xthis_ptr,
+                                       x_rbnode_iter xiter_last,
+                                       xrbt_bool_t xbt_release)
+{
+    x_rbnode_iter xiter_node   = xiter_last;
+    x_rbnode_iter xiter_parent = XNODE_PARENT(xiter_last);
+    x_rbnode_iter xiter_next   = XRBT_NULL;
+    x_rbnode_iter xiter_root   = XRBT_NULL;
+    xrbt_uint32_t xut_rbh      = 0;
+    xrbt_uint32_t xut_cbh      = xrbtree_black_height(XNODE_RIGHT(xiter_last));
+    xrbt_uint32_t xut_nbh      = xut_cbh + ((X_BLACK == xiter_last->xut_color) ? 1 : 0);
+    xrbt_size_t   xst_count    = 0;
+
+    XASSERT(XNODE_NOT_NIL(xiter_last));
+
+    if (xbt_release)
+    {
+        xst_count += xrbtree_clear_branch(xthis_ptr, XNODE_LEFT(xiter_last));
+    }
+
+    // xut_cbh 为路径上当前节点（调整前）的黑高度，xut_rbh 为新红黑树的黑高度
+    xiter_root = xrbtree_join(xthis_ptr,
+                              XTREE_GET_NIL(xthis_ptr), 0,
+                              xiter_last,
+                              XNODE_RIGHT(xiter_last), xut_cbh,
+                              &xut_rbh);
+    xut_cbh = xut_nbh;
+
+    while (XNODE_NOT_NIL(xiter_parent))
+    {
+        xiter_next = XNODE_PARENT(xiter_parent);
+        xut_nbh    = xut_cbh + ((X_BLACK == xiter_parent->xut_color) ? 1 : 0);
+
+        if (XNODE_LEFT(xiter_parent) == xiter_node)
+        {
+            xiter_root = xrbtree_join(xthis_ptr,
+                                      xiter_root, xut_rbh,
+                                      xiter_parent,
+                                      XNODE_RIGHT(xiter_parent), xut_cbh,
+                                      &xut_rbh);
+        }
+        else if (xbt_release)
+        {
+            xst_count += xrbtree_clear_branch(xthis_ptr, XNODE_LEFT(xiter_parent));
+            xrbtree_dealloc(xthis_ptr, xiter_parent);
+            xst_count += 1;
+        }
+
+        xiter_node   = xiter_parent;
+        xiter_parent = xiter_next;
+        xut_cbh      = xut_nbh;
+    }
+
+    xiter_root->xut_color = X_BLACK;
+    XTREE_SET_NIL(xthis_ptr, xiter_root->xiter_parent);
+
+    XLINK_SET(xthis_ptr->xiter_root, xiter_root);
+    XLINK_SET(xthis_ptr->xiter_lnode, xiter_last);
+
+    return xst_count;
+}
+
+/**********************************************************/
+/**
+ * @brief 查找索引键值相等的节点（不产生操作记录，供内部使用）。
+ */
+static x_rbnode_iter xrbtree_find_pos(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey)
+{
+    x_rbtree_probe_t xprobe;
+    x_rbnode_iter    xiter_node = XTREE_GET_NIL(xthis_ptr);
+
+    xrbtree_probe_init(xthis_ptr, &xprobe, xrbt_vkey);
+    xiter_node = xrbtree_lower_pos(xthis_ptr, &xprobe);
+
+    if (XNODE_IS_NIL(xiter_node) ||
+        xrbtree_differ_pn(xthis_ptr, &xprobe, xiter_node) ||
+        xrbtree_less_pn(xthis_ptr, &xprobe, xiter_node))
+    {
+        return XTREE_GET_NIL(xthis_ptr);
+    }
+
+    return xiter_node;
+}
+
+/**********************************************************/
+/**
+ * @brief 向 x_rbtree_t 对象插入新节点。
+ * @note
+ * 映射表模式下，值数据只在新节点创建成功后设置，或者在 xbt_assign 为 XRBT_TRUE 时
+ * 覆盖已有节点的值数据；其他情况下不会访问 xrbt_vval 以及已有节点的值数据。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [in ] xrbt_vkey  : 新节点的索引键值。
+ * @param [in ] xrbt_vval  : 新节点的值数据（映射表模式，可为 XRBT_NULL）。
+ * @param [in ] xbt_move   : 回调设置 索引键值/值数据 时，是否使用 move 操作方式。
+ * @param [in ] xbt_assign : 索引键值已存在时，是否覆盖其值数据。
+ * @param [out] xbt_ok     : 返回操作成功的标识。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回对应节点；申请节点失败时，返回 nil 节点（xbt_ok 为 XRBT_FALSE）。
+ */
+static x_rbnode_iter xrbtree_insert_nkey(x_rbtree_ptr xthis_ptr,
+                                         xrbt_vkey_t xrbt_vkey,
+                                         xrbt_vval_t xrbt_vval,
+                                         xrbt_bool_t xbt_move,
+                                         xrbt_bool_t xbt_assign,
+                                         xrbt_bool_t * xbt_ok)
+{
+    //======================================
+
+    x_rbnode_iter    xiter_node = XTREE_GET_NIL(xthis_ptr);
+    xrbt_int32_t     xit_select = -1;
+    x_rbnode_iter    xiter_dpos = XTREE_GET_NIL(xthis_ptr);
+    x_rbtree_probe_t xprobe;
+
+    XASSERT(!XTREE_IS_LINK(xthis_ptr));
+
+    XSTAT_OP(xthis_ptr, XRBT_STATS_OP_INSERT);
+    XTRACE2(insert_entry, xthis_ptr, xthis_ptr->xst_count);
+    XRECORD(xthis_ptr, XRBT_RECORD_INSERT, xrbt_vkey);
+
+    xrbtree_probe_init(xthis_ptr, &xprobe, xrbt_vkey);
+    xiter_dpos = xrbtree_dock_pos(xthis_ptr, &xprobe, &xit_select);
+    if (0 == xit_select)
+    {
+        if (xbt_assign && (xthis_ptr->xst_vsize > 0))
+        {
+            XTREE_VCB(xthis_ptr)->xfunc_v_destruct(
+                                    XNODE_VVAL(xiter_dpos),
+                                    xthis_ptr->xst_vsize,
+                                    XTREE_CB(xthis_ptr)->xctxt_t_callback);
+            XTREE_VCB(xthis_ptr)->xfunc_v_copyfrom(
+                                    XNODE_VVAL(xiter_dpos),
+                                    xrbt_vval,
+                                    xthis_ptr->xst_vsize,
+                                    xbt_move,
+                                    XTREE_CB(xthis_ptr)->xctxt_t_callback);
+        }
+
+        if (XRBT_NULL != xbt_ok)
+            *xbt_ok = XRBT_FALSE;
+        XTRACE4(insert_return, xthis_ptr, xiter_dpos, 0, xthis_ptr->xut_trace_depth);
+        return xiter_dpos;
+    }
+
+    //======================================
+
+    xiter_node = xrbtree_node_get(xthis_ptr, xrbt_vkey);
+    if (XRBT_NULL == xiter_node)
+    {
+        if (XRBT_NULL != xbt_ok)
+            *xbt_ok = XRBT_FALSE;
+        XTRACE4(insert_return, xthis_ptr, XTREE_GET_NIL(xthis_ptr), 0, xthis_ptr->xut_trace_depth);
+        return XTREE_GET_NIL(xthis_ptr);
+    }
+
+    xrbtree_node_setkey(xthis_ptr, xiter_node, &xprobe, xbt_move);
+
+    if (xthis_ptr->xst_vsize > 0)
+    {
+        XTREE_VCB(xthis_ptr)->xfunc_v_copyfrom(
+                                    XNODE_VVAL(xiter_node),
+                                    xrbt_vval,
+                                    xthis_ptr->xst_vsize,
+                                    xbt_move,
+                                    XTREE_CB(xthis_ptr)->xctxt_t_callback);
+    }
+
+    //======================================
+
+    xrbtree_dock_at(xthis_ptr, xiter_node, xiter_dpos, xit_select);
+
+    //======================================
+
+    if (XRBT_NULL != xbt_ok)
+        *xbt_ok = XRBT_TRUE;
+
+    //======================================
+
+    XTRACE4(insert_return, xthis_ptr, xiter_node, 1, xthis_ptr->xut_trace_depth);
+    return xiter_node;
+}
+
+/**********************************************************/
+/**
+ * @brief 设置回调函数（为 XRBT_NULL 的回调函数使用默认的回调函数）。
+ * @note  xtree_cb、xtree_vcb 为 x_rbtree_t 对象中的回调函数，或者本进程的绑定（共享模式）。
+ */
+static xrbt_void_t xrbtree_set_callback(xrbt_callback_t * xtree_cb,
+                                        xrbt_vcallback_t * xtree_vcb,
+                                        xrbt_callback_t * xcallback,
+                                        xrbt_vcallback_t * xvcallback)
+{
+#define XFUC_CHECK_SET(xfunc, xcheck, xdef) \
+    do { xfunc = (XRBT_NULL != xcheck) ? xcheck : xdef; } while (0)
+
+    if (XRBT_NULL != xcallback)
+    {
+        XFUC_CHECK_SET(xtree_cb->xfunc_n_memalloc,
+                       xcallback->xfunc_n_memalloc,
+                       &xrbt_comm_node_memalloc);
+        XFUC_CHECK_SET(xtree_cb->xfunc_n_memfree,
+                       xcallback->xfunc_n_memfree,
+                       &xrbt_comm_node_memfree);
+        XFUC_CHECK_SET(xtree_cb->xfunc_k_copyfrom,
+                       xcallback->xfunc_k_copyfrom,
+                       &xrbt_comm_vkey_copyfrom);
+        XFUC_CHECK_SET(xtree_cb->xfunc_k_destruct,
+                       xcallback->xfunc_k_destruct,
+                       &xrbt_comm_vkey_destruct);
+        XFUC_CHECK_SET(xtree_cb->xfunc_k_compare,
+                       xcallback->xfunc_k_compare,
+                       &xrbt_comm_vkey_compare);
+
+        xtree_cb->xctxt_t_callback = xcallback->xctxt_t_callback;
+    }
+    else
+    {
+        xtree_cb->xfunc_n_memalloc = &xrbt_comm_node_memalloc;
+        xtree_cb->xfunc_n_memfree  = &xrbt_comm_node_memfree ;
+        xtree_cb->xfunc_k_copyfrom = &xrbt_comm_vkey_copyfrom;
+        xtree_cb->xfunc_k_destruct = &xrbt_comm_vkey_destruct;
+        xtree_cb->xfunc_k_compare  = &xrbt_comm_vkey_compare ;
+        xtree_cb->xctxt_t_callback = XRBT_NULL;
+    }
+
+    if (XRBT_NULL != xvcallback)
+    {
+        XFUC_CHECK_SET(xtree_vcb->xfunc_v_copyfrom,
+                       xvcallback->xfunc_v_copyfrom,
+                       &xrbt_comm_vval_copyfrom);
+        XFUC_CHECK_SET(xtree_vcb->xfunc_v_destruct,
+                       xvcallback->xfunc_v_destruct,
+                       &xrbt_comm_vkey_destruct);
+    }
+    else
+    {
+        xtree_vcb->xfunc_v_copyfrom = &xrbt_comm_vval_copyfrom;
+        xtree_vcb->xfunc_v_destruct = &xrbt_comm_vkey_destruct;
+    }
+
+#undef XFUC_CHECK_SET
+}
+
+//====================================================================
+
+// 
+// 红黑树的序列化操作接口（参看 xrbtree_save() 的数据格式说明）
+// 
+
+/** 序列化数据的分块读写大小 */
+#define XSTREAM_CHUNK       (64 * 1024)
+#define XSTREAM_HSIZE       32
+
+#define XFNV64_OFFSET       0xCBF29CE484222325ULL
+#define XFNV64_PRIME        0x00000100000001B3ULL
+
+/**
+ * @struct x_rbtree_stream_t
+ * @brief  序列化操作所使用的分块读写缓存（同时累计已读写数据的校验值）。
+ */
+typedef struct x_rbtree_stream_t
+{
+    xfunc_stream_write_t xfunc_write;  ///< 序列化输出的回调函数（输出时有效）
+    xfunc_stream_read_t  xfunc_read;   ///< 序列化输入的回调函数（输入时有效）
+    xrbt_ctxt_t          xrbt_ctxt;    ///< 回调的上下文标识
+    xrbt_byte_t        * xbt_chunk;    ///< 分块缓存
+    xrbt_size_t          xst_pos;      ///< 分块缓存中的 读/写 位置
+    xrbt_size_t          xst_end;      ///< 分块缓存中的有效数据末尾（输入时有效）
+    xrbt_size_t          xst_hpos;     ///< 分块缓存中尚未累计校验值的起始位置
+    xrbt_bool_t          xbt_fail;     ///< 是否已出现 读/写 失败
+    xrbt_uint64_t        xu64_hash;    ///< 已累计的校验值
+} x_rbtree_stream_t;
+
+/**********************************************************/
+/**
+ * @brief 将分块缓存中 [xst_hpos, xst_pos) 的数据累计到校验值。
+ */
+static xrbt_void_t xstream_hash(x_rbtree_stream_t * xstream_ptr)
+{
+    xrbt_uint64_t xu64_hash = xstream_ptr->xu64_hash;
+    xrbt_size_t   xst_iter  = xstream_ptr->xst_hpos;
+
+    for (; xst_iter < xstream_ptr->xst_pos; ++xst_iter)
+    {
+        xu64_hash = (xu64_hash ^ xstream_ptr->xbt_chunk[xst_iter]) * XFNV64_PRIME;
+    }
+
+    xstream_ptr->xu64_hash = xu64_hash;
+    xstream_ptr->xst_hpos  = xstream_ptr->xst_pos;
+}
+
+/**********************************************************/
+/**
+ * @brief 输出分块缓存中的数据。
+ */
+static xrbt_void_t xstream_flush(x_rbtree_stream_t * xstream_ptr)
+{
+    xstream_hash(xstream_ptr);
+
+    if ((xstream_ptr->xst_pos > 0) && !xstream_ptr->xbt_fail)
+    {
+        xstream_ptr->xbt_fail = !xstream_ptr->xfunc_write(
+                                        xstream_ptr->xrbt_ctxt,
+                                        xstream_ptr->xbt_chunk,
+                                        xstream_ptr->xst_pos);
+    }
+
+    xstream_ptr->xst_pos  = 0;
+    xstream_ptr->xst_hpos = 0;
+}
+
+/**********************************************************/
+/**
+ * @brief 向分块缓存写入数据。
+ */
+static xrbt_void_t xstream_write(x_rbtree_stream_t * xstream_ptr,
+                                 const xrbt_void_t * xmt_data,
+                                 xrbt_size_t xst_size)
+{
+    const xrbt_byte_t * xbt_data = (const xrbt_byte_t *)xmt_data;
+    xrbt_size_t         xst_copy = 0;
+
+    while (xst_size > 0)
+    {
+        if (XSTREAM_CHUNK == xstream_ptr->xst_pos)
+            xstream_flush(xstream_ptr);
+
+        xst_copy = XSTREAM_CHUNK - xstream_ptr->xst_pos;
+        if (xst_copy > xst_size)
+            xst_copy = xst_size;
+
+        memcpy(xstream_ptr->xbt_chunk + xstream_ptr->xst_pos, xbt_data, xst_copy);
+        xstream_ptr->xst_pos += xst_copy;
+        xbt_data += xst_copy;
+        xst_size -= xst_copy;
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 读取下一个数据块到分块缓存（读取前累计已消耗数据的校验值）。
+ */
+static xrbt_bool_t xstream_fill(x_rbtree_stream_t * xstream_ptr)
+{
+    xstream_hash(xstream_ptr);
+
+    xstream_ptr->xst_pos  = 0;
+    xstream_ptr->xst_hpos = 0;
+    xstream_ptr->xst_end  = 0;
+
+    if (!xstream_ptr->xbt_fail)
+    {
+        xstream_ptr->xst_end = xstream_ptr->xfunc_read(
+                                        xstream_ptr->xrbt_ctxt,
+                                        xstream_ptr->xbt_chunk,
+                                        XSTREAM_CHUNK);
+    }
+
+    if (0 == xstream_ptr->xst_end)
+        xstream_ptr->xbt_fail = XRBT_TRUE;
+    return !xstream_ptr->xbt_fail;
+}
+
+/**********************************************************/
+/**
+ * @brief 从分块缓存读取数据。
+ */
+static xrbt_bool_t xstream_read(x_rbtree_stream_t * xstream_ptr,
+                                xrbt_void_t * xmt_data,
+                                xrbt_size_t xst_size)
+{
+    xrbt_byte_t * xbt_data = (xrbt_byte_t *)xmt_data;
+    xrbt_size_t   xst_copy = 0;
+
+    while (xst_size > 0)
+    {
+        if ((xstream_ptr->xst_pos == xstream_ptr->xst_end) && !xstream_fill(xstream_ptr))
+            return XRBT_FALSE;
+
+        xst_copy = xstream_ptr->xst_end - xstream_ptr->xst_pos;
+        if (xst_copy > xst_size)
+            xst_copy = xst_size;
+
+        memcpy(xbt_data, xstream_ptr->xbt_chunk + xstream_ptr->xst_pos, xst_copy);
+        xstream_ptr->xst_pos += xst_copy;
+        xbt_data += xst_copy;
+        xst_size -= xst_copy;
+    }
+
+    return XRBT_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 以 zigzag + LEB128 变长编码写入有符号的差值。
+ */
+static xrbt_void_t xstream_write_delta(x_rbtree_stream_t * xstream_ptr, xrbt_uint64_t xu64_delta)
+{
+    xrbt_byte_t   xbt_code[10];
+    xrbt_size_t   xst_code = 0;
+    xrbt_uint64_t xu64_zig = (xu64_delta << 1) ^ (0 - (xu64_delta >> 63));
+
+    do
+    {
+        xbt_code[xst_code] = (xrbt_byte_t)(xu64_zig & 0x7F);
+        xu64_zig >>= 7;
+        if (0 != xu64_zig)
+            xbt_code[xst_code] |= 0x80;
+        xst_code += 1;
+    } while (0 != xu64_zig);
+
+    xstream_write(xstream_ptr, xbt_code, xst_code);
+}
+
+/**********************************************************/
+/**
+ * @brief 读取以 zigzag + LEB128 变长编码的有符号差值。
+ */
+static xrbt_bool_t xstream_read_delta(x_rbtree_stream_t * xstream_ptr, xrbt_uint64_t * xu64_delta)
+{
+    xrbt_uint64_t xu64_zig = 0;
+    xrbt_uint32_t xut_bits = 0;
+    xrbt_byte_t   xbt_code = 0x80;
+
+    while (0 != (xbt_code & 0x80))
+    {
+        if ((xut_bits >= 64) || !xstream_read(xstream_ptr, &xbt_code, 1))
+            return XRBT_FALSE;
+
+        xu64_zig |= (xrbt_uint64_t)(xbt_code & 0x7F) << xut_bits;
+        xut_bits += 7;
+    }
+
+    *xu64_delta = (xu64_zig >> 1) ^ (0 - (xu64_zig & 1));
+    return XRBT_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 以本机字节序读取 4/8 字节的整数索引键。
+ */
+static inline xrbt_uint64_t xstream_kint_get(xrbt_vkey_t xrbt_vkey, xrbt_size_t xst_ksize)
+{
+    xrbt_uint32_t xut_kint  = 0;
+    xrbt_uint64_t xu64_kint = 0;
+
+    if (sizeof(xrbt_uint32_t) == xst_ksize)
+    {
+        memcpy(&xut_kint, xrbt_vkey, sizeof(xrbt_uint32_t));
+        return xut_kint;
+    }
+
+    memcpy(&xu64_kint, xrbt_vkey, sizeof(xrbt_uint64_t));
+    return xu64_kint;
+}
+
+/**********************************************************/
+/**
+ * @brief 以本机字节序写入 4/8 字节的整数索引键。
+ */
+static inline xrbt_void_t xstream_kint_set(xrbt_vkey_t xrbt_vkey,
+                                           xrbt_size_t xst_ksize,
+                                           xrbt_uint64_t xu64_kint)
+{
+    xrbt_uint32_t xut_kint = (xrbt_uint32_t)xu64_kint;
+
+    if (sizeof(xrbt_uint32_t) == xst_ksize)
+        memcpy(xrbt_vkey, &xut_kint, sizeof(xrbt_uint32_t));
+    else
+        memcpy(xrbt_vkey, &xu64_kint, sizeof(xrbt_uint64_t));
+}
+
+/**
+ * @struct x_rbtree_loader_t
+ * @brief  加载序列化数据时，按索引键顺序构建红黑树的上下文信息。
+ */
+typedef struct x_rbtree_loader_t
+{
+    x_rbtree_stream_t * xstream_ptr;   ///< 序列化数据的读取缓存
+    xrbt_uint32_t       xut_encode;    ///< 索引键的编码方式
+    xrbt_uint32_t       xut_rlevel;    ///< 着为红色的节点所在层级（根节点为第 0 层）
+    xrbt_byte_t       * xbt_kbuf;      ///< 读取 索引键/值数据 的临时缓存（按 XNODE_VALIGN 对齐）
+    xrbt_uint64_t       xu64_kprev;    ///< 前一个索引键的整数值（XRBT_SAVE_DELTA 编码方式）
+} x_rbtree_loader_t;
+
+/**********************************************************/
+/**
+ * @brief 从序列化数据中读取下一个节点的 索引键/值数据，构造节点。
+ * 
+ * @return x_rbnode_iter
+ *         - 读取失败、申请节点失败时，返回 XRBT_NULL 。
+ */
+static x_rbnode_iter xrbtree_load_node(x_rbtree_ptr xthis_ptr, x_rbtree_loader_t * xloader_ptr)
+{
+    x_rbnode_iter    xiter_node = XRBT_NULL;
+    xrbt_uint64_t    xu64_delta = 0;
+    xrbt_vkey_t      xrbt_vkey  = (xrbt_vkey_t)xloader_ptr->xbt_kbuf;
+    xrbt_vval_t      xrbt_vval  = (xrbt_vval_t)(xloader_ptr->xbt_kbuf +
+                                                XNODE_VOFFS(xthis_ptr->xst_ksize));
+    x_rbtree_probe_t xprobe;
+
+    if (XRBT_SAVE_DELTA == xloader_ptr->xut_encode)
+    {
+        if (!xstream_read_delta(xloader_ptr->xstream_ptr, &xu64_delta))
+            return XRBT_NULL;
+
+        xloader_ptr->xu64_kprev += xu64_delta;
+        xstream_kint_set(xrbt_vkey, xthis_ptr->xst_ksize, xloader_ptr->xu64_kprev);
+    }
+    else if (!xstream_read(xloader_ptr->xstream_ptr, xrbt_vkey, xthis_ptr->xst_ksize))
+    {
+        return XRBT_NULL;
+    }
+
+    if ((xthis_ptr->xst_vsize > 0) &&
+        !xstream_read(xloader_ptr->xstream_ptr, xrbt_vval, xthis_ptr->xst_vsize))
+    {
+        return XRBT_NULL;
+    }
+
+    xrbtree_probe_init(xthis_ptr, &xprobe, xrbt_vkey);
+    xiter_node = xrbtree_node_get(xthis_ptr, xrbt_vkey);
+    if (XRBT_NULL == xiter_node)
+    {
+        xloader_ptr->xstream_ptr->xbt_fail = XRBT_TRUE;
+        return XRBT_NULL;
+    }
+
+    xrbtree_node_setkey(xthis_ptr, xiter_node, &xprobe, XRBT_TRUE);
+
+    if (xthis_ptr->xst_vsize > 0)
+    {
+        XTREE_VCB(xthis_ptr)->xfunc_v_copyfrom(
+                                    XNODE_VVAL(xiter_node),
+                                    xrbt_vval,
+                                    xthis_ptr->xst_vsize,
+                                    XRBT_TRUE,
+                                    XTREE_CB(xthis_ptr)->xctxt_t_callback);
+    }
+
+    return xiter_node;
+}
+
+/**********************************************************/
+/**
+ * @brief 按索引键顺序，以序列化数据中 [xst_lpos, xst_rpos) 区间的节点构建平衡的子树。
+ * @note
+ * 中间节点作为子树的根，左右子树的节点数量至多相差 1，
+ * 只有最深的（未满的）一层节点着为红色，其余节点均为黑色，满足红黑树的性质；
+ * 读取失败时，已构造的节点仍链接在返回的子树中（由调用方统一释放）。
+ */
+static x_rbnode_iter xrbtree_load_branch(x_rbtree_ptr xthis_ptr,
+                                         x_rbtree_loader_t * xloader_ptr,
+                                         xrbt_size_t xst_lpos,
+                                         xrbt_size_t xst_rpos,
+                                         xrbt_uint32_t xut_level)
+{
+    x_rbnode_iter xiter_node = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter xiter_left = XTREE_GET_NIL(xthis_ptr);
+    xrbt_size_t   xst_mpos   = 0;
+
+    if (xst_lpos >= xst_rpos)
+        return xiter_node;
+
+    xst_mpos   = xst_lpos + (xst_rpos - xst_lpos - 1) / 2;
+    xiter_left = xrbtree_load_branch(xthis_ptr, xloader_ptr, xst_lpos, xst_mpos, xut_level + 1);
+    if (xloader_ptr->xstream_ptr->xbt_fail)
+        return xiter_left;
+
+    xiter_node = xrbtree_load_node(xthis_ptr, xloader_ptr);
+    if (XRBT_NULL == xiter_node)
+        return xiter_left;
+
+    xiter_node->xut_color  = (xut_level == xloader_ptr->xut_rlevel) ? X_RED : X_BLACK;
+    XNODE_SET_LEFT(xiter_node, xiter_left);
+    if (XNODE_NOT_NIL(xiter_left))
+        XNODE_SET_PARENT(xiter_left, xiter_node);
+
+    XNODE_SET_RIGHT(xiter_node, xrbtree_load_branch(
+                    xthis_ptr, xloader_ptr, xst_mpos + 1, xst_rpos, xut_level + 1));
+    if (XNODE_NOT_NIL(XNODE_RIGHT(xiter_node)))
+        XNODE_SET_PARENT(XNODE_RIGHT(xiter_node), xiter_node);
+
+    return xiter_node;
+}
+
+/**********************************************************/
+/**
+ * @brief 回调 fwrite() 的序列化输出接口（xrbtree_save_file() 使用）。
+ */
+static xrbt_bool_t xstream_file_write(xrbt_ctxt_t xrbt_ctxt,
+                                      const xrbt_void_t * xmt_data,
+                                      xrbt_size_t xst_size)
+{
+    return (xst_size == (xrbt_size_t)fwrite(xmt_data, 1, xst_size, (FILE *)xrbt_ctxt));
+}
+
+/**********************************************************/
+/**
+ * @brief 回调 fread() 的序列化输入接口（xrbtree_load_file() 使用）。
+ */
+static xrbt_size_t xstream_file_read(xrbt_ctxt_t xrbt_ctxt,
+                                     xrbt_void_t * xmt_buf,
+                                     xrbt_size_t xst_size)
+{
+    return (xrbt_size_t)fread(xmt_buf, 1, xst_size, (FILE *)xrbt_ctxt);
+}
+
+//====================================================================
+
+// 
+// 红黑树的外部操作接口
+// 
+
+/**********************************************************/
+/**
+ * @brief 返回内部 x_rbtree_t 的 sizeof 值。
+ */
+xrbt_size_t xrbtree_sizeof(void)
+{
+    return sizeof(x_rbtree_t);
+}
+
+/**********************************************************/
+/**
+ * @brief 创建 x_rbtree_t 对象。
+ * @note
+ * xcallback 会在红黑树对象内部另有缓存保存所设置的参数，外部无须持续保留；
+ * 若某个回调函数为 XRBT_NULL，则取内部默认值。
+ * 
+ * @param [in ] xst_ksize : 索引键数据类型所需的缓存大小（如 sizeof 值）。
+ * @param [in ] xcallback : 节点操作的相关回调函数。
+ * 
+ * @return x_rbtree_ptr
+ *         - 成功，返回 x_rbtree_t 对象；
+ *         - 失败，返回 XRBT_NULL；
+ */
+x_rbtree_ptr xrbtree_create(xrbt_size_t xst_ksize, xrbt_callback_t * xcallback)
+{
+    XASSERT((xst_ksize > 0) && (xst_ksize <= 0x7FFFFFFF));
+
+    x_rbtree_ptr xthis_ptr = (x_rbtree_ptr)xrbt_heap_alloc(sizeof(x_rbtree_t));
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+    return xrbtree_emplace_create(xthis_ptr, xst_ksize, xcallback);
+}
+
+/**********************************************************/
+/**
+ * @brief 创建 映射表模式（节点同时存储 索引键 与 值数据）的 x_rbtree_t 对象。
+ * @note
+ * 值数据 不参与节点的比较操作；xvcallback 为 XRBT_NULL 或者
+ * 某个回调函数为 XRBT_NULL 时，则取内部默认值（按字节拷贝，默认值为全 0）。
+ * 
+ * @param [in ] xst_ksize  : 索引键数据类型所需的缓存大小（如 sizeof 值）。
+ * @param [in ] xst_vsize  : 值数据类型所需的缓存大小（为 0 时，等同于 xrbtree_create()）。
+ * @param [in ] xcallback  : 节点操作的相关回调函数。
+ * @param [in ] xvcallback : 节点值数据的相关回调函数。
+ * 
+ * @return x_rbtree_ptr
+ *         - 成功，返回 x_rbtree_t 对象；
+ *         - 失败，返回 XRBT_NULL；
+ */
+x_rbtree_ptr xrbtree_create_kv(xrbt_size_t xst_ksize,
+                               xrbt_size_t xst_vsize,
+                               xrbt_callback_t * xcallback,
+                               xrbt_vcallback_t * xvcallback)
+{
+    return xrbtree_create_ex(xst_ksize, xst_vsize, 0, xcallback, xvcallback);
+}
+
+/**********************************************************/
+/**
+ * @brief 创建 x_rbtree_t 对象（可指定模式标识）。
+ * 
+ * @param [in ] xst_ksize  : 索引键数据类型所需的缓存大小（如 sizeof 值）。
+ * @param [in ] xst_vsize  : 值数据类型所需的缓存大小（为 0 时，不使用映射表模式）。
+ * @param [in ] xut_flags  : 模式标识（参看 emXRBtreeFlags 枚举值）。
+ * @param [in ] xcallback  : 节点操作的相关回调函数。
+ * @param [in ] xvcallback : 节点值数据的相关回调函数。
+ * 
+ * @return x_rbtree_ptr
+ *         - 成功，返回 x_rbtree_t 对象；
+ *         - 失败，返回 XRBT_NULL；
+ */
+x_rbtree_ptr xrbtree_create_ex(xrbt_size_t xst_ksize,
+                               xrbt_size_t xst_vsize,
+                               xrbt_uint32_t xut_flags,
+                               xrbt_callback_t * xcallback,
+                               xrbt_vcallback_t * xvcallback)
+{
+    XASSERT((xst_ksize > 0) && (xst_ksize <= 0x7FFFFFFF));
+
+    x_rbtree_ptr xthis_ptr = (x_rbtree_ptr)xrbt_heap_alloc(sizeof(x_rbtree_t));
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+    if (XRBT_NULL == xrbtree_emplace_create_ex(
+            xthis_ptr, xst_ksize, xst_vsize, xut_flags, xcallback, xvcallback))
+    {
+        xrbt_heap_free(xthis_ptr);
+        return XRBT_NULL;
+    }
+
+    return xthis_ptr;
+}
+
+/**********************************************************/
+/**
+ * @brief 销毁 x_rbtree_t 对象。
+ */
+xrbt_void_t xrbtree_destroy(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+    xrbtree_emplace_destroy(xthis_ptr);
+    xrbt_heap_free(xthis_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 在已开辟 x_rbtree_t 对象缓存的位置上创建 x_rbtree_t 对象。
+ * @note  xthis_ptr 的缓存大小必须大于等于 sizeof(x_rbtree_t) 值。
+ */
+x_rbtree_ptr xrbtree_emplace_create(x_rbtree_ptr xthis_ptr,
+                                    xrbt_size_t xst_ksize,
+                                    xrbt_callback_t * xcallback)
+{
+    return xrbtree_emplace_create_kv(
+                xthis_ptr, xst_ksize, 0, xcallback, XRBT_NULL);
+}
+
+/**********************************************************/
+/**
+ * @brief 在已开辟 x_rbtree_t 对象缓存的位置上创建 映射表模式 的 x_rbtree_t 对象。
+ * @note  参数说明参看 @see xrbtree_create_kv() 。
+ */
+x_rbtree_ptr xrbtree_emplace_create_kv(x_rbtree_ptr xthis_ptr,
+                                       xrbt_size_t xst_ksize,
+                                       xrbt_size_t xst_vsize,
+                                       xrbt_callback_t * xcallback,
+                                       xrbt_vcallback_t * xvcallback)
+{
+    return xrbtree_emplace_create_ex(
+        xthis_ptr, xst_ksize, xst_vsize, 0, xcallback, xvcallback);
+}
+
+/**********************************************************/
+/**
+ * @brief 在已开辟 x_rbtree_t 对象缓存的位置上创建 x_rbtree_t 对象（可指定模式标识）。
+ * @note  参数说明参看 @see xrbtree_create_ex() 。
+ */
+x_rbtree_ptr xrbtree_emplace_create_ex(x_rbtree_ptr xthis_ptr,
+                                       xrbt_size_t xst_ksize,
+                                       xrbt_size_t xst_vsize,
+                                       xrbt_uint32_t xut_flags,
+                                       xrbt_callback_t * xcallback,
+                                       xrbt_vcallback_t * xvcallback)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT((xst_ksize > 0) && (xst_ksize <= XNODE_KSIZE_MAX));
+    XASSERT(xst_vsize <= (0x7FFFFFFF - XNODE_VOFFS(xst_ksize)));
+    XASSERT(!(xut_flags & XRBT_FLAG_INTRUSIVE) ||
+            (!(xut_flags & (XRBT_FLAG_BORROW | XRBT_FLAG_NOFREE)) && (0 == xst_vsize)));
+    XASSERT(!(xut_flags & XRBT_FLAG_SHARED) || !(xut_flags & XRBT_FLAG_BORROW));
+
+    xrbtree_set_callback(&xthis_ptr->xcallback, &xthis_ptr->xvcallback, xcallback, xvcallback);
+
+    X_RESET_NIL(xthis_ptr);
+
+    xthis_ptr->xst_ksize = xst_ksize;
+    xthis_ptr->xst_vsize = xst_vsize;
+    xthis_ptr->xut_flags = xut_flags;
+    xthis_ptr->xut_kmode = (xut_flags & XRBT_FLAG_BORROW) ? XNODE_KMODE_BORROW : 0;
+    xthis_ptr->xut_lkoffs = 0;
+    if (xut_flags & XRBT_FLAG_INTRUSIVE)
+    {
+        xthis_ptr->xut_kmode  = XNODE_KMODE_LINK;
+        xthis_ptr->xut_lkoffs = XNODE_LINK_KBIAS + (xrbt_uint32_t)sizeof(x_rbtree_link_t);
+    }
+    xthis_ptr->xfunc_k_prefix = XRBT_NULL;
+    xthis_ptr->xfunc_k_hash   = XRBT_NULL;
+    xrbtree_node_size(xthis_ptr);
+    xthis_ptr->xst_count = 0;
+    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_root );
+    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_lnode);
+    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_rnode);
+    XLINK_SET(xthis_ptr->xiter_spare, XRBT_NULL);
+    XLINK_SET(xthis_ptr->xiter_reclaim, XRBT_NULL);
+    XLINK_SET(xthis_ptr->xiter_rnil, XRBT_NULL);
+    xthis_ptr->xst_reclaim   = 0;
+    xrbtree_reset_stats(xthis_ptr);
+    XTRACE_EXEC(xthis_ptr->xut_trace_depth  = 0);
+    XTRACE_EXEC(xthis_ptr->xut_trace_rotate = 0);
+#if XRBTREE_ENABLE_RECORD
+    xthis_ptr->xfile_record   = XRBT_NULL;
+    xthis_ptr->xu64_record_tm = 0;
+#endif // XRBTREE_ENABLE_RECORD
+
+    // 共享模式下，创建的进程自动绑定（其他进程挂接时，参看 xrbtree_emplace_reattach()）
+    if ((xut_flags & XRBT_FLAG_SHARED) &&
+        !xrbtree_bind_callback(xthis_ptr, xcallback, xvcallback))
+    {
+        return XRBT_NULL;
+    }
+
+    return xthis_ptr;
+}
+
+/**********************************************************/
+/**
+ * @brief 创建 侵入模式（XRBT_FLAG_INTRUSIVE）的 x_rbtree_t 对象。
+ * @note
+ * 节点的索引键值为 (xrbt_byte_t *)链接头 + xit_koffset 所指向的 xst_ksize 个字节，
+ * 偏移量可为负值（索引键位于链接头之前），但不可与链接头的内存区域重叠。
+ * 
+ * @param [in ] xst_ksize   : 索引键数据类型所需的缓存大小（如 sizeof 值）。
+ * @param [in ] xit_koffset : 索引键相对链接头的偏移量（参看 XRBT_LINK_KOFFSET()）。
+ * @param [in ] xut_flags   : 模式标识（可组合 XRBT_FLAG_MULTI，XRBT_FLAG_INTRUSIVE 总是被设置）。
+ * @param [in ] xcallback   : 节点操作的相关回调函数（只使用 xfunc_k_compare 与 xctxt_t_callback）。
+ * 
+ * @return x_rbtree_ptr
+ *         - 成功，返回 x_rbtree_t 对象；
+ *         - 失败，返回 XRBT_NULL；
+ */
+x_rbtree_ptr xrbtree_create_intrusive(xrbt_size_t xst_ksize,
+                                      xrbt_int32_t xit_koffset,
+                                      xrbt_uint32_t xut_flags,
+                                      xrbt_callback_t * xcallback)
+{
+    XASSERT((xst_ksize > 0) && (xst_ksize <= XNODE_KSIZE_MAX));
+
+    x_rbtree_ptr xthis_ptr = (x_rbtree_ptr)xrbt_heap_alloc(sizeof(x_rbtree_t));
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+    if (XRBT_NULL == xrbtree_emplace_create_intrusive(
+            xthis_ptr, xst_ksize, xit_koffset, xut_flags, xcallback))
+    {
+        xrbt_heap_free(xthis_ptr);
+        return XRBT_NULL;
+    }
+
+    return xthis_ptr;
+}
+
+/**********************************************************/
+/**
+ * @brief 在已开辟 x_rbtree_t 对象缓存的位置上创建 侵入模式 的 x_rbtree_t 对象。
+ * @note  参数说明参看 @see xrbtree_create_intrusive() 。
+ */
+x_rbtree_ptr xrbtree_emplace_create_intrusive(x_rbtree_ptr xthis_ptr,
+                                              xrbt_size_t xst_ksize,
+                                              xrbt_int32_t xit_koffset,
+                                              xrbt_uint32_t xut_flags,
+                                              xrbt_callback_t * xcallback)
+{
+    XASSERT(xit_koffset > -XNODE_LINK_KBIAS);
+    XASSERT(xit_koffset <  XNODE_LINK_KBIAS);
+    XASSERT((xit_koffset >= (xrbt_int32_t)sizeof(x_rbtree_link_t)) ||
+            (xit_koffset + (xrbt_int32_t)xst_ksize <= 0));
+
+    xthis_ptr = xrbtree_emplace_create_ex(
+                    xthis_ptr,
+                    xst_ksize,
+                    0,
+                    (xut_flags & ~XRBT_FLAG_BORROW) | XRBT_FLAG_INTRUSIVE,
+                    xcallback,
+                    XRBT_NULL);
+
+    if (XRBT_NULL != xthis_ptr)
+        xthis_ptr->xut_lkoffs = (xrbt_uint32_t)(XNODE_LINK_KBIAS + xit_koffset);
+
+    return xthis_ptr;
+}
+
+/**********************************************************/
+/**
+ * @brief 重新挂接 整体移动（或跨进程映射）后的 x_rbtree_t 对象。
+ */
+x_rbtree_ptr xrbtree_emplace_reattach(x_rbtree_ptr xthis_ptr,
+                                      xrbt_callback_t * xcallback,
+                                      xrbt_vcallback_t * xvcallback,
+                                      xfunc_vkey_prefix_t xfunc_k_prefix,
+                                      xfunc_vkey_hash_t xfunc_k_hash)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT((XRBT_NULL != xfunc_k_prefix) ==
+            (0 != (xthis_ptr->xut_kmode & XNODE_KMODE_PREFIX)));
+
+    // 节点之间以自相对偏移量链接，整体移动后无须重定位；
+    // 共享模式下，对象正被其他进程使用，只为本进程绑定回调函数
+    if (XTREE_IS_SHARED(xthis_ptr))
+    {
+        XASSERT((XRBT_NULL == xfunc_k_prefix) && (XRBT_NULL == xfunc_k_hash));
+        return xrbtree_bind_callback(xthis_ptr, xcallback, xvcallback) ? xthis_ptr : XRBT_NULL;
+    }
+
+    X_RESET_NIL(xthis_ptr);
+    xrbtree_set_callback(&xthis_ptr->xcallback, &xthis_ptr->xvcallback, xcallback, xvcallback);
+    xthis_ptr->xfunc_k_prefix = xfunc_k_prefix;
+    xthis_ptr->xfunc_k_hash   = XTREE_IS_BORROW(xthis_ptr) ? xfunc_k_hash : XRBT_NULL;
+    xrbtree_reset_stats(xthis_ptr);
+    XTRACE_EXEC(xthis_ptr->xut_trace_depth  = 0);
+    XTRACE_EXEC(xthis_ptr->xut_trace_rotate = 0);
+#if XRBTREE_ENABLE_RECORD
+    xthis_ptr->xfile_record   = XRBT_NULL;
+    xthis_ptr->xu64_record_tm = 0;
+#endif // XRBTREE_ENABLE_RECORD
+
+    return xthis_ptr;
+}
+
+/**********************************************************/
+/**
+ * @brief 共享模式（XRBT_FLAG_SHARED）下，为本进程绑定红黑树所使用的回调函数。
+ */
+xrbt_bool_t xrbtree_bind_callback(x_rbtree_ptr xthis_ptr,
+                                  xrbt_callback_t * xcallback,
+                                  xrbt_vcallback_t * xvcallback)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XTREE_IS_SHARED(xthis_ptr));
+
+    x_rbtree_bind_t * xbind_ptr = xrbtree_bind_find(xthis_ptr);
+
+    if (XRBT_NULL == xbind_ptr)
+    {
+        xbind_ptr = xrbtree_bind_find(XRBT_NULL);
+        if (XRBT_NULL == xbind_ptr)
+            return XRBT_FALSE;
+    }
+
+    xrbtree_set_callback(&xbind_ptr->xcallback, &xbind_ptr->xvcallback, xcallback, xvcallback);
+    xbind_ptr->xtree_ptr = xthis_ptr;
+
+    return XRBT_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 共享模式（XRBT_FLAG_SHARED）下，解除本进程对红黑树的回调函数绑定。
+ */
+xrbt_void_t xrbtree_unbind_callback(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+    x_rbtree_bind_t * xbind_ptr = xrbtree_bind_find(xthis_ptr);
+
+    if (XRBT_NULL != xbind_ptr)
+    {
+        memset(xbind_ptr, 0, sizeof(x_rbtree_bind_t));
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 在已开辟 x_rbtree_t 对象缓存的位置上销毁 x_rbtree_t 对象。
+ */
+xrbt_void_t xrbtree_emplace_destroy(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    xrbtree_record_stop(xthis_ptr);
+    xrbtree_clear(xthis_ptr);
+
+    if (XTREE_IS_SHARED(xthis_ptr))
+    {
+        xrbtree_unbind_callback(xthis_ptr);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 清除 x_rbtree_t 对象中的所有节点。
+ */
+xrbt_void_t xrbtree_clear(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+    XSTAT_OP(xthis_ptr, XRBT_STATS_OP_CLEAR);
+    XTRACE2(clear_entry, xthis_ptr, xthis_ptr->xst_count);
+    XRECORD(xthis_ptr, XRBT_RECORD_CLEAR, XRBT_NULL);
+
+    // 不逐个释放节点内存，且 索引键/值数据 无须析构时，直接丢弃整棵树（O(1)）
+    if (xrbtree_need_release(xthis_ptr))
+    {
+        xrbtree_reclaim_steps(xthis_ptr, ~(xrbt_size_t)0);
+        xrbtree_clear_branch(xthis_ptr, XTREE_ROOT(xthis_ptr));
+    }
+    xrbtree_node_drop_spare(xthis_ptr);
+
+    XLINK_SET(xthis_ptr->xiter_reclaim, XRBT_NULL);
+    XLINK_SET(xthis_ptr->xiter_rnil, XRBT_NULL);
+    xthis_ptr->xst_reclaim   = 0;
+
+    X_RESET_NIL(xthis_ptr);
+
+    xthis_ptr->xst_count = 0;
+    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_root );
+    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_lnode);
+    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_rnode);
+
+    XTRACE1(clear_return, xthis_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 分步清除 x_rbtree_t 对象中的所有节点（用于事件循环等不可长时间阻塞的场合）。
+ * 
+ * @return xrbt_size_t
+ *         - 返回剩余的待释放节点数量（返回 0 表示清除已完成）。
+ */
+xrbt_size_t xrbtree_clear_step(x_rbtree_ptr xthis_ptr, xrbt_size_t xst_budget)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+    if (0 == xst_budget)
+    {
+        return xthis_ptr->xst_reclaim;
+    }
+
+    XSTAT_OP(xthis_ptr, XRBT_STATS_OP_CLEAR);
+
+    // 开始新的清除：整棵树转为待释放的节点（O(1)）
+    if ((XRBT_NULL == XLINK_GET(xthis_ptr->xiter_reclaim)) && (xthis_ptr->xst_count > 0))
+    {
+        XRECORD(xthis_ptr, XRBT_RECORD_CLEAR, XRBT_NULL);
+
+        XLINK_SET(xthis_ptr->xiter_reclaim, XTREE_ROOT(xthis_ptr));
+        XLINK_SET(xthis_ptr->xiter_rnil, XTREE_GET_NIL(xthis_ptr));
+        xthis_ptr->xst_reclaim   = xthis_ptr->xst_count;
+
+        X_RESET_NIL(xthis_ptr);
+        xthis_ptr->xst_count = 0;
+        XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_root );
+        XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_lnode);
+        XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_rnode);
+    }
+
+    return xrbtree_reclaim_steps(xthis_ptr, xst_budget);
+}
+
+/**********************************************************/
+/**
+ * @brief 以 O(1) 的方式，将 x_rbtree_t 对象中的所有节点（含分步清除中待释放的节点），
+ *        转移到新创建的 回收对象 中，x_rbtree_t 对象随即为空。
+ * 
+ * @return x_rbtree_ptr
+ *         - 返回 回收对象；
+ *         - 没有需要释放的节点时（如 XRBT_FLAG_NOFREE 模式下无须析构），
+ *           按 xrbtree_clear() 的方式清除后，返回 XRBT_NULL 。
+ */
+x_rbtree_ptr xrbtree_detach(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+    x_rbtree_ptr  xreclaim_ptr = XRBT_NULL;
+    x_rbnode_iter xiter_root   = XTREE_ROOT(xthis_ptr);
+
+    if (((0 == xthis_ptr->xst_count) && (XRBT_NULL == XLINK_GET(xthis_ptr->xiter_reclaim))) ||
+        !xrbtree_need_release(xthis_ptr))
+    {
+        xrbtree_clear(xthis_ptr);
+        return XRBT_NULL;
+    }
+
+    xreclaim_ptr = (x_rbtree_ptr)xrbt_heap_alloc(sizeof(x_rbtree_t));
+    if (XRBT_NULL == xreclaim_ptr)
+    {
+        xrbtree_clear(xthis_ptr);
+        return XRBT_NULL;
+    }
+
+    // 分步清除中的待释放节点 挂接为最左侧节点的左子树，与当前的所有节点合为一体
+    //（二者引用相同的 nil 节点）
+    if (XRBT_NULL != XLINK_GET(xthis_ptr->xiter_reclaim))
+    {
+        XASSERT(XLINK_GET(xthis_ptr->xiter_rnil) == XTREE_GET_NIL(xthis_ptr));
+        if (XNODE_NOT_NIL(xiter_root))
+            XNODE_SET_LEFT(XTREE_BEGIN(xthis_ptr), XLINK_GET(xthis_ptr->xiter_reclaim));
+        else
+            xiter_root = XLINK_GET(xthis_ptr->xiter_reclaim);
+    }
+
+    memcpy(xreclaim_ptr, xthis_ptr, sizeof(x_rbtree_t));
+    X_RESET_NIL(xreclaim_ptr);
+    xreclaim_ptr->xst_count     = 0;
+    XTREE_SET_NIL(xreclaim_ptr, xreclaim_ptr->xiter_root );
+    XTREE_SET_NIL(xreclaim_ptr, xreclaim_ptr->xiter_lnode);
+    XTREE_SET_NIL(xreclaim_ptr, xreclaim_ptr->xiter_rnode);
+    XLINK_SET(xreclaim_ptr->xiter_spare, XRBT_NULL);
+    XLINK_SET(xreclaim_ptr->xiter_reclaim, xiter_root);
+    XLINK_SET(xreclaim_ptr->xiter_rnil, XTREE_GET_NIL(xthis_ptr));
+    xreclaim_ptr->xst_reclaim   = xthis_ptr->xst_count + xthis_ptr->xst_reclaim;
+    xrbtree_reset_stats(xreclaim_ptr);
+#if XRBTREE_ENABLE_RECORD
+    xreclaim_ptr->xfile_record  = XRBT_NULL;
+#endif // XRBTREE_ENABLE_RECORD
+
+    XRECORD(xthis_ptr, XRBT_RECORD_CLEAR, XRBT_NULL);
+    X_RESET_NIL(xthis_ptr);
+    xthis_ptr->xst_count     = 0;
+    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_root );
+    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_lnode);
+    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_rnode);
+    XLINK_SET(xthis_ptr->xiter_reclaim, XRBT_NULL);
+    XLINK_SET(xthis_ptr->xiter_rnil, XRBT_NULL);
+    xthis_ptr->xst_reclaim   = 0;
+
+    return xreclaim_ptr;
+}
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象中的节点数量。
+ */
+xrbt_size_t xrbtree_size(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    return xthis_ptr->xst_count;
+}
+
+/**********************************************************/
+/**
+ * @brief 判断 x_rbtree_t 对象中节点数量是否为空。
+ */
+xrbt_bool_t xrbtree_empty(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    return (0 == xthis_ptr->xst_count);
+}
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象创建时所指定的模式标识（参看 emXRBtreeFlags 枚举值）。
+ */
+xrbt_uint32_t xrbtree_flags(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    return xthis_ptr->xut_flags;
+}
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象中节点值数据的缓存大小（非映射表模式时为 0）。
+ */
+xrbt_size_t xrbtree_vsize(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    return xthis_ptr->xst_vsize;
+}
+
+/**********************************************************/
+/**
+ * @brief 设置节点内联存储的 索引键前缀值 与 哈希值 的计算回调函数。
+ * @note
+ * 1. 只可在 x_rbtree_t 对象为空时设置（节点对象的内存布局会随之改变）；
+ * 2. 前缀值 存储于节点头部（紧随节点链接信息之后），定位操作时先比较前缀值，
+ *    前缀值相同时，才回调 xfunc_k_compare 进行完整比较；
+ * 3. 哈希值 只在借用索引键模式（XRBT_FLAG_BORROW）下存储，
+ *    用于 查找/插入 时快速判断索引键值不相等，其他模式下忽略该参数；
+ * 4. 两者均须与 xfunc_k_compare 的比较结果保持一致（参看 xfunc_vkey_prefix_t 说明）；
+ * 5. 参数可为 XRBT_NULL，表示不使用对应的快速比较方式。
+ * 
+ * @param [in ] xthis_ptr      : 红黑树对象。
+ * @param [in ] xfunc_k_prefix : 计算索引键前缀值的回调函数。
+ * @param [in ] xfunc_k_hash   : 计算索引键哈希值的回调函数。
+ * 
+ * @return xrbt_bool_t
+ *         - 成功，返回 XRBT_TRUE；
+ *         - 失败，返回 XRBT_FALSE（x_rbtree_t 对象不为空）。
+ */
+xrbt_bool_t xrbtree_set_key_hints(x_rbtree_ptr xthis_ptr,
+                                  xfunc_vkey_prefix_t xfunc_k_prefix,
+                                  xfunc_vkey_hash_t xfunc_k_hash)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+    // 侵入模式下，链接头中没有存储前缀值的位置
+    if ((xthis_ptr->xst_count > 0) || XTREE_IS_LINK(xthis_ptr) || XTREE_IS_SHARED(xthis_ptr))
+    {
+        return XRBT_FALSE;
+    }
+
+    // 缓存的备用节点可能与新的内存布局大小不一致
+    XSTAT_OP(xthis_ptr, XRBT_STATS_OP_CLEAR);
+    xrbtree_node_drop_spare(xthis_ptr);
+
+    xthis_ptr->xfunc_k_prefix = xfunc_k_prefix;
+    xthis_ptr->xfunc_k_hash   = XTREE_IS_BORROW(xthis_ptr) ? xfunc_k_hash : XRBT_NULL;
+
+    xthis_ptr->xut_kmode &= XNODE_KMODE_BORROW;
+    if (XRBT_NULL != xfunc_k_prefix)
+        xthis_ptr->xut_kmode |= XNODE_KMODE_PREFIX;
+    xrbtree_node_size(xthis_ptr);
+
+    return XRBT_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 借用索引键模式下，批量重定位节点所借用的索引键指针。
+ * @note
+ * 用于索引键所在的内存区域被重新映射（如 mmap 日志文件 remap）后，
+ * 将所有位于 [xold_base, xold_end) 中的索引键指针，
+ * 按相同偏移量重定位到以 xnew_base 为起始地址的新区域；
+ * 新区域中的索引键内容必须与原区域相同（前缀值、哈希值 及 节点顺序 均保持不变）。
+ * 该操作遍历所有节点，时间复杂度为 O(n)。
+ * 
+ * @param [in ] xthis_ptr : 红黑树对象（必须以 XRBT_FLAG_BORROW 模式创建）。
+ * @param [in ] xold_base : 原内存区域的起始地址。
+ * @param [in ] xold_end  : 原内存区域的结束地址。
+ * @param [in ] xnew_base : 新内存区域的起始地址。
+ * 
+ * @return xrbt_size_t
+ *         - 返回重定位的节点数量。
+ */
+xrbt_size_t xrbtree_rebase_keys(x_rbtree_ptr xthis_ptr,
+                                xrbt_vkey_t xold_base,
+                                xrbt_vkey_t xold_end,
+                                xrbt_vkey_t xnew_base)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XTREE_IS_BORROW(xthis_ptr));
+    XASSERT((xrbt_byte_t *)xold_base <= (xrbt_byte_t *)xold_end);
+
+    xrbt_size_t       xst_count  = 0;
+    x_rbnode_iter     xiter_node = XTREE_BEGIN(xthis_ptr);
+    x_rbtree_bkey_t * xbkey_ptr  = XRBT_NULL;
+
+    for (; XNODE_NOT_NIL(xiter_node);
+         xiter_node = xrbtree_successor(xthis_ptr, xiter_node))
+    {
+        xbkey_ptr = XNODE_BKEY(xiter_node);
+        if (((xrbt_byte_t *)xbkey_ptr->xrbt_kptr >= (xrbt_byte_t *)xold_base) &&
+            ((xrbt_byte_t *)xbkey_ptr->xrbt_kptr <  (xrbt_byte_t *)xold_end ))
+        {
+            xbkey_ptr->xrbt_kptr =
+                (xrbt_vkey_t)((xrbt_byte_t *)xnew_base +
+                    ((xrbt_byte_t *)xbkey_ptr->xrbt_kptr - (xrbt_byte_t *)xold_base));
+            xst_count += 1;
+        }
+    }
+
+    return xst_count;
+}
+
+/**********************************************************/
+/**
+ * @brief 获取 x_rbtree_t 对象的操作统计信息。
+ * @note
+ * 只有在编译时定义 XRBTREE_ENABLE_STATS 为 1 才会进行统计，
+ * 否则 xstats_ptr 被填充为全 0，并返回 XRBT_FALSE 。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [out] xstats_ptr : 返回的统计信息。
+ * 
+ * @return xrbt_bool_t
+ *         - 是否开启了统计功能。
+ */
+xrbt_bool_t xrbtree_get_stats(x_rbtree_ptr xthis_ptr, xrbt_stats_t * xstats_ptr)
+{
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xstats_ptr));
+
+#if XRBTREE_ENABLE_STATS
+    *xstats_ptr = xthis_ptr->xstats;
+    if (xstats_ptr->xu64_searches > 0)
+    {
+        xstats_ptr->xdbl_depth_avg =
+            (double)xstats_ptr->xu64_depth_sum / (double)xstats_ptr->xu64_searches;
+    }
+    return XRBT_TRUE;
+#else // !XRBTREE_ENABLE_STATS
+    memset(xstats_ptr, 0, sizeof(xrbt_stats_t));
+    return XRBT_FALSE;
+#endif // XRBTREE_ENABLE_STATS
+}
+
+/**********************************************************/
+/**
+ * @brief 重置 x_rbtree_t 对象的操作统计信息。
+ */
+xrbt_void_t xrbtree_reset_stats(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+#if XRBTREE_ENABLE_STATS
+    memset(&xthis_ptr->xstats, 0, sizeof(xrbt_stats_t));
+    xthis_ptr->xut_stat_op = XRBT_STATS_OP_INSERT;
+#endif // XRBTREE_ENABLE_STATS
+}
+
+/**********************************************************/
+/**
+ * @brief 开始记录 x_rbtree_t 对象的操作（写入二进制的操作记录文件）。
+ */
+xrbt_bool_t xrbtree_record_start(x_rbtree_ptr xthis_ptr, const char * xszt_path)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xszt_path);
+
+#if XRBTREE_ENABLE_RECORD
+    xrbt_uint32_t xut_head[2];
+
+    xrbtree_record_stop(xthis_ptr);
+
+    xthis_ptr->xfile_record = fopen(xszt_path, "wb");
+    if (XRBT_NULL == xthis_ptr->xfile_record)
+    {
+        return XRBT_FALSE;
+    }
+
+    xut_head[0] = (xrbt_uint32_t)xthis_ptr->xst_ksize;
+    xut_head[1] = xthis_ptr->xut_flags;
+    fwrite(XRBT_RECORD_MAGIC, 1, 8, xthis_ptr->xfile_record);
+    fwrite(xut_head, sizeof(xrbt_uint32_t), 2, xthis_ptr->xfile_record);
+
+    xthis_ptr->xu64_record_tm = xrbtree_record_clock();
+
+    return XRBT_TRUE;
+#else // !XRBTREE_ENABLE_RECORD
+    return XRBT_FALSE;
+#endif // XRBTREE_ENABLE_RECORD
+}
+
+/**********************************************************/
+/**
+ * @brief 停止记录 x_rbtree_t 对象的操作（关闭操作记录文件）。
+ */
+xrbt_void_t xrbtree_record_stop(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+#if XRBTREE_ENABLE_RECORD
+    if (XRBT_NULL != xthis_ptr->xfile_record)
+    {
+        fclose(xthis_ptr->xfile_record);
+        xthis_ptr->xfile_record = XRBT_NULL;
+    }
+#endif // XRBTREE_ENABLE_RECORD
+}
+
+/**********************************************************/
+/**
+ * @brief 将 x_rbtree_t 对象按索引键顺序序列化输出。
+ */
+xrbt_bool_t xrbtree_save(x_rbtree_ptr xthis_ptr,
+                         xfunc_stream_write_t xfunc_write,
+                         xrbt_ctxt_t xrbt_ctxt,
+                         xrbt_uint32_t xut_encode)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xfunc_write);
+
+    x_rbtree_stream_t xstream;
+    x_rbnode_iter     xiter_node = XRBT_NULL;
+    xrbt_uint64_t     xu64_kprev = 0;
+    xrbt_uint64_t     xu64_kint  = 0;
+    xrbt_uint32_t     xut_head[4];
+    xrbt_uint64_t     xu64_count = xthis_ptr->xst_count;
+    xrbt_uint64_t     xu64_check = 0;
+
+    if (XTREE_IS_BORROW(xthis_ptr) || XTREE_IS_LINK(xthis_ptr))
+        return XRBT_FALSE;
+
+    if ((XRBT_SAVE_DELTA != xut_encode) ||
+        ((sizeof(xrbt_uint32_t) != xthis_ptr->xst_ksize) &&
+         (sizeof(xrbt_uint64_t) != xthis_ptr->xst_ksize)))
+    {
+        xut_encode = XRBT_SAVE_RAW;
+    }
+
+    memset(&xstream, 0, sizeof(x_rbtree_stream_t));
+    xstream.xfunc_write = xfunc_write;
+    xstream.xrbt_ctxt   = xrbt_ctxt;
+    xstream.xu64_hash   = XFNV64_OFFSET;
+    xstream.xbt_chunk   = (xrbt_byte_t *)xrbt_heap_alloc(XSTREAM_CHUNK);
+    if (XRBT_NULL == xstream.xbt_chunk)
+        return XRBT_FALSE;
+
+    xut_head[0] = (xrbt_uint32_t)xthis_ptr->xst_ksize;
+    xut_head[1] = (xrbt_uint32_t)xthis_ptr->xst_vsize;
+    xut_head[2] = xthis_ptr->xut_flags & XRBT_FLAG_MULTI;
+    xut_head[3] = xut_encode;
+    xstream_write(&xstream, XRBT_SAVE_MAGIC, 8);
+    xstream_write(&xstream, xut_head, sizeof(xut_head));
+    xstream_write(&xstream, &xu64_count, sizeof(xrbt_uint64_t));
+
+    for (xiter_node = XTREE_BEGIN(xthis_ptr);
+         XNODE_NOT_NIL(xiter_node) && !xstream.xbt_fail;
+         xiter_node = xrbtree_next(xiter_node))
+    {
+        if (XRBT_SAVE_DELTA == xut_encode)
+        {
+            xu64_kint = xstream_kint_get(XNODE_VKEY(xiter_node), xthis_ptr->xst_ksize);
+            xstream_write_delta(&xstream, xu64_kint - xu64_kprev);
+            xu64_kprev = xu64_kint;
+        }
+        else
+        {
+            xstream_write(&xstream, XNODE_VKEY(xiter_node), xthis_ptr->xst_ksize);
+        }
+
+        if (xthis_ptr->xst_vsize > 0)
+            xstream_write(&xstream, XNODE_VVAL(xiter_node), xthis_ptr->xst_vsize);
+    }
+
+    // 校验值不参与自身的累计
+    xstream_hash(&xstream);
+    xu64_check = xstream.xu64_hash;
+    xstream_write(&xstream, &xu64_check, sizeof(xrbt_uint64_t));
+    xstream_flush(&xstream);
+
+    xrbt_heap_free(xstream.xbt_chunk);
+
+    return !xstream.xbt_fail;
+}
+
+/**********************************************************/
+/**
+ * @brief 从 xrbtree_save() 输出的序列化数据中加载 x_rbtree_t 对象的节点。
+ */
+xrbt_bool_t xrbtree_load(x_rbtree_ptr xthis_ptr,
+                         xfunc_stream_read_t xfunc_read,
+                         xrbt_ctxt_t xrbt_ctxt)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xfunc_read);
+
+    x_rbtree_stream_t xstream;
+    x_rbtree_loader_t xloader;
+    xrbt_byte_t       xbt_magic[8];
+    xrbt_uint32_t     xut_head[4];
+    xrbt_uint64_t     xu64_count = 0;
+    xrbt_uint64_t     xu64_check = 0;
+    xrbt_uint64_t     xu64_hash  = 0;
+    xrbt_uint64_t     xu64_level = 0;
+    x_rbnode_iter     xiter_root = XRBT_NULL;
+
+    if (XTREE_IS_BORROW(xthis_ptr) || XTREE_IS_LINK(xthis_ptr))
+        return XRBT_FALSE;
+
+    xrbtree_clear(xthis_ptr);
+
+    memset(&xstream, 0, sizeof(x_rbtree_stream_t));
+    xstream.xfunc_read = xfunc_read;
+    xstream.xrbt_ctxt  = xrbt_ctxt;
+    xstream.xu64_hash  = XFNV64_OFFSET;
+    xstream.xbt_chunk  = (xrbt_byte_t *)xrbt_heap_alloc(XSTREAM_CHUNK);
+    if (XRBT_NULL == xstream.xbt_chunk)
+        return XRBT_FALSE;
+
+    //======================================
+    // 头部校验
+
+    if (!xstream_read(&xstream, xbt_magic, sizeof(xbt_magic)) ||
+        !xstream_read(&xstream, xut_head, sizeof(xut_head)) ||
+        !xstream_read(&xstream, &xu64_count, sizeof(xrbt_uint64_t)) ||
+        (0 != memcmp(xbt_magic, XRBT_SAVE_MAGIC, 8)) ||
+        (xut_head[0] != (xrbt_uint32_t)xthis_ptr->xst_ksize) ||
+        (xut_head[1] != (xrbt_uint32_t)xthis_ptr->xst_vsize) ||
+        ((xut_head[2] & XRBT_FLAG_MULTI) && !XTREE_IS_MULTI(xthis_ptr)) ||
+        (xut_head[3] > XRBT_SAVE_DELTA) ||
+        ((XRBT_SAVE_DELTA == xut_head[3]) &&
+         (sizeof(xrbt_uint32_t) != xthis_ptr->xst_ksize) &&
+         (sizeof(xrbt_uint64_t) != xthis_ptr->xst_ksize)) ||
+        (xu64_count > (xrbt_size_t)~0))
+    {
+        xrbt_heap_free(xstream.xbt_chunk);
+        return XRBT_FALSE;
+    }
+
+    memset(&xloader, 0, sizeof(x_rbtree_loader_t));
+    xloader.xstream_ptr = &xstream;
+    xloader.xut_encode  = xut_head[3];
+    xloader.xbt_kbuf    = (xrbt_byte_t *)xrbt_heap_alloc(
+                                XNODE_VOFFS(xthis_ptr->xst_ksize) + xthis_ptr->xst_vsize);
+    if (XRBT_NULL == xloader.xbt_kbuf)
+    {
+        xrbt_heap_free(xstream.xbt_chunk);
+        return XRBT_FALSE;
+    }
+
+    // 左右子树的节点数量至多相差 1，最深一层为第 floor(log2(count)) 层，
+    // 空节点只出现在最深的两层，最深一层着为红色后，各路径的黑色节点数量一致
+    for (xu64_level = xu64_count / 2; xu64_level > 0; xu64_level /= 2)
+    {
+        xloader.xut_rlevel += 1;
+    }
+
+    //======================================
+    // 按索引键顺序构建平衡的红黑树
+
+    XSTAT_OP(xthis_ptr, XRBT_STATS_OP_INSERT);
+
+    xiter_root = xrbtree_load_branch(xthis_ptr, &xloader, 0, (xrbt_size_t)xu64_count, 0);
+
+    XLINK_SET(xthis_ptr->xiter_root, xiter_root);
+    if (XNODE_NOT_NIL(xiter_root))
+    {
+        xiter_root->xut_color = X_BLACK;
+        XTREE_SET_NIL(xthis_ptr, xiter_root->xiter_parent);
+        XLINK_SET(xthis_ptr->xiter_lnode, xrbtree_far_left(xthis_ptr, xiter_root));
+        XLINK_SET(xthis_ptr->xiter_rnode, xrbtree_far_right(xthis_ptr, xiter_root));
+    }
+    xthis_ptr->xst_count = (xrbt_size_t)xu64_count;
+
+    // 校验值不参与自身的累计
+    xstream_hash(&xstream);
+    xu64_hash  = xstream.xu64_hash;
+    if (!xstream_read(&xstream, &xu64_check, sizeof(xrbt_uint64_t)) ||
+        (xu64_check != xu64_hash))
+    {
+        xstream.xbt_fail = XRBT_TRUE;
+    }
+
+    xrbt_heap_free(xloader.xbt_kbuf);
+    xrbt_heap_free(xstream.xbt_chunk);
+
+    if (xstream.xbt_fail)
+    {
+        xrbtree_clear(xthis_ptr);
+        return XRBT_FALSE;
+    }
+
+    return XRBT_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 将 x_rbtree_t 对象序列化输出到文件。
+ */
+xrbt_bool_t xrbtree_save_file(x_rbtree_ptr xthis_ptr,
+                              const char * xszt_path,
+                              xrbt_uint32_t xut_encode)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xszt_path);
+
+    xrbt_bool_t xbt_ok   = XRBT_FALSE;
+    FILE      * xfile_pt = fopen(xszt_path, "wb");
+
+    if (XRBT_NULL == xfile_pt)
+        return XRBT_FALSE;
+
+    // 已按 XSTREAM_CHUNK 分块读写，关闭 stdio 的缓存以避免多一次拷贝
+    setvbuf(xfile_pt, XRBT_NULL, _IONBF, 0);
+    xbt_ok = xrbtree_save(xthis_ptr, &xstream_file_write, xfile_pt, xut_encode);
+    if (0 != fclose(xfile_pt))
+        xbt_ok = XRBT_FALSE;
+
+    return xbt_ok;
+}
+
+/**********************************************************/
+/**
+ * @brief 从文件中加载 x_rbtree_t 对象的节点。
+ */
+xrbt_bool_t xrbtree_load_file(x_rbtree_ptr xthis_ptr, const char * xszt_path)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xszt_path);
+
+    xrbt_bool_t xbt_ok   = XRBT_FALSE;
+    FILE      * xfile_pt = fopen(xszt_path, "rb");
+
+    if (XRBT_NULL == xfile_pt)
+        return XRBT_FALSE;
+
+    setvbuf(xfile_pt, XRBT_NULL, _IONBF, 0);
+    xbt_ok = xrbtree_load(xthis_ptr, &xstream_file_read, xfile_pt);
+    fclose(xfile_pt);
+
+    return xbt_ok;
+}
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象中的左手臂长度。
+ */
+xrbt_size_t xrbtree_left_length(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+    xrbt_size_t   xst_length = 0;
+    x_rbnode_iter xiter_node = XTREE_BEGIN(xthis_ptr);
+
+    while (xiter_node != XTREE_ROOT(xthis_ptr))
+    {
+        xst_length += 1;
+        xiter_node = XNODE_PARENT(xiter_node);
+    }
+
+    return xst_length;
+}
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象中的右手臂长度。
+ */
+xrbt_size_t xrbtree_right_length(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+    xrbt_size_t   xst_length = 0;
+    x_rbnode_iter xiter_node = XTREE_RBEGIN(xthis_ptr);
+
+    while (xiter_node != XTREE_ROOT(xthis_ptr))
+    {
+        xst_length += 1;
+        xiter_node = XNODE_PARENT(xiter_node);
+    }
+
+    return xst_length;
+}
+
+/**********************************************************/
+/**
+ * @brief 向 x_rbtree_t 对象插入新节点。
+ * @note  回调设置索引键值时，不使用 move 操作方式。
+ * 
+ * @param [in ] xthis_ptr : 红黑树对象。
+ * @param [in ] xrbt_vkey : 新节点的索引键值。
+ * @param [out] xbt_ok    : 返回操作成功的标识。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回对应节点；
+ *         - 申请节点内存失败时，返回 xrbtree_end()（xbt_ok 为 XRBT_FALSE）。
+ */
+x_rbnode_iter xrbtree_insert(x_rbtree_ptr xthis_ptr,
+                             xrbt_vkey_t xrbt_vkey,
+                             xrbt_bool_t * xbt_ok)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xrbt_vkey);
+
+    return xrbtree_insert_nkey(xthis_ptr,
+                               xrbt_vkey,
+                               XRBT_NULL,
+                               XRBT_FALSE,
+                               XRBT_FALSE,
+                               xbt_ok);
+}
+
+/**********************************************************/
+/**
+ * @brief 向 x_rbtree_t 对象插入新节点。
+ * @note  回调设置索引键值时，使用 move 操作方式。
+ * 
+ * @param [in ] xthis_ptr : 红黑树对象。
+ * @param [in ] xrbt_vkey : 新节点的索引键值。
+ * @param [out] xbt_ok    : 返回操作成功的标识。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回对应节点；
+ *         - 申请节点内存失败时，返回 xrbtree_end()（xbt_ok 为 XRBT_FALSE）。
+ */
+x_rbnode_iter xrbtree_insert_mkey(x_rbtree_ptr xthis_ptr,
+                                  xrbt_vkey_t xrbt_vkey,
+                                  xrbt_bool_t * xbt_ok)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xrbt_vkey);
+
+    return xrbtree_insert_nkey(xthis_ptr,
+                               xrbt_vkey,
+                               XRBT_NULL,
+                               XRBT_TRUE,
+                               XRBT_FALSE,
+                               xbt_ok);
+}
+
+/**********************************************************/
+/**
+ * @brief 向 映射表模式 的 x_rbtree_t 对象插入新节点（索引键 + 值数据）。
+ * @note
+ * 回调设置 索引键 与 值数据 时，不使用 move 操作方式；
+ * 若索引键已存在，则不对 索引键 与 值数据 做任何操作（即 try_emplace 语义）；
+ * 若 xrbt_vval 为 XRBT_NULL，新节点的值数据按默认值构造。
+ * 
+ * @param [in ] xthis_ptr : 红黑树对象。
+ * @param [in ] xrbt_vkey : 新节点的索引键值。
+ * @param [in ] xrbt_vval : 新节点的值数据。
+ * @param [out] xbt_ok    : 返回操作成功的标识（索引键已存在时为 XRBT_FALSE）。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回对应节点；
+ *         - 申请节点内存失败时，返回 xrbtree_end()（xbt_ok 为 XRBT_FALSE）。
+ */
+x_rbnode_iter xrbtree_try_emplace(x_rbtree_ptr xthis_ptr,
+                                  xrbt_vkey_t xrbt_vkey,
+                                  xrbt_vval_t xrbt_vval,
+                                  xrbt_bool_t * xbt_ok)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xrbt_vkey);
+
+    return xrbtree_insert_nkey(xthis_ptr,
+                               xrbt_vkey,
+                               xrbt_vval,
+                               XRBT_FALSE,
+                               XRBT_FALSE,
+                               xbt_ok);
+}
+
+/**********************************************************/
+/**
+ * @brief 向 映射表模式 的 x_rbtree_t 对象插入新节点（索引键 + 值数据）。
+ * @note
+ * 与 @see xrbtree_try_emplace() 相同，但回调设置 索引键 与 值数据 时，使用 move 操作方式；
+ * 索引键已存在时，xrbt_mkey 与 xrbt_mval 都不会被 move 。
+ */
+x_rbnode_iter xrbtree_try_emplace_mkey(x_rbtree_ptr xthis_ptr,
+                                       xrbt_vkey_t xrbt_mkey,
+                                       xrbt_vval_t xrbt_mval,
+                                       xrbt_bool_t * xbt_ok)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xrbt_mkey);
+
+    return xrbtree_insert_nkey(xthis_ptr,
+                               xrbt_mkey,
+                               xrbt_mval,
+                               XRBT_TRUE,
+                               XRBT_FALSE,
+                               xbt_ok);
+}
+
+/**********************************************************/
+/**
+ * @brief 向 映射表模式 的 x_rbtree_t 对象插入新节点，若索引键已存在，则覆盖其值数据。
+ * @note
+ * 回调设置 索引键 与 值数据 时，不使用 move 操作方式；
+ * 覆盖值数据时，先析构原有的值数据，再拷贝新的值数据（索引键保持不变）。
+ * 
+ * @param [in ] xthis_ptr : 红黑树对象。
+ * @param [in ] xrbt_vkey : 节点的索引键值。
+ * @param [in ] xrbt_vval : 节点的值数据。
+ * @param [out] xbt_ok    : 返回的标识（XRBT_TRUE 为插入新节点，XRBT_FALSE 为覆盖值数据）。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回对应节点；
+ *         - 申请节点内存失败时，返回 xrbtree_end()（xbt_ok 为 XRBT_FALSE）。
+ */
+x_rbnode_iter xrbtree_insert_or_assign(x_rbtree_ptr xthis_ptr,
+                                       xrbt_vkey_t xrbt_vkey,
+                                       xrbt_vval_t xrbt_vval,
+                                       xrbt_bool_t * xbt_ok)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xrbt_vkey);
+
+    return xrbtree_insert_nkey(xthis_ptr,
+                               xrbt_vkey,
+                               xrbt_vval,
+                               XRBT_FALSE,
+                               XRBT_TRUE,
+                               xbt_ok);
+}
+
+/**********************************************************/
+/**
+ * @brief 与 @see xrbtree_insert_or_assign() 相同，但回调设置数据时，使用 move 操作方式。
+ */
+x_rbnode_iter xrbtree_insert_or_assign_mkey(x_rbtree_ptr xthis_ptr,
+                                            xrbt_vkey_t xrbt_mkey,
+                                            xrbt_vval_t xrbt_mval,
+                                            xrbt_bool_t * xbt_ok)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xrbt_mkey);
+
+    return xrbtree_insert_nkey(xthis_ptr,
+                               xrbt_mkey,
+                               xrbt_mval,
+                               XRBT_TRUE,
+                               XRBT_TRUE,
+                               xbt_ok);
+}
+
+/**********************************************************/
+/**
+ * @brief 单次定位的 插入/更新 操作（upsert）。
+ * @note
+ * 只进行一次自根向下的定位操作（不会二次查找）：
+ * 若索引键值不存在，则插入新节点（拷贝索引键值，映射表模式下值数据按默认值构造），
+ * 再回调 xfunc_init 初始化新节点；否则回调 xfunc_merge 合并到已有节点。
+ * xfunc_init 或 xfunc_merge 为 XRBT_NULL 时，忽略对应的回调操作。
+ * 
+ * @param [in ] xthis_ptr   : 红黑树对象。
+ * @param [in ] xrbt_vkey   : 索引键值。
+ * @param [in ] xfunc_init  : 初始化新节点的回调函数。
+ * @param [in ] xfunc_merge : 合并已有节点的回调函数。
+ * @param [in ] xrbt_ctxt   : 回调的上下文标识。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回对应节点（新节点 或 已有节点）；
+ *         - 申请节点内存失败时，返回 xrbtree_end()（不回调 xfunc_init/xfunc_merge）。
+ */
+x_rbnode_iter xrbtree_upsert(x_rbtree_ptr xthis_ptr,
+                             xrbt_vkey_t xrbt_vkey,
+                             xfunc_node_upsert_t xfunc_init,
+                             xfunc_node_upsert_t xfunc_merge,
+                             xrbt_ctxt_t xrbt_ctxt)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xrbt_vkey);
+
+    xrbt_bool_t   xbt_ok     = XRBT_FALSE;
+    x_rbnode_iter xiter_node = xrbtree_insert_nkey(xthis_ptr,
+                                                   xrbt_vkey,
+                                                   XRBT_NULL,
+                                                   XRBT_FALSE,
+                                                   XRBT_FALSE,
+                                                   &xbt_ok);
+
+    if (XNODE_IS_NIL(xiter_node))
+    {
+        return xiter_node;
+    }
+
+    if (xbt_ok)
+    {
+        if (XRBT_NULL != xfunc_init)
+            xfunc_init(xiter_node, xrbt_vkey, xrbt_ctxt);
+    }
+    else
+    {
+        if (XRBT_NULL != xfunc_merge)
+            xfunc_merge(xiter_node, xrbt_vkey, xrbt_ctxt);
+    }
+
+    return xiter_node;
+}
+
+/**********************************************************/
+/**
+ * @brief 从 x_rbtree_t 对象中删除指定节点。
+ */
+xrbt_void_t xrbtree_erase(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT((XRBT_NULL != xiter_node) && XNODE_NOT_NIL(xiter_node));
+    XASSERT(xrbtree_iter_tree(xiter_node) == xthis_ptr);
+
+    XSTAT_OP(xthis_ptr, XRBT_STATS_OP_ERASE);
+    xrbtree_dealloc(xthis_ptr, xrbtree_undock(xthis_ptr, xiter_node));
+}
+
+/**********************************************************/
+/**
+ * @brief 从 x_rbtree_t 对象中删除指定节点。
+ */
+xrbt_bool_t xrbtree_erase_vkey(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xrbt_vkey);
+
+    XRECORD(xthis_ptr, XRBT_RECORD_ERASE, xrbt_vkey);
+
+    x_rbnode_iter xiter_node = xrbtree_find_pos(xthis_ptr, xrbt_vkey);
+    if (XNODE_IS_NIL(xiter_node))
+    {
+        return XRBT_FALSE;
+    }
+
+    xrbtree_erase(xthis_ptr, xiter_node);
+
+    return XRBT_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 从 x_rbtree_t 对象中删除 [xiter_first, xiter_last) 区间内的所有节点。
+ * @note  xiter_last 可为 xrbtree_end() ；整棵树被删除时，按 xrbtree_clear() 方式处理。
+ * 
+ * @return xrbt_size_t
+ *         - 返回删除的节点数量。
+ */
+xrbt_size_t xrbtree_erase_range(x_rbtree_ptr xthis_ptr,
+                                x_rbnode_iter xiter_first,
+                                x_rbnode_iter xiter_last)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT((XRBT_NULL != xiter_first) && (XRBT_NULL != xiter_last));
+
+    xrbt_size_t   xst_count  = 0;
+    xrbt_size_t   xst_limit  = 0;
+    x_rbnode_iter xiter_next = XTREE_GET_NIL(xthis_ptr);
+
+    if ((xiter_first == XTREE_BEGIN(xthis_ptr)) && XNODE_IS_NIL(xiter_last))
+    {
+        xst_count = xthis_ptr->xst_count;
+        xrbtree_clear(xthis_ptr);
+        return xst_count;
+    }
+
+    // 删除区间为红黑树的前段时：节点数量不超过 log2(n) 的，逐个分离最左侧节点（每次均摊 O(1)）；
+    // 否则整体分离（O(k + log n)）
+    if ((xiter_first == XTREE_BEGIN(xthis_ptr)) && (xiter_first != xiter_last))
+    {
+        for (xst_count = xthis_ptr->xst_count; xst_count > 0; xst_count >>= 1)
+            xst_limit += 1;
+
+        for (xiter_next = xiter_first;
+             (xiter_next != xiter_last) && (xst_count < xst_limit);
+             xiter_next = xrbtree_successor(xthis_ptr, xiter_next))
+        {
+            xst_count += 1;
+        }
+
+        if (xiter_next != xiter_last)
+        {
+            xst_count = xrbtree_split_front(xthis_ptr, xiter_last, XRBT_TRUE);
+
+            XASSERT(xthis_ptr->xst_count > xst_count);
+            xthis_ptr->xst_count -= xst_count;
+            return xst_count;
+        }
+
+        xst_count = 0;
+    }
+
+    while (xiter_first != xiter_last)
+    {
+        xiter_next = xrbtree_successor(xthis_ptr, xiter_first);
+        xrbtree_dealloc(xthis_ptr, xrbtree_undock(xthis_ptr, xiter_first));
+        xiter_first = xiter_next;
+        xst_count  += 1;
+    }
+
+    return xst_count;
+}
+
+/**********************************************************/
+/**
+ * @brief 从 x_rbtree_t 对象中删除 所有等于 指定索引键值 的节点。
+ * @note  只进行一次定位操作，然后一次遍历删除相等节点的区间。
+ * 
+ * @return xrbt_size_t
+ *         - 返回删除的节点数量。
+ */
+xrbt_size_t xrbtree_erase_equal(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XRBT_NULL != xrbt_vkey);
+
+    x_rbtree_probe_t xprobe;
+    x_rbnode_iter    xiter_upper = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter    xiter_lower = XTREE_GET_NIL(xthis_ptr);
+
+    xrbtree_probe_init(xthis_ptr, &xprobe, xrbt_vkey);
+    xiter_lower = xrbtree_equal_pos(xthis_ptr, &xprobe, &xiter_upper);
+
+    return xrbtree_erase_range(xthis_ptr, xiter_lower, xiter_upper);
+}
+
+/**********************************************************/
+/**
+ * @brief 为 x_rbtree_t 对象申请一个处于分离状态的节点对象。
+ * @note
+ * 返回节点的 索引键/值数据 缓存是未初始化的，由调用方直接在其中构造（emplace），
+ * 之后可使用 xrbtree_dock() 将其停靠到红黑树中；
+ * 若停靠失败（索引键值冲突），调用方析构其 索引键/值数据 后，
+ * 应使用 xrbtree_node_recycle() 归还节点，以供下次申请操作复用。
+ * 
+ * @param [in ] xthis_ptr : 红黑树对象。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回分离状态的节点对象（可用 xrbtree_iter_vkey() 取其索引键缓存）；
+ *         - 申请节点内存失败时，返回 XRBT_NULL 。
+ */
+x_rbnode_iter xrbtree_node_alloc(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(!XTREE_IS_BORROW(xthis_ptr) && !XTREE_IS_LINK(xthis_ptr));
+
+    XSTAT_OP(xthis_ptr, XRBT_STATS_OP_NODE);
+    return xrbtree_node_get(xthis_ptr, XRBT_NULL);
+}
+
+/**********************************************************/
+/**
+ * @brief 归还 xrbtree_node_alloc() 申请的节点对象。
+ * @note
+ * xiter_node 必须处于分离状态，且其 索引键/值数据 已析构（或从未构造）；
+ * x_rbtree_t 对象会缓存一个这样的节点，供下次申请操作复用，其余的直接释放。
+ */
+xrbt_void_t xrbtree_node_recycle(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT((XRBT_NULL != xiter_node) && XNODE_NOT_NIL(xiter_node));
+    XASSERT(XNODE_IS_UNDOCKED(xiter_node));
+    XASSERT(!XTREE_IS_LINK(xthis_ptr));
+
+    XSTAT_OP(xthis_ptr, XRBT_STATS_OP_NODE);
+
+    if (XTREE_IS_NOFREE(xthis_ptr))
+    {
+        XNODE_SET_PARENT(xiter_node, XLINK_GET(xthis_ptr->xiter_spare));
+        XLINK_SET(xthis_ptr->xiter_spare, xiter_node);
+    }
+    else if (XRBT_NULL == XLINK_GET(xthis_ptr->xiter_spare))
+    {
+        XLINK_SET(xthis_ptr->xiter_spare, xiter_node);
+    }
+    else
+    {
+        XSTAT_OP_ADD(xthis_ptr, xu64_frees, 1);
+        XSTAT_OP_ADD(xthis_ptr, xu64_free_bytes, xthis_ptr->xst_nsize);
+        XTREE_CB(xthis_ptr)->xfunc_n_memfree(
+            xiter_node,
+            xthis_ptr->xst_nsize,
+            XTREE_CB(xthis_ptr)->xctxt_t_callback);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 释放处于分离状态、且 索引键/值数据 已构造的节点对象。
+ */
+xrbt_void_t xrbtree_node_release(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT((XRBT_NULL != xiter_node) && XNODE_NOT_NIL(xiter_node));
+    XASSERT(XNODE_IS_UNDOCKED(xiter_node));
+    XASSERT(!XTREE_IS_LINK(xthis_ptr));
+
+    XSTAT_OP(xthis_ptr, XRBT_STATS_OP_NODE);
+    xrbtree_dealloc(xthis_ptr, xiter_node);
+}
+
+/**********************************************************/
+/**
+ * @brief 将节点对象停靠（插入）到红黑树中。
+ * @note
+ * xiter_node 必须处于分离状态（参看 @see xrbtree_iter_is_undocked()），
+ * 而且其索引键必须 与 xthis_ptr 存储的节点索引键类型相同。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [in ] xiter_node : 停靠操作的节点对象。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回的 节点对象 == xiter_node，停靠成功。
+ *         - 返回的 节点对象 != xiter_node，停靠失败（索引键值冲突）。
+ */
+x_rbnode_iter xrbtree_dock(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT((XRBT_NULL != xiter_node) && XNODE_IS_UNDOCKED(xiter_node));
+
+    // 侵入模式下，链接头由调用方嵌入（可为全 0 的初始状态），停靠前写入其存储方式与索引键偏移量
+    if (XTREE_IS_LINK(xthis_ptr))
+    {
+        xiter_node->xut_kmode = XNODE_KMODE_LINK;
+        xiter_node->xut_ksize = xthis_ptr->xut_lkoffs;
+    }
+
+    XASSERT(XNODE_NOT_NIL(xiter_node));
+    XASSERT(XTREE_IS_LINK(xthis_ptr) || (xiter_node->xut_ksize == xthis_ptr->xst_ksize));
+
+    //======================================
+
+    x_rbtree_probe_t xprobe;
+    xrbt_int32_t     xit_select  = -1;
+    x_rbnode_iter    xiter_where = XTREE_GET_NIL(xthis_ptr);
+
+    // 停靠操作前，重新计算节点的 前缀值/哈希值（节点的索引键由调用方构造）
+    xrbtree_probe_init(xthis_ptr, &xprobe, XNODE_VKEY(xiter_node));
+    if (xiter_node->xut_kmode & XNODE_KMODE_PREFIX)
+        XNODE_PREFIX(xiter_node) = xprobe.xu64_prefix;
+    if (xiter_node->xut_kmode & XNODE_KMODE_BORROW)
+        XNODE_BKEY(xiter_node)->xut_khash = xprobe.xut_khash;
+
+    xiter_where = xrbtree_dock_pos(xthis_ptr, &xprobe, &xit_select);
+
+    if (0 == xit_select)
+    {
+        return xiter_where;
+    }
+
+    //======================================
+
+    xrbtree_dock_at(xthis_ptr, xiter_node, xiter_where, xit_select);
+
+    //======================================
+
+    return xiter_node;
+}
+
+/**********************************************************/
+/**
+ * @brief 将节点对象从红黑树中分离（移除）出来。
+ * @note xiter_node 必须 已经隶属于 xthis_ptr 。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [in ] xiter_node : 分离操作的节点对象。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回的 节点对象 == xiter_node。
+ */
+x_rbnode_iter xrbtree_undock(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT((XRBT_NULL != xiter_node) && XNODE_NOT_NIL(xiter_node));
+    XASSERT(xrbtree_iter_tree(xiter_node) == xthis_ptr);
+
+    x_rbnode_iter xiter_fixup  = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter xiter_parent = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter xiter_where  = xiter_node;
+    x_rbnode_iter xiter_ntrav  = xiter_where;
+
+    XTRACE2(undock_entry, xthis_ptr, xiter_node);
+
+    xrbtree_update(xthis_ptr, xiter_where, 0, XRBT_TRUE);
+
+    if (XNODE_IS_NIL(XNODE_LEFT(xiter_ntrav)))
+    {
+        xiter_fixup = XNODE_RIGHT(xiter_ntrav);
+    }
+    else if (XNODE_IS_NIL(XNODE_RIGHT(xiter_ntrav)))
     {
-        xiter_dpos->xiter_left = xiter_node;
+        xiter_fixup = XNODE_LEFT(xiter_ntrav);
     }
     else
     {
-        xiter_dpos->xiter_right = xiter_node;
+        xiter_ntrav = xrbtree_successor(xthis_ptr, xiter_node);
+        xiter_fixup = XNODE_RIGHT(xiter_ntrav);
     }
 
-    xiter_node->xut_color = X_RED;
-    xiter_node->xut_ksize = xthis_ptr->xst_ksize;
-    XTREE_SET_NIL(xthis_ptr, xiter_node->xiter_left);
-    XTREE_SET_NIL(xthis_ptr, xiter_node->xiter_right);
+    if (xiter_ntrav == xiter_where)
+    {
+        xiter_parent = XNODE_PARENT(xiter_where);
+        if (XNODE_NOT_NIL(xiter_fixup))
+            XNODE_SET_PARENT(xiter_fixup, xiter_parent);
 
-    xrbtree_dock_fixup(xthis_ptr, xiter_node);
+        if (XTREE_ROOT(xthis_ptr) == xiter_where)
+        {
+            XLINK_SET(xthis_ptr->xiter_root, xiter_fixup);
+        }
+        else if (XNODE_LEFT(xiter_parent) == xiter_where)
+        {
+            XNODE_SET_LEFT(xiter_parent, xiter_fixup);
+        }
+        else
+        {
+            XNODE_SET_RIGHT(xiter_parent, xiter_fixup);
+        }
+    }
+    else
+    {
+        XNODE_SET_PARENT(XNODE_LEFT(xiter_where), xiter_ntrav);
+        XNODE_SET_LEFT(xiter_ntrav, XNODE_LEFT(xiter_where));
 
-    //======================================
+        if (xiter_ntrav == XNODE_RIGHT(xiter_where))
+        {
+            xiter_parent = xiter_ntrav;
+        }
+        else
+        {
+            xiter_parent = XNODE_PARENT(xiter_ntrav);
+            if (XNODE_NOT_NIL(xiter_fixup))
+            {
+                XNODE_SET_PARENT(xiter_fixup, xiter_parent);
+            }
 
-    if (XRBT_NULL != xbt_ok)
-        *xbt_ok = XRBT_TRUE;
-    xrbtree_update(xthis_ptr, xiter_node, XRBT_FALSE);
+            XNODE_SET_LEFT(xiter_parent, xiter_fixup);
+            XNODE_SET_RIGHT(xiter_ntrav, XNODE_RIGHT(xiter_where));
+            XNODE_SET_PARENT(XNODE_RIGHT(xiter_where), xiter_ntrav);
+        }
 
-    //======================================
+        if (XTREE_ROOT(xthis_ptr) == xiter_where)
+        {
+            XLINK_SET(xthis_ptr->xiter_root, xiter_ntrav);
+        }
+        else if (XNODE_LEFT(XNODE_PARENT(xiter_where)) == xiter_where)
+        {
+            XNODE_SET_LEFT(XNODE_PARENT(xiter_where), xiter_ntrav);
+        }
+        else
+        {
+            XNODE_SET_RIGHT(XNODE_PARENT(xiter_where), xiter_ntrav);
+        }
 
-    return xiter_node;
-}
+        XNODE_SET_PARENT(xiter_ntrav, XNODE_PARENT(xiter_where));
 
-//====================================================================
+        // recolor it (swap color)
+        if (xiter_ntrav->xut_color != xiter_where->xut_color)
+        {
+            XNODE_SPIN_CLR(xiter_ntrav);
+            XNODE_SPIN_CLR(xiter_where);
+        }
+    }
 
-// 
-// 红黑树的外部操作接口
-// 
+    if (X_BLACK == xiter_where->xut_color)
+    {
+        xrbtree_undock_fixup(xthis_ptr, xiter_fixup, xiter_parent);
+    }
+
+    XNODE_UNDOCK(xiter_where);
+
+    XTRACE3(undock_return, xthis_ptr, xiter_where, xthis_ptr->xst_count);
+    return xiter_where;
+}
 
 /**********************************************************/
 /**
- * @brief 返回内部 x_rbtree_t 的 sizeof 值。
+ * @brief 返回 x_rbtree_t 对象中的最小节点（等同于 xrbtree_begin()，O(1)）。
  */
-xrbt_size_t xrbtree_sizeof(void)
+x_rbnode_iter xrbtree_peek_min(x_rbtree_ptr xthis_ptr)
 {
-    return sizeof(x_rbtree_t);
+    XASSERT(XRBT_NULL != xthis_ptr);
+    return XTREE_BEGIN(xthis_ptr);
 }
 
 /**********************************************************/
 /**
- * @brief 创建 x_rbtree_t 对象。
- * @note
- * xcallback 会在红黑树对象内部另有缓存保存所设置的参数，外部无须持续保留；
- * 若某个回调函数为 XRBT_NULL，则取内部默认值。
- * 
- * @param [in ] xst_ksize : 索引键数据类型所需的缓存大小（如 sizeof 值）。
- * @param [in ] xcallback : 节点操作的相关回调函数。
- * 
- * @return x_rbtree_ptr
- *         - 成功，返回 x_rbtree_t 对象；
- *         - 失败，返回 XRBT_NULL；
+ * @brief 返回 x_rbtree_t 对象中的最大节点（等同于 xrbtree_rbegin()，O(1)）。
  */
-x_rbtree_ptr xrbtree_create(xrbt_size_t xst_ksize, xrbt_callback_t * xcallback)
+x_rbnode_iter xrbtree_peek_max(x_rbtree_ptr xthis_ptr)
 {
-    XASSERT((xst_ksize > 0) && (xst_ksize <= 0x7FFFFFFF));
-
-    x_rbtree_ptr xthis_ptr = (x_rbtree_ptr)xrbt_heap_alloc(sizeof(x_rbtree_t));
     XASSERT(XRBT_NULL != xthis_ptr);
-
-    return xrbtree_emplace_create(xthis_ptr, xst_ksize, xcallback);
+    return XTREE_RBEGIN(xthis_ptr);
 }
 
 /**********************************************************/
 /**
- * @brief 销毁 x_rbtree_t 对象。
+ * @brief 将最小节点从红黑树中分离出来（按优先队列的方式使用红黑树）。
  */
-xrbt_void_t xrbtree_destroy(x_rbtree_ptr xthis_ptr)
+x_rbnode_iter xrbtree_pop_min(x_rbtree_ptr xthis_ptr)
 {
     XASSERT(XRBT_NULL != xthis_ptr);
 
-    xrbtree_emplace_destroy(xthis_ptr);
-    xrbt_heap_free(xthis_ptr);
+    if (XNODE_IS_NIL(XTREE_BEGIN(xthis_ptr)))
+    {
+        return XRBT_NULL;
+    }
+
+    return xrbtree_undock(xthis_ptr, XTREE_BEGIN(xthis_ptr));
 }
 
 /**********************************************************/
 /**
- * @brief 在已开辟 x_rbtree_t 对象缓存的位置上创建 x_rbtree_t 对象。
- * @note  xthis_ptr 的缓存大小必须大于等于 sizeof(x_rbtree_t) 值。
+ * @brief 将最大节点从红黑树中分离出来（参看 xrbtree_pop_min() ）。
  */
-x_rbtree_ptr xrbtree_emplace_create(x_rbtree_ptr xthis_ptr,
-                                    xrbt_size_t xst_ksize,
-                                    xrbt_callback_t * xcallback)
+x_rbnode_iter xrbtree_pop_max(x_rbtree_ptr xthis_ptr)
 {
     XASSERT(XRBT_NULL != xthis_ptr);
-    XASSERT((xst_ksize > 0) && (xst_ksize <= 0x7FFFFFFF));
 
-#define XFUC_CHECK_SET(xfunc, xcheck, xdef) \
-    do { xfunc = (XRBT_NULL != xcheck) ? xcheck : xdef; } while (0)
-
-    if (XRBT_NULL != xcallback)
+    if (XNODE_IS_NIL(XTREE_RBEGIN(xthis_ptr)))
     {
-        XFUC_CHECK_SET(xthis_ptr->xcallback.xfunc_n_memalloc,
-                       xcallback->xfunc_n_memalloc,
-                       &xrbt_comm_node_memalloc);
-        XFUC_CHECK_SET(xthis_ptr->xcallback.xfunc_n_memfree,
-                       xcallback->xfunc_n_memfree,
-                       &xrbt_comm_node_memfree);
-        XFUC_CHECK_SET(xthis_ptr->xcallback.xfunc_k_copyfrom,
-                       xcallback->xfunc_k_copyfrom,
-                       &xrbt_comm_vkey_copyfrom);
-        XFUC_CHECK_SET(xthis_ptr->xcallback.xfunc_k_destruct,
-                       xcallback->xfunc_k_destruct,
-                       &xrbt_comm_vkey_destruct);
-        XFUC_CHECK_SET(xthis_ptr->xcallback.xfunc_k_compare,
-                       xcallback->xfunc_k_compare,
-                       &xrbt_comm_vkey_compare);
-
-        xthis_ptr->xcallback.xctxt_t_callback = xcallback->xctxt_t_callback;
+        return XRBT_NULL;
     }
-    else
+
+    return xrbtree_undock(xthis_ptr, XTREE_RBEGIN(xthis_ptr));
+}
+
+/**********************************************************/
+/**
+ * @brief 将 [xrbtree_begin(), xiter_last) 区间内的节点整体从红黑树中分离（只适用于侵入模式）。
+ */
+xrbt_void_t xrbtree_undock_front(x_rbtree_ptr xthis_ptr,
+                                 x_rbnode_iter xiter_last,
+                                 xrbt_size_t xst_count)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT(XTREE_IS_LINK(xthis_ptr));
+    XASSERT((XRBT_NULL != xiter_last) && (xst_count <= xthis_ptr->xst_count));
+
+    if (0 == xst_count)
     {
-        xthis_ptr->xcallback.xfunc_n_memalloc = &xrbt_comm_node_memalloc;
-        xthis_ptr->xcallback.xfunc_n_memfree  = &xrbt_comm_node_memfree ;
-        xthis_ptr->xcallback.xfunc_k_copyfrom = &xrbt_comm_vkey_copyfrom;
-        xthis_ptr->xcallback.xfunc_k_destruct = &xrbt_comm_vkey_destruct;
-        xthis_ptr->xcallback.xfunc_k_compare  = &xrbt_comm_vkey_compare ;
-        xthis_ptr->xcallback.xctxt_t_callback = XRBT_NULL;
+        return;
     }
 
-#undef XFUC_CHECK_SET
-
-    X_RESET_NIL(xthis_ptr);
+    if (XNODE_IS_NIL(xiter_last))
+    {
+        XASSERT(xst_count == xthis_ptr->xst_count);
 
-    xthis_ptr->xst_ksize = xst_ksize;
-    xthis_ptr->xst_count = 0;
-    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_root );
-    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_lnode);
-    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_rnode);
+        xthis_ptr->xst_count = 0;
+        XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_root );
+        XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_lnode);
+        XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_rnode);
+        return;
+    }
 
-    return xthis_ptr;
+    xrbtree_split_front(xthis_ptr, xiter_last, XRBT_FALSE);
+    xthis_ptr->xst_count -= xst_count;
 }
 
 /**********************************************************/
 /**
- * @brief 在已开辟 x_rbtree_t 对象缓存的位置上销毁 x_rbtree_t 对象。
+ * @brief 判断两个 x_rbtree_t 对象之间，节点对象是否可以直接转移（无须重新申请、拷贝）。
+ * @note
+ * 要求 节点内存布局（索引键/值数据 大小、索引键存储方式）相同，
+ * 且 节点的 比较、析构、内存释放 等回调（以及回调的上下文标识）相同；
+ * 多键模式（XRBT_FLAG_MULTI）可以不同。
  */
-xrbt_void_t xrbtree_emplace_destroy(x_rbtree_ptr xthis_ptr)
+xrbt_bool_t xrbtree_compatible(x_rbtree_ptr xthis_ptr, x_rbtree_ptr xother_ptr)
 {
-    XASSERT(XRBT_NULL != xthis_ptr);
-    xrbtree_clear(xthis_ptr);
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xother_ptr));
+
+    return ((xthis_ptr->xst_ksize  == xother_ptr->xst_ksize ) &&
+            (xthis_ptr->xst_vsize  == xother_ptr->xst_vsize ) &&
+            (xthis_ptr->xst_nsize  == xother_ptr->xst_nsize ) &&
+            (xthis_ptr->xut_kmode  == xother_ptr->xut_kmode ) &&
+            (xthis_ptr->xut_lkoffs == xother_ptr->xut_lkoffs) &&
+            (XTREE_IS_NOFREE(xthis_ptr) == XTREE_IS_NOFREE(xother_ptr)) &&
+            (XTREE_CB(xthis_ptr)->xfunc_n_memalloc == XTREE_CB(xother_ptr)->xfunc_n_memalloc) &&
+            (XTREE_CB(xthis_ptr)->xfunc_n_memfree  == XTREE_CB(xother_ptr)->xfunc_n_memfree ) &&
+            (XTREE_CB(xthis_ptr)->xfunc_k_destruct == XTREE_CB(xother_ptr)->xfunc_k_destruct) &&
+            (XTREE_CB(xthis_ptr)->xfunc_k_compare  == XTREE_CB(xother_ptr)->xfunc_k_compare ) &&
+            (XTREE_CB(xthis_ptr)->xctxt_t_callback == XTREE_CB(xother_ptr)->xctxt_t_callback) &&
+            (XTREE_VCB(xthis_ptr)->xfunc_v_destruct == XTREE_VCB(xother_ptr)->xfunc_v_destruct) &&
+            (xthis_ptr->xfunc_k_prefix == xother_ptr->xfunc_k_prefix) &&
+            (xthis_ptr->xfunc_k_hash   == xother_ptr->xfunc_k_hash  ));
 }
 
 /**********************************************************/
 /**
- * @brief 清除 x_rbtree_t 对象中的所有节点。
+ * @brief 将节点从红黑树中分离出来，以节点句柄的形式返回（节点的所有权转移至句柄）。
  */
-xrbt_void_t xrbtree_clear(x_rbtree_ptr xthis_ptr)
+xrbt_nhandle_t xrbtree_extract(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node)
 {
     XASSERT(XRBT_NULL != xthis_ptr);
-    xrbtree_clear_branch(xthis_ptr, xthis_ptr->xiter_root);
+    XASSERT((XRBT_NULL != xiter_node) && XNODE_NOT_NIL(xiter_node));
 
-    X_RESET_NIL(xthis_ptr);
+    xrbt_nhandle_t xhandle;
+    xhandle.xtree_ptr  = xthis_ptr;
+    xhandle.xiter_node = xrbtree_undock(xthis_ptr, xiter_node);
 
-    xthis_ptr->xst_count = 0;
-    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_root );
-    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_lnode);
-    XTREE_SET_NIL(xthis_ptr, xthis_ptr->xiter_rnode);
+    return xhandle;
 }
 
 /**********************************************************/
 /**
- * @brief 返回 x_rbtree_t 对象中的节点数量。
+ * @brief 将指定索引键值的节点从红黑树中分离出来，以节点句柄的形式返回。
+ * @note  多键模式下，分离的是相等节点中的首个节点；索引键值不存在时，返回空句柄。
  */
-xrbt_size_t xrbtree_size(x_rbtree_ptr xthis_ptr)
+xrbt_nhandle_t xrbtree_extract_vkey(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey)
 {
-    XASSERT(XRBT_NULL != xthis_ptr);
-    return xthis_ptr->xst_count;
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xrbt_vkey));
+
+    xrbt_nhandle_t xhandle    = { XRBT_NULL, XRBT_NULL };
+    x_rbnode_iter  xiter_node = xrbtree_find_pos(xthis_ptr, xrbt_vkey);
+
+    if (XNODE_NOT_NIL(xiter_node))
+    {
+        xhandle = xrbtree_extract(xthis_ptr, xiter_node);
+    }
+
+    return xhandle;
 }
 
 /**********************************************************/
 /**
- * @brief 判断 x_rbtree_t 对象中节点数量是否为空。
+ * @brief 将节点句柄持有的节点停靠到 x_rbtree_t 对象中（不申请内存、不拷贝数据）。
+ * @note
+ * 停靠成功时，节点的所有权转移至 xthis_ptr，句柄被置空；
+ * 句柄为空、两棵树不兼容（参看 xrbtree_compatible()）或者索引键值冲突时，句柄保持不变。
+ * 
+ * @param [in    ] xthis_ptr : 红黑树对象。
+ * @param [in,out] xhandle   : 节点句柄。
+ * @param [out   ] xbt_ok    : 返回操作成功的标识（可为 XRBT_NULL）。
+ * 
+ * @return x_rbnode_iter
+ *         - 停靠成功，返回该节点；
+ *         - 索引键值冲突，返回已有的节点；
+ *         - 句柄为空或者不兼容，返回 xrbtree_end() 。
  */
-xrbt_bool_t xrbtree_empty(x_rbtree_ptr xthis_ptr)
+x_rbnode_iter xrbtree_insert_handle(x_rbtree_ptr xthis_ptr,
+                                    xrbt_nhandle_t * xhandle,
+                                    xrbt_bool_t * xbt_ok)
 {
-    XASSERT(XRBT_NULL != xthis_ptr);
-    return (0 == xthis_ptr->xst_count);
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xhandle));
+
+    x_rbnode_iter xiter_node = XTREE_GET_NIL(xthis_ptr);
+
+    if (XRBT_NULL != xbt_ok)
+        *xbt_ok = XRBT_FALSE;
+
+    if ((XRBT_NULL == xhandle->xiter_node) ||
+        !xrbtree_compatible(xthis_ptr, xhandle->xtree_ptr))
+    {
+        return xiter_node;
+    }
+
+    xiter_node = xrbtree_dock(xthis_ptr, xhandle->xiter_node);
+    if (xiter_node == xhandle->xiter_node)
+    {
+        xhandle->xtree_ptr  = XRBT_NULL;
+        xhandle->xiter_node = XRBT_NULL;
+
+        if (XRBT_NULL != xbt_ok)
+            *xbt_ok = XRBT_TRUE;
+    }
+
+    return xiter_node;
 }
 
 /**********************************************************/
 /**
- * @brief 返回 x_rbtree_t 对象中的左手臂长度。
+ * @brief 释放节点句柄持有的节点（回调析构其 索引键/值数据），并置空句柄。
  */
-xrbt_size_t xrbtree_left_length(x_rbtree_ptr xthis_ptr)
+xrbt_void_t xrbtree_handle_release(xrbt_nhandle_t * xhandle)
 {
-    XASSERT(XRBT_NULL != xthis_ptr);
-
-    xrbt_size_t   xst_length = 0;
-    x_rbnode_iter xiter_node = XTREE_BEGIN(xthis_ptr);
+    XASSERT(XRBT_NULL != xhandle);
 
-    while (xiter_node != xthis_ptr->xiter_root)
+    if (XRBT_NULL != xhandle->xiter_node)
     {
-        xst_length += 1;
-        xiter_node = xiter_node->xiter_parent;
+        XASSERT(XNODE_IS_UNDOCKED(xhandle->xiter_node));
+        xrbtree_dealloc(xhandle->xtree_ptr, xhandle->xiter_node);
     }
 
-    return xst_length;
+    xhandle->xtree_ptr  = XRBT_NULL;
+    xhandle->xiter_node = XRBT_NULL;
 }
 
 /**********************************************************/
 /**
- * @brief 返回 x_rbtree_t 对象中的右手臂长度。
+ * @brief 将 xsrc_ptr 中的节点转移到 xthis_ptr 中（不申请内存、不拷贝数据）。
+ * @note
+ * 按 xsrc_ptr 的顺序逐个转移：先在 xthis_ptr 中定位停靠位置，
+ * 索引键值冲突的节点（非多键模式）留在 xsrc_ptr 中，否则分离后直接停靠到该位置；
+ * 两棵树不兼容（参看 xrbtree_compatible()）时，不做任何操作。
+ * 
+ * @param [in ] xthis_ptr : 目标红黑树对象。
+ * @param [in ] xsrc_ptr  : 源红黑树对象。
+ * 
+ * @return xrbt_size_t
+ *         - 返回转移的节点数量。
  */
-xrbt_size_t xrbtree_right_length(x_rbtree_ptr xthis_ptr)
+xrbt_size_t xrbtree_merge(x_rbtree_ptr xthis_ptr, x_rbtree_ptr xsrc_ptr)
 {
-    XASSERT(XRBT_NULL != xthis_ptr);
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xsrc_ptr));
 
-    xrbt_size_t   xst_length = 0;
-    x_rbnode_iter xiter_node = XTREE_RBEGIN(xthis_ptr);
+    x_rbtree_probe_t xprobe;
+    xrbt_int32_t     xit_select  = -1;
+    xrbt_size_t      xst_count   = 0;
+    x_rbnode_iter    xiter_where = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter    xiter_node  = XTREE_BEGIN(xsrc_ptr);
+    x_rbnode_iter    xiter_next  = XTREE_GET_NIL(xsrc_ptr);
 
-    while (xiter_node != xthis_ptr->xiter_root)
+    if ((xthis_ptr == xsrc_ptr) || !xrbtree_compatible(xthis_ptr, xsrc_ptr))
     {
-        xst_length += 1;
-        xiter_node = xiter_node->xiter_parent;
+        return 0;
     }
 
-    return xst_length;
+    while (XNODE_NOT_NIL(xiter_node))
+    {
+        xiter_next = xrbtree_successor(xsrc_ptr, xiter_node);
+
+        xrbtree_probe_init(xthis_ptr, &xprobe, XNODE_VKEY(xiter_node));
+        xiter_where = xrbtree_dock_pos(xthis_ptr, &xprobe, &xit_select);
+        if (0 != xit_select)
+        {
+            // 定位后 xthis_ptr 未被修改，停靠位置保持有效
+            xrbtree_undock(xsrc_ptr, xiter_node);
+            xrbtree_dock_at(xthis_ptr, xiter_node, xiter_where, xit_select);
+            xst_count += 1;
+        }
+
+        xiter_node = xiter_next;
+    }
+
+    return xst_count;
 }
 
 /**********************************************************/
 /**
- * @brief 向 x_rbtree_t 对象插入新节点。
- * @note  回调设置索引键值时，不使用 move 操作方式。
- * 
- * @param [in ] xthis_ptr : 红黑树对象。
- * @param [in ] xrbt_vkey : 新节点的索引键值。
- * @param [out] xbt_ok    : 返回操作成功的标识。
- * 
- * @return x_rbnode_iter
- *         - 返回对应节点。
+ * @brief 在 x_rbtree_t 对象中查找指定节点。
+ * @note  若返回 NIL 则表示 x_rbtree_t 对象不包含该节点键值。
  */
-x_rbnode_iter xrbtree_insert(x_rbtree_ptr xthis_ptr,
-                             xrbt_vkey_t xrbt_vkey,
-                             xrbt_bool_t * xbt_ok)
+x_rbnode_iter xrbtree_find(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey)
 {
-    XASSERT(XRBT_NULL != xthis_ptr);
-    XASSERT(XRBT_NULL != xrbt_vkey);
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xrbt_vkey));
+
+    XRECORD(xthis_ptr, XRBT_RECORD_FIND, xrbt_vkey);
+    return xrbtree_find_pos(xthis_ptr, xrbt_vkey);
+}
+
+/**********************************************************/
+/**
+ * @brief 返回的是首个不小于 指定索引键值 的 节点位置。
+ */
+x_rbnode_iter xrbtree_lower_bound(x_rbtree_ptr xthis_ptr,
+                                  xrbt_vkey_t xrbt_vkey)
+{
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xrbt_vkey));
+
+    XRECORD(xthis_ptr, XRBT_RECORD_LOWER_BOUND, xrbt_vkey);
+
+    x_rbtree_probe_t xprobe;
+    xrbtree_probe_init(xthis_ptr, &xprobe, xrbt_vkey);
+
+    return xrbtree_lower_pos(xthis_ptr, &xprobe);
+}
+
+/**********************************************************/
+/**
+ * @brief 返回的是首个大于 指定索引键值 的 节点位置。
+ */
+x_rbnode_iter xrbtree_upper_bound(x_rbtree_ptr xthis_ptr,
+                                  xrbt_vkey_t xrbt_vkey)
+{
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xrbt_vkey));
 
-    return xrbtree_insert_nkey(xthis_ptr, xrbt_vkey, XRBT_FALSE, xbt_ok);
+    x_rbtree_probe_t xprobe;
+    xrbtree_probe_init(xthis_ptr, &xprobe, xrbt_vkey);
+
+    return xrbtree_upper_pos(xthis_ptr, &xprobe);
 }
 
 /**********************************************************/
 /**
- * @brief 向 x_rbtree_t 对象插入新节点。
- * @note  回调设置索引键值时，使用 move 操作方式。
- * 
- * @param [in ] xthis_ptr : 红黑树对象。
- * @param [in ] xrbt_vkey : 新节点的索引键值。
- * @param [out] xbt_ok    : 返回操作成功的标识。
+ * @brief 使用 探测值 在 x_rbtree_t 对象中查找指定节点（异构查找，无须构造索引键对象）。
+ * @note  若返回 NIL 则表示 x_rbtree_t 对象不包含该节点键值。
  * 
- * @return x_rbnode_iter
- *         - 返回对应节点。
+ * @param [in ] xthis_ptr     : 红黑树对象。
+ * @param [in ] xrbt_probe    : 探测值。
+ * @param [in ] xfunc_compare : 比较 探测值 与 节点索引键值 的回调函数。
+ * @param [in ] xrbt_ctxt     : xfunc_compare 回调的上下文标识。
  */
-x_rbnode_iter xrbtree_insert_mkey(x_rbtree_ptr xthis_ptr,
-                                  xrbt_vkey_t xrbt_vkey,
-                                  xrbt_bool_t * xbt_ok)
+x_rbnode_iter xrbtree_find_with(x_rbtree_ptr xthis_ptr,
+                                xrbt_vkey_t xrbt_probe,
+                                xfunc_probe_compare_t xfunc_compare,
+                                xrbt_ctxt_t xrbt_ctxt)
 {
-    XASSERT(XRBT_NULL != xthis_ptr);
-    XASSERT(XRBT_NULL != xrbt_vkey);
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xfunc_compare));
+
+    xrbt_int32_t  xit_cmp    = 0;
+    x_rbnode_iter xiter_node = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter xiter_trav = XTREE_ROOT(xthis_ptr);
+    XSTAT_DEPTH_DECL(xst_depth);
+
+    // 多键模式下，需要返回首个相等的节点，所以不能在遇到相等节点时提前返回
+    if (XTREE_IS_MULTI(xthis_ptr))
+    {
+        xiter_node = xrbtree_lower_bound_with(
+                        xthis_ptr, xrbt_probe, xfunc_compare, xrbt_ctxt);
+        XSTAT_INC(xthis_ptr, xu64_compares);
+        if (XNODE_NOT_NIL(xiter_node) &&
+            (0 == xfunc_compare(xrbt_probe,
+                                XNODE_VKEY(xiter_node),
+                                xthis_ptr->xst_ksize,
+                                xrbt_ctxt)))
+        {
+            return xiter_node;
+        }
+
+        return XTREE_GET_NIL(xthis_ptr);
+    }
+
+    while (XNODE_NOT_NIL(xiter_trav))
+    {
+        XSTAT_DEPTH_STEP(xst_depth);
+        XSTAT_INC(xthis_ptr, xu64_compares);
+        xit_cmp = xfunc_compare(xrbt_probe,
+                                XNODE_VKEY(xiter_trav),
+                                xthis_ptr->xst_ksize,
+                                xrbt_ctxt);
+        if (xit_cmp < 0)
+            xiter_trav = XNODE_LEFT(xiter_trav);
+        else if (xit_cmp > 0)
+            xiter_trav = XNODE_RIGHT(xiter_trav);
+        else
+            break;
+    }
 
-    return xrbtree_insert_nkey(xthis_ptr, xrbt_vkey, XRBT_TRUE, xbt_ok);
+    XSTAT_DEPTH(xthis_ptr, xst_depth);
+    return XNODE_NOT_NIL(xiter_trav) ? xiter_trav : xiter_node;
 }
 
 /**********************************************************/
 /**
- * @brief 从 x_rbtree_t 对象中删除指定节点。
+ * @brief 返回的是首个不小于 探测值 的 节点位置（异构查找）。
+ * @note  参数说明参看 @see xrbtree_find_with() 。
  */
-xrbt_void_t xrbtree_erase(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node)
+x_rbnode_iter xrbtree_lower_bound_with(x_rbtree_ptr xthis_ptr,
+                                       xrbt_vkey_t xrbt_probe,
+                                       xfunc_probe_compare_t xfunc_compare,
+                                       xrbt_ctxt_t xrbt_ctxt)
 {
-    XASSERT(XRBT_NULL != xthis_ptr);
-    XASSERT((XRBT_NULL != xiter_node) && XNODE_NOT_NIL(xiter_node));
-    XASSERT(xrbtree_iter_tree(xiter_node) == xthis_ptr);
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xfunc_compare));
 
-    xrbtree_dealloc(xthis_ptr, xrbtree_undock(xthis_ptr, xiter_node));
+    x_rbnode_iter xiter_node = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter xiter_trav = XTREE_ROOT(xthis_ptr);
+    XSTAT_DEPTH_DECL(xst_depth);
+
+    while (XNODE_NOT_NIL(xiter_trav))
+    {
+        XSTAT_DEPTH_STEP(xst_depth);
+        XSTAT_INC(xthis_ptr, xu64_compares);
+        if (xfunc_compare(xrbt_probe,
+                          XNODE_VKEY(xiter_trav),
+                          xthis_ptr->xst_ksize,
+                          xrbt_ctxt) > 0)
+        {
+            xiter_trav = XNODE_RIGHT(xiter_trav);
+        }
+        else
+        {
+            xiter_node = xiter_trav;
+            xiter_trav = XNODE_LEFT(xiter_trav);
+        }
+    }
+
+    XSTAT_DEPTH(xthis_ptr, xst_depth);
+    return xiter_node;
 }
 
 /**********************************************************/
 /**
- * @brief 从 x_rbtree_t 对象中删除指定节点。
+ * @brief 返回的是首个大于 探测值 的 节点位置（异构查找）。
+ * @note  参数说明参看 @see xrbtree_find_with() 。
  */
-xrbt_bool_t xrbtree_erase_vkey(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey)
+x_rbnode_iter xrbtree_upper_bound_with(x_rbtree_ptr xthis_ptr,
+                                       xrbt_vkey_t xrbt_probe,
+                                       xfunc_probe_compare_t xfunc_compare,
+                                       xrbt_ctxt_t xrbt_ctxt)
 {
-    XASSERT(XRBT_NULL != xthis_ptr);
-    XASSERT(XRBT_NULL != xrbt_vkey);
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xfunc_compare));
 
-    x_rbnode_iter xiter_node = xrbtree_find(xthis_ptr, xrbt_vkey);
-    if (XNODE_IS_NIL(xiter_node))
+    x_rbnode_iter xiter_node = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter xiter_trav = XTREE_ROOT(xthis_ptr);
+    XSTAT_DEPTH_DECL(xst_depth);
+
+    while (XNODE_NOT_NIL(xiter_trav))
     {
-        return XRBT_FALSE;
+        XSTAT_DEPTH_STEP(xst_depth);
+        XSTAT_INC(xthis_ptr, xu64_compares);
+        if (xfunc_compare(xrbt_probe,
+                          XNODE_VKEY(xiter_trav),
+                          xthis_ptr->xst_ksize,
+                          xrbt_ctxt) < 0)
+        {
+            xiter_node = xiter_trav;
+            xiter_trav = XNODE_LEFT(xiter_trav);
+        }
+        else
+        {
+            xiter_trav = XNODE_RIGHT(xiter_trav);
+        }
     }
 
-    xrbtree_erase(xthis_ptr, xiter_node);
-
-    return XRBT_TRUE;
+    XSTAT_DEPTH(xthis_ptr, xst_depth);
+    return xiter_node;
 }
 
 /**********************************************************/
 /**
- * @brief 将节点对象停靠（插入）到红黑树中。
+ * @brief 返回 等于 指定索引键值 的节点区间 [*xiter_lower, *xiter_upper) 。
  * @note
- * xiter_node 必须处于分离状态（参看 @see xrbtree_iter_is_undocked()），
- * 而且其索引键必须 与 xthis_ptr 存储的节点索引键类型相同。
- * 
- * @param [in ] xthis_ptr  : 红黑树对象。
- * @param [in ] xiter_node : 停靠操作的节点对象。
+ * *xiter_lower 等同于 xrbtree_lower_bound() 的返回值，
+ * *xiter_upper 等同于 xrbtree_upper_bound() 的返回值，但只进行一次定位操作。
  * 
- * @return x_rbnode_iter
- *         - 返回的 节点对象 == xiter_node，停靠成功。
- *         - 返回的 节点对象 != xiter_node，停靠失败（索引键值冲突）。
+ * @param [in ] xthis_ptr   : 红黑树对象。
+ * @param [in ] xrbt_vkey   : 索引键值。
+ * @param [out] xiter_lower : 返回区间的起始节点。
+ * @param [out] xiter_upper : 返回区间的终止节点。
  */
-x_rbnode_iter xrbtree_dock(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node)
+xrbt_void_t xrbtree_equal_range(x_rbtree_ptr xthis_ptr,
+                                xrbt_vkey_t xrbt_vkey,
+                                x_rbnode_iter * xiter_lower,
+                                x_rbnode_iter * xiter_upper)
 {
-    XASSERT(XRBT_NULL != xthis_ptr);
-    XASSERT((XRBT_NULL != xiter_node) && XNODE_NOT_NIL(xiter_node));
-    XASSERT(XNODE_IS_UNDOCKED(xiter_node));
-    XASSERT(xiter_node->xut_ksize == xthis_ptr->xst_ksize);
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xrbt_vkey));
+    XASSERT((XRBT_NULL != xiter_lower) && (XRBT_NULL != xiter_upper));
 
-    //======================================
+    x_rbtree_probe_t xprobe;
+    xrbtree_probe_init(xthis_ptr, &xprobe, xrbt_vkey);
 
-    xrbt_int32_t  xit_select  = -1;
-    x_rbnode_iter xiter_where = xrbtree_dock_pos(xthis_ptr,
-                                                 XNODE_VKEY(xiter_node),
-                                                 &xit_select);
+    *xiter_lower = xrbtree_equal_pos(xthis_ptr, &xprobe, xiter_upper);
+}
 
-    if (0 == xit_select)
-    {
-        return xiter_where;
-    }
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象中 等于 指定索引键值 的节点数量。
+ */
+xrbt_size_t xrbtree_count(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey)
+{
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xrbt_vkey));
 
-    //======================================
+    x_rbtree_probe_t xprobe;
+    xrbt_size_t      xst_count   = 0;
+    x_rbnode_iter    xiter_upper = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter    xiter_lower = XTREE_GET_NIL(xthis_ptr);
 
-    xiter_node->xiter_parent = xiter_where;
-    if (XNODE_IS_NIL(xiter_where))
-    {
-        xthis_ptr->xiter_root = xiter_node;
-    }
-    else if (xit_select < 0)
-    {
-        xiter_where->xiter_left = xiter_node;
-    }
-    else
+    xrbtree_probe_init(xthis_ptr, &xprobe, xrbt_vkey);
+    xiter_lower = xrbtree_equal_pos(xthis_ptr, &xprobe, &xiter_upper);
+
+    while (xiter_lower != xiter_upper)
     {
-        xiter_where->xiter_right = xiter_node;
+        xst_count  += 1;
+        xiter_lower = xrbtree_successor(xthis_ptr, xiter_lower);
     }
 
-    xiter_node->xut_color = X_RED;
-    XTREE_SET_NIL(xthis_ptr, xiter_node->xiter_left );
-    XTREE_SET_NIL(xthis_ptr, xiter_node->xiter_right);
-
-    //======================================
-
-    xrbtree_dock_fixup(xthis_ptr, xiter_node);
-    xrbtree_update(xthis_ptr, xiter_node, XRBT_FALSE);
-
-    //======================================
-
-    return xiter_node;
+    return xst_count;
 }
 
 /**********************************************************/
 /**
- * @brief 将节点对象从红黑树中分离（移除）出来。
- * @note xiter_node 必须 已经隶属于 xthis_ptr 。
- * 
- * @param [in ] xthis_ptr  : 红黑树对象。
- * @param [in ] xiter_node : 分离操作的节点对象。
+ * @brief 初始化批量区间扫描的游标（参看 xrbtree_scan()）。
  * 
- * @return x_rbnode_iter
- *         - 返回的 节点对象 == xiter_node。
+ * @param [out] xcursor   : 游标。
+ * @param [in ] xut_flags : 扫描标识（参看 emXRBtreeScanFlags 枚举值）。
  */
-x_rbnode_iter xrbtree_undock(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node)
+xrbt_void_t xrbtree_cursor_init(xrbt_cursor_t * xcursor, xrbt_uint32_t xut_flags)
 {
-    XASSERT(XRBT_NULL != xthis_ptr);
-    XASSERT((XRBT_NULL != xiter_node) && XNODE_NOT_NIL(xiter_node));
-    XASSERT(xrbtree_iter_tree(xiter_node) == xthis_ptr);
+    XASSERT(XRBT_NULL != xcursor);
 
-    x_rbnode_iter xiter_fixup  = XTREE_GET_NIL(xthis_ptr);
-    x_rbnode_iter xiter_parent = XTREE_GET_NIL(xthis_ptr);
-    x_rbnode_iter xiter_where  = xiter_node;
-    x_rbnode_iter xiter_ntrav  = xiter_where;
+    xcursor->xiter_next = XRBT_NULL;
+    xcursor->xiter_stop = XRBT_NULL;
+    xcursor->xut_flags  = xut_flags;
+}
 
-    if (XNODE_IS_NIL(xiter_ntrav->xiter_left))
-    {
-        xiter_fixup = xiter_ntrav->xiter_right;
-    }
-    else if (XNODE_IS_NIL(xiter_ntrav->xiter_right))
-    {
-        xiter_fixup = xiter_ntrav->xiter_left;
-    }
-    else
-    {
-        xiter_ntrav = xrbtree_successor(xthis_ptr, xiter_node);
-        xiter_fixup = xiter_ntrav->xiter_right;
-    }
+/**********************************************************/
+/**
+ * @brief 定位批量区间扫描的 起始节点 与 终止节点，写入游标。
+ */
+static xrbt_void_t xrbtree_scan_locate(x_rbtree_ptr xthis_ptr,
+                                       xrbt_vkey_t xrbt_lower,
+                                       xrbt_vkey_t xrbt_upper,
+                                       xrbt_cursor_t * xcursor)
+{
+    x_rbtree_probe_t xprobe_lower;
+    x_rbtree_probe_t xprobe_upper;
+    x_rbnode_iter    xiter_first = XTREE_GET_NIL(xthis_ptr);
+    x_rbnode_iter    xiter_stop  = XTREE_GET_NIL(xthis_ptr);
 
-    if (xiter_ntrav == xiter_where)
+    if (XRBT_NULL != xrbt_lower)
+        xrbtree_probe_init(xthis_ptr, &xprobe_lower, xrbt_lower);
+    if (XRBT_NULL != xrbt_upper)
+        xrbtree_probe_init(xthis_ptr, &xprobe_upper, xrbt_upper);
+
+    if (0 == (xcursor->xut_flags & XRBT_SCAN_DESC))
     {
-        xiter_parent = xiter_where->xiter_parent;
-        if (XNODE_NOT_NIL(xiter_fixup))
-            xiter_fixup->xiter_parent = xiter_parent;
+        xiter_first = (XRBT_NULL != xrbt_lower) ?
+                        xrbtree_lower_pos(xthis_ptr, &xprobe_lower) :
+                        XTREE_BEGIN(xthis_ptr);
 
-        if (xthis_ptr->xiter_root == xiter_where)
-        {
-            xthis_ptr->xiter_root = xiter_fixup;
-        }
-        else if (xiter_parent->xiter_left == xiter_where)
-        {
-            xiter_parent->xiter_left = xiter_fixup;
-        }
-        else
+        if (XRBT_NULL != xrbt_upper)
         {
-            xiter_parent->xiter_right = xiter_fixup;
+            xiter_stop = xrbtree_lower_pos(xthis_ptr, &xprobe_upper);
+
+            // 下界不小于上界时，区间为空
+            if (XNODE_IS_NIL(xiter_first) ||
+                !xrbtree_less_np(xthis_ptr, xiter_first, &xprobe_upper))
+            {
+                xiter_first = xiter_stop;
+            }
         }
     }
     else
     {
-        xiter_where->xiter_left->xiter_parent = xiter_ntrav;
-        xiter_ntrav->xiter_left = xiter_where->xiter_left;
-
-        if (xiter_ntrav == xiter_where->xiter_right)
+        // 降序扫描：起始节点为上界的前驱，终止节点为下界的前驱
+        if (XRBT_NULL != xrbt_upper)
         {
-            xiter_parent = xiter_ntrav;
+            xiter_first = xrbtree_lower_pos(xthis_ptr, &xprobe_upper);
+            xiter_first = XNODE_IS_NIL(xiter_first) ?
+                            XTREE_RBEGIN(xthis_ptr) :
+                            xrbtree_precursor(xthis_ptr, xiter_first);
         }
         else
         {
-            xiter_parent = xiter_ntrav->xiter_parent;
-            if (XNODE_NOT_NIL(xiter_fixup))
-            {
-                xiter_fixup->xiter_parent = xiter_parent;
-            }
-
-            xiter_parent->xiter_left = xiter_fixup;
-            xiter_ntrav->xiter_right = xiter_where->xiter_right;
-            xiter_where->xiter_right->xiter_parent = xiter_ntrav;
+            xiter_first = XTREE_RBEGIN(xthis_ptr);
         }
 
-        if (xthis_ptr->xiter_root == xiter_where)
+        if (XRBT_NULL != xrbt_lower)
         {
-            xthis_ptr->xiter_root = xiter_ntrav;
+            xiter_stop = xrbtree_lower_pos(xthis_ptr, &xprobe_lower);
+            xiter_stop = XNODE_IS_NIL(xiter_stop) ?
+                            XTREE_RBEGIN(xthis_ptr) :
+                            xrbtree_precursor(xthis_ptr, xiter_stop);
+
+            if (XNODE_IS_NIL(xiter_first) ||
+                xrbtree_less_np(xthis_ptr, xiter_first, &xprobe_lower))
+            {
+                xiter_first = xiter_stop;
+            }
         }
-        else if (xiter_where->xiter_parent->xiter_left == xiter_where)
+    }
+
+    xcursor->xiter_next = xiter_first;
+    xcursor->xiter_stop = xiter_stop;
+}
+
+/**********************************************************/
+/**
+ * @brief 批量区间扫描中，求 升序（降序）的下一个节点。
+ * @note
+ * 沿子树向下查找最左（最右）节点时，路径上各节点的 右（左）子树 将按路径逆序
+ * 依次被访问，在此时预取，使后续的访问与当前路径上的访问重叠。
+ */
+static x_rbnode_iter xrbtree_scan_step(x_rbnode_iter xiter_node, xrbt_bool_t xbt_desc)
+{
+    x_rbnode_iter xiter_parent = XNODE_PARENT(xiter_node);
+    x_rbnode_iter xiter_trav   = xbt_desc ? XNODE_LEFT(xiter_node) : XNODE_RIGHT(xiter_node);
+
+    if (XNODE_NOT_NIL(xiter_trav))
+    {
+        if (xbt_desc)
         {
-            xiter_where->xiter_parent->xiter_left = xiter_ntrav;
+            XNODE_PREFETCH(XNODE_LEFT(xiter_trav));
+            while (XNODE_NOT_NIL(XNODE_RIGHT(xiter_trav)))
+            {
+                XNODE_PREFETCH(XNODE_LEFT(xiter_trav));
+                xiter_trav = XNODE_RIGHT(xiter_trav);
+            }
+            XNODE_PREFETCH(XNODE_LEFT(xiter_trav));
         }
         else
         {
-            xiter_where->xiter_parent->xiter_right = xiter_ntrav;
+            while (XNODE_NOT_NIL(XNODE_LEFT(xiter_trav)))
+            {
+                XNODE_PREFETCH(XNODE_RIGHT(xiter_trav));
+                xiter_trav = XNODE_LEFT(xiter_trav);
+            }
+            XNODE_PREFETCH(XNODE_RIGHT(xiter_trav));
         }
 
-        xiter_ntrav->xiter_parent = xiter_where->xiter_parent;
-
-        // recolor it (swap color)
-        if (xiter_ntrav->xut_color != xiter_where->xut_color)
-        {
-            XNODE_SPIN_CLR(xiter_ntrav);
-            XNODE_SPIN_CLR(xiter_where);
-        }
+        return xiter_trav;
     }
 
-    if (X_BLACK == xiter_where->xut_color)
+    while (XNODE_NOT_NIL(xiter_parent) &&
+           (xiter_node == (xbt_desc ? XNODE_LEFT(xiter_parent) : XNODE_RIGHT(xiter_parent))))
     {
-        xrbtree_undock_fixup(xthis_ptr, xiter_fixup, xiter_parent);
+        xiter_node   = xiter_parent;
+        xiter_parent = XNODE_PARENT(xiter_parent);
     }
 
-    xrbtree_update(xthis_ptr, xiter_where, XRBT_TRUE);
-
-    XNODE_UNDOCK(xiter_where);
-
-    return xiter_where;
+    return xiter_parent;
 }
 
 /**********************************************************/
 /**
- * @brief 在 x_rbtree_t 对象中查找指定节点。
- * @note  若返回 NIL 则表示 x_rbtree_t 对象不包含该节点键值。
+ * @brief 批量扫描 [xrbt_lower, xrbt_upper) 区间内的节点，
+ *        每次调用输出至多 xst_max 个节点的 索引键/值数据 地址，并由游标记录扫描位置。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [in ] xrbt_lower : 区间下界（包含；为 XRBT_NULL 时，自首个节点开始）。
+ * @param [in ] xrbt_upper : 区间上界（不包含；为 XRBT_NULL 时，至最后一个节点为止）。
+ * @param [out] xvkey_buf  : 输出 索引键 地址的缓存（可为 XRBT_NULL）。
+ * @param [out] xvval_buf  : 输出 值数据 地址的缓存（仅对 映射表模式 有效，可为 XRBT_NULL）。
+ * @param [in ] xst_max    : 缓存可容纳的元素数量。
+ * @param [in,out] xcursor : 游标（参看 xrbtree_cursor_init()）。
+ * 
+ * @return xrbt_size_t
+ *         - 返回本次输出的节点数量；返回 0 表示扫描已完成。
  */
-x_rbnode_iter xrbtree_find(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey)
+xrbt_size_t xrbtree_scan(x_rbtree_ptr xthis_ptr,
+                         xrbt_vkey_t xrbt_lower,
+                         xrbt_vkey_t xrbt_upper,
+                         xrbt_vkey_t * xvkey_buf,
+                         xrbt_vval_t * xvval_buf,
+                         xrbt_size_t xst_max,
+                         xrbt_cursor_t * xcursor)
 {
-    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xrbt_vkey));
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xcursor));
+    XASSERT((XRBT_NULL == xvval_buf) ||
+            ((0 != xthis_ptr->xst_vsize) && !XTREE_IS_LINK(xthis_ptr)));
 
-    x_rbnode_iter xiter_node = xrbtree_lower_bound(xthis_ptr, xrbt_vkey);
+    xrbt_size_t   xst_count  = 0;
+    xrbt_bool_t   xbt_desc   = (0 != (xcursor->xut_flags & XRBT_SCAN_DESC));
+    x_rbnode_iter xiter_node = XRBT_NULL;
+    x_rbnode_iter xiter_next = XRBT_NULL;
+    x_rbnode_iter xiter_stop = XRBT_NULL;
 
-    if (XNODE_IS_NIL(xiter_node) ||
-        xthis_ptr->xcallback.xfunc_k_compare(
-                              xrbt_vkey,
-                              XNODE_VKEY(xiter_node),
-                              xthis_ptr->xst_ksize,
-                              xthis_ptr->xcallback.xctxt_t_callback)
-       )
+    if (XRBT_NULL == xcursor->xiter_next)
     {
-        return XTREE_GET_NIL(xthis_ptr);
+        xrbtree_scan_locate(xthis_ptr, xrbt_lower, xrbt_upper, xcursor);
     }
 
-    return xiter_node;
+    xiter_node = xcursor->xiter_next;
+    xiter_stop = xcursor->xiter_stop;
+
+    while ((xst_count < xst_max) && (xiter_node != xiter_stop))
+    {
+        XASSERT(XNODE_NOT_NIL(xiter_node));
+
+        xiter_next = xrbtree_scan_step(xiter_node, xbt_desc);
+
+        if (XRBT_NULL != xvkey_buf)
+            xvkey_buf[xst_count] = XNODE_VKEY(xiter_node);
+        if (XRBT_NULL != xvval_buf)
+            xvval_buf[xst_count] = XNODE_VVAL(xiter_node);
+
+        xst_count += 1;
+        xiter_node = xiter_next;
+    }
+
+    xcursor->xiter_next = xiter_node;
+    return xst_count;
 }
 
 /**********************************************************/
 /**
- * @brief 返回的是首个不小于 指定索引键值 的 节点位置。
+ * @brief 按中序收集 以 xiter_node 为根的子树 中，前 xut_depth 层的节点。
  */
-x_rbnode_iter xrbtree_lower_bound(x_rbtree_ptr xthis_ptr,
-                                  xrbt_vkey_t xrbt_vkey)
+static xrbt_size_t xrbtree_partition_collect(x_rbnode_iter xiter_node,
+                                             xrbt_uint32_t xut_depth,
+                                             x_rbnode_iter * xiter_bounds,
+                                             xrbt_size_t xst_count)
 {
-    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xrbt_vkey));
-
-    x_rbnode_iter xiter_node = XTREE_GET_NIL(xthis_ptr);
-    x_rbnode_iter xiter_trav = xthis_ptr->xiter_root;
-
-    while (XNODE_NOT_NIL(xiter_trav))
+    if (XNODE_IS_NIL(xiter_node) || (0 == xut_depth))
     {
-        if (xthis_ptr->xcallback.xfunc_k_compare(
-                                  XNODE_VKEY(xiter_trav),
-                                  xrbt_vkey,
-                                  xthis_ptr->xst_ksize,
-                                  xthis_ptr->xcallback.xctxt_t_callback))
-        {
-            xiter_trav = xiter_trav->xiter_right;
-        }
-        else
-        {
-            xiter_node = xiter_trav;
-            xiter_trav = xiter_trav->xiter_left;
-        }
+        return xst_count;
     }
 
-    return xiter_node;
+    xst_count = xrbtree_partition_collect(
+                    XNODE_LEFT(xiter_node), xut_depth - 1, xiter_bounds, xst_count);
+    xiter_bounds[xst_count++] = xiter_node;
+    return xrbtree_partition_collect(
+                    XNODE_RIGHT(xiter_node), xut_depth - 1, xiter_bounds, xst_count);
 }
 
 /**********************************************************/
 /**
- * @brief 返回的是首个大于 指定索引键值 的 节点位置。
+ * @brief 在靠近根节点的位置，将 x_rbtree_t 对象切分为至多 xst_max 个互不相交的有序分段。
+ * 
+ * @param [in ] xthis_ptr    : 红黑树对象。
+ * @param [out] xiter_bounds : 返回分段的边界（须可容纳 xst_max + 1 个元素），
+ *                             最后一个边界为 xrbtree_end() 。
+ * @param [in ] xst_max      : 分段的最大数量（不小于 1）。
+ * 
+ * @return xrbt_size_t
+ *         - 返回分段的数量（树为空时，返回 0）。
  */
-x_rbnode_iter xrbtree_upper_bound(x_rbtree_ptr xthis_ptr,
-                                  xrbt_vkey_t xrbt_vkey)
+xrbt_size_t xrbtree_partition(x_rbtree_ptr xthis_ptr,
+                              x_rbnode_iter * xiter_bounds,
+                              xrbt_size_t xst_max)
 {
-    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xrbt_vkey));
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xiter_bounds));
+    XASSERT(xst_max >= 1);
 
-    x_rbnode_iter xiter_node = XTREE_GET_NIL(xthis_ptr);
-    x_rbnode_iter xiter_trav = xthis_ptr->xiter_root;
+    xrbt_uint32_t xut_depth = 0;
+    xrbt_size_t   xst_count = 0;
+    xrbt_size_t   xst_iter  = 0;
 
-    while (XNODE_NOT_NIL(xiter_trav))
+    xiter_bounds[0] = XTREE_GET_NIL(xthis_ptr);
+    if (0 == xthis_ptr->xst_count)
     {
-        if (xthis_ptr->xcallback.xfunc_k_compare(
-                                  xrbt_vkey,
-                                  XNODE_VKEY(xiter_trav),
-                                  xthis_ptr->xst_ksize,
-                                  xthis_ptr->xcallback.xctxt_t_callback))
-        {
-            xiter_node = xiter_trav;
-            xiter_trav = xiter_trav->xiter_left;
-        }
-        else
-        {
-            xiter_trav = xiter_trav->xiter_right;
-        }
+        return 0;
     }
 
-    return xiter_node;
+    // 顶部 xut_depth 层至多有 2^xut_depth - 1 个节点，即至多 2^xut_depth <= xst_max 个分段
+    for (xst_iter = xst_max; xst_iter > 1; xst_iter /= 2)
+        xut_depth += 1;
+
+    // 以 顶部各层的节点（中序）为边界，每个分段由 一个边界节点 与 其后的一棵子树 组成
+    xiter_bounds[0] = XTREE_BEGIN(xthis_ptr);
+    xst_count = xrbtree_partition_collect(
+                    XTREE_ROOT(xthis_ptr), xut_depth, xiter_bounds, 1);
+
+    // 最左侧节点位于顶部各层时，首个分段为空
+    if ((xst_count > 1) && (xiter_bounds[1] == xiter_bounds[0]))
+    {
+        for (xst_iter = 1; xst_iter < xst_count; ++xst_iter)
+            xiter_bounds[xst_iter - 1] = xiter_bounds[xst_iter];
+        xst_count -= 1;
+    }
+
+    xiter_bounds[xst_count] = XTREE_GET_NIL(xthis_ptr);
+    return xst_count;
 }
 
 /**********************************************************/
@@ -1396,7 +4869,7 @@ x_rbnode_iter xrbtree_upper_bound(x_rbtree_ptr xthis_ptr,
 x_rbnode_iter xrbtree_root(x_rbtree_ptr xthis_ptr)
 {
     XASSERT(XRBT_NULL != xthis_ptr);
-    return xthis_ptr->xiter_root;
+    return XTREE_ROOT(xthis_ptr);
 }
 
 /**********************************************************/
@@ -1406,6 +4879,7 @@ x_rbnode_iter xrbtree_root(x_rbtree_ptr xthis_ptr)
 x_rbnode_iter xrbtree_begin(x_rbtree_ptr xthis_ptr)
 {
     XASSERT(XRBT_NULL != xthis_ptr);
+    XRECORD(xthis_ptr, XRBT_RECORD_BEGIN, XRBT_NULL);
     return XTREE_BEGIN(xthis_ptr);
 }
 
@@ -1437,6 +4911,7 @@ x_rbnode_iter xrbtree_next(x_rbnode_iter xiter_node)
 x_rbnode_iter xrbtree_rbegin(x_rbtree_ptr xthis_ptr)
 {
     XASSERT(XRBT_NULL != xthis_ptr);
+    XRECORD(xthis_ptr, XRBT_RECORD_RBEGIN, XRBT_NULL);
     return XTREE_RBEGIN(xthis_ptr);
 }
 
@@ -1471,6 +4946,17 @@ xrbt_vkey_t xrbtree_iter_vkey(x_rbnode_iter xiter_node)
     return XNODE_VKEY(xiter_node);
 }
 
+/**********************************************************/
+/**
+ * @brief 返回 节点对象 指向的值数据（仅对 映射表模式 的节点有效）。
+ */
+xrbt_vval_t xrbtree_iter_value(x_rbnode_iter xiter_node)
+{
+    XASSERT((XRBT_NULL != xiter_node) && XNODE_NOT_NIL(xiter_node));
+    XASSERT(!(xiter_node->xut_kmode & XNODE_KMODE_LINK));
+    return XNODE_VVAL(xiter_node);
+}
+
 /**********************************************************/
 /**
  * @brief 判断 节点对象 是否为 NIL 。
@@ -1487,7 +4973,8 @@ xrbt_bool_t xrbtree_iter_is_nil(x_rbnode_iter xiter_node)
  */
 xrbt_bool_t xrbtree_iter_is_undocked(x_rbnode_iter xiter_node)
 {
-    XASSERT((XRBT_NULL != xiter_node) && XNODE_NOT_NIL(xiter_node));
+    XASSERT(XRBT_NULL != xiter_node);
+    XASSERT(XNODE_NOT_NIL(xiter_node) || XNODE_IS_UNDOCKED(xiter_node));
     return XNODE_IS_UNDOCKED(xiter_node);
 }
 
@@ -1503,22 +4990,22 @@ x_rbtree_ptr xrbtree_iter_tree(x_rbnode_iter xiter_node)
 
     while (XNODE_NOT_NIL(xiter_node))
     {
-        if (XNODE_IS_NIL(xiter_node->xiter_parent))
+        if (XNODE_IS_NIL(XNODE_PARENT(xiter_node)))
         {
-            xiter_node = xiter_node->xiter_parent;
+            xiter_node = XNODE_PARENT(xiter_node);
             break;
         }
 
-        if (XNODE_IS_NIL(xiter_node->xiter_right))
+        if (XNODE_IS_NIL(XNODE_RIGHT(xiter_node)))
         {
-            xiter_node = xiter_node->xiter_right;
+            xiter_node = XNODE_RIGHT(xiter_node);
             break;
         }
 
-        xiter_node = xiter_node->xiter_left;
+        xiter_node = XNODE_LEFT(xiter_node);
     }
 
-    return ((x_rbtree_nil_t *)xiter_node)->xower_ptr;
+    return (x_rbtree_ptr)XLINK_GET(((x_rbtree_nil_t *)xiter_node)->xower_ptr);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -23,6 +23,8 @@
 #ifndef __XRBTREE_H__
 #define __XRBTREE_H__
 
+#include <stddef.h>  // for offsetof()
+
 ////////////////////////////////////////////////////////////////////////////////
 
 #ifdef __cplusplus
@@ -47,9 +49,11 @@ typedef void           xrbt_void_t;
 typedef unsigned char  xrbt_byte_t;
 typedef int            xrbt_int32_t;
 typedef unsigned int   xrbt_uint32_t;
+typedef unsigned long long xrbt_uint64_t;
 typedef unsigned int   xrbt_size_t;
 typedef unsigned int   xrbt_bool_t;
 typedef void *         xrbt_vkey_t;
+typedef void *         xrbt_vval_t;
 typedef void *         xrbt_ctxt_t;
 
 /** 声明红黑树所使用的节点结构体 */
@@ -58,6 +62,13 @@ struct x_rbtree_node_t;
 /** 声明红黑树所使用的节点迭代器 */
 typedef struct x_rbtree_node_t * x_rbnode_iter;
 
+/**
+ * 节点链接字段的存储类型：所指向节点的地址 与 该字段自身地址 之差（自相对偏移量），
+ * 为 0 时表示 XRBT_NULL 。红黑树对象与其节点整体映射到任意地址后，链接依然有效
+ * （参看 XRBT_FLAG_SHARED、xrbtree_emplace_reattach()）。
+ */
+typedef ptrdiff_t xrbt_lofs_t;
+
 /** 声明红黑树结构体 */
 struct x_rbtree_t;
 
@@ -67,12 +78,14 @@ typedef struct x_rbtree_t * x_rbtree_ptr;
 /**
  * @brief 申请节点对象缓存的回调函数类型。
  *
- * @param [in ] xrbt_vkey : 请求申请缓存的节点索引键（插入操作时回调回来的索引键）。
+ * @param [in ] xrbt_vkey : 请求申请缓存的节点索引键（插入操作时回调回来的索引键，
+ *                          通过 xrbtree_node_alloc() 申请时为 XRBT_NULL）。
  * @param [in ] xst_nsize : 节点对象所需缓存的大小（即 请求申请缓存的大小）。
  * @param [in ] xrbt_ctxt : 回调的上下文标识。
  * 
  * @return xrbt_void_t *
- *         - 节点对象缓存。
+ *         - 节点对象缓存；返回 XRBT_NULL 表示申请失败，
+ *           相应的插入操作失败（返回 xrbtree_end()），红黑树保持不变。
  */
 typedef xrbt_void_t * (* xfunc_node_memalloc_t)(
                             xrbt_vkey_t xrbt_vkey,
@@ -137,6 +150,73 @@ typedef xrbt_bool_t (* xfunc_vkey_compare_t)(
                             xrbt_size_t xrbt_size,
                             xrbt_ctxt_t xrbt_ctxt);
 
+/**
+ * @brief 比较 探测值 与 节点索引键值 的回调函数类型（用于异构查找操作）。
+ * @note  探测值可为任意类型，但其比较结果必须与红黑树的索引键值排序规则一致。
+ *
+ * @param [in ] xrbt_probe : 探测值。
+ * @param [in ] xrbt_vkey  : 节点索引键值。
+ * @param [in ] xrbt_size  : xrbt_vkey 缓存大小。
+ * @param [in ] xrbt_ctxt  : 调用方传入的上下文标识。
+ *
+ * @return xrbt_int32_t
+ *         - 若 xrbt_probe <  xrbt_vkey ，返回值 < 0；
+ *         - 若 xrbt_probe == xrbt_vkey ，返回值 = 0；
+ *         - 若 xrbt_probe >  xrbt_vkey ，返回值 > 0。
+ */
+typedef xrbt_int32_t (* xfunc_probe_compare_t)(
+                            xrbt_vkey_t xrbt_probe,
+                            xrbt_vkey_t xrbt_vkey,
+                            xrbt_size_t xrbt_size,
+                            xrbt_ctxt_t xrbt_ctxt);
+
+/**
+ * @brief 单次定位的 插入/更新 操作（upsert）中，初始化新节点 或 合并已有节点 的回调函数类型。
+ * @note  回调时节点已停靠在红黑树中，回调操作不可修改节点的索引键值。
+ *
+ * @param [in ] xiter_node : 操作的节点对象（新节点 或 已有节点）。
+ * @param [in ] xrbt_vkey  : 调用方传入的索引键值。
+ * @param [in ] xrbt_ctxt  : 调用方传入的上下文标识。
+ */
+typedef xrbt_void_t (* xfunc_node_upsert_t)(
+                            x_rbnode_iter xiter_node,
+                            xrbt_vkey_t xrbt_vkey,
+                            xrbt_ctxt_t xrbt_ctxt);
+
+/**
+ * @brief 计算索引键前缀值的回调函数类型（用于定位操作中的快速比较）。
+ * @note
+ * 前缀值必须与 xfunc_vkey_compare_t 的排序规则保持一致（保序）：
+ * 即 若 prefix(a) < prefix(b)，则必有 a < b；前缀值相等时，才会回调完整的比较操作。
+ *
+ * @param [in ] xrbt_vkey : 索引键值。
+ * @param [in ] xrbt_size : 索引键值缓存大小。
+ * @param [in ] xrbt_ctxt : 回调的上下文标识。
+ *
+ * @return xrbt_uint64_t
+ *         - 返回索引键前缀值。
+ */
+typedef xrbt_uint64_t (* xfunc_vkey_prefix_t)(
+                            xrbt_vkey_t xrbt_vkey,
+                            xrbt_size_t xrbt_size,
+                            xrbt_ctxt_t xrbt_ctxt);
+
+/**
+ * @brief 计算索引键哈希值的回调函数类型（用于快速判断索引键值不相等）。
+ * @note  相等的索引键值（比较操作判定为相等）必须得到相同的哈希值。
+ *
+ * @param [in ] xrbt_vkey : 索引键值。
+ * @param [in ] xrbt_size : 索引键值缓存大小。
+ * @param [in ] xrbt_ctxt : 回调的上下文标识。
+ *
+ * @return xrbt_uint32_t
+ *         - 返回索引键哈希值。
+ */
+typedef xrbt_uint32_t (* xfunc_vkey_hash_t)(
+                            xrbt_vkey_t xrbt_vkey,
+                            xrbt_size_t xrbt_size,
+                            xrbt_ctxt_t xrbt_ctxt);
+
 /**
  * @struct x_rbtree_node_callback_t
  * @brief  红黑树节点的 相关回调函数接口 的结构体描述信息。
@@ -151,6 +231,262 @@ typedef struct x_rbtree_node_callback_t
     xrbt_ctxt_t           xctxt_t_callback; ///< 回调的上下文标识
 } xrbt_callback_t;
 
+/**
+ * @struct x_rbtree_value_callback_t
+ * @brief  红黑树节点（映射表模式）的 值数据相关回调函数接口 的结构体描述信息。
+ * @note
+ * 值数据 不参与节点的比较操作，其回调的上下文标识使用 xrbt_callback_t 中的 xctxt_t_callback；
+ * xfunc_v_copyfrom 回调的目标缓存总是未初始化的（构造操作），若其源数据为 XRBT_NULL，
+ * 则表示按默认值构造；覆盖已有的值数据时，会先回调 xfunc_v_destruct 进行析构。
+ */
+typedef struct x_rbtree_value_callback_t
+{
+    xfunc_vkey_copyfrom_t xfunc_v_copyfrom; ///< 拷贝节点对象的值数据的回调操作接口
+    xfunc_vkey_destruct_t xfunc_v_destruct; ///< 析构节点对象的值数据的回调操作接口
+} xrbt_vcallback_t;
+
+/**
+ * @enum  emXRBtreeFlags
+ * @brief 红黑树对象的模式标识（创建时指定，可组合使用）。
+ */
+typedef enum emXRBtreeFlags
+{
+    /**
+     * 多键模式：允许索引键值重复，插入操作总是成功，
+     * 相等的索引键值按插入的先后顺序排列（新节点位于已有的相等节点之后）。
+     */
+    XRBT_FLAG_MULTI = 0x00000001,
+
+    /**
+     * 借用索引键模式：节点只存储调用方索引键的指针，不进行拷贝（不回调 xfunc_k_copyfrom、
+     * xfunc_k_destruct），可选内联存储索引键的 前缀值/哈希值（参看 xrbtree_set_key_hints()）。
+     * 索引键的生命周期约定：
+     * 1. 节点处于红黑树中的期间，其借用的索引键必须保持有效，且内容不可改变；
+     * 2. 索引键所在的内存区域被重新映射时，调用方须使用 xrbtree_rebase_keys() 批量重定位；
+     * 3. 节点被 删除/清除 后，红黑树不再访问其借用的索引键，调用方可自行回收；
+     * 4. 该模式下不可使用 xrbtree_node_alloc() 就地构造索引键。
+     */
+    XRBT_FLAG_BORROW = 0x00000002,
+
+    /**
+     * 侵入模式：节点即调用方对象中嵌入的链接头（x_rbtree_link_t），
+     * 索引键位于调用方对象中、相对链接头的固定偏移处（参看 xrbtree_create_intrusive()）。
+     * 1. 红黑树不申请、不拷贝、不析构任何数据（不回调除 xfunc_k_compare 以外的节点回调）；
+     * 2. 使用 xrbtree_dock()/xrbtree_undock() 停靠/分离链接头，
+     *    删除/清除 操作只将节点分离出来，对象的生命周期由调用方管理；
+     * 3. 同一个对象嵌入多个链接头时，可同时位于多棵红黑树中；
+     * 4. 该模式下不可使用 按索引键插入 的操作（insert/try_emplace/insert_or_assign/upsert），
+     *    也不可使用 xrbtree_node_alloc()/recycle()/release() 以及 值数据、前缀值 等功能；
+     * 5. 不可与 XRBT_FLAG_BORROW 组合使用。
+     */
+    XRBT_FLAG_INTRUSIVE = 0x00000004,
+
+    /**
+     * 不逐个释放节点模式：节点内存由 xfunc_n_memalloc 所对应的内存资源整体回收
+     * （如 std::pmr::monotonic_buffer_resource、请求级的内存池），红黑树从不回调 xfunc_n_memfree：
+     * 1. 删除的节点缓存留在红黑树内部的链表中，供后续的插入操作复用；
+     * 2. 索引键/值数据 的析构回调均为默认值（XRBT_NULL，即无须析构）时，
+     *    xrbtree_clear()/xrbtree_destroy() 不再遍历节点，为 O(1) 操作；
+     * 3. 内存资源须在红黑树销毁（或清除）之后才可整体释放；
+     * 4. 不可与 XRBT_FLAG_INTRUSIVE 组合使用。
+     */
+    XRBT_FLAG_NOFREE = 0x00000008,
+
+    /**
+     * 共享模式：红黑树对象与其节点位于多个进程共享的内存中（如 POSIX 共享内存段），
+     * 各进程可将其映射到不同的地址（节点之间以自相对偏移量链接，参看 xrbt_lofs_t）：
+     * 1. 回调函数的地址 及 上下文标识 只在本进程内有效，不使用红黑树对象中存储的回调函数，
+     *    每个进程须先以 xrbtree_bind_callback() 绑定本进程的回调函数，才可访问红黑树；
+     *    创建红黑树的进程由创建操作自动绑定，xrbtree_emplace_destroy() 自动解除绑定；
+     * 2. 每个进程可同时绑定的共享模式红黑树数量不超过 XRBT_BIND_MAX ；
+     * 3. 不可与 XRBT_FLAG_BORROW 组合使用（所借用的索引键指针只在本进程内有效），
+     *    也不可设置 前缀值/哈希值 回调（xrbtree_set_key_hints() 返回 XRBT_FALSE）；
+     * 4. 进程间的并发访问由调用方同步（参看 xmmtree_open_shm()）。
+     */
+    XRBT_FLAG_SHARED = 0x00000010,
+} emXRBtreeFlags;
+
+/** 每个进程可同时绑定的 共享模式（XRBT_FLAG_SHARED）红黑树数量 */
+#define XRBT_BIND_MAX   16
+
+/**
+ * @struct x_rbtree_link_t
+ * @brief  侵入模式（XRBT_FLAG_INTRUSIVE）下，嵌入到调用方对象中的链接头。
+ * @note
+ * 其内存布局与内部的节点头部一致，可直接转换为 x_rbnode_iter 使用（参看 XRBT_LINK_ITER()）；
+ * 全 0 初始化的链接头即处于分离状态，停靠时由红黑树写入其余字段，调用方不可修改其内容；
+ * 链接字段存储的是自相对偏移量，须以 XRBT_LINK_GET() 读取所指向的节点。
+ */
+typedef struct x_rbtree_link_t
+{
+    xrbt_uint32_t xut_lbits;      ///< 内部使用（颜色值、索引键的存储方式、索引键偏移量）
+    xrbt_lofs_t   xiter_parent;   ///< 父节点
+    xrbt_lofs_t   xiter_left;     ///< 左子树
+    xrbt_lofs_t   xiter_right;    ///< 右子树
+} x_rbtree_link_t;
+
+/** 链接头 与 节点迭代器 的相互转换 */
+#define XRBT_LINK_ITER(xlink_ptr)   ((x_rbnode_iter)(xlink_ptr))
+#define XRBT_ITER_LINK(xiter_node)  ((x_rbtree_link_t *)(xiter_node))
+
+/** 读取链接字段（xrbt_lofs_t 左值）所指向的节点（字段为 0 时，返回 XRBT_NULL） */
+#define XRBT_LINK_GET(xlofs)                                                   \
+            ((0 == (xlofs)) ? (x_rbnode_iter)XRBT_NULL :                       \
+                (x_rbnode_iter)((xrbt_byte_t *)&(xlofs) + (xlofs)))            \
+
+/** 由成员（链接头/节点迭代器）的地址，返回其所在的调用方对象（container_of） */
+#define XRBT_CONTAINER_OF(xmember_ptr, xtype, xmember)                         \
+            ((xtype *)((xrbt_byte_t *)(xmember_ptr) - offsetof(xtype, xmember)))
+
+/** 计算 调用方对象 中，索引键成员 相对 链接头成员 的偏移量（可为负值） */
+#define XRBT_LINK_KOFFSET(xtype, xlink, xkey)                                  \
+            ((xrbt_int32_t)offsetof(xtype, xkey) - (xrbt_int32_t)offsetof(xtype, xlink))
+
+/**
+ * @struct x_rbtree_nhandle_t
+ * @brief  节点句柄：持有一个已分离出红黑树的节点（参看 xrbtree_extract()）。
+ * @note
+ * 句柄通过 xrbtree_insert_handle() 转移到其他兼容的红黑树中，
+ * 或者通过 xrbtree_handle_release() 释放；节点的释放操作使用 xtree_ptr 的回调，
+ * 因此在句柄被转移或释放之前，xtree_ptr 必须保持有效。
+ */
+typedef struct x_rbtree_nhandle_t
+{
+    x_rbtree_ptr  xtree_ptr;      ///< 节点所分离出的红黑树（空句柄时为 XRBT_NULL）
+    x_rbnode_iter xiter_node;     ///< 持有的节点（空句柄时为 XRBT_NULL）
+} xrbt_nhandle_t;
+
+/**
+ * @enum  emXRBtreeScanFlags
+ * @brief 批量区间扫描的标识（参看 xrbtree_cursor_init()）。
+ */
+typedef enum emXRBtreeScanFlags
+{
+    XRBT_SCAN_ASC  = 0x00000000, ///< 升序扫描
+    XRBT_SCAN_DESC = 0x00000001, ///< 降序扫描
+} emXRBtreeScanFlags;
+
+/**
+ * @struct x_rbtree_cursor_t
+ * @brief  批量区间扫描的游标（参看 xrbtree_scan()），调用方不可修改其内容。
+ * @note
+ * 游标记录 下一个待输出的节点 与 扫描终止的节点，两次扫描之间删除这两个节点，
+ * 会导致游标失效；插入的节点，则视其位置，可能被后续的扫描输出。
+ */
+typedef struct x_rbtree_cursor_t
+{
+    x_rbnode_iter xiter_next;     ///< 下一个待输出的节点（XRBT_NULL 表示尚未定位）
+    x_rbnode_iter xiter_stop;     ///< 扫描终止的节点（不输出）
+    xrbt_uint32_t xut_flags;      ///< 扫描标识（参看 emXRBtreeScanFlags 枚举值）
+} xrbt_cursor_t;
+
+/**
+ * @enum  emXRBtreeStatsOp
+ * @brief 操作统计信息中，分类统计 内存申请/释放 的操作类型。
+ */
+typedef enum emXRBtreeStatsOp
+{
+    XRBT_STATS_OP_INSERT = 0, ///< 插入操作（insert/try_emplace/insert_or_assign/upsert）
+    XRBT_STATS_OP_ERASE  = 1, ///< 删除操作（erase/erase_vkey/erase_range/erase_equal）
+    XRBT_STATS_OP_CLEAR  = 2, ///< 清除操作（clear/destroy）
+    XRBT_STATS_OP_NODE   = 3, ///< 分离节点的 申请/归还 操作（xrbtree_node_alloc/recycle）
+    XRBT_STATS_OP_COUNT  = 4, ///< 操作类型的数量
+} emXRBtreeStatsOp;
+
+/**
+ * @struct x_rbtree_stats_op_t
+ * @brief  单个操作类型的统计信息。
+ */
+typedef struct x_rbtree_stats_op_t
+{
+    xrbt_uint64_t xu64_calls      ; ///< 操作次数（按节点计数）
+    xrbt_uint64_t xu64_allocs     ; ///< 节点内存申请次数
+    xrbt_uint64_t xu64_frees      ; ///< 节点内存释放次数
+    xrbt_uint64_t xu64_alloc_bytes; ///< 节点内存申请字节数
+    xrbt_uint64_t xu64_free_bytes ; ///< 节点内存释放字节数
+} xrbt_stats_op_t;
+
+/**
+ * @struct x_rbtree_stats_t
+ * @brief  红黑树对象的操作统计信息（参看 xrbtree_get_stats()）。
+ */
+typedef struct x_rbtree_stats_t
+{
+    xrbt_uint64_t   xu64_compares     ; ///< 索引键比较回调的调用次数
+    xrbt_uint64_t   xu64_rotate_left  ; ///< 左旋转次数
+    xrbt_uint64_t   xu64_rotate_right ; ///< 右旋转次数
+    xrbt_uint64_t   xu64_recolors     ; ///< 修正操作中的节点改色次数
+    xrbt_uint64_t   xu64_fixup_loops  ; ///< 插入/删除 修正操作的循环次数
+    xrbt_uint64_t   xu64_rewalk_left  ; ///< 删除最左侧节点后，（以其后继节点）更新最左侧节点的次数
+    xrbt_uint64_t   xu64_rewalk_right ; ///< 删除最右侧节点后，（以其前驱节点）更新最右侧节点的次数
+    xrbt_uint64_t   xu64_searches     ; ///< 自根向下的定位操作次数
+    xrbt_uint64_t   xu64_depth_sum    ; ///< 定位操作访问的节点总数
+    xrbt_uint32_t   xut_depth_max     ; ///< 定位操作的最大深度
+    double          xdbl_depth_avg    ; ///< 定位操作的平均深度（xrbtree_get_stats() 时计算）
+    xrbt_stats_op_t xops[XRBT_STATS_OP_COUNT]; ///< 按操作类型分类的内存统计信息
+} xrbt_stats_t;
+
+/**
+ * @enum  emXRBtreeRecordOp
+ * @brief 操作记录文件中的操作类型（参看 xrbtree_record_start()）。
+ */
+typedef enum emXRBtreeRecordOp
+{
+    XRBT_RECORD_INSERT      = 1, ///< 插入操作（insert/try_emplace/insert_or_assign/upsert），带索引键
+    XRBT_RECORD_ERASE       = 2, ///< 按索引键删除（xrbtree_erase_vkey），带索引键
+    XRBT_RECORD_FIND        = 3, ///< 查找操作（xrbtree_find），带索引键
+    XRBT_RECORD_LOWER_BOUND = 4, ///< 下界定位（xrbtree_lower_bound），带索引键
+    XRBT_RECORD_BEGIN       = 5, ///< 正向遍历的起始（xrbtree_begin）
+    XRBT_RECORD_RBEGIN      = 6, ///< 反向遍历的起始（xrbtree_rbegin）
+    XRBT_RECORD_CLEAR       = 7, ///< 清除操作（xrbtree_clear）
+} emXRBtreeRecordOp;
+
+/** 操作记录文件的头部标识 */
+#define XRBT_RECORD_MAGIC   "XRBTREC1"
+
+/**
+ * @brief 序列化输出的回调函数类型（参看 xrbtree_save()）。
+ *
+ * @param [in ] xrbt_ctxt : 回调的上下文标识。
+ * @param [in ] xmt_data  : 待输出的数据。
+ * @param [in ] xst_size  : 待输出的数据字节数。
+ * 
+ * @return xrbt_bool_t
+ *         - 全部输出成功，返回 XRBT_TRUE；否则返回 XRBT_FALSE 。
+ */
+typedef xrbt_bool_t (* xfunc_stream_write_t)(
+                                xrbt_ctxt_t xrbt_ctxt,
+                                const xrbt_void_t * xmt_data,
+                                xrbt_size_t xst_size);
+
+/**
+ * @brief 序列化输入的回调函数类型（参看 xrbtree_load()）。
+ *
+ * @param [in ] xrbt_ctxt : 回调的上下文标识。
+ * @param [out] xmt_buf   : 读取数据的缓存。
+ * @param [in ] xst_size  : 缓存的字节数。
+ * 
+ * @return xrbt_size_t
+ *         - 返回读取到的字节数（小于 xst_size 时，表示已到数据末尾或读取失败）。
+ */
+typedef xrbt_size_t (* xfunc_stream_read_t)(
+                                xrbt_ctxt_t xrbt_ctxt,
+                                xrbt_void_t * xmt_buf,
+                                xrbt_size_t xst_size);
+
+/**
+ * @enum  emXRBtreeSaveEncode
+ * @brief 序列化数据中索引键的编码方式（参看 xrbtree_save()）。
+ */
+typedef enum emXRBtreeSaveEncode
+{
+    XRBT_SAVE_RAW   = 0, ///< 按索引键的原始字节存储
+    XRBT_SAVE_DELTA = 1, ///< 4/8 字节的整数索引键，存储与前一索引键的差值（zigzag + LEB128 变长编码）
+} emXRBtreeSaveEncode;
+
+/** 序列化数据的头部标识 */
+#define XRBT_SAVE_MAGIC     "XRBTSAV1"
+
 //====================================================================
 
 // 
@@ -181,209 +517,992 @@ x_rbtree_ptr xrbtree_create(xrbt_size_t xst_ksize, xrbt_callback_t * xcallback);
 
 /**********************************************************/
 /**
- * @brief 销毁 x_rbtree_t 对象。
+ * @brief 创建 映射表模式（节点同时存储 索引键 与 值数据）的 x_rbtree_t 对象。
+ * @note
+ * 值数据 不参与节点的比较操作；xvcallback 为 XRBT_NULL 或者
+ * 某个回调函数为 XRBT_NULL 时，则取内部默认值（按字节拷贝，默认值为全 0）。
+ * 
+ * @param [in ] xst_ksize  : 索引键数据类型所需的缓存大小（如 sizeof 值）。
+ * @param [in ] xst_vsize  : 值数据类型所需的缓存大小（为 0 时，等同于 xrbtree_create()）。
+ * @param [in ] xcallback  : 节点操作的相关回调函数。
+ * @param [in ] xvcallback : 节点值数据的相关回调函数。
+ * 
+ * @return x_rbtree_ptr
+ *         - 成功，返回 x_rbtree_t 对象；
+ *         - 失败，返回 XRBT_NULL；
  */
-xrbt_void_t xrbtree_destroy(x_rbtree_ptr xthis_ptr);
+x_rbtree_ptr xrbtree_create_kv(xrbt_size_t xst_ksize,
+                               xrbt_size_t xst_vsize,
+                               xrbt_callback_t * xcallback,
+                               xrbt_vcallback_t * xvcallback);
 
 /**********************************************************/
 /**
- * @brief 在已开辟 x_rbtree_t 对象缓存的位置上创建 x_rbtree_t 对象。
- * @note  xthis_ptr 的缓存大小必须大于等于 sizeof(x_rbtree_t) 值。
+ * @brief 创建 x_rbtree_t 对象（可指定模式标识）。
+ * 
+ * @param [in ] xst_ksize  : 索引键数据类型所需的缓存大小（如 sizeof 值）。
+ * @param [in ] xst_vsize  : 值数据类型所需的缓存大小（为 0 时，不使用映射表模式）。
+ * @param [in ] xut_flags  : 模式标识（参看 emXRBtreeFlags 枚举值）。
+ * @param [in ] xcallback  : 节点操作的相关回调函数。
+ * @param [in ] xvcallback : 节点值数据的相关回调函数。
+ * 
+ * @return x_rbtree_ptr
+ *         - 成功，返回 x_rbtree_t 对象；
+ *         - 失败，返回 XRBT_NULL；
  */
-x_rbtree_ptr xrbtree_emplace_create(x_rbtree_ptr xthis_ptr,
-                                    xrbt_size_t xst_ksize,
-                                    xrbt_callback_t * xcallback);
+x_rbtree_ptr xrbtree_create_ex(xrbt_size_t xst_ksize,
+                               xrbt_size_t xst_vsize,
+                               xrbt_uint32_t xut_flags,
+                               xrbt_callback_t * xcallback,
+                               xrbt_vcallback_t * xvcallback);
 
 /**********************************************************/
 /**
- * @brief 在已开辟 x_rbtree_t 对象缓存的位置上销毁 x_rbtree_t 对象。
+ * @brief 销毁 x_rbtree_t 对象。
  */
-xrbt_void_t xrbtree_emplace_destroy(x_rbtree_ptr xthis_ptr);
+xrbt_void_t xrbtree_destroy(x_rbtree_ptr xthis_ptr);
 
 /**********************************************************/
 /**
- * @brief 清除 x_rbtree_t 对象中的所有节点。
+ * @brief 在已开辟 x_rbtree_t 对象缓存的位置上创建 x_rbtree_t 对象。
+ * @note  xthis_ptr 的缓存大小必须大于等于 sizeof(x_rbtree_t) 值。
  */
-xrbt_void_t xrbtree_clear(x_rbtree_ptr xthis_ptr);
+x_rbtree_ptr xrbtree_emplace_create(x_rbtree_ptr xthis_ptr,
+                                    xrbt_size_t xst_ksize,
+                                    xrbt_callback_t * xcallback);
 
 /**********************************************************/
 /**
- * @brief 返回 x_rbtree_t 对象中的节点数量。
+ * @brief 在已开辟 x_rbtree_t 对象缓存的位置上创建 映射表模式 的 x_rbtree_t 对象。
+ * @note  参数说明参看 @see xrbtree_create_kv() 。
  */
-xrbt_size_t xrbtree_size(x_rbtree_ptr xthis_ptr);
+x_rbtree_ptr xrbtree_emplace_create_kv(x_rbtree_ptr xthis_ptr,
+                                       xrbt_size_t xst_ksize,
+                                       xrbt_size_t xst_vsize,
+                                       xrbt_callback_t * xcallback,
+                                       xrbt_vcallback_t * xvcallback);
 
 /**********************************************************/
 /**
- * @brief 判断 x_rbtree_t 对象中节点数量是否为空。
+ * @brief 在已开辟 x_rbtree_t 对象缓存的位置上创建 x_rbtree_t 对象（可指定模式标识）。
+ * @note
+ * 参数说明参看 @see xrbtree_create_ex() ；共享模式（XRBT_FLAG_SHARED）下，
+ * 本进程绑定的红黑树数量已达到 XRBT_BIND_MAX 时，返回 XRBT_NULL 。
  */
-xrbt_bool_t xrbtree_empty(x_rbtree_ptr xthis_ptr);
+x_rbtree_ptr xrbtree_emplace_create_ex(x_rbtree_ptr xthis_ptr,
+                                       xrbt_size_t xst_ksize,
+                                       xrbt_size_t xst_vsize,
+                                       xrbt_uint32_t xut_flags,
+                                       xrbt_callback_t * xcallback,
+                                       xrbt_vcallback_t * xvcallback);
 
 /**********************************************************/
 /**
- * @brief 返回 x_rbtree_t 对象中的左手臂长度。
+ * @brief 创建 侵入模式（XRBT_FLAG_INTRUSIVE）的 x_rbtree_t 对象。
+ * @note
+ * 节点的索引键值为 (xrbt_byte_t *)链接头 + xit_koffset 所指向的 xst_ksize 个字节，
+ * 比较操作的两侧都直接引用调用方对象中的数据；若需比较整个调用方对象，
+ * 可令 xit_koffset 为 -offsetof(对象类型, 链接头)，xst_ksize 为 sizeof(对象类型)。
+ * 使用 xrbtree_create_ex() 指定 XRBT_FLAG_INTRUSIVE 时，索引键紧随链接头之后
+ * （即 xit_koffset 为 sizeof(x_rbtree_link_t)）。
+ * 
+ * @param [in ] xst_ksize   : 索引键数据类型所需的缓存大小（如 sizeof 值）。
+ * @param [in ] xit_koffset : 索引键相对链接头的偏移量（参看 XRBT_LINK_KOFFSET()）。
+ * @param [in ] xut_flags   : 模式标识（可组合 XRBT_FLAG_MULTI，XRBT_FLAG_INTRUSIVE 总是被设置）。
+ * @param [in ] xcallback   : 节点操作的相关回调函数（只使用 xfunc_k_compare 与 xctxt_t_callback）。
+ * 
+ * @return x_rbtree_ptr
+ *         - 成功，返回 x_rbtree_t 对象；
+ *         - 失败，返回 XRBT_NULL；
  */
-xrbt_size_t xrbtree_left_length(x_rbtree_ptr xthis_ptr);
+x_rbtree_ptr xrbtree_create_intrusive(xrbt_size_t xst_ksize,
+                                      xrbt_int32_t xit_koffset,
+                                      xrbt_uint32_t xut_flags,
+                                      xrbt_callback_t * xcallback);
 
 /**********************************************************/
 /**
- * @brief 返回 x_rbtree_t 对象中的右手臂长度。
+ * @brief 在已开辟 x_rbtree_t 对象缓存的位置上创建 侵入模式 的 x_rbtree_t 对象。
+ * @note  参数说明参看 @see xrbtree_create_intrusive() 。
  */
-xrbt_size_t xrbtree_right_length(x_rbtree_ptr xthis_ptr);
+x_rbtree_ptr xrbtree_emplace_create_intrusive(x_rbtree_ptr xthis_ptr,
+                                              xrbt_size_t xst_ksize,
+                                              xrbt_int32_t xit_koffset,
+                                              xrbt_uint32_t xut_flags,
+                                              xrbt_callback_t * xcallback);
 
 /**********************************************************/
 /**
- * @brief 向 x_rbtree_t 对象插入新节点。
- * @note  回调设置索引键值时，不使用 move 操作方式。
+ * @brief 重新挂接 整体移动（或跨进程映射）后的 x_rbtree_t 对象（O(1)）。
+ * @note
+ * 用于 x_rbtree_t 对象与其全部节点位于同一内存区域（如 mmap 映射的文件），
+ * 且该区域被整体映射到新地址（或由新的进程重新映射）的场合：
+ * 1. 节点之间以自相对偏移量链接（参看 xrbt_lofs_t），区域的地址发生变化时无须重定位；
+ * 2. 回调函数的地址跨进程后不再有效，须重新设置（参数含义参看 xrbtree_emplace_create_ex()、
+ *    xrbtree_set_key_hints()），前缀值回调是否为 XRBT_NULL 须与原先一致；
+ * 3. 操作统计信息被重置，操作记录被停止（不关闭原先的记录文件）；
+ * 4. 共享模式（XRBT_FLAG_SHARED）下，红黑树对象正被其他进程使用，不改写其中的任何数据，
+ *    只为本进程绑定回调函数（参看 xrbtree_bind_callback()，xfunc_k_prefix、xfunc_k_hash 须为 XRBT_NULL）。
+ * 借用索引键模式下，所借用的索引键指针不重定位（参看 xrbtree_rebase_keys()）。
  * 
- * @param [in ] xthis_ptr : 红黑树对象。
- * @param [in ] xrbt_vkey : 新节点的索引键值。
- * @param [out] xbt_ok    : 返回操作成功的标识。
+ * @param [in ] xthis_ptr      : 红黑树对象（当前所在的地址）。
+ * @param [in ] xcallback      : 节点操作的相关回调函数。
+ * @param [in ] xvcallback     : 节点值数据的相关回调函数。
+ * @param [in ] xfunc_k_prefix : 计算索引键前缀值的回调函数。
+ * @param [in ] xfunc_k_hash   : 计算索引键哈希值的回调函数。
  * 
- * @return x_rbnode_iter
- *         - 返回对应节点。
+ * @return x_rbtree_ptr
+ *         - 成功，返回 xthis_ptr ；
+ *         - 失败，返回 XRBT_NULL（共享模式下，本进程绑定的红黑树数量已达到 XRBT_BIND_MAX）。
  */
-x_rbnode_iter xrbtree_insert(
-    x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey, xrbt_bool_t * xbt_ok);
+x_rbtree_ptr xrbtree_emplace_reattach(x_rbtree_ptr xthis_ptr,
+                                      xrbt_callback_t * xcallback,
+                                      xrbt_vcallback_t * xvcallback,
+                                      xfunc_vkey_prefix_t xfunc_k_prefix,
+                                      xfunc_vkey_hash_t xfunc_k_hash);
 
 /**********************************************************/
 /**
- * @brief 向 x_rbtree_t 对象插入新节点。
- * @note  回调设置索引键值时，使用 move 操作方式。
+ * @brief 共享模式（XRBT_FLAG_SHARED）下，为本进程绑定红黑树所使用的回调函数。
+ * @note
+ * 绑定记录在本进程内（以 x_rbtree_t 对象在本进程中的地址区分），不改写红黑树对象；
+ * 已绑定时，替换原先的绑定。绑定、解除绑定 操作之间须由调用方互斥，
+ * 且不可与 本进程中访问同一红黑树对象的操作 并发。
  * 
- * @param [in ] xthis_ptr : 红黑树对象。
- * @param [in ] xrbt_mkey : 新节点的索引键值。
- * @param [out] xbt_ok    : 返回操作成功的标识。
+ * @param [in ] xthis_ptr  : 红黑树对象（本进程中的地址）。
+ * @param [in ] xcallback  : 节点操作的相关回调函数（参看 xrbtree_emplace_create_ex()）。
+ * @param [in ] xvcallback : 节点值数据的相关回调函数。
  * 
- * @return x_rbnode_iter
- *         - 返回对应节点。
+ * @return xrbt_bool_t
+ *         - 成功，返回 XRBT_TRUE；
+ *         - 失败，返回 XRBT_FALSE（本进程绑定的红黑树数量已达到 XRBT_BIND_MAX）。
  */
-x_rbnode_iter xrbtree_insert_mkey(
-    x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_mkey, xrbt_bool_t * xbt_ok);
+xrbt_bool_t xrbtree_bind_callback(x_rbtree_ptr xthis_ptr,
+                                  xrbt_callback_t * xcallback,
+                                  xrbt_vcallback_t * xvcallback);
 
 /**********************************************************/
 /**
- * @brief 从 x_rbtree_t 对象中删除指定节点。
+ * @brief 共享模式（XRBT_FLAG_SHARED）下，解除本进程对红黑树的回调函数绑定。
+ * @note  用于本进程不再访问（如 解除映射）红黑树对象、而其他进程继续使用的场合。
  */
-xrbt_void_t xrbtree_erase(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node);
+xrbt_void_t xrbtree_unbind_callback(x_rbtree_ptr xthis_ptr);
 
 /**********************************************************/
 /**
- * @brief 从 x_rbtree_t 对象中删除指定节点。
+ * @brief 在已开辟 x_rbtree_t 对象缓存的位置上销毁 x_rbtree_t 对象。
  */
-xrbt_bool_t xrbtree_erase_vkey(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey);
+xrbt_void_t xrbtree_emplace_destroy(x_rbtree_ptr xthis_ptr);
 
 /**********************************************************/
 /**
- * @brief 将节点对象停靠（插入）到红黑树中。
- * @note
- * xiter_node 必须处于分离状态（参看 @see xrbtree_iter_is_undocked()），
- * 而且其索引键必须 与 xthis_ptr 存储的节点索引键类型相同。
- * 
- * @param [in ] xthis_ptr  : 红黑树对象。
- * @param [in ] xiter_node : 停靠操作的节点对象。
- * 
- * @return x_rbnode_iter
- *         - 返回的 节点对象 == xiter_node，停靠成功。
- *         - 返回的 节点对象 != xiter_node，停靠失败（索引键值冲突）。
+ * @brief 清除 x_rbtree_t 对象中的所有节点。
+ * @note  侵入模式下，只将所有链接头置为分离状态（O(n) 遍历），不释放调用方对象。
  */
-x_rbnode_iter xrbtree_dock(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node);
+xrbt_void_t xrbtree_clear(x_rbtree_ptr xthis_ptr);
 
 /**********************************************************/
 /**
- * @brief 将节点对象从红黑树中分离（移除）出来。
- * @note xiter_node 必须 已经隶属于 xthis_ptr 。
- * 
- * @param [in ] xthis_ptr  : 红黑树对象。
- * @param [in ] xiter_node : 分离操作的节点对象。
+ * @brief 分步清除 x_rbtree_t 对象中的所有节点（用于事件循环等不可长时间阻塞的场合）。
+ * @note
+ * 1. 没有待释放的节点时，先以 O(1) 的方式将所有节点分离为 待释放的节点，
+ *    x_rbtree_t 对象随即为空，可继续进行插入等操作（新插入的节点不受本次清除影响）；
+ * 2. 每次调用至多执行 xst_budget 步（每步释放一个节点，或进行一次旋转操作），
+ *    不使用递归，全部释放完成的总步数不超过 2n ；
+ * 3. xst_budget 为 0 时，不执行任何操作，只返回待释放的节点数量；
+ * 4. xrbtree_clear() 与 xrbtree_destroy() 会释放剩余的待释放节点。
  * 
- * @return x_rbnode_iter
- *         - 返回的 节点对象 == xiter_node。
+ * @return xrbt_size_t
+ *         - 返回剩余的待释放节点数量（返回 0 表示清除已完成）。
  */
-x_rbnode_iter xrbtree_undock(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node);
+xrbt_size_t xrbtree_clear_step(x_rbtree_ptr xthis_ptr, xrbt_size_t xst_budget);
 
 /**********************************************************/
 /**
- * @brief 在 x_rbtree_t 对象中查找指定节点。
- * @note  若返回 NIL 则表示 x_rbtree_t 对象不包含该节点键值。
+ * @brief 以 O(1) 的方式，将 x_rbtree_t 对象中的所有节点（含分步清除中待释放的节点），
+ *        转移到新创建的 回收对象 中，x_rbtree_t 对象随即为空。
+ * @note
+ * 回收对象 为一个空的 x_rbtree_t 对象（使用原对象的回调函数），持有待释放的节点，
+ * 由 xrbtree_clear_step() 分步释放，或由 xrbtree_destroy() 一次性释放并销毁；
+ * 释放节点时只访问节点本身，不访问原对象（原对象可被继续使用或销毁），
+ * 因此可交由其他线程执行（此时，回调函数须可在其他线程中调用）。
+ * 
+ * @return x_rbtree_ptr
+ *         - 返回 回收对象；
+ *         - 没有需要释放的节点时（如 XRBT_FLAG_NOFREE 模式下无须析构），
+ *           按 xrbtree_clear() 的方式清除后，返回 XRBT_NULL 。
  */
-x_rbnode_iter xrbtree_find(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey);
+x_rbtree_ptr xrbtree_detach(x_rbtree_ptr xthis_ptr);
 
 /**********************************************************/
 /**
- * @brief 返回的是首个不小于 指定索引键值 的 节点位置。
+ * @brief 返回 x_rbtree_t 对象中的节点数量。
  */
-x_rbnode_iter xrbtree_lower_bound(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey);
+xrbt_size_t xrbtree_size(x_rbtree_ptr xthis_ptr);
 
 /**********************************************************/
 /**
- * @brief 返回的是首个大于 指定索引键值 的 节点位置。
+ * @brief 判断 x_rbtree_t 对象中节点数量是否为空。
  */
-x_rbnode_iter xrbtree_upper_bound(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey);
+xrbt_bool_t xrbtree_empty(x_rbtree_ptr xthis_ptr);
 
 /**********************************************************/
 /**
- * @brief 返回 x_rbtree_t 对象的根节点。
+ * @brief 返回 x_rbtree_t 对象创建时所指定的模式标识（参看 emXRBtreeFlags 枚举值）。
  */
-x_rbnode_iter xrbtree_root(x_rbtree_ptr xthis_ptr);
+xrbt_uint32_t xrbtree_flags(x_rbtree_ptr xthis_ptr);
 
 /**********************************************************/
 /**
- * @brief 返回 x_rbtree_t 对象的正向遍历操作的起始节点。
+ * @brief 返回 x_rbtree_t 对象中节点值数据的缓存大小（非映射表模式时为 0）。
  */
-x_rbnode_iter xrbtree_begin(x_rbtree_ptr xthis_ptr);
+xrbt_size_t xrbtree_vsize(x_rbtree_ptr xthis_ptr);
 
 /**********************************************************/
 /**
- * @brief 返回 x_rbtree_t 对象的正向遍历操作的终止节点。
+ * @brief 设置节点内联存储的 索引键前缀值 与 哈希值 的计算回调函数。
+ * @note
+ * 只可在 x_rbtree_t 对象为空时设置，参数可为 XRBT_NULL（不使用对应的快速比较方式）；
+ * 前缀值 存储于节点头部，定位操作时先比较前缀值，前缀值相同时才回调完整的比较操作；
+ * 哈希值 只在借用索引键模式（XRBT_FLAG_BORROW）下存储，其他模式下忽略。
+ * 
+ * @param [in ] xthis_ptr      : 红黑树对象。
+ * @param [in ] xfunc_k_prefix : 计算索引键前缀值的回调函数。
+ * @param [in ] xfunc_k_hash   : 计算索引键哈希值的回调函数。
+ * 
+ * @return xrbt_bool_t
+ *         - 成功，返回 XRBT_TRUE；
+ *         - 失败，返回 XRBT_FALSE（x_rbtree_t 对象不为空）。
  */
-x_rbnode_iter xrbtree_end(x_rbtree_ptr xthis_ptr);
+xrbt_bool_t xrbtree_set_key_hints(x_rbtree_ptr xthis_ptr,
+                                  xfunc_vkey_prefix_t xfunc_k_prefix,
+                                  xfunc_vkey_hash_t xfunc_k_hash);
 
 /**********************************************************/
 /**
- * @brief 返回（正向）下一个节点对象。
+ * @brief 按字节序计算索引键前缀值（取前 8 字节，以大端序组成整数，不足 8 字节时补 0）。
+ * @note
+ * 可作为 xrbtree_set_key_hints() 的前缀值回调，
+ * 适用于按无符号字节逐个比较的索引键（如默认的比较操作、memcmp 排序的字节串）。
  */
-x_rbnode_iter xrbtree_next(x_rbnode_iter xiter_node);
+xrbt_uint64_t xrbtree_vkey_prefix_bytes(xrbt_vkey_t xrbt_vkey,
+                                        xrbt_size_t xrbt_size,
+                                        xrbt_ctxt_t xrbt_ctxt);
 
 /**********************************************************/
 /**
- * @brief 返回 x_rbtree_t 对象的反向遍历操作的起始节点。
+ * @brief 借用索引键模式下，批量重定位节点所借用的索引键指针（O(n) 遍历）。
+ * @note
+ * 所有位于 [xold_base, xold_end) 中的索引键指针，按相同偏移量重定位到 xnew_base 起始的区域，
+ * 新区域中的索引键内容必须与原区域相同。
+ * 
+ * @param [in ] xthis_ptr : 红黑树对象（必须以 XRBT_FLAG_BORROW 模式创建）。
+ * @param [in ] xold_base : 原内存区域的起始地址。
+ * @param [in ] xold_end  : 原内存区域的结束地址。
+ * @param [in ] xnew_base : 新内存区域的起始地址。
+ * 
+ * @return xrbt_size_t
+ *         - 返回重定位的节点数量。
  */
-x_rbnode_iter xrbtree_rbegin(x_rbtree_ptr xthis_ptr);
+xrbt_size_t xrbtree_rebase_keys(x_rbtree_ptr xthis_ptr,
+                                xrbt_vkey_t xold_base,
+                                xrbt_vkey_t xold_end,
+                                xrbt_vkey_t xnew_base);
 
 /**********************************************************/
 /**
- * @brief 返回 x_rbtree_t 对象的反向遍历操作的终止节点。
+ * @brief 获取 x_rbtree_t 对象的操作统计信息。
+ * @note
+ * 只有在编译 xrbtree.c 时定义 XRBTREE_ENABLE_STATS 为 1 才会进行统计，
+ * 否则 xstats_ptr 被填充为全 0，并返回 XRBT_FALSE 。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [out] xstats_ptr : 返回的统计信息。
+ * 
+ * @return xrbt_bool_t
+ *         - 是否开启了统计功能。
  */
-x_rbnode_iter xrbtree_rend(x_rbtree_ptr xthis_ptr);
+xrbt_bool_t xrbtree_get_stats(x_rbtree_ptr xthis_ptr, xrbt_stats_t * xstats_ptr);
 
 /**********************************************************/
 /**
- * @brief 返回（反向）下一个节点对象。
+ * @brief 重置 x_rbtree_t 对象的操作统计信息。
  */
-x_rbnode_iter xrbtree_rnext(x_rbnode_iter xiter_node);
+xrbt_void_t xrbtree_reset_stats(x_rbtree_ptr xthis_ptr);
 
 /**********************************************************/
 /**
- * @brief 返回 节点对象 指向的索引键值。
+ * @brief 开始记录 x_rbtree_t 对象的操作（写入二进制的操作记录文件）。
+ * @note
+ * 只有在编译 xrbtree.c 时定义 XRBTREE_ENABLE_RECORD 为 1 才可使用，否则总是返回 XRBT_FALSE 。
+ * 文件格式（字节序为本机字节序）：
+ * 1. 文件头：8 字节的 XRBT_RECORD_MAGIC，4 字节的 索引键大小，4 字节的 模式标识；
+ * 2. 每条记录：1 字节的操作类型（emXRBtreeRecordOp），
+ *    与上一条记录的时间间隔（纳秒，LEB128 变长编码），
+ *    带索引键的操作再跟随 索引键大小 个字节的索引键内容（xrbt_vkey 所指向的原始字节）。
+ * 只有索引键为平凡类型（可按字节拷贝）时，记录的索引键内容才可脱机重放；
+ * xrbtree_next()/xrbtree_rnext() 不持有红黑树对象，不进行记录。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [in ] xszt_path  : 操作记录文件的路径（已存在时覆盖）。
+ * 
+ * @return xrbt_bool_t
+ *         - 成功，返回 XRBT_TRUE；
+ *         - 失败，返回 XRBT_FALSE 。
  */
-xrbt_vkey_t xrbtree_iter_vkey(x_rbnode_iter xiter_node);
+xrbt_bool_t xrbtree_record_start(x_rbtree_ptr xthis_ptr, const char * xszt_path);
 
 /**********************************************************/
 /**
- * @brief 判断 节点对象 是否为 NIL 。
+ * @brief 停止记录 x_rbtree_t 对象的操作（关闭操作记录文件）。
+ * @note  销毁 x_rbtree_t 对象时，会自动停止记录。
  */
-xrbt_bool_t xrbtree_iter_is_nil(x_rbnode_iter xiter_node);
+xrbt_void_t xrbtree_record_stop(x_rbtree_ptr xthis_ptr);
 
 /**********************************************************/
 /**
- * @brief 判断 节点对象 是否为 非停靠状态（即其已被分离出红黑树）。
+ * @brief 将 x_rbtree_t 对象按索引键顺序序列化输出。
+ * @note
+ * 数据格式（字节序为本机字节序）：
+ * 1. 头部：8 字节的 XRBT_SAVE_MAGIC，4 字节的 索引键大小，4 字节的 值数据大小，
+ *    4 字节的 模式标识（只保留 XRBT_FLAG_MULTI），4 字节的 编码方式（emXRBtreeSaveEncode），
+ *    8 字节的 节点数量；
+ * 2. 按索引键顺序排列的各个节点：索引键内容（XRBT_SAVE_RAW 为原始字节，
+ *    XRBT_SAVE_DELTA 为变长编码的差值），映射表模式下再跟随 值数据大小 个字节的值数据；
+ * 3. 尾部：8 字节的校验值（对 头部 与 节点数据 计算的 FNV-1a 64 位哈希值）。
+ * 只有 索引键/值数据 为平凡类型（可按字节拷贝）时，序列化数据才可重新加载；
+ * 借用索引键模式、侵入模式 不支持序列化操作。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [in ] xfunc_write: 序列化输出的回调函数。
+ * @param [in ] xrbt_ctxt  : 回调的上下文标识。
+ * @param [in ] xut_encode : 索引键的编码方式（索引键大小不为 4/8 字节时，退化为 XRBT_SAVE_RAW）。
+ * 
+ * @return xrbt_bool_t
+ *         - 成功，返回 XRBT_TRUE；
+ *         - 失败，返回 XRBT_FALSE 。
  */
-xrbt_bool_t xrbtree_iter_is_undocked(x_rbnode_iter xiter_node);
+xrbt_bool_t xrbtree_save(x_rbtree_ptr xthis_ptr,
+                         xfunc_stream_write_t xfunc_write,
+                         xrbt_ctxt_t xrbt_ctxt,
+                         xrbt_uint32_t xut_encode);
 
 /**********************************************************/
 /**
- * @brief 返回 节点对象 所隶属的红黑树。
- * @note  内部会进行节点遍历操作，使用时应注重效率问题。
+ * @brief 从 xrbtree_save() 输出的序列化数据中加载 x_rbtree_t 对象的节点。
+ * @note
+ * 加载前会清除红黑树中原有的节点；数据分块读取，节点按索引键顺序直接构建为平衡的红黑树，
+ * 过程中不调用比较回调，也无须旋转操作（O(n)）；索引键/值数据 经由拷贝回调构造。
+ * 索引键大小、值数据大小 须与红黑树一致，且非 XRBT_FLAG_MULTI 模式的红黑树
+ * 不可加载 XRBT_FLAG_MULTI 模式输出的数据；读取失败、校验失败、申请节点内存失败时，
+ * 红黑树被清空。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [in ] xfunc_read : 序列化输入的回调函数。
+ * @param [in ] xrbt_ctxt  : 回调的上下文标识。
+ * 
+ * @return xrbt_bool_t
+ *         - 成功，返回 XRBT_TRUE；
+ *         - 失败，返回 XRBT_FALSE 。
+ */
+xrbt_bool_t xrbtree_load(x_rbtree_ptr xthis_ptr,
+                         xfunc_stream_read_t xfunc_read,
+                         xrbt_ctxt_t xrbt_ctxt);
+
+/**********************************************************/
+/**
+ * @brief 将 x_rbtree_t 对象序列化输出到文件（参看 xrbtree_save()）。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [in ] xszt_path  : 文件路径（已存在时覆盖）。
+ * @param [in ] xut_encode : 索引键的编码方式（参看 emXRBtreeSaveEncode）。
+ * 
+ * @return xrbt_bool_t
+ *         - 成功，返回 XRBT_TRUE；
+ *         - 失败，返回 XRBT_FALSE 。
+ */
+xrbt_bool_t xrbtree_save_file(x_rbtree_ptr xthis_ptr,
+                              const char * xszt_path,
+                              xrbt_uint32_t xut_encode);
+
+/**********************************************************/
+/**
+ * @brief 从文件中加载 x_rbtree_t 对象的节点（参看 xrbtree_load()）。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [in ] xszt_path  : 文件路径。
+ * 
+ * @return xrbt_bool_t
+ *         - 成功，返回 XRBT_TRUE；
+ *         - 失败，返回 XRBT_FALSE 。
+ */
+xrbt_bool_t xrbtree_load_file(x_rbtree_ptr xthis_ptr, const char * xszt_path);
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象中的左手臂长度。
+ */
+xrbt_size_t xrbtree_left_length(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象中的右手臂长度。
+ */
+xrbt_size_t xrbtree_right_length(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 向 x_rbtree_t 对象插入新节点。
+ * @note  回调设置索引键值时，不使用 move 操作方式。
+ * 
+ * @param [in ] xthis_ptr : 红黑树对象。
+ * @param [in ] xrbt_vkey : 新节点的索引键值。
+ * @param [out] xbt_ok    : 返回操作成功的标识。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回对应节点；
+ *         - 申请节点内存失败时，返回 xrbtree_end()（xbt_ok 为 XRBT_FALSE）。
+ */
+x_rbnode_iter xrbtree_insert(
+    x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey, xrbt_bool_t * xbt_ok);
+
+/**********************************************************/
+/**
+ * @brief 向 x_rbtree_t 对象插入新节点。
+ * @note  回调设置索引键值时，使用 move 操作方式。
+ * 
+ * @param [in ] xthis_ptr : 红黑树对象。
+ * @param [in ] xrbt_mkey : 新节点的索引键值。
+ * @param [out] xbt_ok    : 返回操作成功的标识。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回对应节点；
+ *         - 申请节点内存失败时，返回 xrbtree_end()（xbt_ok 为 XRBT_FALSE）。
+ */
+x_rbnode_iter xrbtree_insert_mkey(
+    x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_mkey, xrbt_bool_t * xbt_ok);
+
+/**********************************************************/
+/**
+ * @brief 向 映射表模式 的 x_rbtree_t 对象插入新节点（索引键 + 值数据）。
+ * @note
+ * 回调设置 索引键 与 值数据 时，不使用 move 操作方式；
+ * 若索引键已存在，则不对 索引键 与 值数据 做任何操作（即 try_emplace 语义）；
+ * 若 xrbt_vval 为 XRBT_NULL，新节点的值数据按默认值构造。
+ * 
+ * @param [in ] xthis_ptr : 红黑树对象。
+ * @param [in ] xrbt_vkey : 新节点的索引键值。
+ * @param [in ] xrbt_vval : 新节点的值数据。
+ * @param [out] xbt_ok    : 返回操作成功的标识（索引键已存在时为 XRBT_FALSE）。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回对应节点；
+ *         - 申请节点内存失败时，返回 xrbtree_end()（xbt_ok 为 XRBT_FALSE）。
+ */
+x_rbnode_iter xrbtree_try_emplace(x_rbtree_ptr xthis_ptr,
+                                  xrbt_vkey_t xrbt_vkey,
+                                  xrbt_vval_t xrbt_vval,
+                                  xrbt_bool_t * xbt_ok);
+
+/**********************************************************/
+/**
+ * @brief 向 映射表模式 的 x_rbtree_t 对象插入新节点（索引键 + 值数据）。
+ * @note
+ * 与 @see xrbtree_try_emplace() 相同，但回调设置 索引键 与 值数据 时，使用 move 操作方式；
+ * 索引键已存在时，xrbt_mkey 与 xrbt_mval 都不会被 move 。
+ */
+x_rbnode_iter xrbtree_try_emplace_mkey(x_rbtree_ptr xthis_ptr,
+                                       xrbt_vkey_t xrbt_mkey,
+                                       xrbt_vval_t xrbt_mval,
+                                       xrbt_bool_t * xbt_ok);
+
+/**********************************************************/
+/**
+ * @brief 向 映射表模式 的 x_rbtree_t 对象插入新节点，若索引键已存在，则覆盖其值数据。
+ * @note
+ * 回调设置 索引键 与 值数据 时，不使用 move 操作方式；
+ * 覆盖值数据时，先析构原有的值数据，再拷贝新的值数据（索引键保持不变）。
+ * 
+ * @param [in ] xthis_ptr : 红黑树对象。
+ * @param [in ] xrbt_vkey : 节点的索引键值。
+ * @param [in ] xrbt_vval : 节点的值数据。
+ * @param [out] xbt_ok    : 返回的标识（XRBT_TRUE 为插入新节点，XRBT_FALSE 为覆盖值数据）。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回对应节点；
+ *         - 申请节点内存失败时，返回 xrbtree_end()（xbt_ok 为 XRBT_FALSE）。
+ */
+x_rbnode_iter xrbtree_insert_or_assign(x_rbtree_ptr xthis_ptr,
+                                       xrbt_vkey_t xrbt_vkey,
+                                       xrbt_vval_t xrbt_vval,
+                                       xrbt_bool_t * xbt_ok);
+
+/**********************************************************/
+/**
+ * @brief 与 @see xrbtree_insert_or_assign() 相同，但回调设置数据时，使用 move 操作方式。
+ */
+x_rbnode_iter xrbtree_insert_or_assign_mkey(x_rbtree_ptr xthis_ptr,
+                                            xrbt_vkey_t xrbt_mkey,
+                                            xrbt_vval_t xrbt_mval,
+                                            xrbt_bool_t * xbt_ok);
+
+/**********************************************************/
+/**
+ * @brief 单次定位的 插入/更新 操作（upsert）。
+ * @note
+ * 只进行一次自根向下的定位操作（不会二次查找）：
+ * 若索引键值不存在，则插入新节点（拷贝索引键值，映射表模式下值数据按默认值构造），
+ * 再回调 xfunc_init 初始化新节点；否则回调 xfunc_merge 合并到已有节点。
+ * xfunc_init 或 xfunc_merge 为 XRBT_NULL 时，忽略对应的回调操作。
+ * 
+ * @param [in ] xthis_ptr   : 红黑树对象。
+ * @param [in ] xrbt_vkey   : 索引键值。
+ * @param [in ] xfunc_init  : 初始化新节点的回调函数。
+ * @param [in ] xfunc_merge : 合并已有节点的回调函数。
+ * @param [in ] xrbt_ctxt   : 回调的上下文标识。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回对应节点（新节点 或 已有节点）；
+ *         - 申请节点内存失败时，返回 xrbtree_end()（不回调 xfunc_init/xfunc_merge）。
+ */
+x_rbnode_iter xrbtree_upsert(x_rbtree_ptr xthis_ptr,
+                             xrbt_vkey_t xrbt_vkey,
+                             xfunc_node_upsert_t xfunc_init,
+                             xfunc_node_upsert_t xfunc_merge,
+                             xrbt_ctxt_t xrbt_ctxt);
+
+/**********************************************************/
+/**
+ * @brief 从 x_rbtree_t 对象中删除指定节点。
+ */
+xrbt_void_t xrbtree_erase(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node);
+
+/**********************************************************/
+/**
+ * @brief 从 x_rbtree_t 对象中删除指定节点。
+ */
+xrbt_bool_t xrbtree_erase_vkey(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey);
+
+/**********************************************************/
+/**
+ * @brief 从 x_rbtree_t 对象中删除 [xiter_first, xiter_last) 区间内的所有节点。
+ * @note
+ * xiter_last 可为 xrbtree_end() ；整棵树被删除时，按 xrbtree_clear() 方式处理；
+ * xiter_first 为 xrbtree_begin() 、且删除的节点数量 k 超过 log2(n) 时，
+ * 删除的前段被整体分离，耗时为 O(k + log n) 。
+ * 
+ * @return xrbt_size_t
+ *         - 返回删除的节点数量。
+ */
+xrbt_size_t xrbtree_erase_range(x_rbtree_ptr xthis_ptr,
+                                x_rbnode_iter xiter_first,
+                                x_rbnode_iter xiter_last);
+
+/**********************************************************/
+/**
+ * @brief 从 x_rbtree_t 对象中删除 所有等于 指定索引键值 的节点。
+ * @note  只进行一次定位操作，然后一次遍历删除相等节点的区间。
+ * 
+ * @return xrbt_size_t
+ *         - 返回删除的节点数量。
+ */
+xrbt_size_t xrbtree_erase_equal(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey);
+
+/**********************************************************/
+/**
+ * @brief 为 x_rbtree_t 对象申请一个处于分离状态的节点对象。
+ * @note
+ * 返回节点的 索引键/值数据 缓存是未初始化的，由调用方直接在其中构造（emplace），
+ * 之后可使用 xrbtree_dock() 将其停靠到红黑树中；
+ * 若停靠失败（索引键值冲突），调用方析构其 索引键/值数据 后，
+ * 应使用 xrbtree_node_recycle() 归还节点，以供下次申请操作复用。
+ * 
+ * @param [in ] xthis_ptr : 红黑树对象。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回分离状态的节点对象（可用 xrbtree_iter_vkey() 取其索引键缓存）；
+ *         - 申请节点内存失败时，返回 XRBT_NULL 。
+ */
+x_rbnode_iter xrbtree_node_alloc(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 归还 xrbtree_node_alloc() 申请的节点对象。
+ * @note
+ * xiter_node 必须处于分离状态，且其 索引键/值数据 已析构（或从未构造）；
+ * x_rbtree_t 对象会缓存一个这样的节点，供下次申请操作复用，其余的直接释放。
+ */
+xrbt_void_t xrbtree_node_recycle(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node);
+
+/**********************************************************/
+/**
+ * @brief 释放处于分离状态、且 索引键/值数据 已构造的节点对象。
+ * @note
+ * 用于丢弃 xrbtree_undock()、xrbtree_pop_min()、xrbtree_pop_max() 分离出的节点：
+ * 先回调析构其 索引键/值数据，再释放节点对象。
+ */
+xrbt_void_t xrbtree_node_release(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node);
+
+/**********************************************************/
+/**
+ * @brief 将节点对象停靠（插入）到红黑树中。
+ * @note
+ * xiter_node 必须处于分离状态（参看 @see xrbtree_iter_is_undocked()），
+ * 而且其索引键必须 与 xthis_ptr 存储的节点索引键类型相同；
+ * 侵入模式下，xiter_node 为 XRBT_LINK_ITER(链接头)，全 0 初始化的链接头可直接停靠。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [in ] xiter_node : 停靠操作的节点对象。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回的 节点对象 == xiter_node，停靠成功。
+ *         - 返回的 节点对象 != xiter_node，停靠失败（索引键值冲突）。
+ */
+x_rbnode_iter xrbtree_dock(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node);
+
+/**********************************************************/
+/**
+ * @brief 将节点对象从红黑树中分离（移除）出来。
+ * @note
+ * xiter_node 必须 已经隶属于 xthis_ptr ；
+ * 侵入模式下，分离后的链接头可重新停靠，或者随调用方对象直接释放。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [in ] xiter_node : 分离操作的节点对象。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回的 节点对象 == xiter_node。
+ */
+x_rbnode_iter xrbtree_undock(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node);
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象中的最小节点（等同于 xrbtree_begin()，O(1)）。
+ * @note  x_rbtree_t 对象为空时，返回 xrbtree_end() 。
+ */
+x_rbnode_iter xrbtree_peek_min(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象中的最大节点（等同于 xrbtree_rbegin()，O(1)）。
+ * @note  x_rbtree_t 对象为空时，返回 xrbtree_rend() 。
+ */
+x_rbnode_iter xrbtree_peek_max(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 将最小节点从红黑树中分离出来（按优先队列的方式使用红黑树）。
+ * @note
+ * 除删除修正操作外，新的最小节点直接取自被分离节点的后继节点，为 O(1) 操作；
+ * 返回的节点处于分离状态，其 索引键/值数据 保持不变，调用方可修改后
+ * 使用 xrbtree_dock() 重新停靠，或者使用 xrbtree_node_release() 释放。
+ * 
+ * @param [in ] xthis_ptr : 红黑树对象。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回分离出的节点对象；
+ *         - x_rbtree_t 对象为空时，返回 XRBT_NULL 。
+ */
+x_rbnode_iter xrbtree_pop_min(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 将最大节点从红黑树中分离出来（参看 xrbtree_pop_min() ）。
+ * 
+ * @return x_rbnode_iter
+ *         - 返回分离出的节点对象；
+ *         - x_rbtree_t 对象为空时，返回 XRBT_NULL 。
+ */
+x_rbnode_iter xrbtree_pop_max(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 将 [xrbtree_begin(), xiter_last) 区间内的节点整体从红黑树中分离（只适用于侵入模式）。
+ * @note
+ * 只调整 xiter_last 至根节点路径上的链接（O(log n)），不访问被分离的节点：
+ * 被分离节点的链接头保持原样，不再属于红黑树，调用方须事先遍历记录这些节点，
+ * 并在再次停靠（或以 xrbtree_iter_is_undocked() 判断）之前，将其链接头清零。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [in ] xiter_last : 区间的结束位置（可为 xrbtree_end()）。
+ * @param [in ] xst_count  : 区间内的节点数量（由调用方遍历时计数）。
+ */
+xrbt_void_t xrbtree_undock_front(x_rbtree_ptr xthis_ptr,
+                                 x_rbnode_iter xiter_last,
+                                 xrbt_size_t xst_count);
+
+/**********************************************************/
+/**
+ * @brief 判断两个 x_rbtree_t 对象之间，节点对象是否可以直接转移（无须重新申请、拷贝）。
+ * @note
+ * 要求 节点内存布局（索引键/值数据 大小、索引键存储方式）相同，
+ * 且 节点的 比较、析构、内存释放 等回调（以及回调的上下文标识）、XRBT_FLAG_NOFREE 模式 相同；
+ * 多键模式（XRBT_FLAG_MULTI）可以不同。
+ */
+xrbt_bool_t xrbtree_compatible(x_rbtree_ptr xthis_ptr, x_rbtree_ptr xother_ptr);
+
+/**********************************************************/
+/**
+ * @brief 将节点从红黑树中分离出来，以节点句柄的形式返回（节点的所有权转移至句柄）。
+ * @note  等同于 xrbtree_undock()，但返回的句柄记录了节点所属的红黑树。
+ */
+xrbt_nhandle_t xrbtree_extract(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node);
+
+/**********************************************************/
+/**
+ * @brief 将指定索引键值的节点从红黑树中分离出来，以节点句柄的形式返回。
+ * @note  多键模式下，分离的是相等节点中的首个节点；索引键值不存在时，返回空句柄。
+ */
+xrbt_nhandle_t xrbtree_extract_vkey(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey);
+
+/**********************************************************/
+/**
+ * @brief 将节点句柄持有的节点停靠到 x_rbtree_t 对象中（不申请内存、不拷贝数据）。
+ * @note
+ * 停靠成功时，节点的所有权转移至 xthis_ptr，句柄被置空；
+ * 句柄为空、两棵树不兼容（参看 xrbtree_compatible()）或者索引键值冲突时，句柄保持不变。
+ * 
+ * @param [in    ] xthis_ptr : 红黑树对象。
+ * @param [in,out] xhandle   : 节点句柄。
+ * @param [out   ] xbt_ok    : 返回操作成功的标识（可为 XRBT_NULL）。
+ * 
+ * @return x_rbnode_iter
+ *         - 停靠成功，返回该节点；
+ *         - 索引键值冲突，返回已有的节点；
+ *         - 句柄为空或者不兼容，返回 xrbtree_end() 。
+ */
+x_rbnode_iter xrbtree_insert_handle(x_rbtree_ptr xthis_ptr,
+                                    xrbt_nhandle_t * xhandle,
+                                    xrbt_bool_t * xbt_ok);
+
+/**********************************************************/
+/**
+ * @brief 释放节点句柄持有的节点（回调析构其 索引键/值数据），并置空句柄。
+ * @note  侵入模式下，只将句柄置空，调用方对象由调用方管理。
+ */
+xrbt_void_t xrbtree_handle_release(xrbt_nhandle_t * xhandle);
+
+/**********************************************************/
+/**
+ * @brief 将 xsrc_ptr 中的节点转移到 xthis_ptr 中（不申请内存、不拷贝数据）。
+ * @note
+ * 与 std::set::merge() 语义相同：索引键值冲突的节点（非多键模式）留在 xsrc_ptr 中；
+ * 两棵树不兼容（参看 xrbtree_compatible()）时，不做任何操作。
+ * 
+ * @param [in ] xthis_ptr : 目标红黑树对象。
+ * @param [in ] xsrc_ptr  : 源红黑树对象。
+ * 
+ * @return xrbt_size_t
+ *         - 返回转移的节点数量。
+ */
+xrbt_size_t xrbtree_merge(x_rbtree_ptr xthis_ptr, x_rbtree_ptr xsrc_ptr);
+
+/**********************************************************/
+/**
+ * @brief 在 x_rbtree_t 对象中查找指定节点。
+ * @note  若返回 NIL 则表示 x_rbtree_t 对象不包含该节点键值。
+ */
+x_rbnode_iter xrbtree_find(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey);
+
+/**********************************************************/
+/**
+ * @brief 返回的是首个不小于 指定索引键值 的 节点位置。
+ */
+x_rbnode_iter xrbtree_lower_bound(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey);
+
+/**********************************************************/
+/**
+ * @brief 返回的是首个大于 指定索引键值 的 节点位置。
+ */
+x_rbnode_iter xrbtree_upper_bound(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey);
+
+/**********************************************************/
+/**
+ * @brief 使用 探测值 在 x_rbtree_t 对象中查找指定节点（异构查找，无须构造索引键对象）。
+ * @note  若返回 NIL 则表示 x_rbtree_t 对象不包含该节点键值。
+ * 
+ * @param [in ] xthis_ptr     : 红黑树对象。
+ * @param [in ] xrbt_probe    : 探测值。
+ * @param [in ] xfunc_compare : 比较 探测值 与 节点索引键值 的回调函数。
+ * @param [in ] xrbt_ctxt     : xfunc_compare 回调的上下文标识。
+ */
+x_rbnode_iter xrbtree_find_with(x_rbtree_ptr xthis_ptr,
+                                xrbt_vkey_t xrbt_probe,
+                                xfunc_probe_compare_t xfunc_compare,
+                                xrbt_ctxt_t xrbt_ctxt);
+
+/**********************************************************/
+/**
+ * @brief 返回的是首个不小于 探测值 的 节点位置（异构查找）。
+ * @note  参数说明参看 @see xrbtree_find_with() 。
+ */
+x_rbnode_iter xrbtree_lower_bound_with(x_rbtree_ptr xthis_ptr,
+                                       xrbt_vkey_t xrbt_probe,
+                                       xfunc_probe_compare_t xfunc_compare,
+                                       xrbt_ctxt_t xrbt_ctxt);
+
+/**********************************************************/
+/**
+ * @brief 返回的是首个大于 探测值 的 节点位置（异构查找）。
+ * @note  参数说明参看 @see xrbtree_find_with() 。
+ */
+x_rbnode_iter xrbtree_upper_bound_with(x_rbtree_ptr xthis_ptr,
+                                       xrbt_vkey_t xrbt_probe,
+                                       xfunc_probe_compare_t xfunc_compare,
+                                       xrbt_ctxt_t xrbt_ctxt);
+
+/**********************************************************/
+/**
+ * @brief 返回 等于 指定索引键值 的节点区间 [*xiter_lower, *xiter_upper) 。
+ * @note
+ * *xiter_lower 等同于 xrbtree_lower_bound() 的返回值，
+ * *xiter_upper 等同于 xrbtree_upper_bound() 的返回值，但只进行一次定位操作。
+ * 
+ * @param [in ] xthis_ptr   : 红黑树对象。
+ * @param [in ] xrbt_vkey   : 索引键值。
+ * @param [out] xiter_lower : 返回区间的起始节点。
+ * @param [out] xiter_upper : 返回区间的终止节点。
+ */
+xrbt_void_t xrbtree_equal_range(x_rbtree_ptr xthis_ptr,
+                                xrbt_vkey_t xrbt_vkey,
+                                x_rbnode_iter * xiter_lower,
+                                x_rbnode_iter * xiter_upper);
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象中 等于 指定索引键值 的节点数量。
+ */
+xrbt_size_t xrbtree_count(x_rbtree_ptr xthis_ptr, xrbt_vkey_t xrbt_vkey);
+
+/**********************************************************/
+/**
+ * @brief 初始化批量区间扫描的游标（参看 xrbtree_scan()）。
+ * 
+ * @param [out] xcursor   : 游标。
+ * @param [in ] xut_flags : 扫描标识（参看 emXRBtreeScanFlags 枚举值）。
+ */
+xrbt_void_t xrbtree_cursor_init(xrbt_cursor_t * xcursor, xrbt_uint32_t xut_flags);
+
+/**********************************************************/
+/**
+ * @brief 批量扫描 [xrbt_lower, xrbt_upper) 区间内的节点，
+ *        每次调用输出至多 xst_max 个节点的 索引键/值数据 地址，并由游标记录扫描位置。
+ * @note
+ * 1. 首次调用时（游标刚被初始化），定位区间的起止节点；后续调用从游标处继续，
+ *    忽略 xrbt_lower 与 xrbt_upper 参数；
+ * 2. 扫描在库内部进行节点遍历（并预取后续访问的节点），无须逐个节点调用
+ *    xrbtree_next() 与 xrbtree_iter_vkey()；
+ * 3. 输出的是节点中的数据地址（不进行拷贝），在节点被删除前保持有效。
+ * 
+ * @param [in ] xthis_ptr  : 红黑树对象。
+ * @param [in ] xrbt_lower : 区间下界（包含；为 XRBT_NULL 时，自首个节点开始）。
+ * @param [in ] xrbt_upper : 区间上界（不包含；为 XRBT_NULL 时，至最后一个节点为止）。
+ * @param [out] xvkey_buf  : 输出 索引键 地址的缓存（可为 XRBT_NULL）。
+ * @param [out] xvval_buf  : 输出 值数据 地址的缓存（仅对 映射表模式 有效，可为 XRBT_NULL）。
+ * @param [in ] xst_max    : 缓存可容纳的元素数量。
+ * @param [in,out] xcursor : 游标（参看 xrbtree_cursor_init()）。
+ * 
+ * @return xrbt_size_t
+ *         - 返回本次输出的节点数量；返回 0 表示扫描已完成。
+ */
+xrbt_size_t xrbtree_scan(x_rbtree_ptr xthis_ptr,
+                         xrbt_vkey_t xrbt_lower,
+                         xrbt_vkey_t xrbt_upper,
+                         xrbt_vkey_t * xvkey_buf,
+                         xrbt_vval_t * xvval_buf,
+                         xrbt_size_t xst_max,
+                         xrbt_cursor_t * xcursor);
+
+/**********************************************************/
+/**
+ * @brief 在靠近根节点的位置，将 x_rbtree_t 对象切分为至多 xst_max 个互不相交的有序分段。
+ * @note
+ * 第 i 个分段为节点区间 [xiter_bounds[i], xiter_bounds[i + 1]) ，可用 xrbtree_next() 遍历；
+ * 分段的边界取自树的顶部若干层节点（O(xst_max) 的操作），各分段的节点数量大致相当，
+ * 常用于将遍历操作分配给多个线程（参看 xrbtree_par.h）。
+ * 
+ * @param [in ] xthis_ptr    : 红黑树对象。
+ * @param [out] xiter_bounds : 返回分段的边界（须可容纳 xst_max + 1 个元素），
+ *                             最后一个边界为 xrbtree_end() 。
+ * @param [in ] xst_max      : 分段的最大数量（不小于 1）。
+ * 
+ * @return xrbt_size_t
+ *         - 返回分段的数量（树为空时，返回 0）。
+ */
+xrbt_size_t xrbtree_partition(x_rbtree_ptr xthis_ptr,
+                              x_rbnode_iter * xiter_bounds,
+                              xrbt_size_t xst_max);
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象的根节点。
+ */
+x_rbnode_iter xrbtree_root(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象的正向遍历操作的起始节点。
+ */
+x_rbnode_iter xrbtree_begin(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象的正向遍历操作的终止节点。
+ */
+x_rbnode_iter xrbtree_end(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回（正向）下一个节点对象。
+ */
+x_rbnode_iter xrbtree_next(x_rbnode_iter xiter_node);
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象的反向遍历操作的起始节点。
+ */
+x_rbnode_iter xrbtree_rbegin(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回 x_rbtree_t 对象的反向遍历操作的终止节点。
+ */
+x_rbnode_iter xrbtree_rend(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回（反向）下一个节点对象。
+ */
+x_rbnode_iter xrbtree_rnext(x_rbnode_iter xiter_node);
+
+/**********************************************************/
+/**
+ * @brief 返回 节点对象 指向的索引键值。
+ */
+xrbt_vkey_t xrbtree_iter_vkey(x_rbnode_iter xiter_node);
+
+/**********************************************************/
+/**
+ * @brief 返回 节点对象 指向的值数据（仅对 映射表模式 的节点有效）。
+ */
+xrbt_vval_t xrbtree_iter_value(x_rbnode_iter xiter_node);
+
+/**********************************************************/
+/**
+ * @brief 判断 节点对象 是否为 NIL 。
+ */
+xrbt_bool_t xrbtree_iter_is_nil(x_rbnode_iter xiter_node);
+
+/**********************************************************/
+/**
+ * @brief 判断 节点对象 是否为 非停靠状态（即其已被分离出红黑树）。
+ */
+xrbt_bool_t xrbtree_iter_is_undocked(x_rbnode_iter xiter_node);
+
+/**********************************************************/
+/**
+ * @brief 返回 节点对象 所隶属的红黑树。
+ * @note  内部会进行节点遍历操作，使用时应注重效率问题。
  */
 x_rbtree_ptr xrbtree_iter_tree(x_rbnode_iter xiter_node);
 
@@ -472,9 +1591,14 @@ _Static xrbt_bool_t xrbtree_xfunc_##_Suffix##_compare(                         \
 
 #ifdef __cplusplus
 
+#include <new>     // for placement new
 #if __cplusplus >= 201103L
-#include <utility> // for std::move()
+#include <utility>     // for std::move(), std::forward()
+#include <type_traits> // for std::enable_if
 #endif // __cplusplus >= 201103L
+#if __cplusplus >= 201402L
+#include <functional>  // for std::less<>
+#endif // __cplusplus >= 201402L
 
 template< class _Kty >
 inline xrbt_void_t xrbtree_vkey_copyfrom(xrbt_vkey_t xrbt_dkey,
@@ -483,12 +1607,13 @@ inline xrbt_void_t xrbtree_vkey_copyfrom(xrbt_vkey_t xrbt_dkey,
                                          xrbt_bool_t xbt_move ,
                                          xrbt_ctxt_t xrbt_ctxt)
 {
+    // xrbt_dkey 指向的是未初始化的节点缓存，需使用 placement new 构造
 #if __cplusplus >= 201103L
     if (xbt_move)
-        *(_Kty *)xrbt_dkey = std::move(*(_Kty *)xrbt_skey);
+        new (xrbt_dkey) _Kty(std::move(*(_Kty *)xrbt_skey));
     else
 #endif // __cplusplus >= 201103L
-        *(_Kty *)xrbt_dkey = *(_Kty *)xrbt_skey;
+        new (xrbt_dkey) _Kty(*(_Kty *)xrbt_skey);
 }
 
 template< class _Kty >
@@ -508,8 +1633,25 @@ inline xrbt_bool_t xrbtree_vkey_compare(xrbt_vkey_t xrbt_lkey,
     return (*(_Kty *)xrbt_lkey < *(_Kty *)xrbt_rkey);
 }
 
+/**
+ * @brief 计算字符串类索引键（如 std::string）的前缀值，可作为 xrbtree_set_key_hints() 的回调。
+ * @note
+ * _Kty 需提供 data() 与 size() 接口（字符类型为 char），且其排序规则为 按无符号字节逐个比较
+ * （std::string 的 operator < 满足该条件）；不足 8 字节时补 0 。
+ */
+template< class _Kty >
+inline xrbt_uint64_t xrbtree_vkey_prefix_string(xrbt_vkey_t xrbt_vkey,
+                                                xrbt_size_t xrbt_size,
+                                                xrbt_ctxt_t xrbt_ctxt)
+{
+    const _Kty & xkey = *(const _Kty *)xrbt_vkey;
+    return xrbtree_vkey_prefix_bytes((xrbt_vkey_t)xkey.data(),
+                                     (xrbt_size_t)xkey.size(),
+                                     xrbt_ctxt);
+}
+
 template< class _Kty >
-inline xrbt_callback_t xrbtree_default_callback(xrbt_ctxt_t xrbt_ctxt)
+inline xrbt_callback_t xrbtree_default_callback(xrbt_ctxt_t xrbt_ctxt = XRBT_NULL)
 {
     xrbt_callback_t xcallback =
     {
@@ -524,6 +1666,43 @@ inline xrbt_callback_t xrbtree_default_callback(xrbt_ctxt_t xrbt_ctxt)
     return xcallback;
 }
 
+template< class _Vty >
+inline xrbt_void_t xrbtree_vval_copyfrom(xrbt_vval_t xrbt_dval,
+                                         xrbt_vval_t xrbt_sval,
+                                         xrbt_size_t xrbt_size,
+                                         xrbt_bool_t xbt_move ,
+                                         xrbt_ctxt_t xrbt_ctxt)
+{
+    if (XRBT_NULL == xrbt_sval)
+        new (xrbt_dval) _Vty();
+#if __cplusplus >= 201103L
+    else if (xbt_move)
+        new (xrbt_dval) _Vty(std::move(*(_Vty *)xrbt_sval));
+#endif // __cplusplus >= 201103L
+    else
+        new (xrbt_dval) _Vty(*(_Vty *)xrbt_sval);
+}
+
+template< class _Vty >
+inline xrbt_void_t xrbtree_vval_destruct(xrbt_vval_t xrbt_vval,
+                                         xrbt_size_t xrbt_size,
+                                         xrbt_ctxt_t xrbt_ctxt)
+{
+    (*(_Vty *)xrbt_vval).~_Vty();
+}
+
+template< class _Vty >
+inline xrbt_vcallback_t xrbtree_default_vcallback(void)
+{
+    xrbt_vcallback_t xvcallback =
+    {
+        /* .xfunc_v_copyfrom = */ &xrbtree_vval_copyfrom< _Vty >,
+        /* .xfunc_v_destruct = */ &xrbtree_vval_destruct< _Vty >
+    };
+
+    return xvcallback;
+}
+
 template< class _Kty >
 inline x_rbtree_ptr xrbtree_create_k(xrbt_callback_t * xcallback = XRBT_NULL)
 {
@@ -537,6 +1716,42 @@ inline x_rbtree_ptr xrbtree_create_k(xrbt_callback_t * xcallback = XRBT_NULL)
     return xrbtree_create(sizeof(_Kty), xcallback);
 }
 
+template< class _Kty >
+inline x_rbtree_ptr xrbtree_create_intrusive_k(xrbt_int32_t xit_koffset,
+                                               xrbt_uint32_t xut_flags = 0,
+                                               xrbt_callback_t * xcallback = XRBT_NULL)
+{
+    if (XRBT_NULL == xcallback)
+    {
+        static xrbt_callback_t _S_callback =
+            xrbtree_default_callback< _Kty >();
+        xcallback = &_S_callback;
+    }
+
+    return xrbtree_create_intrusive(sizeof(_Kty), xit_koffset, xut_flags, xcallback);
+}
+
+template< class _Kty, class _Vty >
+inline x_rbtree_ptr xrbtree_create_k(xrbt_callback_t * xcallback = XRBT_NULL,
+                                     xrbt_vcallback_t * xvcallback = XRBT_NULL)
+{
+    if (XRBT_NULL == xcallback)
+    {
+        static xrbt_callback_t _S_callback =
+            xrbtree_default_callback< _Kty >();
+        xcallback = &_S_callback;
+    }
+
+    if (XRBT_NULL == xvcallback)
+    {
+        static xrbt_vcallback_t _S_vcallback =
+            xrbtree_default_vcallback< _Vty >();
+        xvcallback = &_S_vcallback;
+    }
+
+    return xrbtree_create_kv(sizeof(_Kty), sizeof(_Vty), xcallback, xvcallback);
+}
+
 template< class _Kty >
 inline x_rbnode_iter xrbtree_insert_k(x_rbtree_ptr xthis_ptr,
                                       const _Kty & xkey,
@@ -547,20 +1762,158 @@ inline x_rbnode_iter xrbtree_insert_k(x_rbtree_ptr xthis_ptr,
 
 #if __cplusplus >= 201103L
 template< class _Kty >
-inline x_rbnode_iter xrbtree_insert_k(x_rbtree_ptr xthis_ptr,
-                                      _Kty && xkey,
-                                      xrbt_bool_t * xbt_ok = XRBT_NULL)
+inline typename std::enable_if<
+            !std::is_lvalue_reference< _Kty >::value, x_rbnode_iter >::type
+    xrbtree_insert_k(x_rbtree_ptr xthis_ptr,
+                     _Kty && xkey,
+                     xrbt_bool_t * xbt_ok = XRBT_NULL)
 {
     return xrbtree_insert_mkey(xthis_ptr, const_cast< _Kty * >(&xkey), xbt_ok);
 }
+
+/**
+ * @brief 在 xrbtree_node_alloc() 申请的节点中构造索引键时，
+ *        用于异常安全的辅助对象（构造失败时归还节点）。
+ */
+struct xrbtree_node_guard_t
+{
+    x_rbtree_ptr  xthis_ptr;
+    x_rbnode_iter xiter_node;
+
+    ~xrbtree_node_guard_t(void)
+    {
+        if (XRBT_NULL != xiter_node)
+            xrbtree_node_recycle(xthis_ptr, xiter_node);
+    }
+};
+
+/**
+ * @brief 直接在节点缓存中构造索引键（emplace），再将节点停靠到红黑树中。
+ * @note
+ * 停靠位置由节点中已构造的索引键确定，不会产生临时的索引键对象；
+ * 若索引键值冲突，则析构索引键，并将节点缓存留给下次 emplace 操作复用。
+ * 仅适用于非映射表模式的 x_rbtree_t 对象（映射表模式请使用 xrbtree_try_emplace_k()），
+ * 且不可为 借用模式（XRBT_FLAG_BORROW）或 侵入模式（XRBT_FLAG_INTRUSIVE）。
+ * 
+ * @return std::pair< x_rbnode_iter, xrbt_bool_t >
+ *         - first  : 对应节点（新节点 或 冲突的已有节点）；
+ *         - second : 是否插入成功；
+ *         - 申请节点内存失败，或红黑树的模式不适用时，返回 ( xrbtree_end(), XRBT_FALSE ) 。
+ */
+template< class _Kty, class... _Args >
+inline std::pair< x_rbnode_iter, xrbt_bool_t >
+    xrbtree_emplace_k(x_rbtree_ptr xthis_ptr, _Args &&... xargs)
+{
+    // 映射表模式的值数据 不会被构造，借用/侵入 模式的节点中没有索引键缓存
+    if ((0 != xrbtree_vsize(xthis_ptr)) ||
+        (0 != (xrbtree_flags(xthis_ptr) & (XRBT_FLAG_BORROW | XRBT_FLAG_INTRUSIVE))))
+    {
+        return std::pair< x_rbnode_iter, xrbt_bool_t >(xrbtree_end(xthis_ptr), XRBT_FALSE);
+    }
+
+    x_rbnode_iter xiter_node = xrbtree_node_alloc(xthis_ptr);
+    x_rbnode_iter xiter_dock = xiter_node;
+
+    if (XRBT_NULL == xiter_node)
+    {
+        return std::pair< x_rbnode_iter, xrbt_bool_t >(xrbtree_end(xthis_ptr), XRBT_FALSE);
+    }
+
+    {
+        xrbtree_node_guard_t xguard = { xthis_ptr, xiter_node };
+        new (xrbtree_iter_vkey(xiter_node)) _Kty(std::forward< _Args >(xargs)...);
+        xguard.xiter_node = XRBT_NULL;
+    }
+
+    xiter_dock = xrbtree_dock(xthis_ptr, xiter_node);
+    if (xiter_dock != xiter_node)
+    {
+        static_cast< _Kty * >(xrbtree_iter_vkey(xiter_node))->~_Kty();
+        xrbtree_node_recycle(xthis_ptr, xiter_node);
+        return std::pair< x_rbnode_iter, xrbt_bool_t >(xiter_dock, XRBT_FALSE);
+    }
+
+    return std::pair< x_rbnode_iter, xrbt_bool_t >(xiter_node, XRBT_TRUE);
+}
 #endif // __cplusplus >= 201103L
 
+template< class _Kty, class _Vty >
+inline x_rbnode_iter xrbtree_try_emplace_k(x_rbtree_ptr xthis_ptr,
+                                           const _Kty & xkey,
+                                           const _Vty & xval,
+                                           xrbt_bool_t * xbt_ok = XRBT_NULL)
+{
+    return xrbtree_try_emplace(xthis_ptr,
+                               const_cast< _Kty * >(&xkey),
+                               const_cast< _Vty * >(&xval),
+                               xbt_ok);
+}
+
+template< class _Kty, class _Vty >
+inline x_rbnode_iter xrbtree_insert_or_assign_k(x_rbtree_ptr xthis_ptr,
+                                                const _Kty & xkey,
+                                                const _Vty & xval,
+                                                xrbt_bool_t * xbt_ok = XRBT_NULL)
+{
+    return xrbtree_insert_or_assign(xthis_ptr,
+                                    const_cast< _Kty * >(&xkey),
+                                    const_cast< _Vty * >(&xval),
+                                    xbt_ok);
+}
+
+template< class _Init, class _Merge >
+struct xrbtree_upsert_functor_t
+{
+    _Init  & xfunc_init;
+    _Merge & xfunc_merge;
+
+    static xrbt_void_t init(x_rbnode_iter xiter_node,
+                            xrbt_vkey_t xrbt_vkey,
+                            xrbt_ctxt_t xrbt_ctxt)
+    {
+        static_cast< xrbtree_upsert_functor_t * >(xrbt_ctxt)->xfunc_init(xiter_node);
+    }
+
+    static xrbt_void_t merge(x_rbnode_iter xiter_node,
+                             xrbt_vkey_t xrbt_vkey,
+                             xrbt_ctxt_t xrbt_ctxt)
+    {
+        static_cast< xrbtree_upsert_functor_t * >(xrbt_ctxt)->xfunc_merge(xiter_node);
+    }
+};
+
+/**
+ * @brief 单次定位的 插入/更新 操作（参看 @see xrbtree_upsert() ）。
+ * @note  xfunc_init 与 xfunc_merge 的调用形式为 func(x_rbnode_iter) 。
+ */
+template< class _Kty, class _Init, class _Merge >
+inline x_rbnode_iter xrbtree_upsert_k(x_rbtree_ptr xthis_ptr,
+                                      const _Kty & xkey,
+                                      _Init xfunc_init,
+                                      _Merge xfunc_merge)
+{
+    typedef xrbtree_upsert_functor_t< _Init, _Merge > _Functor;
+    _Functor xfunctor = { xfunc_init, xfunc_merge };
+
+    return xrbtree_upsert(xthis_ptr,
+                          const_cast< _Kty * >(&xkey),
+                          &_Functor::init,
+                          &_Functor::merge,
+                          &xfunctor);
+}
+
 template< class _Kty >
 inline xrbt_bool_t xrbtree_erase_k(x_rbtree_ptr xthis_ptr, const _Kty & xkey)
 {
     return xrbtree_erase_vkey(xthis_ptr, const_cast< _Kty * >(&xkey));
 }
 
+template< class _Kty >
+inline xrbt_size_t xrbtree_erase_equal_k(x_rbtree_ptr xthis_ptr, const _Kty & xkey)
+{
+    return xrbtree_erase_equal(xthis_ptr, const_cast< _Kty * >(&xkey));
+}
+
 template< class _Kty >
 inline x_rbnode_iter xrbtree_find_k(x_rbtree_ptr xthis_ptr, const _Kty & xkey)
 {
@@ -581,12 +1934,383 @@ inline x_rbnode_iter xrbtree_upper_bound_k(x_rbtree_ptr xthis_ptr,
     return xrbtree_upper_bound(xthis_ptr, const_cast< _Kty * >(&xkey));
 }
 
+#if __cplusplus >= 201402L
+
+//====================================================================
+// 异构查找（transparent lookup）：
+// 比较器 _Cmp 带有 is_transparent 类型定义（如 std::less<>）时，
+// 可直接使用 探测值（如 std::string_view 之于 std::string）进行查找，
+// 无须构造临时的索引键对象；_Cmp 的排序规则必须与红黑树的比较回调一致。
+
+template< class _Tty >
+struct xrbtree_void_type
+{
+    typedef void type;
+};
+
+template< class _Cmp, class = void >
+struct xrbtree_is_transparent : std::false_type
+{
+};
+
+template< class _Cmp >
+struct xrbtree_is_transparent< _Cmp,
+            typename xrbtree_void_type< typename _Cmp::is_transparent >::type >
+    : std::true_type
+{
+};
+
+template< class _Kty, class _Pty, class _Cmp >
+struct xrbtree_probe_enable
+    : std::integral_constant< bool,
+            xrbtree_is_transparent< _Cmp >::value &&
+            !std::is_same< typename std::decay< _Pty >::type, _Kty >::value >
+{
+};
+
+template< class _Kty, class _Pty, class _Cmp >
+inline xrbt_int32_t xrbtree_probe_compare(xrbt_vkey_t xrbt_probe,
+                                          xrbt_vkey_t xrbt_vkey,
+                                          xrbt_size_t xrbt_size,
+                                          xrbt_ctxt_t xrbt_ctxt)
+{
+    const _Cmp & xcmp   = *static_cast< const _Cmp * >(xrbt_ctxt);
+    const _Pty & xprobe = *static_cast< const _Pty * >(xrbt_probe);
+    const _Kty & xkey   = *static_cast< const _Kty * >(xrbt_vkey);
+
+    if (xcmp(xprobe, xkey))
+        return -1;
+    if (xcmp(xkey, xprobe))
+        return 1;
+    return 0;
+}
+
+template< class _Kty, class _Cmp = std::less<>, class _Pty >
+inline typename std::enable_if<
+            xrbtree_probe_enable< _Kty, _Pty, _Cmp >::value, x_rbnode_iter >::type
+    xrbtree_find_k(x_rbtree_ptr xthis_ptr,
+                   const _Pty & xprobe,
+                   const _Cmp & xcmp = _Cmp())
+{
+    return xrbtree_find_with(xthis_ptr,
+                             const_cast< _Pty * >(&xprobe),
+                             &xrbtree_probe_compare< _Kty, _Pty, _Cmp >,
+                             const_cast< _Cmp * >(&xcmp));
+}
+
+template< class _Kty, class _Cmp = std::less<>, class _Pty >
+inline typename std::enable_if<
+            xrbtree_probe_enable< _Kty, _Pty, _Cmp >::value, x_rbnode_iter >::type
+    xrbtree_lower_bound_k(x_rbtree_ptr xthis_ptr,
+                          const _Pty & xprobe,
+                          const _Cmp & xcmp = _Cmp())
+{
+    return xrbtree_lower_bound_with(xthis_ptr,
+                                    const_cast< _Pty * >(&xprobe),
+                                    &xrbtree_probe_compare< _Kty, _Pty, _Cmp >,
+                                    const_cast< _Cmp * >(&xcmp));
+}
+
+template< class _Kty, class _Cmp = std::less<>, class _Pty >
+inline typename std::enable_if<
+            xrbtree_probe_enable< _Kty, _Pty, _Cmp >::value, x_rbnode_iter >::type
+    xrbtree_upper_bound_k(x_rbtree_ptr xthis_ptr,
+                          const _Pty & xprobe,
+                          const _Cmp & xcmp = _Cmp())
+{
+    return xrbtree_upper_bound_with(xthis_ptr,
+                                    const_cast< _Pty * >(&xprobe),
+                                    &xrbtree_probe_compare< _Kty, _Pty, _Cmp >,
+                                    const_cast< _Cmp * >(&xcmp));
+}
+
+#endif // __cplusplus >= 201402L
+
+template< class _Kty >
+inline xrbt_void_t xrbtree_equal_range_k(x_rbtree_ptr xthis_ptr,
+                                         const _Kty & xkey,
+                                         x_rbnode_iter * xiter_lower,
+                                         x_rbnode_iter * xiter_upper)
+{
+    xrbtree_equal_range(xthis_ptr,
+                        const_cast< _Kty * >(&xkey),
+                        xiter_lower,
+                        xiter_upper);
+}
+
+template< class _Kty >
+inline xrbt_size_t xrbtree_count_k(x_rbtree_ptr xthis_ptr, const _Kty & xkey)
+{
+    return xrbtree_count(xthis_ptr, const_cast< _Kty * >(&xkey));
+}
+
 template< class _Kty >
 inline _Kty & xrbtree_ikey_k(x_rbnode_iter xiter_node)
 {
     return *(static_cast< _Kty * >(xrbtree_iter_vkey(xiter_node)));
 }
 
+template< class _Vty >
+inline _Vty & xrbtree_ival_k(x_rbnode_iter xiter_node)
+{
+    return *(static_cast< _Vty * >(xrbtree_iter_value(xiter_node)));
+}
+
+#if __cplusplus >= 201103L
+
+//====================================================================
+// 节点句柄（对应 std::set/std::map 的 node_type）：
+// 只可移动，析构时释放仍持有的节点；key()/mapped() 可在转移前修改节点数据，
+// 但修改索引键后，必须重新插入到红黑树中才可参与查找。
+
+class xrbtree_node_handle_t
+{
+public:
+    xrbtree_node_handle_t(void)
+    {
+        m_xhandle.xtree_ptr  = XRBT_NULL;
+        m_xhandle.xiter_node = XRBT_NULL;
+    }
+
+    explicit xrbtree_node_handle_t(const xrbt_nhandle_t & xhandle)
+        : m_xhandle(xhandle)
+    {
+    }
+
+    xrbtree_node_handle_t(xrbtree_node_handle_t && xobject)
+        : m_xhandle(xobject.release())
+    {
+    }
+
+    xrbtree_node_handle_t & operator = (xrbtree_node_handle_t && xobject)
+    {
+        if (this != &xobject)
+        {
+            xrbtree_handle_release(&m_xhandle);
+            m_xhandle = xobject.release();
+        }
+        return *this;
+    }
+
+    xrbtree_node_handle_t(const xrbtree_node_handle_t &) = delete;
+    xrbtree_node_handle_t & operator = (const xrbtree_node_handle_t &) = delete;
+
+    ~xrbtree_node_handle_t(void)
+    {
+        xrbtree_handle_release(&m_xhandle);
+    }
+
+public:
+    inline bool empty(void) const { return (XRBT_NULL == m_xhandle.xiter_node); }
+    inline explicit operator bool (void) const { return !empty(); }
+
+    /** 返回持有的节点（空句柄时为 XRBT_NULL） */
+    inline x_rbnode_iter node(void) const { return m_xhandle.xiter_node; }
+
+    template< class _Kty >
+    inline _Kty & key(void) const { return xrbtree_ikey_k< _Kty >(m_xhandle.xiter_node); }
+
+    template< class _Vty >
+    inline _Vty & mapped(void) const { return xrbtree_ival_k< _Vty >(m_xhandle.xiter_node); }
+
+    /** 放弃节点的所有权，返回 C 接口的节点句柄 */
+    inline xrbt_nhandle_t release(void)
+    {
+        xrbt_nhandle_t xhandle = m_xhandle;
+        m_xhandle.xtree_ptr  = XRBT_NULL;
+        m_xhandle.xiter_node = XRBT_NULL;
+        return xhandle;
+    }
+
+    inline xrbt_nhandle_t * handle(void) { return &m_xhandle; }
+
+private:
+    xrbt_nhandle_t m_xhandle;
+};
+
+/**
+ * @struct xrbtree_insert_return_t
+ * @brief  插入节点句柄的返回值（对应 std::set::insert_return_type）。
+ */
+struct xrbtree_insert_return_t
+{
+    x_rbnode_iter         position; ///< 插入的节点，或者冲突的已有节点（失败时可为 xrbtree_end()）
+    bool                  inserted; ///< 是否插入成功
+    xrbtree_node_handle_t node    ; ///< 插入失败时，仍持有节点的句柄
+};
+
+inline xrbtree_node_handle_t xrbtree_extract_k(x_rbtree_ptr xthis_ptr, x_rbnode_iter xiter_node)
+{
+    return xrbtree_node_handle_t(xrbtree_extract(xthis_ptr, xiter_node));
+}
+
+template< class _Kty >
+inline xrbtree_node_handle_t xrbtree_extract_k(x_rbtree_ptr xthis_ptr, const _Kty & xkey)
+{
+    return xrbtree_node_handle_t(
+                xrbtree_extract_vkey(xthis_ptr, const_cast< _Kty * >(&xkey)));
+}
+
+inline xrbtree_insert_return_t xrbtree_insert_k(x_rbtree_ptr xthis_ptr,
+                                                xrbtree_node_handle_t && xnode)
+{
+    xrbtree_insert_return_t xreturn;
+    xrbt_bool_t             xbt_ok = XRBT_FALSE;
+
+    xreturn.position = xrbtree_insert_handle(xthis_ptr, xnode.handle(), &xbt_ok);
+    xreturn.inserted = (XRBT_FALSE != xbt_ok);
+    if (!xreturn.inserted)
+        xreturn.node = std::move(xnode);
+
+    return xreturn;
+}
+
+#endif // __cplusplus >= 201103L
+
+#if (__cplusplus >= 201703L) && defined(__has_include)
+#if __has_include(<memory_resource>)
+#define XRBTREE_HAS_PMR 1
+#endif // __has_include(<memory_resource>)
+#endif // (__cplusplus >= 201703L) && defined(__has_include)
+
+#ifdef XRBTREE_HAS_PMR
+
+#include <memory_resource>
+
+//====================================================================
+// std::pmr::memory_resource 桥接：
+// 回调的上下文标识指向 xrbtree_pmr_ctxt_t 对象，节点内存经其中的内存资源申请/释放，
+// 按 节点头部、索引键、值数据 三者中最大的对齐要求（_Align）传递对齐参数；
+// 调用方自定义的 比较 等回调，以 xrbtree_pmr_user_ctxt() 取得原来的上下文标识。
+
+/**
+ * @struct xrbtree_pmr_ctxt_t
+ * @brief  桥接回调的上下文：内存资源 与 调用方的上下文标识
+ *         （由调用方持有，须在红黑树销毁之后才可释放）。
+ */
+struct xrbtree_pmr_ctxt_t
+{
+    std::pmr::memory_resource * xmr_ptr   ; ///< 节点内存的来源
+    xrbt_ctxt_t                 xctxt_user; ///< 调用方的上下文标识
+};
+
+/**
+ * @brief 由桥接回调的上下文标识，取得调用方的上下文标识。
+ */
+inline xrbt_ctxt_t xrbtree_pmr_user_ctxt(xrbt_ctxt_t xrbt_ctxt)
+{
+    return static_cast< xrbtree_pmr_ctxt_t * >(xrbt_ctxt)->xctxt_user;
+}
+
+/**
+ * @brief 经内存资源申请节点内存（其抛出的异常不穿过 xrbtree.c，申请失败返回 XRBT_NULL）。
+ */
+template< std::size_t _Align >
+inline xrbt_void_t * xrbtree_pmr_memalloc(xrbt_vkey_t xrbt_vkey,
+                                          xrbt_size_t xst_nsize,
+                                          xrbt_ctxt_t xrbt_ctxt)
+{
+    try
+    {
+        return static_cast< xrbtree_pmr_ctxt_t * >(xrbt_ctxt)->xmr_ptr->allocate(
+                                                                    xst_nsize, _Align);
+    }
+    catch (...)
+    {
+    }
+    return XRBT_NULL;
+}
+
+template< std::size_t _Align >
+inline xrbt_void_t xrbtree_pmr_memfree(x_rbnode_iter xiter_node,
+                                       xrbt_size_t xst_nsize,
+                                       xrbt_ctxt_t xrbt_ctxt)
+{
+    static_cast< xrbtree_pmr_ctxt_t * >(xrbt_ctxt)->xmr_ptr->deallocate(
+                                                    xiter_node, xst_nsize, _Align);
+}
+
+/**
+ * @brief 节点的对齐要求（值数据按 8 字节对齐存放，不支持更高的对齐要求）。
+ */
+template< class _Kty, class _Vty = xrbt_byte_t >
+struct xrbtree_pmr_align
+    : std::integral_constant< std::size_t,
+            (alignof(_Kty) > alignof(_Vty)) ?
+                ((alignof(_Kty) > alignof(x_rbtree_link_t)) ? alignof(_Kty) : alignof(x_rbtree_link_t)) :
+                ((alignof(_Vty) > alignof(x_rbtree_link_t)) ? alignof(_Vty) : alignof(x_rbtree_link_t)) >
+{
+};
+
+/**
+ * @brief 判断内存资源是否为单调增长的（其 deallocate() 为空操作，可整体释放）。
+ * @note
+ * 以 dynamic_cast 识别 std::pmr::monotonic_buffer_resource（及其派生类），须启用 RTTI；
+ * 未启用 RTTI 时总是返回 false 。其他不逐个释放内存的资源（如自定义的内存池）无法识别，
+ * 调用方可在创建红黑树时直接指定 XRBT_FLAG_NOFREE 。
+ */
+inline bool xrbtree_pmr_is_monotonic(std::pmr::memory_resource * xmr_ptr)
+{
+#if defined(__cpp_rtti) || defined(__GXX_RTTI) || defined(_CPPRTTI)
+    return (nullptr != dynamic_cast< std::pmr::monotonic_buffer_resource * >(xmr_ptr));
+#else // !RTTI
+    return false;
+#endif // RTTI
+}
+
+/**
+ * @brief 构建经 xpmr_ctxt 中的内存资源申请/释放节点内存的回调
+ *        （其余回调同 xrbtree_default_callback()，上下文标识为 xpmr_ctxt）。
+ * @note  _Kty 无须析构时，析构回调取默认值，以便 XRBT_FLAG_NOFREE 模式下 O(1) 清除。
+ */
+template< class _Kty, class _Vty = xrbt_byte_t >
+inline xrbt_callback_t xrbtree_pmr_callback(xrbtree_pmr_ctxt_t * xpmr_ctxt)
+{
+    xrbt_callback_t xcallback = xrbtree_default_callback< _Kty >(xpmr_ctxt);
+    xcallback.xfunc_n_memalloc = &xrbtree_pmr_memalloc< xrbtree_pmr_align< _Kty, _Vty >::value >;
+    xcallback.xfunc_n_memfree  = &xrbtree_pmr_memfree < xrbtree_pmr_align< _Kty, _Vty >::value >;
+    if (std::is_trivially_destructible< _Kty >::value)
+        xcallback.xfunc_k_destruct = XRBT_NULL;
+    return xcallback;
+}
+
+/**
+ * @brief 创建节点内存取自 xpmr_ctxt->xmr_ptr 的 x_rbtree_t 对象（红黑树对象本身仍在堆上申请）。
+ * @note
+ * 内存资源为 std::pmr::monotonic_buffer_resource 时，自动设置 XRBT_FLAG_NOFREE 模式
+ * （参看 xrbtree_pmr_is_monotonic()），其他不逐个释放的资源可由 xut_flags 直接指定；
+ * xpmr_ctxt 及其内存资源 必须在 xrbtree_destroy() 之后才可释放。
+ */
+template< class _Kty >
+inline x_rbtree_ptr xrbtree_create_pmr_k(xrbtree_pmr_ctxt_t * xpmr_ctxt,
+                                         xrbt_uint32_t xut_flags = 0)
+{
+    if (xrbtree_pmr_is_monotonic(xpmr_ctxt->xmr_ptr))
+        xut_flags |= XRBT_FLAG_NOFREE;
+
+    xrbt_callback_t xcallback = xrbtree_pmr_callback< _Kty >(xpmr_ctxt);
+    return xrbtree_create_ex(sizeof(_Kty), 0, xut_flags, &xcallback, XRBT_NULL);
+}
+
+/**
+ * @brief 创建节点内存取自 xpmr_ctxt->xmr_ptr 的 映射表模式 的 x_rbtree_t 对象。
+ */
+template< class _Kty, class _Vty >
+inline x_rbtree_ptr xrbtree_create_pmr_k(xrbtree_pmr_ctxt_t * xpmr_ctxt,
+                                         xrbt_uint32_t xut_flags = 0)
+{
+    if (xrbtree_pmr_is_monotonic(xpmr_ctxt->xmr_ptr))
+        xut_flags |= XRBT_FLAG_NOFREE;
+
+    xrbt_callback_t  xcallback  = xrbtree_pmr_callback< _Kty, _Vty >(xpmr_ctxt);
+    xrbt_vcallback_t xvcallback = xrbtree_default_vcallback< _Vty >();
+    if (std::is_trivially_destructible< _Vty >::value)
+        xvcallback.xfunc_v_destruct = XRBT_NULL;
+    return xrbtree_create_ex(sizeof(_Kty), sizeof(_Vty), xut_flags, &xcallback, &xvcallback);
+}
+
+#endif // XRBTREE_HAS_PMR
+
 #endif // __cplusplus
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,710 @@
+﻿/**
+ * @file    xrbtree_par.c
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * 文件名称：xrbtree_par.c
+ * 创建日期：2019年09月09日
+ * 文件标识：
+ * 文件摘要：红黑树（x_rbtree_t）的并行遍历、并行归约 与 后台回收操作。
+ *
+ * 当前版本：1.0.0.0
+ * 作    者：
+ * 完成日期：2019年09月09日
+ * 版本摘要：
+ *
+ * 历史版本：
+ * 原作者  ：
+ * 完成日期：
+ * 版本摘要：
+ * </pre>
+ */
+
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif // !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+
+#include "xrbtree_par.h"
+
+#include <stdlib.h>
+#include <memory.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <pthread.h>
+#endif // _WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ENABLE_XASSERT
+#if ((defined _DEBUG) || (defined DEBUG))
+#define ENABLE_XASSERT 1
+#else // !((defined _DEBUG) || (defined DEBUG))
+#define ENABLE_XASSERT 0
+#endif // ((defined _DEBUG) || (defined DEBUG))
+#endif // ENABLE_XASSERT
+
+#ifndef XASSERT
+#if ENABLE_XASSERT
+#include <assert.h>
+#define XASSERT(xptr)    assert(xptr)
+#else // !ENABLE_XASSERT
+#define XASSERT(xptr)
+#endif // ENABLE_XASSERT
+#endif // XASSERT
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define XPAR_PARTS_PER_THREAD   8       ///< 每个线程平均分得的分段数量（用于负载均衡）
+#define XPAR_THREADS_MAX        256     ///< 线程数量的上限
+#define XPAR_NODES_PER_THREAD   4096    ///< 每个线程至少分得的节点数量（节点较少时，由调用线程独自完成）
+#define XPAR_ALIGN              16      ///< 部分结果缓存的对齐字节数
+#define XPAR_ALIGN_UP(xsize)    (((xsize) + (XPAR_ALIGN - 1)) & ~(xrbt_size_t)(XPAR_ALIGN - 1))
+
+/**
+ * @struct x_par_job_t
+ * @brief  一次并行操作的共享状态。
+ */
+typedef struct x_par_job_t
+{
+    x_rbnode_iter        * xiter_bounds; ///< 分段的边界（参看 xrbtree_partition()）
+    xrbt_size_t            xst_parts;    ///< 分段的数量
+    xrbt_size_t            xst_next;     ///< 下一个待领取的分段
+    xrbt_size_t            xst_visits;   ///< 已访问的节点数量
+    xrbt_size_t            xst_nused;    ///< 实际参与的线程数量（含调用线程）
+
+    xfunc_node_visit_t     xfunc_visit;  ///< 并行遍历的回调函数（并行归约时为 XRBT_NULL）
+    xrbt_ctxt_t            xrbt_ctxt;    ///< 并行遍历的回调上下文标识
+    const xrbt_reducer_t * xreducer;     ///< 并行归约的相关回调函数（并行遍历时为 XRBT_NULL）
+    xrbt_bool_t            xbt_ordered;  ///< 是否为 XRBT_PAR_ORDERED 模式
+    xrbt_size_t            xst_astep;    ///< 部分结果缓存的步长（按 XPAR_ALIGN 对齐）
+    xrbt_byte_t          * xacc_buf;     ///< 部分结果的缓存（按 分段 或 线程 划分）
+    xrbt_void_t          * xacc_result;  ///< 归约结果
+
+#ifndef _WIN32
+    pthread_mutex_t        xmutex;       ///< 保护 xst_next 等共享字段
+#endif // _WIN32
+} x_par_job_t;
+
+/**
+ * @struct x_par_worker_t
+ * @brief  工作线程的描述信息。
+ */
+typedef struct x_par_worker_t
+{
+    x_par_job_t * xjob_ptr;              ///< 共享状态
+    xrbt_size_t   xst_index;             ///< 线程索引号（调用线程为 0）
+} x_par_worker_t;
+
+#ifndef _WIN32
+
+/**
+ * 工作线程池的共享状态：工作线程在首次并行操作时按需创建，之后常驻（不退出），
+ * 同一时刻只服务于一个并行操作，其他并发（或嵌套）的并行操作在各自的调用线程中完成。
+ */
+static pthread_mutex_t   xpar_pool_mutex   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t    xpar_pool_post    = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t    xpar_pool_idle    = PTHREAD_COND_INITIALIZER;
+static xrbt_size_t       xpar_pool_threads = 0;         ///< 已创建的工作线程数量
+static xrbt_bool_t       xpar_pool_busy    = XRBT_FALSE;///< 是否正被某个并行操作使用
+static x_par_worker_t  * xpar_pool_workers = XRBT_NULL; ///< 当前并行操作的线程描述信息
+static xrbt_size_t       xpar_pool_want    = 0;         ///< 尚未被领取的线程描述信息数量
+static xrbt_size_t       xpar_pool_active  = 0;         ///< 尚未完成的工作线程数量
+
+#endif // _WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************/
+/**
+ * @brief 加锁/解锁 共享状态。
+ */
+static inline xrbt_void_t xpar_lock(x_par_job_t * xjob_ptr)
+{
+#ifndef _WIN32
+    pthread_mutex_lock(&xjob_ptr->xmutex);
+#endif // _WIN32
+}
+
+static inline xrbt_void_t xpar_unlock(x_par_job_t * xjob_ptr)
+{
+#ifndef _WIN32
+    pthread_mutex_unlock(&xjob_ptr->xmutex);
+#endif // _WIN32
+}
+
+/**********************************************************/
+/**
+ * @brief 工作线程的执行流程：循环领取分段，并按升序处理分段内的节点。
+ */
+static xrbt_void_t * xpar_worker_run(xrbt_void_t * xworker_arg)
+{
+    x_par_worker_t       * xworker_ptr = (x_par_worker_t *)xworker_arg;
+    x_par_job_t          * xjob_ptr    = xworker_ptr->xjob_ptr;
+    const xrbt_reducer_t * xreducer    = xjob_ptr->xreducer;
+    xrbt_void_t          * xacc_ptr    = XRBT_NULL;
+    xrbt_size_t            xst_visits  = 0;
+    xrbt_size_t            xst_part    = 0;
+    x_rbnode_iter          xiter_node  = XRBT_NULL;
+    x_rbnode_iter          xiter_stop  = XRBT_NULL;
+
+    // 默认模式的归约，每个线程只使用一个部分结果
+    if ((XRBT_NULL != xreducer) && !xjob_ptr->xbt_ordered)
+    {
+        xacc_ptr = xjob_ptr->xacc_buf + xworker_ptr->xst_index * xjob_ptr->xst_astep;
+        xreducer->xfunc_init(xacc_ptr, xreducer->xctxt_t_callback);
+    }
+
+    for (;;)
+    {
+        xpar_lock(xjob_ptr);
+        xst_part = xjob_ptr->xst_next++;
+        xpar_unlock(xjob_ptr);
+
+        if (xst_part >= xjob_ptr->xst_parts)
+            break;
+
+        xiter_node = xjob_ptr->xiter_bounds[xst_part];
+        xiter_stop = xjob_ptr->xiter_bounds[xst_part + 1];
+
+        if (XRBT_NULL == xreducer)
+        {
+            for (; xiter_node != xiter_stop; xiter_node = xrbtree_next(xiter_node))
+            {
+                xjob_ptr->xfunc_visit(xiter_node, xjob_ptr->xrbt_ctxt);
+                xst_visits += 1;
+            }
+
+            continue;
+        }
+
+        if (xjob_ptr->xbt_ordered)
+        {
+            xacc_ptr = xjob_ptr->xacc_buf + xst_part * xjob_ptr->xst_astep;
+            xreducer->xfunc_init(xacc_ptr, xreducer->xctxt_t_callback);
+        }
+
+        for (; xiter_node != xiter_stop; xiter_node = xrbtree_next(xiter_node))
+        {
+            xreducer->xfunc_visit(xacc_ptr, xiter_node, xreducer->xctxt_t_callback);
+            xst_visits += 1;
+        }
+    }
+
+    xpar_lock(xjob_ptr);
+    xjob_ptr->xst_visits += xst_visits;
+    if ((XRBT_NULL != xreducer) && !xjob_ptr->xbt_ordered)
+    {
+        xreducer->xfunc_merge(xjob_ptr->xacc_result, xacc_ptr, xreducer->xctxt_t_callback);
+        if (XRBT_NULL != xreducer->xfunc_release)
+            xreducer->xfunc_release(xacc_ptr, xreducer->xctxt_t_callback);
+    }
+    xpar_unlock(xjob_ptr);
+
+    return XRBT_NULL;
+}
+
+/**********************************************************/
+/**
+ * @brief 确定实际使用的线程数量。
+ */
+static xrbt_size_t xpar_threads(xrbt_uint32_t xut_nthreads)
+{
+#ifndef _WIN32
+    if (0 == xut_nthreads)
+    {
+        long xlt_ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+        xut_nthreads = (xlt_ncpus > 0) ? (xrbt_uint32_t)xlt_ncpus : 1;
+    }
+
+    return (xut_nthreads > XPAR_THREADS_MAX) ? XPAR_THREADS_MAX : xut_nthreads;
+#else // _WIN32
+    return 1;
+#endif // _WIN32
+}
+
+#ifndef _WIN32
+
+/**********************************************************/
+/**
+ * @brief 线程池中工作线程的执行流程：等待派发，领取线程描述信息后参与并行操作。
+ */
+static xrbt_void_t * xpar_pool_run(xrbt_void_t * xthread_arg)
+{
+    x_par_worker_t * xworker_ptr = XRBT_NULL;
+
+    pthread_mutex_lock(&xpar_pool_mutex);
+    for (;;)
+    {
+        while (0 == xpar_pool_want)
+            pthread_cond_wait(&xpar_pool_post, &xpar_pool_mutex);
+
+        xworker_ptr = &xpar_pool_workers[xpar_pool_want--];
+        pthread_mutex_unlock(&xpar_pool_mutex);
+
+        xpar_worker_run(xworker_ptr);
+
+        pthread_mutex_lock(&xpar_pool_mutex);
+        if (0 == --xpar_pool_active)
+            pthread_cond_signal(&xpar_pool_idle);
+    }
+
+    return XRBT_NULL;
+}
+
+/**********************************************************/
+/**
+ * @brief 将 1 ~ (xst_nthreads - 1) 号线程描述信息派发给线程池（必要时补充创建工作线程）。
+ *
+ * @return xrbt_size_t
+ *         - 返回实际参与的线程数量（含调用线程）；线程池正被使用时，返回 1 。
+ */
+static xrbt_size_t xpar_pool_post_job(x_par_worker_t * xworker_ptr, xrbt_size_t xst_nthreads)
+{
+    pthread_t xthread;
+
+    pthread_mutex_lock(&xpar_pool_mutex);
+
+    if (xpar_pool_busy)
+    {
+        pthread_mutex_unlock(&xpar_pool_mutex);
+        return 1;
+    }
+
+    // 创建失败的线程不再补充，由已有的线程完成
+    while (xpar_pool_threads + 1 < xst_nthreads)
+    {
+        if (0 != pthread_create(&xthread, XRBT_NULL, &xpar_pool_run, XRBT_NULL))
+            break;
+        pthread_detach(xthread);
+        xpar_pool_threads += 1;
+    }
+
+    if (xst_nthreads > xpar_pool_threads + 1)
+        xst_nthreads = xpar_pool_threads + 1;
+
+    if (xst_nthreads > 1)
+    {
+        xpar_pool_busy    = XRBT_TRUE;
+        xpar_pool_workers = xworker_ptr;
+        xpar_pool_want    = xst_nthreads - 1;
+        xpar_pool_active  = xst_nthreads - 1;
+        pthread_cond_broadcast(&xpar_pool_post);
+    }
+
+    pthread_mutex_unlock(&xpar_pool_mutex);
+
+    return xst_nthreads;
+}
+
+/**********************************************************/
+/**
+ * @brief 等待线程池中参与并行操作的工作线程全部完成，并归还线程池。
+ */
+static xrbt_void_t xpar_pool_wait_job(void)
+{
+    pthread_mutex_lock(&xpar_pool_mutex);
+    while (0 != xpar_pool_active)
+        pthread_cond_wait(&xpar_pool_idle, &xpar_pool_mutex);
+
+    xpar_pool_busy    = XRBT_FALSE;
+    xpar_pool_workers = XRBT_NULL;
+    pthread_mutex_unlock(&xpar_pool_mutex);
+}
+
+#endif // _WIN32
+
+/**********************************************************/
+/**
+ * @brief 切分红黑树，派发给线程池（调用线程作为 0 号线程参与），等待全部分段处理完成。
+ *
+ * @return xrbt_bool_t
+ *         - 成功，返回 XRBT_TRUE；
+ *         - 失败（申请部分结果的缓存失败），返回 XRBT_FALSE 。
+ */
+static xrbt_bool_t xpar_execute(x_rbtree_ptr xthis_ptr,
+                                x_par_job_t * xjob_ptr,
+                                xrbt_size_t xst_nthreads)
+{
+    x_rbnode_iter    xiter_local[2];
+    x_par_worker_t   xworker_local;
+    x_par_worker_t * xworker_ptr  = &xworker_local;
+    xrbt_size_t      xst_max      = xst_nthreads * XPAR_PARTS_PER_THREAD;
+    xrbt_size_t      xst_acount   = 0;
+    xrbt_size_t      xst_iter     = 0;
+
+    // 节点较少时，线程间的派发、同步开销超过并行的收益
+    if (xst_nthreads > xrbtree_size(xthis_ptr) / XPAR_NODES_PER_THREAD)
+    {
+        xst_nthreads = xrbtree_size(xthis_ptr) / XPAR_NODES_PER_THREAD;
+        if (0 == xst_nthreads)
+            xst_nthreads = 1;
+        xst_max = xst_nthreads * XPAR_PARTS_PER_THREAD;
+    }
+
+    // 单线程时 无须切分；切分边界的缓存申请失败时，退化为单个分段
+    xjob_ptr->xiter_bounds = XRBT_NULL;
+    if (xst_nthreads > 1)
+    {
+        xjob_ptr->xiter_bounds =
+            (x_rbnode_iter *)malloc((xst_max + 1) * sizeof(x_rbnode_iter));
+    }
+
+    if (XRBT_NULL == xjob_ptr->xiter_bounds)
+    {
+        xjob_ptr->xiter_bounds = xiter_local;
+        xst_max      = 1;
+        xst_nthreads = 1;
+    }
+
+    xjob_ptr->xst_parts = xrbtree_partition(xthis_ptr, xjob_ptr->xiter_bounds, xst_max);
+    if (xst_nthreads > xjob_ptr->xst_parts)
+        xst_nthreads = (xjob_ptr->xst_parts > 0) ? xjob_ptr->xst_parts : 1;
+
+    // 部分结果的缓存：XRBT_PAR_ORDERED 模式下按分段划分，否则按线程划分
+    if (XRBT_NULL != xjob_ptr->xreducer)
+    {
+        xst_acount = xjob_ptr->xbt_ordered ? xjob_ptr->xst_parts : xst_nthreads;
+        xjob_ptr->xst_astep = XPAR_ALIGN_UP(xjob_ptr->xreducer->xst_asize);
+        if (xst_acount > 0)
+        {
+            xjob_ptr->xacc_buf = (xrbt_byte_t *)malloc(xst_acount * xjob_ptr->xst_astep);
+            if (XRBT_NULL == xjob_ptr->xacc_buf)
+            {
+                if (xjob_ptr->xiter_bounds != xiter_local)
+                    free(xjob_ptr->xiter_bounds);
+                return XRBT_FALSE;
+            }
+        }
+
+        xjob_ptr->xreducer->xfunc_init(xjob_ptr->xacc_result,
+                                       xjob_ptr->xreducer->xctxt_t_callback);
+    }
+
+    if (xst_nthreads > 1)
+    {
+        xworker_ptr = (x_par_worker_t *)malloc(xst_nthreads * sizeof(x_par_worker_t));
+        if (XRBT_NULL == xworker_ptr)
+        {
+            xworker_ptr  = &xworker_local;
+            xst_nthreads = 1;
+        }
+    }
+
+#ifndef _WIN32
+    pthread_mutex_init(&xjob_ptr->xmutex, XRBT_NULL);
+#endif // _WIN32
+
+    for (xst_iter = 0; xst_iter < xst_nthreads; ++xst_iter)
+    {
+        xworker_ptr[xst_iter].xjob_ptr  = xjob_ptr;
+        xworker_ptr[xst_iter].xst_index = xst_iter;
+    }
+
+#ifndef _WIN32
+    // 未参与的线程，其部分结果的缓存保持未使用
+    if (xst_nthreads > 1)
+        xst_nthreads = xpar_pool_post_job(xworker_ptr, xst_nthreads);
+#endif // _WIN32
+    xjob_ptr->xst_nused = xst_nthreads;
+
+    xpar_worker_run(&xworker_ptr[0]);
+
+#ifndef _WIN32
+    if (xst_nthreads > 1)
+        xpar_pool_wait_job();
+
+    pthread_mutex_destroy(&xjob_ptr->xmutex);
+#endif // _WIN32
+
+    XASSERT(xjob_ptr->xst_visits == xrbtree_size(xthis_ptr));
+
+    // XRBT_PAR_ORDERED 模式下，按分段的顺序合并部分结果
+    if ((XRBT_NULL != xjob_ptr->xreducer) && xjob_ptr->xbt_ordered)
+    {
+        for (xst_iter = 0; xst_iter < xjob_ptr->xst_parts; ++xst_iter)
+        {
+            xrbt_byte_t * xacc_ptr = xjob_ptr->xacc_buf + xst_iter * xjob_ptr->xst_astep;
+
+            xjob_ptr->xreducer->xfunc_merge(xjob_ptr->xacc_result,
+                                            xacc_ptr,
+                                            xjob_ptr->xreducer->xctxt_t_callback);
+            if (XRBT_NULL != xjob_ptr->xreducer->xfunc_release)
+            {
+                xjob_ptr->xreducer->xfunc_release(xacc_ptr,
+                                                  xjob_ptr->xreducer->xctxt_t_callback);
+            }
+        }
+    }
+
+    if (xworker_ptr != &xworker_local)
+        free(xworker_ptr);
+    if (XRBT_NULL != xjob_ptr->xacc_buf)
+        free(xjob_ptr->xacc_buf);
+    if (xjob_ptr->xiter_bounds != xiter_local)
+        free(xjob_ptr->xiter_bounds);
+
+    return XRBT_TRUE;
+}
+
+/**
+ * @struct x_par_reclaim_t
+ * @brief  后台回收队列中的回收项。
+ */
+typedef struct x_par_reclaim_t
+{
+    x_rbtree_ptr             xreclaim_ptr; ///< 回收对象（参看 xrbtree_detach()）
+    xrbt_uint64_t            xu64_ticket;  ///< 回收的序号
+    struct x_par_reclaim_t * xnext_ptr;    ///< 队列中的下一项
+} x_par_reclaim_t;
+
+#ifndef _WIN32
+
+/**
+ * 后台回收的共享状态：单个后台线程按提交顺序处理队列，所以 已完成的序号 单调递增。
+ */
+static pthread_mutex_t   xpar_reclaim_mutex   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t    xpar_reclaim_submit  = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t    xpar_reclaim_finish  = PTHREAD_COND_INITIALIZER;
+static xrbt_bool_t       xpar_reclaim_running = XRBT_FALSE;
+static x_par_reclaim_t * xpar_reclaim_head    = XRBT_NULL;
+static x_par_reclaim_t * xpar_reclaim_tail    = XRBT_NULL;
+static xrbt_uint64_t     xpar_reclaim_issued  = 0;
+static xrbt_uint64_t     xpar_reclaim_done    = 0;
+
+/**********************************************************/
+/**
+ * @brief 后台回收线程的执行流程。
+ */
+static xrbt_void_t * xpar_reclaim_run(xrbt_void_t * xthread_arg)
+{
+    x_par_reclaim_t * xitem_ptr = XRBT_NULL;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&xpar_reclaim_mutex);
+        while (XRBT_NULL == xpar_reclaim_head)
+            pthread_cond_wait(&xpar_reclaim_submit, &xpar_reclaim_mutex);
+
+        xitem_ptr = xpar_reclaim_head;
+        xpar_reclaim_head = xitem_ptr->xnext_ptr;
+        if (XRBT_NULL == xpar_reclaim_head)
+            xpar_reclaim_tail = XRBT_NULL;
+        pthread_mutex_unlock(&xpar_reclaim_mutex);
+
+        xrbtree_destroy(xitem_ptr->xreclaim_ptr);
+
+        pthread_mutex_lock(&xpar_reclaim_mutex);
+        xpar_reclaim_done = xitem_ptr->xu64_ticket;
+        pthread_cond_broadcast(&xpar_reclaim_finish);
+        pthread_mutex_unlock(&xpar_reclaim_mutex);
+
+        free(xitem_ptr);
+    }
+
+    return XRBT_NULL;
+}
+
+#endif // _WIN32
+
+/**********************************************************/
+/**
+ * @brief 将回收对象提交给后台回收线程（必要时创建该线程）。
+ *
+ * @return xrbt_uint64_t
+ *         - 返回回收的序号；无法提交（已在调用线程中同步释放）时，返回 0 。
+ */
+static xrbt_uint64_t xpar_reclaim_submit_item(x_rbtree_ptr xreclaim_ptr)
+{
+#ifndef _WIN32
+    x_par_reclaim_t * xitem_ptr   = XRBT_NULL;
+    xrbt_uint64_t     xu64_ticket = 0;
+    pthread_t         xthread;
+#endif // _WIN32
+
+    if (XRBT_NULL == xreclaim_ptr)
+    {
+        return 0;
+    }
+
+#ifndef _WIN32
+    xitem_ptr = (x_par_reclaim_t *)malloc(sizeof(x_par_reclaim_t));
+    if (XRBT_NULL != xitem_ptr)
+    {
+        xitem_ptr->xreclaim_ptr = xreclaim_ptr;
+        xitem_ptr->xnext_ptr    = XRBT_NULL;
+
+        pthread_mutex_lock(&xpar_reclaim_mutex);
+
+        if (!xpar_reclaim_running &&
+            (0 == pthread_create(&xthread, XRBT_NULL, &xpar_reclaim_run, XRBT_NULL)))
+        {
+            pthread_detach(xthread);
+            xpar_reclaim_running = XRBT_TRUE;
+        }
+
+        if (xpar_reclaim_running)
+        {
+            xu64_ticket = ++xpar_reclaim_issued;
+            xitem_ptr->xu64_ticket = xu64_ticket;
+
+            if (XRBT_NULL == xpar_reclaim_tail)
+                xpar_reclaim_head = xitem_ptr;
+            else
+                xpar_reclaim_tail->xnext_ptr = xitem_ptr;
+            xpar_reclaim_tail = xitem_ptr;
+
+            pthread_cond_signal(&xpar_reclaim_submit);
+        }
+
+        pthread_mutex_unlock(&xpar_reclaim_mutex);
+
+        if (0 != xu64_ticket)
+            return xu64_ticket;
+        free(xitem_ptr);
+    }
+#endif // _WIN32
+
+    xrbtree_destroy(xreclaim_ptr);
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************/
+/**
+ * @brief 并行遍历 x_rbtree_t 对象的所有节点（参看 文件头部的说明）。
+ *
+ * @param [in ] xthis_ptr    : 红黑树对象。
+ * @param [in ] xfunc_visit  : 访问节点的回调函数。
+ * @param [in ] xrbt_ctxt    : 回调的上下文标识。
+ * @param [in ] xut_nthreads : 线程数量（含调用线程；为 0 时，取在线的 CPU 数量）。
+ * @param [out] xut_nused    : 返回实际参与的线程数量（含调用线程；为 1 表示在调用线程中顺序完成；
+ *                             可为 XRBT_NULL）。
+ *
+ * @return xrbt_size_t
+ *         - 返回访问的节点数量。
+ */
+xrbt_size_t xrbtree_parallel_for_each(x_rbtree_ptr xthis_ptr,
+                                      xfunc_node_visit_t xfunc_visit,
+                                      xrbt_ctxt_t xrbt_ctxt,
+                                      xrbt_uint32_t xut_nthreads,
+                                      xrbt_uint32_t * xut_nused)
+{
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xfunc_visit));
+
+    x_par_job_t xjob;
+    memset(&xjob, 0, sizeof(x_par_job_t));
+
+    xjob.xfunc_visit = xfunc_visit;
+    xjob.xrbt_ctxt   = xrbt_ctxt;
+
+    xpar_execute(xthis_ptr, &xjob, xpar_threads(xut_nthreads));
+    if (XRBT_NULL != xut_nused)
+        *xut_nused = (xrbt_uint32_t)xjob.xst_nused;
+
+    return xjob.xst_visits;
+}
+
+/**********************************************************/
+/**
+ * @brief 并行归约 x_rbtree_t 对象的所有节点（参看 文件头部的说明）。
+ *
+ * @param [in ] xthis_ptr    : 红黑树对象。
+ * @param [in ] xreducer     : 并行归约的相关回调函数。
+ * @param [out] xacc_result  : 归约结果（xreducer->xst_asize 字节的缓存）。
+ * @param [in ] xut_nthreads : 线程数量（含调用线程；为 0 时，取在线的 CPU 数量）。
+ * @param [in ] xut_flags    : 模式标识（参看 emXRBtreeParFlags 枚举值）。
+ * @param [out] xut_nused    : 返回实际参与的线程数量（含调用线程；为 1 表示在调用线程中顺序完成，
+ *                             失败时为 0；可为 XRBT_NULL）。
+ *
+ * @return xrbt_bool_t
+ *         - 成功，返回 XRBT_TRUE；
+ *         - 失败（申请部分结果的缓存失败），返回 XRBT_FALSE（xacc_result 未被初始化）。
+ */
+xrbt_bool_t xrbtree_parallel_reduce(x_rbtree_ptr xthis_ptr,
+                                    const xrbt_reducer_t * xreducer,
+                                    xrbt_void_t * xacc_result,
+                                    xrbt_uint32_t xut_nthreads,
+                                    xrbt_uint32_t xut_flags,
+                                    xrbt_uint32_t * xut_nused)
+{
+    XASSERT((XRBT_NULL != xthis_ptr) && (XRBT_NULL != xreducer));
+    XASSERT((XRBT_NULL != xreducer->xfunc_init ) &&
+            (XRBT_NULL != xreducer->xfunc_visit) &&
+            (XRBT_NULL != xreducer->xfunc_merge));
+    XASSERT(XRBT_NULL != xacc_result);
+
+    x_par_job_t xjob;
+    memset(&xjob, 0, sizeof(x_par_job_t));
+
+    xjob.xreducer    = xreducer;
+    xjob.xbt_ordered = (0 != (xut_flags & XRBT_PAR_ORDERED));
+    xjob.xacc_result = xacc_result;
+
+    xrbt_bool_t xbt_ok = xpar_execute(xthis_ptr, &xjob, xpar_threads(xut_nthreads));
+    if (XRBT_NULL != xut_nused)
+        *xut_nused = (xrbt_uint32_t)xjob.xst_nused;
+
+    return xbt_ok;
+}
+
+/**********************************************************/
+/**
+ * @brief 清除 x_rbtree_t 对象中的所有节点：以 O(1) 的方式分离后，交由后台回收线程释放。
+ *
+ * @return xrbt_uint64_t
+ *         - 返回回收的序号（用于 xrbtree_reclaim_wait()）；已同步完成时，返回 0 。
+ */
+xrbt_uint64_t xrbtree_clear_async(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+    if (xrbtree_flags(xthis_ptr) & XRBT_FLAG_INTRUSIVE)
+    {
+        xrbtree_clear(xthis_ptr);
+        return 0;
+    }
+
+    return xpar_reclaim_submit_item(xrbtree_detach(xthis_ptr));
+}
+
+/**********************************************************/
+/**
+ * @brief 销毁 x_rbtree_t 对象（由 xrbtree_create*() 创建）：
+ *        其节点交由后台回收线程释放，对象本身立即销毁。
+ *
+ * @return xrbt_uint64_t
+ *         - 返回回收的序号（用于 xrbtree_reclaim_wait()）；已同步完成时，返回 0 。
+ */
+xrbt_uint64_t xrbtree_destroy_async(x_rbtree_ptr xthis_ptr)
+{
+    XASSERT(XRBT_NULL != xthis_ptr);
+
+    xrbt_uint64_t xu64_ticket = xrbtree_clear_async(xthis_ptr);
+    xrbtree_destroy(xthis_ptr);
+
+    return xu64_ticket;
+}
+
+/**********************************************************/
+/**
+ * @brief 等待后台回收完成（完成栅栏）。
+ *
+ * @param [in ] xu64_ticket : 回收的序号（xrbtree_clear_async() 等的返回值）；
+ *                            为 0 时，等待此前提交的所有回收完成。
+ */
+xrbt_void_t xrbtree_reclaim_wait(xrbt_uint64_t xu64_ticket)
+{
+#ifndef _WIN32
+    pthread_mutex_lock(&xpar_reclaim_mutex);
+
+    if (0 == xu64_ticket)
+        xu64_ticket = xpar_reclaim_issued;
+
+    while (xpar_reclaim_done < xu64_ticket)
+        pthread_cond_wait(&xpar_reclaim_finish, &xpar_reclaim_mutex);
+
+    pthread_mutex_unlock(&xpar_reclaim_mutex);
+#endif // _WIN32
+}
@@ -0,0 +1,214 @@
+﻿/**
+ * @file    xrbtree_par.h
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * 文件名称：xrbtree_par.h
+ * 创建日期：2019年09月09日
+ * 文件标识：
+ * 文件摘要：红黑树（x_rbtree_t）的并行遍历、并行归约 与 后台回收操作。
+ *
+ * 当前版本：1.0.0.0
+ * 作    者：
+ * 完成日期：2019年09月09日
+ * 版本摘要：
+ *
+ * 历史版本：
+ * 原作者  ：
+ * 完成日期：
+ * 版本摘要：
+ * </pre>
+ */
+
+#ifndef __XRBTREE_PAR_H__
+#define __XRBTREE_PAR_H__
+
+#include "xrbtree.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+////////////////////////////////////////////////////////////////////////////////
+// 并行遍历的相关数据定义以及操作接口
+
+//====================================================================
+
+//
+// 并行遍历的相关数据定义
+//
+
+/**
+ * 并行遍历 由 xrbtree_partition() 在靠近根节点的位置，将红黑树切分为
+ * （线程数量的若干倍）互不相交的有序分段：
+ * 1. 调用线程与其他工作线程 从共享的分段队列中领取分段，先完成的线程继续领取，
+ *    以此均衡各线程的负载（分段的节点数量 并不完全相等）；
+ * 2. 每个分段内，按索引键升序遍历节点；
+ * 3. 遍历期间，红黑树不可被修改，回调函数会在多个线程中被并发调用；
+ * 4. 线程数量为 0 时，取在线的 CPU 数量；每个线程至少分得 4096 个节点，节点较少时由调用线程独自完成
+ *    （实际参与的线程数量 由接口的 xut_nused 参数返回）；
+ * 5. 工作线程来自首次使用时创建的常驻线程池（不随每次调用创建、回收），
+ *    线程池同一时刻只服务于一个并行操作，并发（或在回调函数中嵌套）的其他并行操作
+ *    在各自的调用线程中顺序完成；工作线程创建失败时，由已有的线程完成遍历。
+ * 只在 POSIX 系统（pthread）上并行执行，其他平台上 在调用线程中顺序执行。
+ */
+
+/**
+ * @enum  emXRBtreeParFlags
+ * @brief 并行归约的模式标识（参看 xrbtree_parallel_reduce()）。
+ */
+typedef enum emXRBtreeParFlags
+{
+    XRBT_PAR_ORDERED = 0x00000001, ///< 按索引键的顺序合并各分段的部分结果
+} emXRBtreeParFlags;
+
+/**
+ * @brief 并行遍历中，访问节点的回调函数类型。
+ *
+ * @param [in ] xiter_node : 节点对象。
+ * @param [in ] xrbt_ctxt  : 回调的上下文标识。
+ */
+typedef xrbt_void_t (* xfunc_node_visit_t)(
+                                x_rbnode_iter xiter_node,
+                                xrbt_ctxt_t xrbt_ctxt);
+
+/**
+ * @struct x_rbtree_reducer_t
+ * @brief  并行归约的相关回调函数（参看 xrbtree_parallel_reduce()）。
+ * @note
+ * 部分结果（累加器）为 xst_asize 字节的缓存，由 xfunc_init 初始化，
+ * 由 xfunc_visit 累加节点，由 xfunc_merge 将另一个部分结果合并进来；
+ * xfunc_release 可为 XRBT_NULL，用于释放 已被合并的部分结果 所持有的资源。
+ */
+typedef struct x_rbtree_reducer_t
+{
+    xrbt_size_t xst_asize;                                  ///< 部分结果的字节数
+    xrbt_void_t (* xfunc_init   )(xrbt_void_t * xacc_ptr,
+                                  xrbt_ctxt_t xrbt_ctxt);   ///< 初始化部分结果
+    xrbt_void_t (* xfunc_visit  )(xrbt_void_t * xacc_ptr,
+                                  x_rbnode_iter xiter_node,
+                                  xrbt_ctxt_t xrbt_ctxt);   ///< 将节点累加到部分结果
+    xrbt_void_t (* xfunc_merge  )(xrbt_void_t * xacc_ptr,
+                                  xrbt_void_t * xacc_from,
+                                  xrbt_ctxt_t xrbt_ctxt);   ///< 将 xacc_from 合并到 xacc_ptr
+    xrbt_void_t (* xfunc_release)(xrbt_void_t * xacc_ptr,
+                                  xrbt_ctxt_t xrbt_ctxt);   ///< 释放部分结果（可为 XRBT_NULL）
+    xrbt_ctxt_t xctxt_t_callback;                           ///< 回调的上下文标识
+} xrbt_reducer_t;
+
+//====================================================================
+
+//
+// 并行遍历的操作接口
+//
+
+/**********************************************************/
+/**
+ * @brief 并行遍历 x_rbtree_t 对象的所有节点（参看 文件头部的说明）。
+ * @note  各线程之间不保证访问顺序；需要全局有序的结果时，
+ *        使用 xrbtree_parallel_reduce() 的 XRBT_PAR_ORDERED 模式。
+ *
+ * @param [in ] xthis_ptr    : 红黑树对象。
+ * @param [in ] xfunc_visit  : 访问节点的回调函数。
+ * @param [in ] xrbt_ctxt    : 回调的上下文标识。
+ * @param [in ] xut_nthreads : 线程数量（含调用线程；为 0 时，取在线的 CPU 数量）。
+ * @param [out] xut_nused    : 返回实际参与的线程数量（含调用线程；为 1 表示在调用线程中顺序完成；
+ *                             可为 XRBT_NULL）。
+ *
+ * @return xrbt_size_t
+ *         - 返回访问的节点数量。
+ */
+xrbt_size_t xrbtree_parallel_for_each(x_rbtree_ptr xthis_ptr,
+                                      xfunc_node_visit_t xfunc_visit,
+                                      xrbt_ctxt_t xrbt_ctxt,
+                                      xrbt_uint32_t xut_nthreads,
+                                      xrbt_uint32_t * xut_nused);
+
+/**********************************************************/
+/**
+ * @brief 并行归约 x_rbtree_t 对象的所有节点（参看 文件头部的说明）。
+ * @note
+ * xacc_result 先由 xfunc_init 初始化，再合并各线程（或各分段）的部分结果：
+ * - 默认模式下，每个线程只使用一个部分结果，线程结束时合并（合并顺序不确定，
+ *   xfunc_merge 须满足交换律）；
+ * - XRBT_PAR_ORDERED 模式下，每个分段使用一个部分结果，全部完成后按索引键的顺序合并
+ *   （xacc_from 中的节点总是排在 xacc_ptr 已合并的节点之后），可用于拼接全局有序的输出。
+ *
+ * @param [in ] xthis_ptr    : 红黑树对象。
+ * @param [in ] xreducer     : 并行归约的相关回调函数。
+ * @param [out] xacc_result  : 归约结果（xreducer->xst_asize 字节的缓存）。
+ * @param [in ] xut_nthreads : 线程数量（含调用线程；为 0 时，取在线的 CPU 数量）。
+ * @param [in ] xut_flags    : 模式标识（参看 emXRBtreeParFlags 枚举值）。
+ * @param [out] xut_nused    : 返回实际参与的线程数量（含调用线程；为 1 表示在调用线程中顺序完成，
+ *                             失败时为 0；可为 XRBT_NULL）。
+ *
+ * @return xrbt_bool_t
+ *         - 成功，返回 XRBT_TRUE；
+ *         - 失败（申请部分结果的缓存失败），返回 XRBT_FALSE（xacc_result 未被初始化）。
+ */
+xrbt_bool_t xrbtree_parallel_reduce(x_rbtree_ptr xthis_ptr,
+                                    const xrbt_reducer_t * xreducer,
+                                    xrbt_void_t * xacc_result,
+                                    xrbt_uint32_t xut_nthreads,
+                                    xrbt_uint32_t xut_flags,
+                                    xrbt_uint32_t * xut_nused);
+
+//====================================================================
+
+//
+// 后台回收的操作接口
+//
+
+/**
+ * 后台回收 由 xrbtree_detach() 以 O(1) 的方式分离出红黑树的所有节点，
+ * 交由（首次使用时创建的）后台回收线程按提交顺序释放：
+ * 1. 每次提交返回一个递增的序号，xrbtree_reclaim_wait() 等待该序号的回收完成（完成栅栏）；
+ * 2. 节点释放时调用红黑树的 析构/内存释放 回调，这些回调须可在后台线程中调用；
+ * 3. 侵入模式（XRBT_FLAG_INTRUSIVE）下，节点为调用方对象的链接头，不可在后台分离，
+ *    按 xrbtree_clear() 的方式同步清除；
+ * 4. 进程退出时，尚未回收的节点不再释放（其内存由系统回收，索引键/值数据 不被析构），
+ *    需要析构时，应在退出前调用 xrbtree_reclaim_wait(0) 。
+ * 后台线程创建失败，或在非 POSIX 系统上，在调用线程中同步释放，返回序号 0 。
+ */
+
+/**********************************************************/
+/**
+ * @brief 清除 x_rbtree_t 对象中的所有节点：以 O(1) 的方式分离后，交由后台回收线程释放。
+ * @note  返回后 x_rbtree_t 对象即为空，可继续使用。
+ *
+ * @return xrbt_uint64_t
+ *         - 返回回收的序号（用于 xrbtree_reclaim_wait()）；已同步完成时，返回 0 。
+ */
+xrbt_uint64_t xrbtree_clear_async(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 销毁 x_rbtree_t 对象（由 xrbtree_create*() 创建）：
+ *        其节点交由后台回收线程释放，对象本身立即销毁。
+ *
+ * @return xrbt_uint64_t
+ *         - 返回回收的序号（用于 xrbtree_reclaim_wait()）；已同步完成时，返回 0 。
+ */
+xrbt_uint64_t xrbtree_destroy_async(x_rbtree_ptr xthis_ptr);
+
+/**********************************************************/
+/**
+ * @brief 等待后台回收完成（完成栅栏）。
+ *
+ * @param [in ] xu64_ticket : 回收的序号（xrbtree_clear_async() 等的返回值）；
+ *                            为 0 时，等待此前提交的所有回收完成。
+ */
+xrbt_void_t xrbtree_reclaim_wait(xrbt_uint64_t xu64_ticket);
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}; // extern "C"
+#endif // __cplusplus
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XRBTREE_PAR_H__
@@ -0,0 +1,1459 @@
+﻿/**
+ * @file    xrbtree_stl.h
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * 文件名称：xrbtree_stl.h
+ * 创建日期：2019年09月09日
+ * 文件标识：
+ * 文件摘要：基于 x_rbtree_t 的 STL 风格容器（xrbtree_set / xrbtree_map），需 C++11 。
+ *
+ * 当前版本：1.0.0.0
+ * 作    者：
+ * 完成日期：2019年09月09日
+ * 版本摘要：
+ *
+ * 历史版本：
+ * 原作者  ：
+ * 完成日期：
+ * 版本摘要：
+ * </pre>
+ */
+
+#ifndef __XRBTREE_STL_H__
+#define __XRBTREE_STL_H__
+
+#if !defined(__cplusplus) || (__cplusplus < 201103L)
+#error "xrbtree_stl.h requires C++11"
+#endif // !defined(__cplusplus) || (__cplusplus < 201103L)
+
+#include "xrbtree.h"
+
+#include <cstddef>          // for std::max_align_t, std::ptrdiff_t
+#include <exception>        // for std::exception_ptr, std::rethrow_exception
+#include <new>              // for std::bad_alloc
+#include <iterator>         // for std::bidirectional_iterator_tag, std::reverse_iterator
+#include <memory>           // for std::allocator, std::allocator_traits
+#include <functional>       // for std::less
+#include <initializer_list>
+#include <algorithm>        // for std::equal, std::lexicographical_compare
+#include <limits>           // for std::numeric_limits
+#include <stdexcept>        // for std::out_of_range
+#include <tuple>            // for std::forward_as_tuple
+#include <utility>          // for std::pair, std::piecewise_construct
+
+////////////////////////////////////////////////////////////////////////////////
+// 容器的实现约定：
+// 1. 以容器的 value_type（xrbtree_set 为 _Kty，xrbtree_map 为 std::pair< const _Kty, _Mty >）
+//    作为红黑树节点的索引键，节点采用默认存储方式，value_type 紧随节点头部存放；
+// 2. 节点内存经 分配器（rebind 到按节点对齐要求划分的内存单元）申请/释放，即 memalloc/memfree 回调；
+// 3. 比较器、分配器 与 红黑树对象 一同存放在一次申请的实现块中，容器本身只持有其指针，
+//    move 操作只转移该指针（被 move 的容器为空，可继续使用）；
+// 4. 比较器 与 分配器 均为无状态类型时，回调的上下文标识为 XRBT_NULL，
+//    此时同类型容器之间的 merge()/extract()/insert(node_type&&) 直接转移节点，不申请内存；
+// 5. 分配器、比较器 抛出的异常不会穿过 xrbtree.c 的函数栈：回调中捕获后暂存（参看 xrbtree_stl_pending()），
+//    memalloc 返回 XRBT_NULL，比较回调返回中性的结果，待 xrbtree.c 的接口返回后，
+//    容器先撤销已停靠的节点（保持有序），再重新抛出该异常（申请失败而无异常时抛出 std::bad_alloc）；
+//    value_type 的构造只发生在 C++ 的函数栈中，因此 xrbtree.c 无须以 -fexceptions 编译；
+// 6. 分配器为 std::pmr::polymorphic_allocator 且其内存资源为 monotonic_buffer_resource 时，
+//    红黑树以 XRBT_FLAG_NOFREE 模式创建（不逐个释放节点，value_type 无须析构时 clear() 为 O(1)）；
+//    该识别依赖 RTTI（参看 xrbtree_pmr_is_monotonic()），未启用 RTTI 时总是逐个释放节点。
+
+/**
+ * @brief 回调（memalloc、比较）中捕获、待容器重新抛出的异常（每个线程一个）。
+ */
+inline std::exception_ptr & xrbtree_stl_pending(void)
+{
+    static thread_local std::exception_ptr xexcept_ptr;
+    return xexcept_ptr;
+}
+
+/**
+ * @brief 若回调中暂存了异常，则取出并重新抛出。
+ */
+inline void xrbtree_stl_rethrow(void)
+{
+    std::exception_ptr & xpending = xrbtree_stl_pending();
+    if (xpending)
+    {
+        std::exception_ptr xexcept_ptr = xpending;
+        xpending = nullptr;
+        std::rethrow_exception(xexcept_ptr);
+    }
+}
+
+/**
+ * @brief 返回默认存储方式的节点中，索引键缓存的地址（即节点头部之后，参看 x_rbtree_link_t）。
+ */
+template< class _Vty >
+inline _Vty * xrbtree_stl_vkey(x_rbnode_iter xiter_node)
+{
+    return reinterpret_cast< _Vty * >(
+        reinterpret_cast< xrbt_byte_t * >(xiter_node) + sizeof(x_rbtree_link_t));
+}
+
+//====================================================================
+// 迭代器
+
+/**
+ * @class xrbtree_stl_iterator_t
+ * @brief 容器的双向迭代器（end() 即红黑树的 NIL 节点，对其 -- 操作得到最大节点）。
+ */
+template< class _Vty, bool _Const >
+class xrbtree_stl_iterator_t
+{
+    template< class, bool > friend class xrbtree_stl_iterator_t;
+
+public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef _Vty                            value_type;
+    typedef std::ptrdiff_t                  difference_type;
+    typedef typename std::conditional< _Const, const _Vty *, _Vty * >::type pointer;
+    typedef typename std::conditional< _Const, const _Vty &, _Vty & >::type reference;
+
+public:
+    xrbtree_stl_iterator_t(void) : m_xiter_node(XRBT_NULL) { }
+
+    explicit xrbtree_stl_iterator_t(x_rbnode_iter xiter_node)
+        : m_xiter_node(xiter_node)
+    {
+    }
+
+    template< bool _Other, class = typename std::enable_if< _Const && !_Other >::type >
+    xrbtree_stl_iterator_t(const xrbtree_stl_iterator_t< _Vty, _Other > & xiter)
+        : m_xiter_node(xiter.m_xiter_node)
+    {
+    }
+
+public:
+    inline reference operator * (void) const { return *xrbtree_stl_vkey< _Vty >(m_xiter_node); }
+    inline pointer   operator ->(void) const { return  xrbtree_stl_vkey< _Vty >(m_xiter_node); }
+
+    inline xrbtree_stl_iterator_t & operator ++ (void)
+    {
+        m_xiter_node = xrbtree_next(m_xiter_node);
+        return *this;
+    }
+
+    inline xrbtree_stl_iterator_t operator ++ (int)
+    {
+        xrbtree_stl_iterator_t xiter(*this);
+        ++*this;
+        return xiter;
+    }
+
+    inline xrbtree_stl_iterator_t & operator -- (void)
+    {
+        if (xrbtree_iter_is_nil(m_xiter_node))
+            m_xiter_node = xrbtree_rbegin(xrbtree_iter_tree(m_xiter_node));
+        else
+            m_xiter_node = xrbtree_rnext(m_xiter_node);
+        return *this;
+    }
+
+    inline xrbtree_stl_iterator_t operator -- (int)
+    {
+        xrbtree_stl_iterator_t xiter(*this);
+        --*this;
+        return xiter;
+    }
+
+    template< bool _Other >
+    inline bool operator == (const xrbtree_stl_iterator_t< _Vty, _Other > & xiter) const
+    {
+        return (m_xiter_node == xiter.m_xiter_node);
+    }
+
+    template< bool _Other >
+    inline bool operator != (const xrbtree_stl_iterator_t< _Vty, _Other > & xiter) const
+    {
+        return (m_xiter_node != xiter.m_xiter_node);
+    }
+
+    /** 返回对应的红黑树节点 */
+    inline x_rbnode_iter node(void) const { return m_xiter_node; }
+
+private:
+    x_rbnode_iter m_xiter_node;
+};
+
+//====================================================================
+// 节点句柄（node_type）
+
+/**
+ * @class xrbtree_set_node_t
+ * @brief xrbtree_set 的 node_type 。
+ */
+template< class _Vty >
+class xrbtree_set_node_t : public xrbtree_node_handle_t
+{
+public:
+    typedef _Vty value_type;
+
+    xrbtree_set_node_t(void) { }
+    explicit xrbtree_set_node_t(xrbtree_node_handle_t && xnode)
+        : xrbtree_node_handle_t(std::move(xnode))
+    {
+    }
+
+    inline value_type & value(void) const { return xrbtree_ikey_k< value_type >(node()); }
+};
+
+/**
+ * @class xrbtree_map_node_t
+ * @brief xrbtree_map 的 node_type 。
+ */
+template< class _Kty, class _Mty >
+class xrbtree_map_node_t : public xrbtree_node_handle_t
+{
+public:
+    typedef _Kty key_type;
+    typedef _Mty mapped_type;
+
+    xrbtree_map_node_t(void) { }
+    explicit xrbtree_map_node_t(xrbtree_node_handle_t && xnode)
+        : xrbtree_node_handle_t(std::move(xnode))
+    {
+    }
+
+    inline key_type & key(void) const
+    {
+        return const_cast< key_type & >(
+            xrbtree_ikey_k< std::pair< const _Kty, _Mty > >(node()).first);
+    }
+
+    inline mapped_type & mapped(void) const
+    {
+        return xrbtree_ikey_k< std::pair< const _Kty, _Mty > >(node()).second;
+    }
+};
+
+/**
+ * @struct xrbtree_stl_insert_return_t
+ * @brief  insert(node_type &&) 的返回值（对应 std::set::insert_return_type）。
+ */
+template< class _Iter, class _Node >
+struct xrbtree_stl_insert_return_t
+{
+    _Iter position;
+    bool  inserted;
+    _Node node    ;
+};
+
+//====================================================================
+// 键值提取
+
+template< class _Kty >
+struct xrbtree_stl_identity_t
+{
+    inline const _Kty & operator () (const _Kty & xkey) const { return xkey; }
+};
+
+template< class _Kty, class _Mty >
+struct xrbtree_stl_select1st_t
+{
+    inline const _Kty & operator () (const std::pair< const _Kty, _Mty > & xpair) const
+    {
+        return xpair.first;
+    }
+};
+
+//====================================================================
+// 容器的公共实现
+
+/**
+ * @class xrbtree_stl_tree_t
+ * @brief xrbtree_set / xrbtree_map 的公共实现（唯一键，相当于 std::_Rb_tree）。
+ * @note
+ * 查找操作使用 xrbtree_*_with() 接口直接以 key_type（或异构的探测值）定位，
+ * 比较回调只用于节点之间的比较（插入、停靠）。
+ */
+template< class _Kty, class _Vty, class _KeyOf, class _Cmp, class _Alloc, class _Node >
+class xrbtree_stl_tree_t
+{
+    template< class, class, class, class, class, class > friend class xrbtree_stl_tree_t;
+
+    static_assert(alignof(_Vty) <= alignof(std::max_align_t),
+                  "xrbtree_stl: over-aligned value_type is not supported");
+    static_assert((sizeof(x_rbtree_link_t) % alignof(_Vty)) == 0,
+                  "xrbtree_stl: value_type alignment exceeds the node header alignment");
+    static_assert(sizeof(_Vty) <= 0x0FFFFFFF,
+                  "xrbtree_stl: value_type is too large");
+
+    // constructor, destructor
+
+public:
+    typedef _Kty                            key_type;
+    typedef _Vty                            value_type;
+    typedef std::size_t                     size_type;
+    typedef std::ptrdiff_t                  difference_type;
+    typedef _Cmp                            key_compare;
+    typedef _Alloc                          allocator_type;
+    typedef value_type &                    reference;
+    typedef const value_type &              const_reference;
+    typedef typename std::allocator_traits< _Alloc >::pointer       pointer;
+    typedef typename std::allocator_traits< _Alloc >::const_pointer const_pointer;
+
+    // 集合的元素即索引键，其 iterator 与 const_iterator 相同（均为只读）
+    typedef xrbtree_stl_iterator_t< _Vty, std::is_same< _Kty, _Vty >::value > iterator;
+    typedef xrbtree_stl_iterator_t< _Vty, true >            const_iterator;
+    typedef std::reverse_iterator< iterator >               reverse_iterator;
+    typedef std::reverse_iterator< const_iterator >         const_reverse_iterator;
+    typedef _Node                                           node_type;
+    typedef xrbtree_stl_insert_return_t< iterator, _Node >  insert_return_type;
+
+protected:
+    /** 分配器的内存单元：大小 与 对齐 均为节点的对齐要求 */
+    static constexpr std::size_t XNUNIT_SIZE =
+        (alignof(_Vty) > alignof(x_rbtree_link_t)) ? alignof(_Vty) : alignof(x_rbtree_link_t);
+
+    struct alignas(XNUNIT_SIZE) x_nunit_t
+    {
+        xrbt_byte_t xbt_data[XNUNIT_SIZE];
+    };
+
+    typedef typename std::allocator_traits< _Alloc >::template
+                rebind_alloc< x_nunit_t >                   x_nalloc_t;
+    typedef std::allocator_traits< x_nalloc_t >             x_ntraits_t;
+
+    /** 比较器、分配器 均无状态时，回调不使用上下文标识（同类型容器的节点可直接转移） */
+    static constexpr bool XSTATELESS =
+        std::is_empty< _Cmp >::value && std::is_default_constructible< _Cmp >::value &&
+        std::is_empty< x_nalloc_t >::value && std::is_default_constructible< x_nalloc_t >::value;
+
+    /**
+     * @struct x_impl_t
+     * @brief  实现块：比较器、节点分配器，其后紧随 x_rbtree_t 对象的缓存。
+     */
+    struct x_impl_t
+    {
+        _Cmp       m_xcmp;
+        x_nalloc_t m_xalloc;
+
+        x_impl_t(const _Cmp & xcmp, const x_nalloc_t & xalloc)
+            : m_xcmp(xcmp)
+            , m_xalloc(xalloc)
+        {
+        }
+
+        inline x_rbtree_ptr tree(void)
+        {
+            return reinterpret_cast< x_rbtree_ptr >(
+                reinterpret_cast< xrbt_byte_t * >(this) + XIMPL_HSIZE);
+        }
+    };
+
+    static_assert(alignof(x_impl_t) <= XNUNIT_SIZE,
+                  "xrbtree_stl: over-aligned comparator/allocator is not supported");
+
+    /** 实现块头部的大小（其后的 x_rbtree_t 对象按内存单元对齐） */
+    static constexpr std::size_t XIMPL_HSIZE =
+        (sizeof(x_impl_t) + XNUNIT_SIZE - 1) & ~(XNUNIT_SIZE - 1);
+
+    /** 实现块（含 x_rbtree_t 对象）所需的内存单元数量 */
+    static inline std::size_t x_impl_units(void)
+    {
+        return (XIMPL_HSIZE + xrbtree_sizeof() + XNUNIT_SIZE - 1) / XNUNIT_SIZE;
+    }
+
+public:
+    xrbtree_stl_tree_t(void)
+        : m_ximpl(XRBT_NULL)
+    {
+    }
+
+    explicit xrbtree_stl_tree_t(const _Cmp & xcmp, const _Alloc & xalloc = _Alloc())
+        : m_ximpl(x_impl_create(xcmp, x_nalloc_t(xalloc)))
+    {
+    }
+
+    explicit xrbtree_stl_tree_t(const _Alloc & xalloc)
+        : m_ximpl(x_impl_create(_Cmp(), x_nalloc_t(xalloc)))
+    {
+    }
+
+    template< class _Iter >
+    xrbtree_stl_tree_t(_Iter xiter_first, _Iter xiter_last,
+                       const _Cmp & xcmp = _Cmp(), const _Alloc & xalloc = _Alloc())
+        : m_ximpl(x_impl_create(xcmp, x_nalloc_t(xalloc)))
+    {
+        insert(xiter_first, xiter_last);
+    }
+
+    xrbtree_stl_tree_t(std::initializer_list< value_type > xilist,
+                       const _Cmp & xcmp = _Cmp(), const _Alloc & xalloc = _Alloc())
+        : m_ximpl(x_impl_create(xcmp, x_nalloc_t(xalloc)))
+    {
+        insert(xilist.begin(), xilist.end());
+    }
+
+    xrbtree_stl_tree_t(const xrbtree_stl_tree_t & xobject)
+        : m_ximpl(XRBT_NULL)
+    {
+        if (XRBT_NULL != xobject.m_ximpl)
+        {
+            m_ximpl = x_impl_create(xobject.m_ximpl->m_xcmp,
+                        x_ntraits_t::select_on_container_copy_construction(
+                                    xobject.m_ximpl->m_xalloc));
+            x_copy_from(xobject);
+        }
+    }
+
+    xrbtree_stl_tree_t(xrbtree_stl_tree_t && xobject) noexcept
+        : m_ximpl(xobject.m_ximpl)
+    {
+        xobject.m_ximpl = XRBT_NULL;
+    }
+
+    ~xrbtree_stl_tree_t(void)
+    {
+        x_impl_destroy(m_ximpl);
+    }
+
+    xrbtree_stl_tree_t & operator = (const xrbtree_stl_tree_t & xobject)
+    {
+        if (this != &xobject)
+        {
+            if (XRBT_NULL == xobject.m_ximpl)
+            {
+                clear();
+            }
+            else
+            {
+                // 比较器可能带有状态，直接重建实现块（分配器按 propagate_on_container_copy_assignment 选取）
+                x_nalloc_t xalloc = (x_ntraits_t::propagate_on_container_copy_assignment::value ||
+                                     (XRBT_NULL == m_ximpl)) ?
+                                        xobject.m_ximpl->m_xalloc : m_ximpl->m_xalloc;
+                x_impl_t * ximpl = x_impl_create(xobject.m_ximpl->m_xcmp, xalloc);
+                x_impl_destroy(m_ximpl);
+                m_ximpl = ximpl;
+                x_copy_from(xobject);
+            }
+        }
+        return *this;
+    }
+
+    xrbtree_stl_tree_t & operator = (xrbtree_stl_tree_t && xobject) noexcept
+    {
+        if (this != &xobject)
+        {
+            x_impl_destroy(m_ximpl);
+            m_ximpl = xobject.m_ximpl;
+            xobject.m_ximpl = XRBT_NULL;
+        }
+        return *this;
+    }
+
+    xrbtree_stl_tree_t & operator = (std::initializer_list< value_type > xilist)
+    {
+        clear();
+        insert(xilist.begin(), xilist.end());
+        return *this;
+    }
+
+    // observers
+
+public:
+    allocator_type get_allocator(void) const
+    {
+        return (XRBT_NULL != m_ximpl) ? allocator_type(m_ximpl->m_xalloc) : allocator_type();
+    }
+
+    key_compare key_comp(void) const
+    {
+        return (XRBT_NULL != m_ximpl) ? m_ximpl->m_xcmp : x_default_cmp();
+    }
+
+    /** 返回内部的红黑树对象（只可用于只读操作，如 xrbtree_get_stats()；容器为空时可为 XRBT_NULL） */
+    inline x_rbtree_ptr native_handle(void) const
+    {
+        return (XRBT_NULL != m_ximpl) ? m_ximpl->tree() : XRBT_NULL;
+    }
+
+    // iterators
+
+public:
+    inline iterator begin(void)
+    { return iterator(x_begin()); }
+    inline const_iterator begin(void) const
+    { return const_iterator(x_begin()); }
+    inline const_iterator cbegin(void) const
+    { return const_iterator(x_begin()); }
+
+    inline iterator end(void)
+    { return iterator(x_end()); }
+    inline const_iterator end(void) const
+    { return const_iterator(x_end()); }
+    inline const_iterator cend(void) const
+    { return const_iterator(x_end()); }
+
+    inline reverse_iterator rbegin(void)
+    { return reverse_iterator(end()); }
+    inline const_reverse_iterator rbegin(void) const
+    { return const_reverse_iterator(end()); }
+    inline const_reverse_iterator crbegin(void) const
+    { return const_reverse_iterator(end()); }
+
+    inline reverse_iterator rend(void)
+    { return reverse_iterator(begin()); }
+    inline const_reverse_iterator rend(void) const
+    { return const_reverse_iterator(begin()); }
+    inline const_reverse_iterator crend(void) const
+    { return const_reverse_iterator(begin()); }
+
+    // capacity
+
+public:
+    inline bool empty(void) const
+    { return (XRBT_NULL == m_ximpl) || xrbtree_empty(m_ximpl->tree()); }
+
+    inline size_type size(void) const
+    { return (XRBT_NULL != m_ximpl) ? xrbtree_size(m_ximpl->tree()) : 0; }
+
+    inline size_type max_size(void) const
+    { return std::numeric_limits< xrbt_size_t >::max(); }
+
+    // modifiers
+
+public:
+    void clear(void)
+    {
+        if (XRBT_NULL != m_ximpl)
+            xrbtree_clear(m_ximpl->tree());
+    }
+
+    std::pair< iterator, bool > insert(const value_type & xvalue)
+    {
+        return emplace(xvalue);
+    }
+
+    std::pair< iterator, bool > insert(value_type && xvalue)
+    {
+        return emplace(std::move(xvalue));
+    }
+
+    iterator insert(const_iterator, const value_type & xvalue)
+    {
+        return emplace(xvalue).first;
+    }
+
+    iterator insert(const_iterator, value_type && xvalue)
+    {
+        return emplace(std::move(xvalue)).first;
+    }
+
+    template< class _Iter >
+    void insert(_Iter xiter_first, _Iter xiter_last)
+    {
+        for (; xiter_first != xiter_last; ++xiter_first)
+            emplace(*xiter_first);
+    }
+
+    void insert(std::initializer_list< value_type > xilist)
+    {
+        insert(xilist.begin(), xilist.end());
+    }
+
+    insert_return_type insert(node_type && xnode)
+    {
+        insert_return_type xreturn = { end(), false, node_type() };
+        if (xnode.empty())
+            return xreturn;
+
+        x_rbtree_ptr xtree_ptr = x_tree();
+        if (xrbtree_compatible(xtree_ptr, xnode.handle()->xtree_ptr))
+        {
+            xrbt_bool_t xbt_ok = XRBT_FALSE;
+            xreturn.position = iterator(xrbtree_insert_handle(xtree_ptr, xnode.handle(), &xbt_ok));
+            xreturn.inserted = (XRBT_FALSE != xbt_ok);
+
+            // 比较器抛出异常：节点可能停靠在错误的位置，取回到 xnode 中
+            if (xrbtree_stl_pending() && xreturn.inserted)
+                xnode = node_type(xrbtree_extract_k(xtree_ptr, xreturn.position.node()));
+            xrbtree_stl_rethrow();
+        }
+        else
+        {
+            // 节点内存不可在两个容器之间转移（分配器 或 比较器 带有状态），转为 move 插入
+            std::pair< iterator, bool > xpair =
+                emplace(std::move(xrbtree_ikey_k< value_type >(xnode.node())));
+            xreturn.position = xpair.first;
+            xreturn.inserted = xpair.second;
+            if (xreturn.inserted)
+                xnode = node_type();
+        }
+
+        if (!xreturn.inserted)
+            xreturn.node = std::move(xnode);
+        return xreturn;
+    }
+
+    iterator insert(const_iterator, node_type && xnode)
+    {
+        return insert(std::move(xnode)).position;
+    }
+
+    template< class... _Args >
+    std::pair< iterator, bool > emplace(_Args &&... xargs)
+    {
+        x_rbtree_ptr xtree_ptr = x_tree();
+        std::pair< x_rbnode_iter, xrbt_bool_t > xpair =
+            xrbtree_emplace_k< value_type >(xtree_ptr, std::forward< _Args >(xargs)...);
+
+        if (xrbtree_stl_pending())
+        {
+            // 比较器抛出异常：撤销可能停靠在错误位置的新节点
+            if (XRBT_FALSE != xpair.second)
+                xrbtree_erase(xtree_ptr, xpair.first);
+            xrbtree_stl_rethrow();
+        }
+
+        if ((XRBT_FALSE == xpair.second) && xrbtree_iter_is_nil(xpair.first))
+            throw std::bad_alloc();
+        return std::pair< iterator, bool >(iterator(xpair.first), (XRBT_FALSE != xpair.second));
+    }
+
+    template< class... _Args >
+    iterator emplace_hint(const_iterator, _Args &&... xargs)
+    {
+        return emplace(std::forward< _Args >(xargs)...).first;
+    }
+
+    iterator erase(const_iterator xiter_pos)
+    {
+        x_rbnode_iter xiter_node = xiter_pos.node();
+        x_rbnode_iter xiter_next = xrbtree_next(xiter_node);
+        xrbtree_erase(m_ximpl->tree(), xiter_node);
+        return iterator(xiter_next);
+    }
+
+    iterator erase(const_iterator xiter_first, const_iterator xiter_last)
+    {
+        if (xiter_first != xiter_last)
+            xrbtree_erase_range(m_ximpl->tree(), xiter_first.node(), xiter_last.node());
+        return iterator(xiter_last.node());
+    }
+
+    size_type erase(const key_type & xkey)
+    {
+        const_iterator xiter = find(xkey);
+        if (xiter == end())
+            return 0;
+        erase(xiter);
+        return 1;
+    }
+
+    void swap(xrbtree_stl_tree_t & xobject) noexcept
+    {
+        x_impl_t * ximpl = m_ximpl;
+        m_ximpl = xobject.m_ximpl;
+        xobject.m_ximpl = ximpl;
+    }
+
+    node_type extract(const_iterator xiter_pos)
+    {
+        return node_type(xrbtree_extract_k(m_ximpl->tree(), xiter_pos.node()));
+    }
+
+    node_type extract(const key_type & xkey)
+    {
+        const_iterator xiter = find(xkey);
+        if (xiter == end())
+            return node_type();
+        return extract(xiter);
+    }
+
+    /**
+     * @brief 将 xsource 中的元素转移到当前容器中（索引键冲突的元素留在 xsource 中）。
+     * @note
+     * 两者的节点兼容（参看 xrbtree_compatible()）时，直接转移节点，不申请内存；
+     * 否则逐个 move 插入，再从 xsource 中删除。
+     * 比较器抛出异常时，正在转移的元素退回 xsource 中（再次抛出异常则被销毁），
+     * 已转移的元素留在当前容器中。
+     */
+    template< class _Cmp2 >
+    void merge(xrbtree_stl_tree_t< _Kty, _Vty, _KeyOf, _Cmp2, _Alloc, _Node > & xsource)
+    {
+        if (((void *)&xsource == (void *)this) || xsource.empty())
+            return;
+
+        x_rbtree_ptr xtree_ptr = x_tree();
+        x_rbtree_ptr xsrc_ptr  = xsource.m_ximpl->tree();
+        xrbt_bool_t  xbt_move  = xrbtree_compatible(xtree_ptr, xsrc_ptr);
+
+        // 不直接调用 xrbtree_merge()：比较器在其函数栈中抛出异常时，无法撤销已错位停靠的节点
+        x_rbnode_iter xiter_node = xrbtree_begin(xsrc_ptr);
+        while (!xrbtree_iter_is_nil(xiter_node))
+        {
+            x_rbnode_iter xiter_next = xrbtree_next(xiter_node);
+            if (x_lower_match(_KeyOf()(*xrbtree_stl_vkey< _Vty >(xiter_node))) == x_end())
+            {
+                if (xbt_move)
+                    x_merge_node(xsource, xiter_node);
+                else
+                {
+                    emplace(std::move(*xrbtree_stl_vkey< _Vty >(xiter_node)));
+                    xrbtree_erase(xsrc_ptr, xiter_node);
+                }
+            }
+            xiter_node = xiter_next;
+        }
+    }
+
+    template< class _Cmp2 >
+    void merge(xrbtree_stl_tree_t< _Kty, _Vty, _KeyOf, _Cmp2, _Alloc, _Node > && xsource)
+    {
+        merge(xsource);
+    }
+
+    // lookup
+
+public:
+    inline size_type count(const key_type & xkey) const
+    { return (x_lower_match(xkey) != x_end()) ? 1 : 0; }
+
+    inline bool contains(const key_type & xkey) const
+    { return (x_lower_match(xkey) != x_end()); }
+
+    inline iterator find(const key_type & xkey)
+    { return iterator(x_lower_match(xkey)); }
+    inline const_iterator find(const key_type & xkey) const
+    { return const_iterator(x_lower_match(xkey)); }
+
+    inline iterator lower_bound(const key_type & xkey)
+    { return iterator(x_lower_bound(xkey)); }
+    inline const_iterator lower_bound(const key_type & xkey) const
+    { return const_iterator(x_lower_bound(xkey)); }
+
+    inline iterator upper_bound(const key_type & xkey)
+    { return iterator(x_upper_bound(xkey)); }
+    inline const_iterator upper_bound(const key_type & xkey) const
+    { return const_iterator(x_upper_bound(xkey)); }
+
+    inline std::pair< iterator, iterator > equal_range(const key_type & xkey)
+    {
+        x_rbnode_iter xiter_node = x_lower_match(xkey);
+        if (xiter_node == x_end())
+            return std::pair< iterator, iterator >(lower_bound(xkey), lower_bound(xkey));
+        return std::pair< iterator, iterator >(iterator(xiter_node),
+                                               iterator(xrbtree_next(xiter_node)));
+    }
+
+    inline std::pair< const_iterator, const_iterator > equal_range(const key_type & xkey) const
+    {
+        std::pair< iterator, iterator > xpair =
+            const_cast< xrbtree_stl_tree_t * >(this)->equal_range(xkey);
+        return std::pair< const_iterator, const_iterator >(xpair.first, xpair.second);
+    }
+
+#if __cplusplus >= 201402L
+    // 异构查找：仅当 _Cmp 带有 is_transparent 类型定义时可用
+
+    template< class _Pty, class _Ck = _Cmp,
+              class = typename std::enable_if< xrbtree_is_transparent< _Ck >::value >::type >
+    inline size_type count(const _Pty & xprobe) const
+    { return (x_lower_match(xprobe) != x_end()) ? 1 : 0; }
+
+    template< class _Pty, class _Ck = _Cmp,
+              class = typename std::enable_if< xrbtree_is_transparent< _Ck >::value >::type >
+    inline bool contains(const _Pty & xprobe) const
+    { return (x_lower_match(xprobe) != x_end()); }
+
+    template< class _Pty, class _Ck = _Cmp,
+              class = typename std::enable_if< xrbtree_is_transparent< _Ck >::value >::type >
+    inline iterator find(const _Pty & xprobe)
+    { return iterator(x_lower_match(xprobe)); }
+
+    template< class _Pty, class _Ck = _Cmp,
+              class = typename std::enable_if< xrbtree_is_transparent< _Ck >::value >::type >
+    inline const_iterator find(const _Pty & xprobe) const
+    { return const_iterator(x_lower_match(xprobe)); }
+
+    template< class _Pty, class _Ck = _Cmp,
+              class = typename std::enable_if< xrbtree_is_transparent< _Ck >::value >::type >
+    inline iterator lower_bound(const _Pty & xprobe)
+    { return iterator(x_lower_bound(xprobe)); }
+
+    template< class _Pty, class _Ck = _Cmp,
+              class = typename std::enable_if< xrbtree_is_transparent< _Ck >::value >::type >
+    inline const_iterator lower_bound(const _Pty & xprobe) const
+    { return const_iterator(x_lower_bound(xprobe)); }
+
+    template< class _Pty, class _Ck = _Cmp,
+              class = typename std::enable_if< xrbtree_is_transparent< _Ck >::value >::type >
+    inline iterator upper_bound(const _Pty & xprobe)
+    { return iterator(x_upper_bound(xprobe)); }
+
+    template< class _Pty, class _Ck = _Cmp,
+              class = typename std::enable_if< xrbtree_is_transparent< _Ck >::value >::type >
+    inline const_iterator upper_bound(const _Pty & xprobe) const
+    { return const_iterator(x_upper_bound(xprobe)); }
+
+    template< class _Pty, class _Ck = _Cmp,
+              class = typename std::enable_if< xrbtree_is_transparent< _Ck >::value >::type >
+    inline std::pair< iterator, iterator > equal_range(const _Pty & xprobe)
+    { return std::pair< iterator, iterator >(lower_bound(xprobe), upper_bound(xprobe)); }
+
+    template< class _Pty, class _Ck = _Cmp,
+              class = typename std::enable_if< xrbtree_is_transparent< _Ck >::value >::type >
+    inline std::pair< const_iterator, const_iterator > equal_range(const _Pty & xprobe) const
+    {
+        return std::pair< const_iterator, const_iterator >(lower_bound(xprobe),
+                                                           upper_bound(xprobe));
+    }
+#endif // __cplusplus >= 201402L
+
+    // internal
+
+protected:
+    /** 返回红黑树对象（实现块尚未创建时，先以默认的 比较器/分配器 创建） */
+    inline x_rbtree_ptr x_tree(void)
+    {
+        if (XRBT_NULL == m_ximpl)
+            m_ximpl = x_impl_create(x_default_cmp(), x_nalloc_t());
+        return m_ximpl->tree();
+    }
+
+    inline x_rbnode_iter x_begin(void) const
+    { return (XRBT_NULL != m_ximpl) ? xrbtree_begin(m_ximpl->tree()) : XRBT_NULL; }
+
+    inline x_rbnode_iter x_end(void) const
+    { return (XRBT_NULL != m_ximpl) ? xrbtree_end(m_ximpl->tree()) : XRBT_NULL; }
+
+    /** 首个不小于 xprobe 的节点 */
+    template< class _Pty >
+    x_rbnode_iter x_lower_bound(const _Pty & xprobe) const
+    {
+        if (XRBT_NULL == m_ximpl)
+            return XRBT_NULL;
+        x_rbnode_iter xiter_node =
+            xrbtree_lower_bound_with(m_ximpl->tree(),
+                                     const_cast< _Pty * >(&xprobe),
+                                     &x_probe_lower< _Pty >,
+                                     &m_ximpl->m_xcmp);
+        xrbtree_stl_rethrow();
+        return xiter_node;
+    }
+
+    /** 首个大于 xprobe 的节点 */
+    template< class _Pty >
+    x_rbnode_iter x_upper_bound(const _Pty & xprobe) const
+    {
+        if (XRBT_NULL == m_ximpl)
+            return XRBT_NULL;
+        x_rbnode_iter xiter_node =
+            xrbtree_upper_bound_with(m_ximpl->tree(),
+                                     const_cast< _Pty * >(&xprobe),
+                                     &x_probe_upper< _Pty >,
+                                     &m_ximpl->m_xcmp);
+        xrbtree_stl_rethrow();
+        return xiter_node;
+    }
+
+    /** 等于 xprobe 的节点（不存在时返回 x_end()）：与 std::set 相同，逐层只做一次比较 */
+    template< class _Pty >
+    x_rbnode_iter x_lower_match(const _Pty & xprobe) const
+    {
+        x_rbnode_iter xiter_node = x_lower_bound(xprobe);
+        if ((XRBT_NULL == xiter_node) || xrbtree_iter_is_nil(xiter_node) ||
+            m_ximpl->m_xcmp(xprobe, _KeyOf()(*xrbtree_stl_vkey< _Vty >(xiter_node))))
+        {
+            return x_end();
+        }
+        return xiter_node;
+    }
+
+    /** 将 xsource 中的节点直接转移到当前容器中（异常时退回 xsource） */
+    template< class _Cmp2 >
+    void x_merge_node(xrbtree_stl_tree_t< _Kty, _Vty, _KeyOf, _Cmp2, _Alloc, _Node > & xsource,
+                      x_rbnode_iter xiter_node)
+    {
+        node_type xnode(xrbtree_extract_k(xsource.m_ximpl->tree(), xiter_node));
+        try
+        {
+            insert(std::move(xnode));
+        }
+        catch (...)
+        {
+            xsource.insert(std::move(xnode));
+            throw;
+        }
+    }
+
+    void x_copy_from(const xrbtree_stl_tree_t & xobject)
+    {
+        for (const_iterator xiter = xobject.begin(); xiter != xobject.end(); ++xiter)
+            emplace(*xiter);
+    }
+
+    static _Cmp x_default_cmp(void)
+    {
+        return x_default_cmp(std::is_default_constructible< _Cmp >());
+    }
+
+    static _Cmp x_default_cmp(std::true_type) { return _Cmp(); }
+    static _Cmp x_default_cmp(std::false_type)
+    {
+        // 比较器不可默认构造时，被 move 后的容器只可 赋值 或 析构
+        throw std::logic_error("xrbtree_stl: moved-from container requires a comparator");
+    }
+
+    // callbacks
+
+protected:
+    static inline x_impl_t * x_impl_of(xrbt_ctxt_t xrbt_ctxt)
+    {
+        return static_cast< x_impl_t * >(xrbt_ctxt);
+    }
+
+    static xrbt_void_t * x_memalloc(xrbt_vkey_t xrbt_vkey,
+                                    xrbt_size_t xst_nsize,
+                                    xrbt_ctxt_t xrbt_ctxt)
+    {
+        std::size_t xst_count = (xst_nsize + XNUNIT_SIZE - 1) / XNUNIT_SIZE;
+        try
+        {
+            if (XRBT_NULL == xrbt_ctxt)
+            {
+                x_nalloc_t xalloc;
+                return x_ntraits_t::allocate(xalloc, xst_count);
+            }
+            return x_ntraits_t::allocate(x_impl_of(xrbt_ctxt)->m_xalloc, xst_count);
+        }
+        catch (...)
+        {
+            xrbtree_stl_pending() = std::current_exception();
+        }
+        return XRBT_NULL;
+    }
+
+    static xrbt_void_t x_memfree(x_rbnode_iter xiter_node,
+                                 xrbt_size_t xst_nsize,
+                                 xrbt_ctxt_t xrbt_ctxt)
+    {
+        std::size_t xst_count = (xst_nsize + XNUNIT_SIZE - 1) / XNUNIT_SIZE;
+        x_nunit_t * xmem_ptr = reinterpret_cast< x_nunit_t * >(xiter_node);
+        if (XRBT_NULL == xrbt_ctxt)
+        {
+            x_nalloc_t xalloc;
+            x_ntraits_t::deallocate(xalloc, xmem_ptr, xst_count);
+        }
+        else
+        {
+            x_ntraits_t::deallocate(x_impl_of(xrbt_ctxt)->m_xalloc, xmem_ptr, xst_count);
+        }
+    }
+
+    static xrbt_bool_t x_compare(xrbt_vkey_t xrbt_lkey,
+                                 xrbt_vkey_t xrbt_rkey,
+                                 xrbt_size_t xrbt_size,
+                                 xrbt_ctxt_t xrbt_ctxt)
+    {
+        const _Vty & xlval = *static_cast< const _Vty * >(xrbt_lkey);
+        const _Vty & xrval = *static_cast< const _Vty * >(xrbt_rkey);
+
+        // 已有暂存的异常时，不再调用比较器（其结果由容器撤销）
+        if (xrbtree_stl_pending())
+            return XRBT_FALSE;
+
+        try
+        {
+            if (XRBT_NULL == xrbt_ctxt)
+                return _Cmp()(_KeyOf()(xlval), _KeyOf()(xrval));
+            return x_impl_of(xrbt_ctxt)->m_xcmp(_KeyOf()(xlval), _KeyOf()(xrval));
+        }
+        catch (...)
+        {
+            xrbtree_stl_pending() = std::current_exception();
+        }
+        return XRBT_FALSE;
+    }
+
+    /** 容器自身不经由 按索引键插入 的接口拷贝元素，只为 move-only 的 value_type 提供可用的回调 */
+    static xrbt_void_t x_copyfrom(xrbt_vkey_t xrbt_dkey,
+                                  xrbt_vkey_t xrbt_skey,
+                                  xrbt_size_t xrbt_size,
+                                  xrbt_bool_t xbt_move ,
+                                  xrbt_ctxt_t xrbt_ctxt)
+    {
+        x_copyfrom(static_cast< _Vty * >(xrbt_dkey), static_cast< _Vty * >(xrbt_skey),
+                   xbt_move, std::is_copy_constructible< _Vty >());
+    }
+
+    static void x_copyfrom(_Vty * xdst, _Vty * xsrc, xrbt_bool_t xbt_move, std::true_type)
+    {
+        if (xbt_move)
+            new (xdst) _Vty(std::move(*xsrc));
+        else
+            new (xdst) _Vty(*xsrc);
+    }
+
+    static void x_copyfrom(_Vty * xdst, _Vty * xsrc, xrbt_bool_t, std::false_type)
+    {
+        new (xdst) _Vty(std::move(*xsrc));
+    }
+
+    /** xrbtree_lower_bound_with() 只判断 > 0（xkey < xprobe） */
+    template< class _Pty >
+    static xrbt_int32_t x_probe_lower(xrbt_vkey_t xrbt_probe,
+                                      xrbt_vkey_t xrbt_vkey,
+                                      xrbt_size_t xrbt_size,
+                                      xrbt_ctxt_t xrbt_ctxt)
+    {
+        const _Cmp & xcmp = *static_cast< const _Cmp * >(xrbt_ctxt);
+        if (xrbtree_stl_pending())
+            return -1;
+
+        try
+        {
+            return xcmp(_KeyOf()(*static_cast< const _Vty * >(xrbt_vkey)),
+                        *static_cast< const _Pty * >(xrbt_probe)) ? 1 : -1;
+        }
+        catch (...)
+        {
+            xrbtree_stl_pending() = std::current_exception();
+        }
+        return -1;
+    }
+
+    /** xrbtree_upper_bound_with() 只判断 < 0（xprobe < xkey） */
+    template< class _Pty >
+    static xrbt_int32_t x_probe_upper(xrbt_vkey_t xrbt_probe,
+                                      xrbt_vkey_t xrbt_vkey,
+                                      xrbt_size_t xrbt_size,
+                                      xrbt_ctxt_t xrbt_ctxt)
+    {
+        const _Cmp & xcmp = *static_cast< const _Cmp * >(xrbt_ctxt);
+        if (xrbtree_stl_pending())
+            return 1;
+
+        try
+        {
+            return xcmp(*static_cast< const _Pty * >(xrbt_probe),
+                        _KeyOf()(*static_cast< const _Vty * >(xrbt_vkey))) ? -1 : 1;
+        }
+        catch (...)
+        {
+            xrbtree_stl_pending() = std::current_exception();
+        }
+        return 1;
+    }
+
+    static x_impl_t * x_impl_create(const _Cmp & xcmp, const x_nalloc_t & xalloc)
+    {
+        x_nalloc_t  xnalloc(xalloc);
+        std::size_t xst_count = x_impl_units();
+        x_nunit_t * xmem_ptr  = x_ntraits_t::allocate(xnalloc, xst_count);
+
+        x_impl_t * ximpl = XRBT_NULL;
+        try
+        {
+            ximpl = new (xmem_ptr) x_impl_t(xcmp, xnalloc);
+        }
+        catch (...)
+        {
+            x_ntraits_t::deallocate(xnalloc, xmem_ptr, xst_count);
+            throw;
+        }
+
+        xrbt_callback_t xcallback =
+        {
+            /* .xfunc_n_memalloc = */ &x_memalloc,
+            /* .xfunc_n_memfree  = */ &x_memfree,
+            /* .xfunc_k_copyfrom = */ &x_copyfrom,
+            /* .xfunc_k_destruct = */ std::is_trivially_destructible< _Vty >::value ?
+                                            XRBT_NULL : &xrbtree_vkey_destruct< _Vty >,
+            /* .xfunc_k_compare  = */ &x_compare,
+            /* .xctxt_t_callback = */ XSTATELESS ? XRBT_NULL : ximpl
+        };
+
+        xrbtree_emplace_create_ex(ximpl->tree(), (xrbt_size_t)sizeof(_Vty), 0,
+                                  x_alloc_flags(xnalloc), &xcallback, XRBT_NULL);
+        return ximpl;
+    }
+
+    /** 由分配器确定红黑树的模式标识 */
+    template< class _Ay >
+    static xrbt_uint32_t x_alloc_flags(const _Ay &)
+    {
+        return 0;
+    }
+
+#ifdef XRBTREE_HAS_PMR
+    template< class _Uy >
+    static xrbt_uint32_t x_alloc_flags(const std::pmr::polymorphic_allocator< _Uy > & xalloc)
+    {
+        return xrbtree_pmr_is_monotonic(xalloc.resource()) ? XRBT_FLAG_NOFREE : 0;
+    }
+#endif // XRBTREE_HAS_PMR
+
+    static void x_impl_destroy(x_impl_t * ximpl)
+    {
+        if (XRBT_NULL == ximpl)
+            return;
+
+        xrbtree_emplace_destroy(ximpl->tree());
+
+        x_nalloc_t xnalloc(ximpl->m_xalloc);
+        ximpl->~x_impl_t();
+        x_ntraits_t::deallocate(xnalloc, reinterpret_cast< x_nunit_t * >(ximpl), x_impl_units());
+    }
+
+protected:
+    x_impl_t * m_ximpl;
+};
+
+//====================================================================
+// xrbtree_set
+
+/**
+ * @class xrbtree_set
+ * @brief 与 std::set 接口一致的有序集合（基于 x_rbtree_t）。
+ */
+template< class _Kty, class _Cmp = std::less< _Kty >, class _Alloc = std::allocator< _Kty > >
+class xrbtree_set
+    : public xrbtree_stl_tree_t< _Kty, _Kty, xrbtree_stl_identity_t< _Kty >,
+                                 _Cmp, _Alloc, xrbtree_set_node_t< _Kty > >
+{
+    typedef xrbtree_stl_tree_t< _Kty, _Kty, xrbtree_stl_identity_t< _Kty >,
+                                _Cmp, _Alloc, xrbtree_set_node_t< _Kty > > x_super_t;
+
+public:
+    typedef _Cmp value_compare;
+
+public:
+    using x_super_t::x_super_t;
+
+    xrbtree_set(void) { }
+
+    xrbtree_set(std::initializer_list< _Kty > xilist,
+                const _Cmp & xcmp = _Cmp(), const _Alloc & xalloc = _Alloc())
+        : x_super_t(xilist, xcmp, xalloc)
+    {
+    }
+
+    xrbtree_set & operator = (std::initializer_list< _Kty > xilist)
+    {
+        x_super_t::operator = (xilist);
+        return *this;
+    }
+
+    inline value_compare value_comp(void) const { return this->key_comp(); }
+};
+
+template< class _Kty, class _Cmp, class _Alloc >
+inline bool operator == (const xrbtree_set< _Kty, _Cmp, _Alloc > & xlhs,
+                         const xrbtree_set< _Kty, _Cmp, _Alloc > & xrhs)
+{
+    return (xlhs.size() == xrhs.size()) && std::equal(xlhs.begin(), xlhs.end(), xrhs.begin());
+}
+
+template< class _Kty, class _Cmp, class _Alloc >
+inline bool operator != (const xrbtree_set< _Kty, _Cmp, _Alloc > & xlhs,
+                         const xrbtree_set< _Kty, _Cmp, _Alloc > & xrhs)
+{
+    return !(xlhs == xrhs);
+}
+
+template< class _Kty, class _Cmp, class _Alloc >
+inline bool operator < (const xrbtree_set< _Kty, _Cmp, _Alloc > & xlhs,
+                        const xrbtree_set< _Kty, _Cmp, _Alloc > & xrhs)
+{
+    return std::lexicographical_compare(xlhs.begin(), xlhs.end(), xrhs.begin(), xrhs.end());
+}
+
+template< class _Kty, class _Cmp, class _Alloc >
+inline bool operator > (const xrbtree_set< _Kty, _Cmp, _Alloc > & xlhs,
+                        const xrbtree_set< _Kty, _Cmp, _Alloc > & xrhs)
+{
+    return (xrhs < xlhs);
+}
+
+template< class _Kty, class _Cmp, class _Alloc >
+inline bool operator <= (const xrbtree_set< _Kty, _Cmp, _Alloc > & xlhs,
+                         const xrbtree_set< _Kty, _Cmp, _Alloc > & xrhs)
+{
+    return !(xrhs < xlhs);
+}
+
+template< class _Kty, class _Cmp, class _Alloc >
+inline bool operator >= (const xrbtree_set< _Kty, _Cmp, _Alloc > & xlhs,
+                         const xrbtree_set< _Kty, _Cmp, _Alloc > & xrhs)
+{
+    return !(xlhs < xrhs);
+}
+
+template< class _Kty, class _Cmp, class _Alloc >
+inline void swap(xrbtree_set< _Kty, _Cmp, _Alloc > & xlhs,
+                 xrbtree_set< _Kty, _Cmp, _Alloc > & xrhs) noexcept
+{
+    xlhs.swap(xrhs);
+}
+
+//====================================================================
+// xrbtree_map
+
+/**
+ * @class xrbtree_map
+ * @brief 与 std::map 接口一致的有序映射表（基于 x_rbtree_t）。
+ * @note  节点的索引键为整个 std::pair< const _Kty, _Mty > 对象，未使用 x_rbtree_t 的映射表模式。
+ */
+template< class _Kty, class _Mty, class _Cmp = std::less< _Kty >,
+          class _Alloc = std::allocator< std::pair< const _Kty, _Mty > > >
+class xrbtree_map
+    : public xrbtree_stl_tree_t< _Kty, std::pair< const _Kty, _Mty >,
+                                 xrbtree_stl_select1st_t< _Kty, _Mty >,
+                                 _Cmp, _Alloc, xrbtree_map_node_t< _Kty, _Mty > >
+{
+    typedef xrbtree_stl_tree_t< _Kty, std::pair< const _Kty, _Mty >,
+                                xrbtree_stl_select1st_t< _Kty, _Mty >,
+                                _Cmp, _Alloc, xrbtree_map_node_t< _Kty, _Mty > > x_super_t;
+
+public:
+    typedef _Mty mapped_type;
+    typedef typename x_super_t::key_type       key_type;
+    typedef typename x_super_t::value_type     value_type;
+    typedef typename x_super_t::iterator       iterator;
+    typedef typename x_super_t::const_iterator const_iterator;
+
+    class value_compare
+    {
+        friend class xrbtree_map;
+
+    public:
+        inline bool operator () (const value_type & xlhs, const value_type & xrhs) const
+        {
+            return m_xcmp(xlhs.first, xrhs.first);
+        }
+
+    protected:
+        value_compare(const _Cmp & xcmp) : m_xcmp(xcmp) { }
+
+        _Cmp m_xcmp;
+    };
+
+public:
+    using x_super_t::x_super_t;
+    using x_super_t::insert;
+
+    xrbtree_map(void) { }
+
+    xrbtree_map(std::initializer_list< value_type > xilist,
+                const _Cmp & xcmp = _Cmp(), const _Alloc & xalloc = _Alloc())
+        : x_super_t(xilist, xcmp, xalloc)
+    {
+    }
+
+    xrbtree_map & operator = (std::initializer_list< value_type > xilist)
+    {
+        x_super_t::operator = (xilist);
+        return *this;
+    }
+
+    inline value_compare value_comp(void) const { return value_compare(this->key_comp()); }
+
+    // element access
+
+public:
+    mapped_type & operator [] (const key_type & xkey)
+    {
+        return try_emplace(xkey).first->second;
+    }
+
+    mapped_type & operator [] (key_type && xkey)
+    {
+        return try_emplace(std::move(xkey)).first->second;
+    }
+
+    mapped_type & at(const key_type & xkey)
+    {
+        iterator xiter = this->find(xkey);
+        if (xiter == this->end())
+            throw std::out_of_range("xrbtree_map::at");
+        return xiter->second;
+    }
+
+    const mapped_type & at(const key_type & xkey) const
+    {
+        const_iterator xiter = this->find(xkey);
+        if (xiter == this->end())
+            throw std::out_of_range("xrbtree_map::at");
+        return xiter->second;
+    }
+
+    // modifiers
+
+public:
+    template< class _Pty, class = typename std::enable_if<
+                    std::is_constructible< value_type, _Pty && >::value >::type >
+    std::pair< iterator, bool > insert(_Pty && xpair)
+    {
+        return this->emplace(std::forward< _Pty >(xpair));
+    }
+
+    template< class _Pty, class = typename std::enable_if<
+                    std::is_constructible< value_type, _Pty && >::value >::type >
+    iterator insert(const_iterator, _Pty && xpair)
+    {
+        return this->emplace(std::forward< _Pty >(xpair)).first;
+    }
+
+    /** 索引键不存在时才构造新元素（先定位，不会构造多余的临时对象） */
+    template< class... _Args >
+    std::pair< iterator, bool > try_emplace(const key_type & xkey, _Args &&... xargs)
+    {
+        return x_try_emplace(xkey, std::forward< _Args >(xargs)...);
+    }
+
+    template< class... _Args >
+    std::pair< iterator, bool > try_emplace(key_type && xkey, _Args &&... xargs)
+    {
+        return x_try_emplace(std::move(xkey), std::forward< _Args >(xargs)...);
+    }
+
+    template< class... _Args >
+    iterator try_emplace(const_iterator, const key_type & xkey, _Args &&... xargs)
+    {
+        return x_try_emplace(xkey, std::forward< _Args >(xargs)...).first;
+    }
+
+    template< class... _Args >
+    iterator try_emplace(const_iterator, key_type && xkey, _Args &&... xargs)
+    {
+        return x_try_emplace(std::move(xkey), std::forward< _Args >(xargs)...).first;
+    }
+
+    template< class _Vty >
+    std::pair< iterator, bool > insert_or_assign(const key_type & xkey, _Vty && xval)
+    {
+        std::pair< iterator, bool > xpair = x_try_emplace(xkey, std::forward< _Vty >(xval));
+        if (!xpair.second)
+            xpair.first->second = std::forward< _Vty >(xval);
+        return xpair;
+    }
+
+    template< class _Vty >
+    std::pair< iterator, bool > insert_or_assign(key_type && xkey, _Vty && xval)
+    {
+        std::pair< iterator, bool > xpair =
+            x_try_emplace(std::move(xkey), std::forward< _Vty >(xval));
+        if (!xpair.second)
+            xpair.first->second = std::forward< _Vty >(xval);
+        return xpair;
+    }
+
+    template< class _Vty >
+    iterator insert_or_assign(const_iterator, const key_type & xkey, _Vty && xval)
+    {
+        return insert_or_assign(xkey, std::forward< _Vty >(xval)).first;
+    }
+
+    template< class _Vty >
+    iterator insert_or_assign(const_iterator, key_type && xkey, _Vty && xval)
+    {
+        return insert_or_assign(std::move(xkey), std::forward< _Vty >(xval)).first;
+    }
+
+    // internal
+
+private:
+    /**
+     * 先以 xkey 定位，索引键已存在时不使用 xkey、xargs；
+     * 否则直接在节点缓存中构造元素，再停靠到红黑树中（第二次定位）。
+     */
+    template< class _Kfwd, class... _Args >
+    std::pair< iterator, bool > x_try_emplace(_Kfwd && xkey, _Args &&... xargs)
+    {
+        x_rbnode_iter xiter_node = this->x_lower_match(xkey);
+        if ((XRBT_NULL != xiter_node) && !xrbtree_iter_is_nil(xiter_node))
+            return std::pair< iterator, bool >(iterator(xiter_node), false);
+
+        x_rbtree_ptr  xtree_ptr = this->x_tree();
+        xiter_node = xrbtree_node_alloc(xtree_ptr);
+        if (XRBT_NULL == xiter_node)
+        {
+            xrbtree_stl_rethrow();
+            throw std::bad_alloc();
+        }
+
+        {
+            xrbtree_node_guard_t xguard = { xtree_ptr, xiter_node };
+            new (xrbtree_stl_vkey< value_type >(xiter_node)) value_type(
+                    std::piecewise_construct,
+                    std::forward_as_tuple(std::forward< _Kfwd >(xkey)),
+                    std::forward_as_tuple(std::forward< _Args >(xargs)...));
+            xguard.xiter_node = XRBT_NULL;
+        }
+
+        x_rbnode_iter xiter_dock = xrbtree_dock(xtree_ptr, xiter_node);
+        if (xiter_dock != xiter_node)
+        {
+            // 比较器抛出异常时，其中性结果被视为键值冲突，新节点未停靠
+            xrbtree_stl_vkey< value_type >(xiter_node)->~value_type();
+            xrbtree_node_recycle(xtree_ptr, xiter_node);
+            xrbtree_stl_rethrow();
+            return std::pair< iterator, bool >(iterator(xiter_dock), false);
+        }
+
+        if (xrbtree_stl_pending())
+        {
+            xrbtree_erase(xtree_ptr, xiter_node);
+            xrbtree_stl_rethrow();
+        }
+
+        return std::pair< iterator, bool >(iterator(xiter_node), true);
+    }
+};
+
+template< class _Kty, class _Mty, class _Cmp, class _Alloc >
+inline bool operator == (const xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xlhs,
+                         const xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xrhs)
+{
+    return (xlhs.size() == xrhs.size()) && std::equal(xlhs.begin(), xlhs.end(), xrhs.begin());
+}
+
+template< class _Kty, class _Mty, class _Cmp, class _Alloc >
+inline bool operator != (const xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xlhs,
+                         const xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xrhs)
+{
+    return !(xlhs == xrhs);
+}
+
+template< class _Kty, class _Mty, class _Cmp, class _Alloc >
+inline bool operator < (const xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xlhs,
+                        const xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xrhs)
+{
+    return std::lexicographical_compare(xlhs.begin(), xlhs.end(), xrhs.begin(), xrhs.end());
+}
+
+template< class _Kty, class _Mty, class _Cmp, class _Alloc >
+inline bool operator > (const xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xlhs,
+                        const xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xrhs)
+{
+    return (xrhs < xlhs);
+}
+
+template< class _Kty, class _Mty, class _Cmp, class _Alloc >
+inline bool operator <= (const xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xlhs,
+                         const xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xrhs)
+{
+    return !(xrhs < xlhs);
+}
+
+template< class _Kty, class _Mty, class _Cmp, class _Alloc >
+inline bool operator >= (const xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xlhs,
+                         const xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xrhs)
+{
+    return !(xlhs < xrhs);
+}
+
+template< class _Kty, class _Mty, class _Cmp, class _Alloc >
+inline void swap(xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xlhs,
+                 xrbtree_map< _Kty, _Mty, _Cmp, _Alloc > & xrhs) noexcept
+{
+    xlhs.swap(xrhs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XRBTREE_STL_H__
@@ -0,0 +1,464 @@
+﻿/**
+ * @file    xtimerq.c
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * 文件名称：xtimerq.c
+ * 创建日期：2019年09月09日
+ * 文件标识：
+ * 文件摘要：基于红黑树（x_rbtree_t）的定时器队列。
+ *
+ * 当前版本：1.0.0.0
+ * 作    者：
+ * 完成日期：2019年09月09日
+ * 版本摘要：
+ *
+ * 历史版本：
+ * 原作者  ：
+ * 完成日期：
+ * 版本摘要：
+ * </pre>
+ */
+
+#include "xtimerq.h"
+
+#include <stdlib.h>
+#include <memory.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ENABLE_XASSERT
+#if ((defined _DEBUG) || (defined DEBUG))
+#define ENABLE_XASSERT 1
+#else // !((defined _DEBUG) || (defined DEBUG))
+#define ENABLE_XASSERT 0
+#endif // ((defined _DEBUG) || (defined DEBUG))
+#endif // ENABLE_XASSERT
+
+#ifndef XASSERT
+#if ENABLE_XASSERT
+#include <assert.h>
+#define XASSERT(xptr)    assert(xptr)
+#else // !ENABLE_XASSERT
+#define XASSERT(xptr)
+#endif // ENABLE_XASSERT
+#endif // XASSERT
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @struct x_timerq_t
+ * @brief  定时器队列的结构体描述信息。
+ */
+typedef struct x_timerq_t
+{
+    x_rbtree_ptr    xtree_ptr;      ///< 以到期时间为索引键的红黑树（侵入模式 + 多键模式）
+    xrbt_callback_t xcallback;      ///< 定时器的内存 申请/释放 接口
+    x_timer_ptr     xtimer_pending; ///< 到期待回调链表的首个定时器
+    xrbt_bool_t     xbt_expiring;   ///< 是否正在执行 xtimerq_expire_until()
+} x_timerq_t;
+
+#define XTIMER_ITER(xtimer_ptr)   XRBT_LINK_ITER(&(xtimer_ptr)->xlink)
+#define XTIMER_OF(xiter_node)     XRBT_CONTAINER_OF(XRBT_ITER_LINK(xiter_node), x_timer_t, xlink)
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************/
+/**
+ * @brief 比较两个到期时间的回调函数。
+ */
+static xrbt_bool_t xtimerq_expire_less(
+                            xrbt_vkey_t xrbt_lkey,
+                            xrbt_vkey_t xrbt_rkey,
+                            xrbt_size_t xrbt_size,
+                            xrbt_ctxt_t xrbt_ctxt)
+{
+    return (*(xrbt_uint64_t *)xrbt_lkey < *(xrbt_uint64_t *)xrbt_rkey);
+}
+
+/**********************************************************/
+/**
+ * @brief 定时器默认的内存申请接口。
+ */
+static xrbt_void_t * xtimerq_timer_memalloc(
+                            xrbt_vkey_t xrbt_vkey,
+                            xrbt_size_t xst_nsize,
+                            xrbt_ctxt_t xrbt_ctxt)
+{
+    return malloc(xst_nsize);
+}
+
+/**********************************************************/
+/**
+ * @brief 定时器默认的内存释放接口。
+ */
+static xrbt_void_t xtimerq_timer_memfree(
+                            x_rbnode_iter xiter_node,
+                            xrbt_size_t xnode_size,
+                            xrbt_ctxt_t xrbt_ctxt)
+{
+    free(xiter_node);
+}
+
+/**********************************************************/
+/**
+ * @brief 将定时器从到期待回调链表中移除。
+ */
+static xrbt_void_t xtimerq_unlink_pending(x_timerq_ptr xtimerq_ptr,
+                                          x_timer_ptr xtimer_ptr)
+{
+    XASSERT(xtimer_ptr->xbt_pending);
+
+    if (XRBT_NULL != xtimer_ptr->xtimer_prev)
+        xtimer_ptr->xtimer_prev->xtimer_next = xtimer_ptr->xtimer_next;
+    else
+        xtimerq_ptr->xtimer_pending = xtimer_ptr->xtimer_next;
+
+    if (XRBT_NULL != xtimer_ptr->xtimer_next)
+        xtimer_ptr->xtimer_next->xtimer_prev = xtimer_ptr->xtimer_prev;
+
+    xtimer_ptr->xtimer_prev = XRBT_NULL;
+    xtimer_ptr->xtimer_next = XRBT_NULL;
+    xtimer_ptr->xbt_pending = XRBT_FALSE;
+
+    // 经 xrbtree_undock_front() 整体分离的链接头保持原样，在此置为分离状态
+    memset(&xtimer_ptr->xlink, 0, sizeof(x_rbtree_link_t));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************/
+/**
+ * @brief 创建 x_timerq_t 对象。
+ */
+x_timerq_ptr xtimerq_create(xrbt_callback_t * xcallback)
+{
+    x_timerq_ptr    xtimerq_ptr = XRBT_NULL;
+    xrbt_callback_t xtree_callback;
+
+    memset(&xtree_callback, 0, sizeof(xrbt_callback_t));
+    xtree_callback.xfunc_k_compare = &xtimerq_expire_less;
+
+    xtimerq_ptr = (x_timerq_ptr)malloc(sizeof(x_timerq_t));
+    if (XRBT_NULL == xtimerq_ptr)
+    {
+        return XRBT_NULL;
+    }
+
+    xtimerq_ptr->xtree_ptr = xrbtree_create_intrusive(
+                                sizeof(xrbt_uint64_t),
+                                XRBT_LINK_KOFFSET(x_timer_t, xlink, xu64_expire),
+                                XRBT_FLAG_MULTI,
+                                &xtree_callback);
+    if (XRBT_NULL == xtimerq_ptr->xtree_ptr)
+    {
+        free(xtimerq_ptr);
+        return XRBT_NULL;
+    }
+
+    memset(&xtimerq_ptr->xcallback, 0, sizeof(xrbt_callback_t));
+    if ((XRBT_NULL != xcallback) &&
+        (XRBT_NULL != xcallback->xfunc_n_memalloc) &&
+        (XRBT_NULL != xcallback->xfunc_n_memfree))
+    {
+        xtimerq_ptr->xcallback.xfunc_n_memalloc = xcallback->xfunc_n_memalloc;
+        xtimerq_ptr->xcallback.xfunc_n_memfree  = xcallback->xfunc_n_memfree ;
+        xtimerq_ptr->xcallback.xctxt_t_callback = xcallback->xctxt_t_callback;
+    }
+    else
+    {
+        xtimerq_ptr->xcallback.xfunc_n_memalloc = &xtimerq_timer_memalloc;
+        xtimerq_ptr->xcallback.xfunc_n_memfree  = &xtimerq_timer_memfree ;
+    }
+
+    xtimerq_ptr->xtimer_pending = XRBT_NULL;
+    xtimerq_ptr->xbt_expiring   = XRBT_FALSE;
+
+    return xtimerq_ptr;
+}
+
+/**********************************************************/
+/**
+ * @brief 销毁 x_timerq_t 对象。
+ */
+xrbt_void_t xtimerq_destroy(x_timerq_ptr xtimerq_ptr)
+{
+    XASSERT(XRBT_NULL != xtimerq_ptr);
+    XASSERT(!xtimerq_ptr->xbt_expiring);
+
+    x_rbnode_iter xiter_node = xrbtree_begin(xtimerq_ptr->xtree_ptr);
+    x_rbnode_iter xiter_next = XRBT_NULL;
+    x_timer_ptr   xtimer_ptr = XRBT_NULL;
+
+    // 侵入模式下，红黑树不释放定时器，由此逐个 分离/释放
+    while (!xrbtree_iter_is_nil(xiter_node))
+    {
+        xiter_next = xrbtree_next(xiter_node);
+        xtimer_ptr = XTIMER_OF(xiter_node);
+
+        xrbtree_undock(xtimerq_ptr->xtree_ptr, xiter_node);
+        if (xtimer_ptr->xbt_owned)
+        {
+            xtimerq_ptr->xcallback.xfunc_n_memfree(
+                (x_rbnode_iter)xtimer_ptr,
+                sizeof(x_timer_t),
+                xtimerq_ptr->xcallback.xctxt_t_callback);
+        }
+
+        xiter_node = xiter_next;
+    }
+
+    xrbtree_destroy(xtimerq_ptr->xtree_ptr);
+    free(xtimerq_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 返回 x_timerq_t 对象中处于启动状态的定时器数量。
+ */
+xrbt_size_t xtimerq_size(x_timerq_ptr xtimerq_ptr)
+{
+    XASSERT(XRBT_NULL != xtimerq_ptr);
+    return xrbtree_size(xtimerq_ptr->xtree_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 初始化嵌入在调用方对象中的定时器（处于未启动状态）。
+ */
+xrbt_void_t xtimerq_timer_init(x_timer_ptr xtimer_ptr,
+                               xfunc_timer_expire_t xfunc_expire,
+                               xrbt_ctxt_t xtimer_ctxt)
+{
+    XASSERT(XRBT_NULL != xtimer_ptr);
+    XASSERT(XRBT_NULL != xfunc_expire);
+
+    // 全 0 初始化的链接头即处于分离状态
+    memset(&xtimer_ptr->xlink, 0, sizeof(x_rbtree_link_t));
+
+    xtimer_ptr->xu64_expire  = 0;
+    xtimer_ptr->xfunc_expire = xfunc_expire;
+    xtimer_ptr->xtimer_ctxt  = xtimer_ctxt;
+    xtimer_ptr->xtimer_prev  = XRBT_NULL;
+    xtimer_ptr->xtimer_next  = XRBT_NULL;
+    xtimer_ptr->xbt_pending  = XRBT_FALSE;
+    xtimer_ptr->xbt_owned    = XRBT_FALSE;
+}
+
+/**********************************************************/
+/**
+ * @brief 申请定时器（处于未启动状态）。
+ */
+x_timer_ptr xtimerq_timer_alloc(x_timerq_ptr xtimerq_ptr,
+                                xfunc_timer_expire_t xfunc_expire,
+                                xrbt_ctxt_t xtimer_ctxt)
+{
+    XASSERT(XRBT_NULL != xtimerq_ptr);
+    XASSERT(XRBT_NULL != xfunc_expire);
+
+    x_timer_ptr xtimer_ptr = (x_timer_ptr)xtimerq_ptr->xcallback.xfunc_n_memalloc(
+                                            XRBT_NULL,
+                                            sizeof(x_timer_t),
+                                            xtimerq_ptr->xcallback.xctxt_t_callback);
+    if (XRBT_NULL == xtimer_ptr)
+    {
+        return XRBT_NULL;
+    }
+
+    xtimerq_timer_init(xtimer_ptr, xfunc_expire, xtimer_ctxt);
+    xtimer_ptr->xbt_owned = XRBT_TRUE;
+
+    return xtimer_ptr;
+}
+
+/**********************************************************/
+/**
+ * @brief 释放 xtimerq_timer_alloc() 申请的定时器（处于启动状态时，先取消）。
+ */
+xrbt_void_t xtimerq_timer_free(x_timerq_ptr xtimerq_ptr, x_timer_ptr xtimer_ptr)
+{
+    XASSERT(XRBT_NULL != xtimerq_ptr);
+    XASSERT(XRBT_NULL != xtimer_ptr);
+    XASSERT(xtimer_ptr->xbt_owned);
+
+    xtimerq_cancel(xtimerq_ptr, xtimer_ptr);
+    xtimerq_ptr->xcallback.xfunc_n_memfree(
+        (x_rbnode_iter)xtimer_ptr,
+        sizeof(x_timer_t),
+        xtimerq_ptr->xcallback.xctxt_t_callback);
+}
+
+/**********************************************************/
+/**
+ * @brief 启动定时器；定时器已处于启动状态时，以新的到期时间重新启动。
+ */
+xrbt_void_t xtimerq_arm(x_timerq_ptr xtimerq_ptr,
+                        x_timer_ptr xtimer_ptr,
+                        xrbt_uint64_t xu64_expire)
+{
+    XASSERT(XRBT_NULL != xtimerq_ptr);
+    XASSERT(XRBT_NULL != xtimer_ptr);
+
+    xtimerq_cancel(xtimerq_ptr, xtimer_ptr);
+
+    // 多键模式下，相等的到期时间停靠在已有节点之后，保证先启动的先触发
+    xtimer_ptr->xu64_expire = xu64_expire;
+    xrbtree_dock(xtimerq_ptr->xtree_ptr, XTIMER_ITER(xtimer_ptr));
+}
+
+/**********************************************************/
+/**
+ * @brief 取消定时器。
+ */
+xrbt_bool_t xtimerq_cancel(x_timerq_ptr xtimerq_ptr, x_timer_ptr xtimer_ptr)
+{
+    XASSERT(XRBT_NULL != xtimerq_ptr);
+    XASSERT(XRBT_NULL != xtimer_ptr);
+
+    if (xtimer_ptr->xbt_pending)
+    {
+        xtimerq_unlink_pending(xtimerq_ptr, xtimer_ptr);
+        return XRBT_TRUE;
+    }
+
+    if (!xrbtree_iter_is_undocked(XTIMER_ITER(xtimer_ptr)))
+    {
+        xrbtree_undock(xtimerq_ptr->xtree_ptr, XTIMER_ITER(xtimer_ptr));
+        return XRBT_TRUE;
+    }
+
+    return XRBT_FALSE;
+}
+
+/**********************************************************/
+/**
+ * @brief 判断定时器是否处于启动状态（已到期、正等待回调的定时器也视为启动状态）。
+ */
+xrbt_bool_t xtimerq_is_armed(x_timerq_ptr xtimerq_ptr, x_timer_ptr xtimer_ptr)
+{
+    XASSERT(XRBT_NULL != xtimerq_ptr);
+    XASSERT(XRBT_NULL != xtimer_ptr);
+
+    return (xtimer_ptr->xbt_pending ||
+            !xrbtree_iter_is_undocked(XTIMER_ITER(xtimer_ptr)));
+}
+
+/**********************************************************/
+/**
+ * @brief 返回定时器最近一次启动时的到期时间。
+ */
+xrbt_uint64_t xtimerq_expire_time(x_timer_ptr xtimer_ptr)
+{
+    XASSERT(XRBT_NULL != xtimer_ptr);
+    return xtimer_ptr->xu64_expire;
+}
+
+/**********************************************************/
+/**
+ * @brief 返回定时器的上下文标识。
+ */
+xrbt_ctxt_t xtimerq_timer_ctxt(x_timer_ptr xtimer_ptr)
+{
+    XASSERT(XRBT_NULL != xtimer_ptr);
+    return xtimer_ptr->xtimer_ctxt;
+}
+
+/**********************************************************/
+/**
+ * @brief 获取最近的到期时间（O(1)）。
+ */
+xrbt_bool_t xtimerq_next_expire(x_timerq_ptr xtimerq_ptr, xrbt_uint64_t * xu64_expire)
+{
+    XASSERT(XRBT_NULL != xtimerq_ptr);
+    XASSERT(XRBT_NULL != xu64_expire);
+
+    x_rbnode_iter xiter_node = xrbtree_peek_min(xtimerq_ptr->xtree_ptr);
+    if (xrbtree_iter_is_nil(xiter_node))
+    {
+        return XRBT_FALSE;
+    }
+
+    *xu64_expire = XTIMER_OF(xiter_node)->xu64_expire;
+    return XRBT_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 触发所有 到期时间 <= xu64_now 的定时器。
+ */
+xrbt_size_t xtimerq_expire_until(x_timerq_ptr xtimerq_ptr, xrbt_uint64_t xu64_now)
+{
+    XASSERT(XRBT_NULL != xtimerq_ptr);
+    XASSERT(!xtimerq_ptr->xbt_expiring);
+
+    xrbt_size_t   xst_count   = 0;
+    xrbt_size_t   xst_limit   = 0;
+    x_rbnode_iter xiter_node  = XRBT_NULL;
+    x_timer_ptr   xtimer_ptr  = XRBT_NULL;
+    x_timer_ptr   xtimer_last = XRBT_NULL;
+
+    //======================================
+    // 先将所有到期的定时器（红黑树的前段）移入待回调链表（回调中可能 取消/释放 其他到期的定时器）：
+    // 前 log2(n) 个逐个分离最左侧节点（每次均摊 O(1)），其余的只遍历串联，
+    // 之后以 xrbtree_undock_front() 整体分离（O(log n)）
+
+    for (xst_count = xrbtree_size(xtimerq_ptr->xtree_ptr); xst_count > 0; xst_count >>= 1)
+        xst_limit += 1;
+
+    xiter_node = xrbtree_begin(xtimerq_ptr->xtree_ptr);
+    while (!xrbtree_iter_is_nil(xiter_node))
+    {
+        xtimer_ptr = XTIMER_OF(xiter_node);
+        if (xtimer_ptr->xu64_expire > xu64_now)
+            break;
+
+        xtimer_ptr->xtimer_prev = xtimer_last;
+        xtimer_ptr->xtimer_next = XRBT_NULL;
+        xtimer_ptr->xbt_pending = XRBT_TRUE;
+
+        if (XRBT_NULL != xtimer_last)
+            xtimer_last->xtimer_next = xtimer_ptr;
+        else
+            xtimerq_ptr->xtimer_pending = xtimer_ptr;
+        xtimer_last = xtimer_ptr;
+
+        if (xst_count < xst_limit)
+        {
+            xrbtree_pop_min(xtimerq_ptr->xtree_ptr);
+            xiter_node = xrbtree_begin(xtimerq_ptr->xtree_ptr);
+        }
+        else
+        {
+            xiter_node = xrbtree_next(xiter_node);
+        }
+
+        xst_count += 1;
+    }
+
+    if (xst_count > xst_limit)
+    {
+        xrbtree_undock_front(xtimerq_ptr->xtree_ptr, xiter_node, xst_count - xst_limit);
+    }
+
+    xst_count = 0;
+
+    //======================================
+    // 依次回调
+
+    xtimerq_ptr->xbt_expiring = XRBT_TRUE;
+
+    while (XRBT_NULL != xtimerq_ptr->xtimer_pending)
+    {
+        xtimer_ptr = xtimerq_ptr->xtimer_pending;
+        xtimerq_unlink_pending(xtimerq_ptr, xtimer_ptr);
+
+        xtimer_ptr->xfunc_expire(xtimerq_ptr, xtimer_ptr, xtimer_ptr->xtimer_ctxt);
+        xst_count += 1;
+    }
+
+    xtimerq_ptr->xbt_expiring = XRBT_FALSE;
+
+    //======================================
+
+    return xst_count;
+}
@@ -0,0 +1,242 @@
+﻿/**
+ * @file    xtimerq.h
+ * <pre>
+ * Copyright (c) 2019, Gaaagaa All rights reserved.
+ *
+ * 文件名称：xtimerq.h
+ * 创建日期：2019年09月09日
+ * 文件标识：
+ * 文件摘要：基于红黑树（x_rbtree_t）的定时器队列。
+ *
+ * 当前版本：1.0.0.0
+ * 作    者：
+ * 完成日期：2019年09月09日
+ * 版本摘要：
+ *
+ * 历史版本：
+ * 原作者  ：
+ * 完成日期：
+ * 版本摘要：
+ * </pre>
+ */
+
+#ifndef __XTIMERQ_H__
+#define __XTIMERQ_H__
+
+#include "xrbtree.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif // __cplusplus
+
+////////////////////////////////////////////////////////////////////////////////
+// 定时器队列的相关数据定义以及操作接口
+
+//====================================================================
+
+//
+// 定时器队列的相关数据定义
+//
+
+/**
+ * 定时器队列 以 到期时间（xrbt_uint64_t，单位由调用方决定）为索引键，
+ * 使用 侵入模式 + 多键模式 的 x_rbtree_t 对象存储定时器：
+ * 1. 定时器（x_timer_t）内嵌红黑树的链接头，可由 xtimerq_timer_alloc() 申请，
+ *    也可嵌入调用方对象中，经 xtimerq_timer_init() 初始化后使用；
+ *    之后的 启动/取消/重新启动 只进行链接头的 停靠/分离 操作，不申请内存；
+ * 2. 到期时间相同的定时器，按启动的先后顺序触发；
+ * 3. 最近的到期时间 由红黑树缓存的最左侧节点得到，为 O(1) 操作；
+ * 4. 到期的定时器构成红黑树的前段，由 xrbtree_undock_front() 整体分离（O(log n)，
+ *    参看 xtimerq_expire_until()）。
+ */
+
+/** 声明定时器队列结构体 */
+struct x_timerq_t;
+
+/** 声明定时器队列对象指针 */
+typedef struct x_timerq_t * x_timerq_ptr;
+
+/** 声明定时器结构体 */
+struct x_timer_t;
+
+/** 声明定时器句柄 */
+typedef struct x_timer_t * x_timer_ptr;
+
+/**
+ * @brief 定时器到期的回调函数类型。
+ * @note
+ * 回调时，定时器已经从队列中移除，回调函数中可对任意定时器执行
+ * 启动/取消/释放 操作（包括当前回调的定时器），但不可再调用 xtimerq_expire_until()。
+ *
+ * @param [in ] xtimerq_ptr : 定时器队列对象。
+ * @param [in ] xtimer_ptr  : 到期的定时器。
+ * @param [in ] xtimer_ctxt : 定时器的上下文标识（参看 xtimerq_timer_init()）。
+ */
+typedef xrbt_void_t (* xfunc_timer_expire_t)(
+                            x_timerq_ptr xtimerq_ptr,
+                            x_timer_ptr  xtimer_ptr,
+                            xrbt_ctxt_t  xtimer_ctxt);
+
+/**
+ * @struct x_timer_t
+ * @brief  定时器的结构体描述信息（可嵌入调用方对象中，各字段由定时器队列维护，调用方不可修改）。
+ */
+typedef struct x_timer_t
+{
+    x_rbtree_link_t      xlink;        ///< 红黑树的链接头
+    xrbt_uint64_t        xu64_expire;  ///< 到期时间（红黑树的索引键）
+    xfunc_timer_expire_t xfunc_expire; ///< 到期的回调函数
+    xrbt_ctxt_t          xtimer_ctxt;  ///< 回调的上下文标识
+    x_timer_ptr          xtimer_prev;  ///< 到期待回调链表的前一个定时器
+    x_timer_ptr          xtimer_next;  ///< 到期待回调链表的后一个定时器
+    xrbt_bool_t          xbt_pending;  ///< 是否处于到期待回调链表中
+    xrbt_bool_t          xbt_owned;    ///< 是否由 xtimerq_timer_alloc() 申请
+} x_timer_t;
+
+//====================================================================
+
+//
+// 定时器队列的相关操作接口
+//
+
+/**********************************************************/
+/**
+ * @brief 创建 x_timerq_t 对象。
+ * @note  应使用 @see xtimerq_destroy() 销毁所创建的对象。
+ *
+ * @param [in ] xcallback : 定时器的内存 申请/释放 接口（参看 xtimerq_timer_alloc()，可为 XRBT_NULL）。
+ *
+ * @return x_timerq_ptr
+ *         - 成功，返回 x_timerq_t 对象；
+ *         - 失败，返回 XRBT_NULL 。
+ */
+x_timerq_ptr xtimerq_create(xrbt_callback_t * xcallback);
+
+/**********************************************************/
+/**
+ * @brief 销毁 x_timerq_t 对象。
+ * @note
+ * 处于启动状态的定时器：由 xtimerq_timer_alloc() 申请的随之释放，嵌入调用方对象中的置为未启动状态；
+ * 未启动的定时器须在此之前调用 xtimerq_timer_free() 释放。
+ */
+xrbt_void_t xtimerq_destroy(x_timerq_ptr xtimerq_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回 x_timerq_t 对象中处于启动状态的定时器数量。
+ */
+xrbt_size_t xtimerq_size(x_timerq_ptr xtimerq_ptr);
+
+/**********************************************************/
+/**
+ * @brief 初始化嵌入在调用方对象中的定时器（处于未启动状态）。
+ * @note  定时器的内存由调用方管理，释放前须先调用 xtimerq_cancel() 取消。
+ *
+ * @param [out] xtimer_ptr  : 定时器。
+ * @param [in ] xfunc_expire: 定时器到期的回调函数。
+ * @param [in ] xtimer_ctxt : 定时器的上下文标识。
+ */
+xrbt_void_t xtimerq_timer_init(x_timer_ptr xtimer_ptr,
+                               xfunc_timer_expire_t xfunc_expire,
+                               xrbt_ctxt_t xtimer_ctxt);
+
+/**********************************************************/
+/**
+ * @brief 申请定时器（处于未启动状态）。
+ * @note  使用创建定时器队列时指定的内存申请接口，初始化方式同 xtimerq_timer_init()。
+ *
+ * @return x_timer_ptr
+ *         - 成功，返回定时器句柄；
+ *         - 失败，返回 XRBT_NULL 。
+ */
+x_timer_ptr xtimerq_timer_alloc(x_timerq_ptr xtimerq_ptr,
+                                xfunc_timer_expire_t xfunc_expire,
+                                xrbt_ctxt_t xtimer_ctxt);
+
+/**********************************************************/
+/**
+ * @brief 释放 xtimerq_timer_alloc() 申请的定时器（处于启动状态时，先取消）。
+ */
+xrbt_void_t xtimerq_timer_free(x_timerq_ptr xtimerq_ptr, x_timer_ptr xtimer_ptr);
+
+/**********************************************************/
+/**
+ * @brief 启动定时器；定时器已处于启动状态时，以新的到期时间重新启动。
+ * @note  不申请内存。
+ *
+ * @param [in ] xtimerq_ptr : 定时器队列对象。
+ * @param [in ] xtimer_ptr  : 定时器句柄。
+ * @param [in ] xu64_expire : 到期时间。
+ */
+xrbt_void_t xtimerq_arm(x_timerq_ptr xtimerq_ptr,
+                        x_timer_ptr xtimer_ptr,
+                        xrbt_uint64_t xu64_expire);
+
+/**********************************************************/
+/**
+ * @brief 取消定时器。
+ *
+ * @return xrbt_bool_t
+ *         - 定时器原本处于启动状态，返回 XRBT_TRUE；
+ *         - 否则，返回 XRBT_FALSE 。
+ */
+xrbt_bool_t xtimerq_cancel(x_timerq_ptr xtimerq_ptr, x_timer_ptr xtimer_ptr);
+
+/**********************************************************/
+/**
+ * @brief 判断定时器是否处于启动状态（已到期、正等待回调的定时器也视为启动状态）。
+ */
+xrbt_bool_t xtimerq_is_armed(x_timerq_ptr xtimerq_ptr, x_timer_ptr xtimer_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回定时器最近一次启动时的到期时间。
+ */
+xrbt_uint64_t xtimerq_expire_time(x_timer_ptr xtimer_ptr);
+
+/**********************************************************/
+/**
+ * @brief 返回定时器的上下文标识。
+ */
+xrbt_ctxt_t xtimerq_timer_ctxt(x_timer_ptr xtimer_ptr);
+
+/**********************************************************/
+/**
+ * @brief 获取最近的到期时间（O(1)）。
+ *
+ * @param [in ] xtimerq_ptr : 定时器队列对象。
+ * @param [out] xu64_expire : 返回最近的到期时间。
+ *
+ * @return xrbt_bool_t
+ *         - 队列中有启动状态的定时器，返回 XRBT_TRUE；
+ *         - 队列为空，返回 XRBT_FALSE 。
+ */
+xrbt_bool_t xtimerq_next_expire(x_timerq_ptr xtimerq_ptr, xrbt_uint64_t * xu64_expire);
+
+/**********************************************************/
+/**
+ * @brief 触发所有 到期时间 <= xu64_now 的定时器。
+ * @note
+ * 先将所有到期的定时器（红黑树的前段）一次性从队列中分离，再按 到期时间、启动先后 的顺序依次回调；
+ * 回调中重新启动的定时器（即使 到期时间 <= xu64_now）留待下一次调用时触发。
+ *
+ * @param [in ] xtimerq_ptr : 定时器队列对象。
+ * @param [in ] xu64_now    : 当前时间。
+ *
+ * @return xrbt_size_t
+ *         - 返回触发回调的定时器数量。
+ */
+xrbt_size_t xtimerq_expire_until(x_timerq_ptr xtimerq_ptr, xrbt_uint64_t xu64_now);
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}; // extern "C"
+#endif // __cplusplus
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __XTIMERQ_H__